@@ -76,6 +76,12 @@ absl::Status ReadCheckpointObjectGraph(BundleReader* bundle_reader,
 
 absl::Status SavedModelV2Bundle::Load(const std::string& export_dir,
                                       SavedModelV2Bundle* const bundle) {
+  return Load(export_dir, bundle, BundleReader::Options());
+}
+
+absl::Status SavedModelV2Bundle::Load(
+    const std::string& export_dir, SavedModelV2Bundle* const bundle,
+    const BundleReader::Options& reader_options) {
   metrics::SavedModelReadApi(kCCLoadBundleV2Label).IncrementBy(1);
   SavedModel saved_model_proto;
   TF_RETURN_IF_ERROR(ReadSavedModel(export_dir, &saved_model_proto));
@@ -112,8 +118,8 @@ absl::Status SavedModelV2Bundle::Load(const std::string& export_dir,
     // Load the variables checkpoint reader.
     const std::string variables_prefix =
         io::JoinPath(variables_dir, kSavedModelVariablesFilename);
-    bundle->variable_reader_ =
-        std::make_unique<BundleReader>(Env::Default(), variables_prefix);
+    bundle->variable_reader_ = std::make_unique<BundleReader>(
+        Env::Default(), variables_prefix, reader_options);
     TF_RETURN_WITH_CONTEXT_IF_ERROR(
         bundle->variable_reader_->status(),
         "Unable to load SavedModel variables checkpoint from ",
@@ -46,6 +46,13 @@ class SavedModelV2Bundle {
   static absl::Status Load(const std::string& export_dir,
                            SavedModelV2Bundle* bundle);
 
+  /// As above, reading the variables with a BundleReader created with
+  /// `reader_options`, e.g. to memory-map them (BundleReader::Options::
+  /// use_mmap). The cache in `reader_options`, if any, must outlive `bundle`.
+  static absl::Status Load(const std::string& export_dir,
+                           SavedModelV2Bundle* bundle,
+                           const BundleReader::Options& reader_options);
+
   /// MetaGraphDef from the loaded SavedModel.
   MetaGraphDef& meta_graph_def() { return meta_graph_def_; }
 
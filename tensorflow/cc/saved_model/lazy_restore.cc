@@ -0,0 +1,479 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/lazy_restore.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/tensor_id.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/saved_tensor_slice_util.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+// A use of the output `output` of a node by input `input` of `node`.
+struct Use {
+  int node;
+  int input;
+  int output;
+};
+
+// A variable that is read lazily, in place of output `output` of a RestoreV2.
+struct LazyVariable {
+  int output;
+  const NodeDef* var;
+  std::string tensor_name;
+  int64_t row_offset;
+  // The ResourceGather ops to replace.
+  std::vector<int> gathers;
+  // The Identity and AssignVariableOp nodes that restore the variable.
+  std::vector<std::string> restore_nodes;
+};
+
+class LazyRestoreRewriter {
+ public:
+  LazyRestoreRewriter(const LazyRestoreOptions& options,
+                      const std::string& variables_prefix,
+                      const std::string& saver_scope, GraphDef* graph)
+      : options_(options),
+        variables_prefix_(variables_prefix),
+        saver_scope_(saver_scope),
+        graph_(graph),
+        reader_(Env::Default(), variables_prefix) {
+    for (int i = 0; i < graph_->node_size(); ++i) {
+      const NodeDef& node = graph_->node(i);
+      node_index_[node.name()] = i;
+      for (int j = 0; j < node.input_size(); ++j) {
+        const TensorId id = ParseTensorName(node.input(j));
+        uses_[std::string(id.node())].push_back({i, j, id.index()});
+      }
+    }
+  }
+
+  absl::Status Rewrite(std::vector<std::string>* lazy_variables) {
+    TF_RETURN_IF_ERROR(reader_.status());
+    for (int i = 0; i < graph_->node_size(); ++i) {
+      const NodeDef& node = graph_->node(i);
+      if (node.op() != "RestoreV2" ||
+          !absl::StartsWith(node.name(), saver_scope_)) {
+        continue;
+      }
+      std::vector<LazyVariable> variables;
+      TF_RETURN_IF_ERROR(FindLazyVariables(node, &variables));
+      if (variables.empty()) continue;
+      for (const LazyVariable& variable : variables) {
+        lazy_variables->push_back(variable.var->name());
+      }
+      TF_RETURN_IF_ERROR(RewriteRestore(i, variables));
+    }
+    RemoveNodes();
+    return absl::OkStatus();
+  }
+
+ private:
+  const NodeDef* FindNode(absl::string_view name) const {
+    auto it = node_index_.find(name);
+    return it == node_index_.end() ? nullptr : &graph_->node(it->second);
+  }
+
+  const std::vector<Use>& UsesOf(absl::string_view name) const {
+    static const std::vector<Use>* const kNoUses = new std::vector<Use>();
+    auto it = uses_.find(name);
+    return it == uses_.end() ? *kNoUses : it->second;
+  }
+
+  // Returns the string tensor held by the Const node `name`, which is only
+  // used by `user`.
+  bool GetConstStrings(absl::string_view name, absl::string_view user,
+                       std::vector<std::string>* values) const {
+    const NodeDef* node = FindNode(name);
+    if (node == nullptr || node->op() != "Const") return false;
+    for (const Use& use : UsesOf(name)) {
+      if (graph_->node(use.node).name() != user) return false;
+    }
+    auto it = node->attr().find("value");
+    Tensor tensor;
+    if (it == node->attr().end() || !tensor.FromProto(it->second.tensor()) ||
+        tensor.dtype() != DT_STRING || tensor.dims() != 1) {
+      return false;
+    }
+    for (const tstring& value : tensor.vec<tstring>()) {
+      values->emplace_back(value);
+    }
+    return true;
+  }
+
+  absl::Status FindLazyVariables(const NodeDef& restore,
+                                 std::vector<LazyVariable>* variables) {
+    std::vector<std::string> tensor_names;
+    std::vector<std::string> shape_and_slices;
+    if (restore.input_size() < 3 ||
+        !GetConstStrings(restore.input(1), restore.name(), &tensor_names) ||
+        !GetConstStrings(restore.input(2), restore.name(),
+                         &shape_and_slices) ||
+        tensor_names.size() != shape_and_slices.size()) {
+      return absl::OkStatus();
+    }
+    auto dtypes = restore.attr().find("dtypes");
+    if (dtypes == restore.attr().end() ||
+        dtypes->second.list().type_size() != tensor_names.size()) {
+      return absl::OkStatus();
+    }
+    for (int k = 0; k < tensor_names.size(); ++k) {
+      LazyVariable variable;
+      variable.output = k;
+      variable.tensor_name = tensor_names[k];
+      if (FindVariable(restore, k, &variable) &&
+          CheckCheckpoint(shape_and_slices[k], &variable) &&
+          FindGathers(&variable)) {
+        variables->push_back(std::move(variable));
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  // Follows output `output` of `restore` through Identity ops to the
+  // AssignVariableOp that restores a variable.
+  bool FindVariable(const NodeDef& restore, int output,
+                    LazyVariable* variable) {
+    std::string producer = restore.name();
+    int producer_output = output;
+    while (true) {
+      const Use* consumer = nullptr;
+      for (const Use& use : UsesOf(producer)) {
+        if (use.output != producer_output) continue;
+        if (consumer != nullptr) return false;
+        consumer = &use;
+      }
+      if (consumer == nullptr) return false;
+      const NodeDef& node = graph_->node(consumer->node);
+      variable->restore_nodes.push_back(node.name());
+      if (node.op() == "AssignVariableOp" && consumer->input == 1) {
+        const TensorId var_id = ParseTensorName(node.input(0));
+        variable->var = FindNode(var_id.node());
+        return var_id.index() == 0 && variable->var != nullptr &&
+               variable->var->op() == "VarHandleOp" &&
+               !lazy_var_names_.contains(variable->var->name());
+      }
+      if (node.op() != "Identity") return false;
+      // Other uses of the Identity, including control dependencies, keep the
+      // restored value alive.
+      for (const Use& use : UsesOf(node.name())) {
+        if (use.output != 0) return false;
+      }
+      producer = node.name();
+      producer_output = 0;
+    }
+  }
+
+  // Checks that the variable is large enough, and that its rows can be read
+  // on their own from the checkpoint.
+  bool CheckCheckpoint(const std::string& shape_and_slice,
+                       LazyVariable* variable) {
+    const auto& attr = variable->var->attr();
+    auto dtype_it = attr.find("dtype");
+    auto shape_it = attr.find("shape");
+    if (dtype_it == attr.end() || shape_it == attr.end()) return false;
+    const DataType dtype = dtype_it->second.type();
+    TensorShape shape;
+    if (!DataTypeCanUseMemcpy(dtype) ||
+        !PartialTensorShape(shape_it->second.shape()).AsTensorShape(&shape) ||
+        shape.dims() < 1 ||
+        shape.num_elements() * DataTypeSize(dtype) <
+            options_.min_variable_bytes) {
+      return false;
+    }
+
+    DataType stored_dtype;
+    TensorShape stored_shape;
+    if (!reader_.LookupDtypeAndShape(variable->tensor_name, &stored_dtype,
+                                     &stored_shape)
+             .ok() ||
+        stored_dtype != dtype) {
+      return false;
+    }
+    variable->row_offset = 0;
+    if (shape_and_slice.empty()) {
+      if (stored_shape != shape) return false;
+    } else {
+      TensorShape full_shape;
+      TensorSlice slice;
+      TensorShape slice_shape;
+      if (!checkpoint::ParseShapeAndSlice(shape_and_slice, &full_shape, &slice,
+                                          &slice_shape)
+               .ok() ||
+          full_shape != stored_shape || slice_shape != shape) {
+        return false;
+      }
+      for (int d = 1; d < slice.dims(); ++d) {
+        if (!slice.IsFullAt(d)) return false;
+      }
+      if (!slice.IsFullAt(0)) variable->row_offset = slice.start(0);
+    }
+
+    // Rules out entries whose rows can not be read on their own, by reading
+    // the first row the variable uses from each stored slice.
+    std::vector<TensorSlice> stored_slices;
+    if (!reader_.LookupTensorSlices(variable->tensor_name, &stored_slices)
+             .ok()) {
+      return false;
+    }
+    std::vector<int64_t> probe_rows = {variable->row_offset};
+    for (const TensorSlice& stored_slice : stored_slices) {
+      if (!stored_slice.IsFullAt(0) &&
+          stored_slice.start(0) > variable->row_offset &&
+          stored_slice.start(0) < variable->row_offset + shape.dim_size(0)) {
+        probe_rows.push_back(stored_slice.start(0));
+      }
+    }
+    for (int64_t probe_row : probe_rows) {
+      Tensor row;
+      if (!reader_.LookupRows(variable->tensor_name, probe_row, 1, &row).ok()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns whether the values read from the variable by `node`, a node of
+  // the variable's own scope, only reach other nodes of that scope or of the
+  // saver. TF1 variables read themselves in their scope (e.g.
+  // "<var>/Read/ReadVariableOp", and "<var>/Read/Identity" with a caching
+  // device), and these reads may be used anywhere.
+  bool ReadsStayInScope(int node, absl::string_view var_scope) const {
+    std::vector<int> stack = {node};
+    absl::flat_hash_set<int> visited = {node};
+    while (!stack.empty()) {
+      const NodeDef& current = graph_->node(stack.back());
+      stack.pop_back();
+      // These do not read the value of the variable.
+      if (current.op() == "VarIsInitializedOp" ||
+          current.op() == "AssignVariableOp") {
+        continue;
+      }
+      for (const Use& use : UsesOf(current.name())) {
+        const std::string& user = graph_->node(use.node).name();
+        if (absl::StartsWith(user, saver_scope_)) continue;
+        if (!absl::StartsWith(user, var_scope)) return false;
+        if (visited.insert(use.node).second) stack.push_back(use.node);
+      }
+    }
+    return true;
+  }
+
+  // Collects the ResourceGather ops reading the variable, and checks that it
+  // has no other readers.
+  bool FindGathers(LazyVariable* variable) {
+    const NodeDef& var = *variable->var;
+    const std::string var_scope = absl::StrCat(var.name(), "/");
+    const DataType dtype = var.attr().at("dtype").type();
+    for (const Use& use : UsesOf(var.name())) {
+      const NodeDef& node = graph_->node(use.node);
+      if (absl::StartsWith(node.name(), var_scope)) {
+        if (!ReadsStayInScope(use.node, var_scope)) return false;
+        continue;
+      }
+      if (node.name() == variable->restore_nodes.back() ||
+          node.op() == "VarIsInitializedOp" ||
+          absl::StartsWith(node.name(), saver_scope_)) {
+        continue;
+      }
+      if (node.op() != "ResourceGather" || use.input != 0) return false;
+      auto batch_dims = node.attr().find("batch_dims");
+      auto gather_dtype = node.attr().find("dtype");
+      if ((batch_dims != node.attr().end() && batch_dims->second.i() != 0) ||
+          gather_dtype == node.attr().end() ||
+          gather_dtype->second.type() != dtype) {
+        return false;
+      }
+      variable->gathers.push_back(use.node);
+    }
+    if (variable->gathers.empty()) return false;
+    lazy_var_names_.insert(var.name());
+    return true;
+  }
+
+  // Replaces the ResourceGather ops of the variables read lazily, and drops
+  // them from `restore` and its inputs.
+  absl::Status RewriteRestore(int restore_index,
+                              const std::vector<LazyVariable>& variables) {
+    NodeDef* restore = graph_->mutable_node(restore_index);
+    std::vector<bool> is_lazy(restore->attr().at("dtypes").list().type_size());
+    for (const LazyVariable& variable : variables) {
+      is_lazy[variable.output] = true;
+      for (int gather : variable.gathers) {
+        RewriteGather(variable, graph_->mutable_node(gather));
+      }
+      for (const std::string& name : variable.restore_nodes) {
+        removed_.insert(name);
+      }
+    }
+
+    // The remaining outputs of `restore`, renumbered.
+    std::vector<int> new_output(is_lazy.size(), -1);
+    int num_outputs = 0;
+    for (int k = 0; k < is_lazy.size(); ++k) {
+      if (!is_lazy[k]) new_output[k] = num_outputs++;
+    }
+    if (num_outputs == 0) {
+      removed_.insert(restore->name());
+      removed_.insert(std::string(ParseTensorName(restore->input(1)).node()));
+      removed_.insert(std::string(ParseTensorName(restore->input(2)).node()));
+      return absl::OkStatus();
+    }
+
+    for (int input = 1; input <= 2; ++input) {
+      const std::string name(ParseTensorName(restore->input(input)).node());
+      NodeDef* names = graph_->mutable_node(node_index_.at(name));
+      Tensor values;
+      if (!values.FromProto(names->attr().at("value").tensor())) {
+        return absl::InternalError(
+            absl::StrCat("Invalid value of node ", names->name()));
+      }
+      Tensor kept(DT_STRING, TensorShape({num_outputs}));
+      for (int k = 0; k < is_lazy.size(); ++k) {
+        if (is_lazy[k]) continue;
+        kept.vec<tstring>()(new_output[k]) = values.vec<tstring>()(k);
+      }
+      kept.AsProtoField((*names->mutable_attr())["value"].mutable_tensor());
+      names->mutable_attr()->erase("_output_shapes");
+    }
+    auto* dtypes = (*restore->mutable_attr())["dtypes"].mutable_list();
+    AttrValue::ListValue kept_dtypes;
+    for (int k = 0; k < is_lazy.size(); ++k) {
+      if (!is_lazy[k]) kept_dtypes.add_type(dtypes->type(k));
+    }
+    dtypes->Swap(&kept_dtypes);
+    restore->mutable_attr()->erase("_output_shapes");
+
+    for (const Use& use : UsesOf(restore->name())) {
+      if (use.output < 0 || is_lazy[use.output]) continue;
+      NodeDef* node = graph_->mutable_node(use.node);
+      node->set_input(use.input,
+                      new_output[use.output] == 0
+                          ? restore->name()
+                          : absl::StrCat(restore->name(), ":",
+                                         new_output[use.output]));
+    }
+    return absl::OkStatus();
+  }
+
+  void RewriteGather(const LazyVariable& variable, NodeDef* gather) {
+    NodeDef paged;
+    paged.set_name(gather->name());
+    paged.set_op("_PagedBundleGather");
+    paged.add_input(gather->input(1));
+    for (int i = 2; i < gather->input_size(); ++i) {
+      if (IsTensorIdControl(ParseTensorName(gather->input(i)))) {
+        paged.add_input(gather->input(i));
+      }
+    }
+    // Keeps the device of the gather, unless it is not a CPU device.
+    DeviceNameUtils::ParsedName device;
+    if (DeviceNameUtils::ParseFullName(gather->device(), &device) &&
+        (!device.has_type || device.type == DEVICE_CPU)) {
+      paged.set_device(gather->device());
+    }
+    auto& attr = *paged.mutable_attr();
+    attr["dtype"] = gather->attr().at("dtype");
+    attr["Tindices"] = gather->attr().at("Tindices");
+    attr["prefix"].set_s(variables_prefix_);
+    attr["tensor_name"].set_s(variable.tensor_name);
+    attr["row_offset"].set_i(variable.row_offset);
+    attr["shape"] = variable.var->attr().at("shape");
+    attr["cache_bytes"].set_i(options_.cache_bytes);
+    if (gather->has_experimental_debug_info()) {
+      *paged.mutable_experimental_debug_info() =
+          gather->experimental_debug_info();
+    }
+    *gather = std::move(paged);
+  }
+
+  // Removes the nodes in `removed_`, and the control dependencies on them.
+  void RemoveNodes() {
+    google::protobuf::RepeatedPtrField<NodeDef> nodes;
+    for (NodeDef& node : *graph_->mutable_node()) {
+      if (removed_.contains(node.name())) continue;
+      auto* inputs = node.mutable_input();
+      for (int i = inputs->size() - 1; i >= 0; --i) {
+        if (absl::StartsWith(inputs->Get(i), "^") &&
+            removed_.contains(absl::string_view(inputs->Get(i)).substr(1))) {
+          inputs->DeleteSubrange(i, 1);
+        }
+      }
+      *nodes.Add() = std::move(node);
+    }
+    graph_->mutable_node()->Swap(&nodes);
+  }
+
+  const LazyRestoreOptions& options_;
+  const std::string variables_prefix_;
+  const std::string saver_scope_;
+  GraphDef* const graph_;
+  BundleReader reader_;
+
+  absl::flat_hash_map<std::string, int> node_index_;
+  // Keyed by the name of the used node.
+  absl::flat_hash_map<std::string, std::vector<Use>> uses_;
+  absl::flat_hash_set<std::string> lazy_var_names_;
+  absl::flat_hash_set<std::string> removed_;
+};
+
+}  // namespace
+
+absl::Status RewriteForLazyRestore(const LazyRestoreOptions& options,
+                                   const std::string& variables_prefix,
+                                   MetaGraphDef* meta_graph,
+                                   std::vector<std::string>* lazy_variables) {
+  lazy_variables->clear();
+  if (!meta_graph->has_saver_def()) return absl::OkStatus();
+  // The restore ops of a saver are created in its name scope, e.g. "save/".
+  const std::string& restore_op_name =
+      meta_graph->saver_def().restore_op_name();
+  const size_t scope_end = restore_op_name.rfind('/');
+  if (scope_end == std::string::npos) return absl::OkStatus();
+  LazyRestoreRewriter rewriter(options, variables_prefix,
+                               restore_op_name.substr(0, scope_end + 1),
+                               meta_graph->mutable_graph_def());
+  TF_RETURN_IF_ERROR(rewriter.Rewrite(lazy_variables));
+  if (!lazy_variables->empty()) {
+    LOG(INFO) << "Reading " << lazy_variables->size()
+              << " variables lazily from " << variables_prefix;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace tensorflow
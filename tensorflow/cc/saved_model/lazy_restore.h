@@ -0,0 +1,66 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CC_SAVED_MODEL_LAZY_RESTORE_H_
+#define TENSORFLOW_CC_SAVED_MODEL_LAZY_RESTORE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+
+namespace tensorflow {
+
+struct LazyRestoreOptions {
+  // Variables smaller than this are restored as usual.
+  int64_t min_variable_bytes = 16 << 20;
+  // Upper bound on the memory used to cache the rows read from the checkpoint,
+  // shared by all the variables read lazily from it.
+  int64_t cache_bytes = int64_t{1} << 30;
+};
+
+// Rewrites `meta_graph` so that large variables are read on demand from the
+// V2 checkpoint at `variables_prefix`, rather than restored in full by the
+// restore op of its saver. This lets a model serve before all of its variables
+// are in memory.
+//
+// A resource variable (VarHandleOp) is read lazily if
+//  - it is restored from `variables_prefix` by a RestoreV2 op of the saver,
+//    and is unpartitioned or partitioned along its first dimension;
+//  - its dtype has a fixed size, its shape is fully defined with at least one
+//    dimension, and it is stored uncompressed in the checkpoint; and
+//  - it is only looked up with ResourceGather, besides the ops in its own name
+//    scope whose results stay in that scope, and the ops in the scope of the
+//    saver (initializer, save ops). A variable whose own reads are used
+//    elsewhere (e.g. "<var>/Read/Identity" of a TF1 variable with a caching
+//    device) is restored as usual.
+// Its ResourceGather ops are replaced by _PagedBundleGather ops that read rows
+// from the checkpoint in pages, and cache them up to a limit. The ops restoring
+// it are removed, so the variable itself stays uninitialized. Every other
+// variable is restored as usual.
+//
+// Only graphs restored by a saver (`MetaGraphDef.saver_def`) are rewritten.
+// The names of the variables that are read lazily are returned in
+// `lazy_variables`.
+absl::Status RewriteForLazyRestore(const LazyRestoreOptions& options,
+                                   const std::string& variables_prefix,
+                                   MetaGraphDef* meta_graph,
+                                   std::vector<std::string>* lazy_variables);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CC_SAVED_MODEL_LAZY_RESTORE_H_
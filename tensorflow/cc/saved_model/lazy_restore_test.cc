@@ -0,0 +1,242 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/lazy_restore.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr int64_t kRows = 64;
+constexpr int64_t kRowSize = 4;
+
+class LazyRestoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    prefix_ = io::JoinPath(testing::TmpDir(), "lazy_restore", "variables");
+    embedding_ = Tensor(DT_FLOAT, TensorShape({kRows, kRowSize}));
+    test::FillIota<float>(&embedding_, 0);
+    bias_ = test::AsTensor<float>({1, 2, 3, 4});
+    BundleWriter writer(Env::Default(), prefix_);
+    TF_ASSERT_OK(writer.Add("bias", bias_));
+    TF_ASSERT_OK(writer.Add("embedding", embedding_));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  // Builds the graph of a model that looks up rows of "embedding" and reads
+  // "bias", with the restore ops of a saver in scope "save".  If
+  // `read_embedding` is set, the model also reads the whole embedding.  If
+  // `restore_bias` is not set, only the embedding is restored.  Like TF1
+  // variables, "embedding" reads itself in its own scope; if
+  // `cache_embedding` is set, that read is also used outside of it, as when
+  // the variable has a caching device.
+  MetaGraphDef BuildModel(bool read_embedding, bool restore_bias = true,
+                          bool cache_embedding = false) {
+    Scope root = Scope::NewRootScope();
+    auto embedding = ops::VarHandleOp(
+        root.WithOpName("embedding"), DT_FLOAT,
+        PartialTensorShape({kRows, kRowSize}),
+        ops::VarHandleOp::SharedName("embedding"));
+    auto bias = ops::VarHandleOp(root.WithOpName("bias"), DT_FLOAT,
+                                 PartialTensorShape({kRowSize}),
+                                 ops::VarHandleOp::SharedName("bias"));
+    ops::VarIsInitializedOp(root.WithOpName("embedding/IsInitialized"),
+                            embedding);
+    auto embedding_read = ops::ReadVariableOp(
+        root.WithOpName("embedding/Read/ReadVariableOp"), embedding, DT_FLOAT);
+    if (cache_embedding) {
+      auto cached = ops::Identity(root.WithOpName("embedding/Read/Identity"),
+                                  embedding_read);
+      ops::Identity(root.WithOpName("read_cached_embedding"), cached);
+    }
+    auto indices = ops::Placeholder(root.WithOpName("indices"), DT_INT32);
+    ops::ResourceGather(root.WithOpName("lookup"), embedding, indices,
+                        DT_FLOAT);
+    ops::ReadVariableOp(root.WithOpName("read_bias"), bias, DT_FLOAT);
+    if (read_embedding) {
+      ops::ReadVariableOp(root.WithOpName("read_embedding"), embedding,
+                          DT_FLOAT);
+    }
+
+    Scope save = root.NewSubScope("save");
+    auto filename = ops::Const(save.WithOpName("Const"), "model");
+    std::vector<Operation> assigns;
+    if (restore_bias) {
+      auto restore = ops::RestoreV2(
+          save.WithOpName("RestoreV2"), filename,
+          ops::Const(save.WithOpName("RestoreV2/tensor_names"),
+                     {"bias", "embedding"}),
+          ops::Const(save.WithOpName("RestoreV2/shape_and_slices"), {"", ""}),
+          {DT_FLOAT, DT_FLOAT});
+      assigns.push_back(
+          ops::AssignVariableOp(
+              save.WithOpName("AssignVariableOp"), bias,
+              ops::Identity(save.WithOpName("Identity"), restore.tensors[0]))
+              .operation);
+      assigns.push_back(
+          ops::AssignVariableOp(save.WithOpName("AssignVariableOp_1"),
+                                embedding,
+                                ops::Identity(save.WithOpName("Identity_1"),
+                                              restore.tensors[1]))
+              .operation);
+    } else {
+      auto restore = ops::RestoreV2(
+          save.WithOpName("RestoreV2"), filename,
+          ops::Const(save.WithOpName("RestoreV2/tensor_names"), {"embedding"}),
+          ops::Const(save.WithOpName("RestoreV2/shape_and_slices"), {""}),
+          {DT_FLOAT});
+      assigns.push_back(
+          ops::AssignVariableOp(save.WithOpName("AssignVariableOp_1"),
+                                embedding,
+                                ops::Identity(save.WithOpName("Identity_1"),
+                                              restore.tensors[0]))
+              .operation);
+    }
+    ops::NoOp(save.WithOpName("restore_all").WithControlDependencies(assigns));
+
+    MetaGraphDef meta_graph;
+    TF_CHECK_OK(root.ToGraphDef(meta_graph.mutable_graph_def()));
+    meta_graph.mutable_saver_def()->set_filename_tensor_name("save/Const:0");
+    meta_graph.mutable_saver_def()->set_restore_op_name("save/restore_all");
+    return meta_graph;
+  }
+
+  LazyRestoreOptions Options() {
+    LazyRestoreOptions options;
+    options.min_variable_bytes = kRows * kRowSize * sizeof(float);
+    options.cache_bytes = 1 << 20;
+    return options;
+  }
+
+  const NodeDef* FindNode(const MetaGraphDef& meta_graph,
+                          const std::string& name) {
+    for (const NodeDef& node : meta_graph.graph_def().node()) {
+      if (node.name() == name) return &node;
+    }
+    return nullptr;
+  }
+
+  std::string prefix_;
+  Tensor embedding_;
+  Tensor bias_;
+};
+
+TEST_F(LazyRestoreTest, ReadsEmbeddingLazily) {
+  MetaGraphDef meta_graph = BuildModel(/*read_embedding=*/false);
+  std::vector<std::string> lazy_variables;
+  TF_ASSERT_OK(
+      RewriteForLazyRestore(Options(), prefix_, &meta_graph, &lazy_variables));
+  EXPECT_THAT(lazy_variables, ElementsAre("embedding"));
+
+  EXPECT_EQ(FindNode(meta_graph, "lookup")->op(), "_PagedBundleGather");
+  EXPECT_EQ(FindNode(meta_graph, "save/Identity_1"), nullptr);
+  EXPECT_EQ(FindNode(meta_graph, "save/AssignVariableOp_1"), nullptr);
+  EXPECT_EQ(FindNode(meta_graph, "save/restore_all")->input_size(), 1);
+  const NodeDef* restore = FindNode(meta_graph, "save/RestoreV2");
+  EXPECT_EQ(restore->attr().at("dtypes").list().type_size(), 1);
+
+  std::unique_ptr<Session> session(NewSession(SessionOptions()));
+  TF_ASSERT_OK(session->Create(meta_graph.graph_def()));
+  TF_ASSERT_OK(session->Run({{"save/Const", test::AsScalar<tstring>(prefix_)}},
+                            {}, {"save/restore_all"}, nullptr));
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run(
+      {{"indices", test::AsTensor<int32_t>({3, 63, 0, 3}, {2, 2})}},
+      {"lookup", "read_bias"}, {}, &outputs));
+  Tensor expected(DT_FLOAT, TensorShape({2, 2, kRowSize}));
+  const int rows[] = {3, 63, 0, 3};
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < kRowSize; ++j) {
+      expected.flat<float>()(i * kRowSize + j) = rows[i] * kRowSize + j;
+    }
+  }
+  test::ExpectTensorEqual<float>(outputs[0], expected);
+  test::ExpectTensorEqual<float>(outputs[1], bias_);
+
+  // Lookups are checked like those of ResourceGather.
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      session->Run({{"indices", test::AsTensor<int32_t>({kRows})}},
+                   {"lookup"}, {}, &outputs)));
+}
+
+TEST_F(LazyRestoreTest, KeepsVariablesWithOtherReaders) {
+  MetaGraphDef meta_graph = BuildModel(/*read_embedding=*/true);
+  const MetaGraphDef original = meta_graph;
+  std::vector<std::string> lazy_variables;
+  TF_ASSERT_OK(
+      RewriteForLazyRestore(Options(), prefix_, &meta_graph, &lazy_variables));
+  EXPECT_TRUE(lazy_variables.empty());
+  EXPECT_EQ(meta_graph.DebugString(), original.DebugString());
+}
+
+TEST_F(LazyRestoreTest, KeepsVariablesReadOutsideTheirScope) {
+  MetaGraphDef meta_graph =
+      BuildModel(/*read_embedding=*/false, /*restore_bias=*/true,
+                 /*cache_embedding=*/true);
+  const MetaGraphDef original = meta_graph;
+  std::vector<std::string> lazy_variables;
+  TF_ASSERT_OK(
+      RewriteForLazyRestore(Options(), prefix_, &meta_graph, &lazy_variables));
+  EXPECT_TRUE(lazy_variables.empty());
+  EXPECT_EQ(meta_graph.DebugString(), original.DebugString());
+}
+
+TEST_F(LazyRestoreTest, KeepsSmallVariables) {
+  MetaGraphDef meta_graph = BuildModel(/*read_embedding=*/false);
+  const MetaGraphDef original = meta_graph;
+  LazyRestoreOptions options = Options();
+  ++options.min_variable_bytes;
+  std::vector<std::string> lazy_variables;
+  TF_ASSERT_OK(
+      RewriteForLazyRestore(options, prefix_, &meta_graph, &lazy_variables));
+  EXPECT_TRUE(lazy_variables.empty());
+  EXPECT_EQ(meta_graph.DebugString(), original.DebugString());
+}
+
+TEST_F(LazyRestoreTest, RemovesRestoreOfLastVariable) {
+  MetaGraphDef meta_graph =
+      BuildModel(/*read_embedding=*/false, /*restore_bias=*/false);
+  std::vector<std::string> lazy_variables;
+  TF_ASSERT_OK(
+      RewriteForLazyRestore(Options(), prefix_, &meta_graph, &lazy_variables));
+  EXPECT_THAT(lazy_variables, ElementsAre("embedding"));
+  EXPECT_EQ(FindNode(meta_graph, "save/RestoreV2"), nullptr);
+  EXPECT_EQ(FindNode(meta_graph, "save/RestoreV2/tensor_names"), nullptr);
+  EXPECT_EQ(FindNode(meta_graph, "save/RestoreV2/shape_and_slices"), nullptr);
+  EXPECT_NE(FindNode(meta_graph, "save/Const"), nullptr);
+  EXPECT_EQ(FindNode(meta_graph, "save/restore_all")->input_size(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,16 +15,19 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/loader.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "tensorflow/cc/saved_model/constants.h"
 #include "tensorflow/cc/saved_model/fingerprinting.h"
+#include "tensorflow/cc/saved_model/lazy_restore.h"
 #include "tensorflow/cc/saved_model/loader_util.h"
 #include "tensorflow/cc/saved_model/metrics.h"
 #include "tensorflow/cc/saved_model/reader.h"
@@ -269,6 +272,31 @@ absl::Status RunRestore(const RunOptions& run_options, const string& export_dir,
                  nullptr /* outputs */, &run_metadata, session);
 }
 
+// If `load_options.lazy_restore` is set, rewrites `meta_graph_def` so that
+// large embedding-like variables are read from the checkpoint on demand,
+// rather than restored by RunRestore().
+absl::Status MaybeRewriteForLazyRestore(
+    const string& export_dir, const SavedModelLoadOptions& load_options,
+    MetaGraphDef* meta_graph_def) {
+  if (!load_options.lazy_restore) return absl::OkStatus();
+  const string variables_directory =
+      io::JoinPath(export_dir, kSavedModelVariablesDirectory);
+  TF_ASSIGN_OR_RETURN(
+      bool variables_index_exists,
+      internal::FileExists(
+          Env::Default(),
+          io::JoinPath(variables_directory,
+                       MetaFilename(kSavedModelVariablesFilename))));
+  if (!variables_index_exists) return absl::OkStatus();
+
+  LazyRestoreOptions options;
+  options.cache_bytes = load_options.lazy_restore_cache_bytes;
+  std::vector<string> lazy_variables;
+  return RewriteForLazyRestore(
+      options, io::JoinPath(variables_directory, kSavedModelVariablesFilename),
+      meta_graph_def, &lazy_variables);
+}
+
 }  // namespace
 
 SavedModelBundleInterface::~SavedModelBundleInterface() = default;
@@ -297,11 +325,14 @@ absl::Status LoadSavedModelInternal(const SessionOptions& session_options,
                                     const RunOptions& run_options,
                                     const string& export_dir,
                                     const std::unordered_set<string>& tags,
+                                    const SavedModelLoadOptions& load_options,
                                     SavedModelBundle* const bundle) {
   TF_RETURN_IF_ERROR(ReadMetaGraphDefFromSavedModel(export_dir, tags,
                                                     &bundle->meta_graph_def));
   TF_RETURN_IF_ERROR(
       ReadSavedModelDebugInfoIfPresent(export_dir, &bundle->debug_info));
+  TF_RETURN_IF_ERROR(MaybeRewriteForLazyRestore(export_dir, load_options,
+                                                &bundle->meta_graph_def));
   TF_RETURN_IF_ERROR(LoadMetagraphIntoSession(
       session_options, bundle->meta_graph_def, &bundle->session));
   TF_RETURN_IF_ERROR(RestoreSession(run_options, bundle->meta_graph_def,
@@ -445,10 +476,13 @@ absl::Status LoadSavedModelInternal(const SessionOptions& session_options,
                                     const RunOptions& run_options,
                                     const string& export_dir,
                                     const std::unordered_set<string>& tags,
+                                    const SavedModelLoadOptions& load_options,
                                     SavedModelBundleLite* const bundle) {
   MetaGraphDef meta_graph_def;
   TF_RETURN_IF_ERROR(
       ReadMetaGraphDefFromSavedModel(export_dir, tags, &meta_graph_def));
+  TF_RETURN_IF_ERROR(
+      MaybeRewriteForLazyRestore(export_dir, load_options, &meta_graph_def));
   std::unique_ptr<Session> session;
   TF_RETURN_IF_ERROR(LoadGraphDefIntoSession(
       session_options, std::move(*meta_graph_def.mutable_graph_def()),
@@ -466,6 +500,7 @@ absl::Status LoadSavedModelGeneric(const SessionOptions& session_options,
                                    const RunOptions& run_options,
                                    const string& export_dir,
                                    const std::unordered_set<string>& tags,
+                                   const SavedModelLoadOptions& load_options,
                                    BundleType* const bundle) {
   metrics::SavedModelReadApi(kCCLoadLabel).IncrementBy(1);
   auto fingerprint_proto =
@@ -479,7 +514,7 @@ absl::Status LoadSavedModelGeneric(const SessionOptions& session_options,
   // TODO(robson): Add tests for the counters.
   const uint64 start_microseconds = Env::Default()->NowMicros();
   const absl::Status status = LoadSavedModelInternal(
-      session_options, run_options, export_dir, tags, bundle);
+      session_options, run_options, export_dir, tags, load_options, bundle);
   auto log_and_count = [&](const string& status_str) {
     LOG(INFO) << "SavedModel load for tags { " << absl::StrJoin(tags, " ")
               << " }; Status: " << status_str << ": " << status << ". Took "
@@ -502,8 +537,18 @@ absl::Status LoadSavedModel(const SessionOptions& session_options,
                             const string& export_dir,
                             const std::unordered_set<string>& tags,
                             SavedModelBundle* const bundle) {
-  return LoadSavedModelGeneric<SavedModelBundle>(session_options, run_options,
-                                                 export_dir, tags, bundle);
+  return LoadSavedModel(session_options, run_options, export_dir, tags,
+                        SavedModelLoadOptions(), bundle);
+}
+
+absl::Status LoadSavedModel(const SessionOptions& session_options,
+                            const RunOptions& run_options,
+                            const string& export_dir,
+                            const std::unordered_set<string>& tags,
+                            const SavedModelLoadOptions& load_options,
+                            SavedModelBundle* const bundle) {
+  return LoadSavedModelGeneric<SavedModelBundle>(
+      session_options, run_options, export_dir, tags, load_options, bundle);
 }
 
 absl::Status RestoreSession(const RunOptions& run_options,
@@ -543,6 +588,16 @@ absl::Status LoadSavedModel(const SessionOptions& session_options,
                             const string& export_dir,
                             const std::unordered_set<string>& tags,
                             SavedModelBundleLite* const bundle) {
+  return LoadSavedModel(session_options, run_options, export_dir, tags,
+                        SavedModelLoadOptions(), bundle);
+}
+
+absl::Status LoadSavedModel(const SessionOptions& session_options,
+                            const RunOptions& run_options,
+                            const string& export_dir,
+                            const std::unordered_set<string>& tags,
+                            const SavedModelLoadOptions& load_options,
+                            SavedModelBundleLite* const bundle) {
   SessionOptions rewritten_options(session_options);
   // We disallow calls to Session::Extend() on the returned session, so we can
   // reduce memory consumption by not storing the original GraphDef.
@@ -555,8 +610,8 @@ absl::Status LoadSavedModel(const SessionOptions& session_options,
       ->set_disable_output_partition_graphs(true);
   // TODO(mrry): Consider specializing the session creation to reduce peak
   // RAM consumption by using `Session::Create(GraphDef&&)`.
-  TF_RETURN_IF_ERROR(LoadSavedModelGeneric(rewritten_options, run_options,
-                                           export_dir, tags, bundle));
+  TF_RETURN_IF_ERROR(LoadSavedModelGeneric(
+      rewritten_options, run_options, export_dir, tags, load_options, bundle));
   return absl::OkStatus();
 }
 
@@ -18,6 +18,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CC_SAVED_MODEL_LOADER_H_
 #define TENSORFLOW_CC_SAVED_MODEL_LOADER_H_
 
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 
@@ -132,10 +133,37 @@ absl::Status LoadSavedModel(const SessionOptions& session_options,
 ///
 /// This overload creates a SavedModelBundleLite, which consumes less RAM than
 /// an equivalent SavedModelBundle.
+///
+absl::Status LoadSavedModel(const SessionOptions& session_options,
+                            const RunOptions& run_options,
+                            const string& export_dir,
+                            const std::unordered_set<string>& tags,
+                            SavedModelBundleLite* bundle);
+
+/// Options of LoadSavedModel() that are not session options.
+struct SavedModelLoadOptions {
+  /// If true, large variables that are only looked up by row are restored on
+  /// demand, in pages read from the checkpoint, instead of before
+  /// LoadSavedModel() returns. See lazy_restore.h for the variables this
+  /// applies to.
+  bool lazy_restore = false;
+  /// Upper bound on the memory used to cache the rows of the variables that
+  /// are restored on demand.
+  int64_t lazy_restore_cache_bytes = int64_t{1} << 30;
+};
+
+/// Same as above, with `load_options`.
+absl::Status LoadSavedModel(const SessionOptions& session_options,
+                            const RunOptions& run_options,
+                            const string& export_dir,
+                            const std::unordered_set<string>& tags,
+                            const SavedModelLoadOptions& load_options,
+                            SavedModelBundle* bundle);
 absl::Status LoadSavedModel(const SessionOptions& session_options,
                             const RunOptions& run_options,
                             const string& export_dir,
                             const std::unordered_set<string>& tags,
+                            const SavedModelLoadOptions& load_options,
                             SavedModelBundleLite* bundle);
 
 /// Checks whether the provided directory could contain a SavedModel. Note that
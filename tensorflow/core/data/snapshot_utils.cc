@@ -120,14 +120,23 @@ absl::Status Writer::Create(Env* env, const std::string& filename,
                             const std::string& compression_type, int version,
                             const DataTypeVector& dtypes,
                             std::unique_ptr<Writer>* out_writer) {
+  return Create(env, filename, compression_type, version, dtypes,
+                /*compression_pool=*/nullptr, out_writer);
+}
+
+absl::Status Writer::Create(Env* env, const std::string& filename,
+                            const std::string& compression_type, int version,
+                            const DataTypeVector& dtypes,
+                            thread::ThreadPool* compression_pool,
+                            std::unique_ptr<Writer>* out_writer) {
   switch (version) {
     case 1:
       *out_writer =
           std::make_unique<CustomWriter>(filename, compression_type, dtypes);
       break;
     case 2:
-      *out_writer =
-          std::make_unique<TFRecordWriter>(filename, compression_type);
+      *out_writer = std::make_unique<TFRecordWriter>(
+          filename, compression_type, compression_pool);
       break;
     default:
       return absl::InvalidArgumentError(absl::StrCat(
@@ -138,15 +147,23 @@ absl::Status Writer::Create(Env* env, const std::string& filename,
 }
 
 TFRecordWriter::TFRecordWriter(const std::string& filename,
-                               const std::string& compression_type)
-    : filename_(filename), compression_type_(compression_type) {}
+                               const std::string& compression_type,
+                               thread::ThreadPool* compression_pool)
+    : filename_(filename),
+      compression_type_(compression_type),
+      compression_pool_(compression_pool) {}
 
 absl::Status TFRecordWriter::Initialize(tensorflow::Env* env) {
   TF_RETURN_IF_ERROR(env->NewAppendableFile(filename_, &dest_));
 
-  record_writer_ = std::make_unique<io::RecordWriter>(
-      dest_.get(), io::RecordWriterOptions::CreateRecordWriterOptions(
-                       /*compression_type=*/compression_type_));
+  io::RecordWriterOptions options =
+      io::RecordWriterOptions::CreateRecordWriterOptions(
+          /*compression_type=*/compression_type_);
+  if (compression_pool_ != nullptr) {
+    options.compression_threads = compression_pool_->NumThreads();
+    options.compression_thread_pool = compression_pool_;
+  }
+  record_writer_ = std::make_unique<io::RecordWriter>(dest_.get(), options);
   return absl::OkStatus();
 }
 
@@ -1146,13 +1163,14 @@ AsyncWriter::AsyncWriter(Env* env, int64_t file_index,
                          const std::string& shard_directory,
                          uint64_t checkpoint_id, const std::string& compression,
                          int64_t version, const DataTypeVector& output_types,
-                         std::function<void(absl::Status)> done) {
+                         std::function<void(absl::Status)> done,
+                         thread::ThreadPool* compression_pool) {
   thread_ = absl::WrapUnique(env->StartThread(
       ThreadOptions(), absl::StrCat("writer_thread_", file_index),
       [this, env, shard_directory, checkpoint_id, compression, version,
-       &output_types, done = std::move(done)] {
+       &output_types, done = std::move(done), compression_pool] {
         done(WriterThread(env, shard_directory, checkpoint_id, compression,
-                          version, output_types));
+                          version, output_types, compression_pool));
       }));
 }
 
@@ -1184,13 +1202,14 @@ absl::Status AsyncWriter::WriterThread(Env* env,
                                        uint64_t checkpoint_id,
                                        const std::string& compression,
                                        int64_t version,
-                                       DataTypeVector output_types) {
+                                       DataTypeVector output_types,
+                                       thread::ThreadPool* compression_pool) {
   std::unique_ptr<snapshot_util::Writer> writer;
   TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(shard_directory));
 
   TF_RETURN_IF_ERROR(snapshot_util::Writer::Create(
       env, GetCheckpointFileName(shard_directory, checkpoint_id), compression,
-      version, std::move(output_types), &writer));
+      version, std::move(output_types), compression_pool, &writer));
 
   while (true) {
     ElementOrEOF be;
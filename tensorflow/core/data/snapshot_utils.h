@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/snapshot.pb.h"
 
 namespace tensorflow {
@@ -89,6 +90,14 @@ class Writer {
                              const DataTypeVector& dtypes,
                              std::unique_ptr<Writer>* out_writer);
 
+  // As above, but compresses version 2 snapshots on `compression_pool`, if
+  // set (see `io::RecordWriterOptions::compression_thread_pool`).
+  static absl::Status Create(Env* env, const std::string& filename,
+                             const std::string& compression_type, int version,
+                             const DataTypeVector& dtypes,
+                             thread::ThreadPool* compression_pool,
+                             std::unique_ptr<Writer>* out_writer);
+
   // Writes a vector of tensors to the snapshot writer file.
   virtual absl::Status WriteTensors(const std::vector<Tensor>& tensors) = 0;
 
@@ -109,7 +118,8 @@ class Writer {
 class TFRecordWriter : public Writer {
  public:
   TFRecordWriter(const std::string& filename,
-                 const std::string& compression_type);
+                 const std::string& compression_type,
+                 thread::ThreadPool* compression_pool = nullptr);
 
   absl::Status Initialize(tensorflow::Env* env) override;
 
@@ -124,6 +134,7 @@ class TFRecordWriter : public Writer {
  private:
   const std::string filename_;
   const std::string compression_type_;
+  thread::ThreadPool* const compression_pool_;  // Not owned.
 
   std::unique_ptr<WritableFile> dest_;
   std::unique_ptr<io::RecordWriter> record_writer_;
@@ -419,13 +430,17 @@ struct ElementOrEOF {
 // }
 // writer->SignalEOF();
 // writer = nullptr;  // This will block until writes are flushed.
+//
+// If `compression_pool` is set, compressed version 2 files are compressed on
+// its threads, which may be shared by several writers and must outlive them.
 class AsyncWriter {
  public:
   explicit AsyncWriter(Env* env, int64_t file_index,
                        const std::string& shard_directory,
                        uint64_t checkpoint_id, const std::string& compression,
                        int64_t version, const DataTypeVector& output_types,
-                       std::function<void(absl::Status)> done);
+                       std::function<void(absl::Status)> done,
+                       thread::ThreadPool* compression_pool = nullptr);
 
   // Writes the given tensors. The method is non-blocking and returns without
   // waiting for the element to be written.
@@ -441,7 +456,8 @@ class AsyncWriter {
   absl::Status WriterThread(Env* env, const std::string& shard_directory,
                             uint64_t checkpoint_id,
                             const std::string& compression, int64_t version,
-                            DataTypeVector output_types);
+                            DataTypeVector output_types,
+                            thread::ThreadPool* compression_pool);
 
   mutex mu_;
   std::deque<ElementOrEOF> deque_ TF_GUARDED_BY(mu_);
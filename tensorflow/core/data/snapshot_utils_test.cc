@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace data {
@@ -47,7 +48,8 @@ void GenerateTensorVector(tensorflow::DataTypeVector& dtypes,
   }
 }
 
-void SnapshotRoundTrip(std::string compression_type, int version) {
+void SnapshotRoundTrip(std::string compression_type, int version,
+                       thread::ThreadPool* compression_pool = nullptr) {
   // Generate ground-truth tensors for writing and reading.
   std::vector<Tensor> tensors;
   tensorflow::DataTypeVector dtypes;
@@ -58,7 +60,8 @@ void SnapshotRoundTrip(std::string compression_type, int version) {
 
   std::unique_ptr<Writer> writer;
   TF_ASSERT_OK(Writer::Create(tensorflow::Env::Default(), filename,
-                              compression_type, version, dtypes, &writer));
+                              compression_type, version, dtypes,
+                              compression_pool, &writer));
 
   for (int i = 0; i < 100; ++i) {
     TF_ASSERT_OK(writer->WriteTensors(tensors));
@@ -98,6 +101,13 @@ TEST(SnapshotUtilTest, CombinationRoundTripTest) {
   SnapshotRoundTrip(io::compression::kNone, 2);
   SnapshotRoundTrip(io::compression::kGzip, 2);
   SnapshotRoundTrip(io::compression::kSnappy, 2);
+  SnapshotRoundTrip(io::compression::kZstd, 2);
+
+  // Parallel compression only applies to version 2 snapshots.
+  thread::ThreadPool compression_pool(Env::Default(), "compression",
+                                      /*num_threads=*/4);
+  SnapshotRoundTrip(io::compression::kGzip, 2, &compression_pool);
+  SnapshotRoundTrip(io::compression::kZstd, 2, &compression_pool);
 }
 
 TEST(SnapshotUtilTest, MetadataFileRoundTrip) {
@@ -200,11 +210,21 @@ void SnapshotTFRecordReaderGzipBenchmark(::testing::benchmark::State& state) {
   SnapshotReaderBenchmarkLoop(state, io::compression::kGzip, 2);
 }
 
+void SnapshotTFRecordReaderSnappyBenchmark(::testing::benchmark::State& state) {
+  SnapshotReaderBenchmarkLoop(state, io::compression::kSnappy, 2);
+}
+
+void SnapshotTFRecordReaderZstdBenchmark(::testing::benchmark::State& state) {
+  SnapshotReaderBenchmarkLoop(state, io::compression::kZstd, 2);
+}
+
 BENCHMARK(SnapshotCustomReaderNoneBenchmark);
 BENCHMARK(SnapshotCustomReaderGzipBenchmark);
 BENCHMARK(SnapshotCustomReaderSnappyBenchmark);
 BENCHMARK(SnapshotTFRecordReaderNoneBenchmark);
 BENCHMARK(SnapshotTFRecordReaderGzipBenchmark);
+BENCHMARK(SnapshotTFRecordReaderSnappyBenchmark);
+BENCHMARK(SnapshotTFRecordReaderZstdBenchmark);
 
 void SnapshotWriterBenchmarkLoop(::testing::benchmark::State& state,
                                  std::string compression_type, int version) {
@@ -251,12 +271,17 @@ void SnapshotTFRecordWriterSnappyBenchmark(::testing::benchmark::State& state) {
   SnapshotWriterBenchmarkLoop(state, io::compression::kSnappy, 2);
 }
 
+void SnapshotTFRecordWriterZstdBenchmark(::testing::benchmark::State& state) {
+  SnapshotWriterBenchmarkLoop(state, io::compression::kZstd, 2);
+}
+
 BENCHMARK(SnapshotCustomWriterNoneBenchmark);
 BENCHMARK(SnapshotCustomWriterGzipBenchmark);
 BENCHMARK(SnapshotCustomWriterSnappyBenchmark);
 BENCHMARK(SnapshotTFRecordWriterNoneBenchmark);
 BENCHMARK(SnapshotTFRecordWriterGzipBenchmark);
 BENCHMARK(SnapshotTFRecordWriterSnappyBenchmark);
+BENCHMARK(SnapshotTFRecordWriterZstdBenchmark);
 
 }  // namespace
 }  // namespace snapshot_util
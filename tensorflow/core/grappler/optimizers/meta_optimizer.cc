@@ -247,7 +247,10 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
   MK_OPT("shape", "shape_optimization", new ShapeOptimizer());
   MK_OPT("remap", "remapping",
          new Remapper(cfg_.remapping(), cfg_.cpu_layout_conversion(),
-                      xla_auto_clustering_on_));
+                      xla_auto_clustering_on_,
+                      /*quantize_matmul_weights=*/
+                      cfg_.experimental_quantize_matmul_weights() ==
+                          RewriterConfig::ON));
   MK_OPT("layout", "layout_optimizer",
          new GenericLayoutOptimizer(
              /*optimization level*/ cfg_.layout_optimizer(),
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <map>
 #include <set>
@@ -25,6 +26,9 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
@@ -83,6 +87,15 @@ namespace grappler {
 //
 // _FusedConv2D/_FusedConv3D + <Activation> -> _FusedConv2D/_FusedConv3D
 // Supported Activations: LeakyRelu, Mish
+//
+// CPU MatMul with a constant right-hand side -> UniformQuantizedDotHybrid, with
+// the constant quantized to int8, if experimental_quantize_matmul_weights is
+// on.
+//
+// In inference graphs, float CPU {MatMul,BatchMatMul,BatchMatMulV2,
+// _FusedMatMul} whose right-hand side does not change between runs are marked
+// with `_cache_packed_weights`, so that their kernels pack it for Eigen's GEMM
+// kernel only once.
 
 namespace {
 
@@ -92,7 +105,11 @@ constexpr char kFusedMatMul[] = "_FusedMatMul";
 constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
+constexpr char kFusedScaledDotProductAttention[] =
+    "_FusedScaledDotProductAttention";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+// Must match kCachePackedWeightsAttr in kernels/matmul_op_packed_weights.h.
+constexpr char kCachePackedWeights[] = "_cache_packed_weights";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMklFusedMish[] = "_MklFusedMish";
 constexpr char kRelu[] = "Relu";
@@ -3054,6 +3071,244 @@ bool FindFusedBatchMatMul(RemapperContext* ctx, int node_index,
   return found_op_type_match;
 }
 
+// Returns true if the dimensions of `lhs` and `rhs` before the last
+// `num_inner_dims` are known to be equal, if only symbolically.
+bool HaveSameOuterDims(const TensorShapeProto& lhs, const TensorShapeProto& rhs,
+                       int num_inner_dims) {
+  if (lhs.unknown_rank() || rhs.unknown_rank() ||
+      lhs.dim_size() != rhs.dim_size() || lhs.dim_size() < num_inner_dims) {
+    return false;
+  }
+  for (int i = 0; i < lhs.dim_size() - num_inner_dims; ++i) {
+    const auto& dim = lhs.dim(i);
+    if (IsUnknown(dim) || dim.size() != rhs.dim(i).size()) return false;
+  }
+  return true;
+}
+
+// Returns true if `mask` broadcasts to `scores` without changing its shape.
+bool IsBroadcastableMask(const TensorShapeProto& mask,
+                         const TensorShapeProto& scores) {
+  if (mask.unknown_rank() || scores.unknown_rank() ||
+      mask.dim_size() > scores.dim_size()) {
+    return false;
+  }
+  const int offset = scores.dim_size() - mask.dim_size();
+  for (int i = 0; i < mask.dim_size(); ++i) {
+    const auto& dim = mask.dim(i);
+    if (dim.size() == 1) continue;
+    if (IsUnknown(dim) || dim.size() != scores.dim(offset + i).size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if `mask` is a constant that masks out the keys after each
+// query, so that it can be replaced by the causal mode of the fused
+// attention. The masked out values must be at most kCausalMaskMaxValue, the
+// others zero. Their exponentials underflow to zero in float, unless the
+// unmasked scores of the row are about as much smaller than the masked ones.
+bool IsCausalMask(const NodeDef& mask, const TensorShapeProto& scores) {
+  constexpr float kCausalMaskMaxValue = -1e4f;
+  Tensor tensor;
+  if (!IsConstant(mask) ||
+      !tensor.FromProto(mask.attr().at("value").tensor()) ||
+      tensor.dims() < 2) {
+    return false;
+  }
+  for (int i = 0; i < tensor.dims() - 2; ++i) {
+    if (tensor.dim_size(i) != 1) return false;
+  }
+  const int64_t query_length = tensor.dim_size(tensor.dims() - 2);
+  const int64_t key_length = tensor.dim_size(tensor.dims() - 1);
+  const int scores_rank = scores.dim_size();
+  if (scores.dim(scores_rank - 2).size() != query_length ||
+      scores.dim(scores_rank - 1).size() != key_length) {
+    return false;
+  }
+
+  if (tensor.dtype() != DT_FLOAT && tensor.dtype() != DT_BFLOAT16) {
+    return false;
+  }
+  const auto value_at = [&tensor](int64_t index) {
+    return tensor.dtype() == DT_FLOAT
+               ? tensor.flat<float>()(index)
+               : static_cast<float>(tensor.flat<bfloat16>()(index));
+  };
+  for (int64_t i = 0; i < query_length; ++i) {
+    for (int64_t j = 0; j < key_length; ++j) {
+      const float value = value_at(i * key_length + j);
+      if (j <= i ? value != 0.0f : !(value <= kCausalMaskMaxValue)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Finds the attention softmax(scale * query * key^T + mask) * value, as it is
+// written with BatchMatMulV2, Mul or RealDiv by a constant, Add and Softmax.
+// The scale and the mask are optional.
+bool FindScaledDotProductAttention(
+    RemapperContext* ctx, int node_index,
+    std::map<std::string, int>* matched_nodes_map,
+    std::set<int>* remove_node_indices, float* scale, bool* is_causal) {
+  if (ctx->xla_cpu_jit_disable_fusion) return false;
+  const auto* node_view = ctx->graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  if (node_def->op() != "BatchMatMulV2" || !NodeIsOnCpu(node_def) ||
+      (!HasDataType(node_def, DT_FLOAT) &&
+       !HasDataType(node_def, DT_BFLOAT16))) {
+    return false;
+  }
+  if (node_view->NumRegularFanins() != 2 ||
+      !IsSoftmax(*node_view->GetRegularFanin(0).node_view()->node())) {
+    return false;
+  }
+  if (!ctx->inferred_graph_properties) return false;
+
+  using utils::MatchingDirection;
+  using utils::NodeStatus;
+  // clang-format off
+  const utils::OpTypePattern scores =
+    {"BatchMatMulV2", "scores", NodeStatus::kRemove,
+      {
+        {"*", "query", NodeStatus::kRemain},
+        {"*", "key", NodeStatus::kRemain}
+      }
+    };
+  const utils::OpTypePattern mask = {"*", "mask", NodeStatus::kRemain};
+  // clang-format on
+  // The operands of Add are tried in both orders, since the matcher does not
+  // swap them when the mask is computed by the same op as the scaled scores.
+  std::vector<utils::OpTypePattern> logits_patterns;
+  for (const char* scale_op : {"Mul", "RealDiv"}) {
+    const utils::OpTypePattern scaled_scores = {
+        scale_op,
+        "scale_op",
+        NodeStatus::kRemove,
+        {scores, {"Const", "scale", NodeStatus::kRemain}}};
+    logits_patterns.push_back(
+        {"Add|AddV2", "mask_add", NodeStatus::kRemove, {scaled_scores, mask}});
+    logits_patterns.push_back(
+        {"Add|AddV2", "mask_add", NodeStatus::kRemove, {mask, scaled_scores}});
+    logits_patterns.push_back(scaled_scores);
+  }
+  logits_patterns.push_back(
+      {"Add|AddV2", "mask_add", NodeStatus::kRemove, {scores, mask}});
+  logits_patterns.push_back(
+      {"Add|AddV2", "mask_add", NodeStatus::kRemove, {mask, scores}});
+  logits_patterns.push_back(scores);
+
+  utils::SubGraphMatcher<MatchingDirection::kFollowInputs> graph_matcher(
+      &(ctx->graph_view));
+  bool found_op_type_match = false;
+  for (const auto& logits : logits_patterns) {
+    // clang-format off
+    const utils::OpTypePattern attention_pattern =
+      {"BatchMatMulV2", "output", NodeStatus::kReplace,
+        {
+          {"Softmax", "softmax", NodeStatus::kRemove, {logits}},
+          {"*", "value", NodeStatus::kRemain}
+        }
+      };
+    // clang-format on
+    matched_nodes_map->clear();
+    remove_node_indices->clear();
+    found_op_type_match = graph_matcher.GetMatchedNodes(
+        attention_pattern, ctx->nodes_to_preserve, node_view,
+        matched_nodes_map, remove_node_indices);
+    if (found_op_type_match) break;
+  }
+  if (!found_op_type_match) return false;
+
+  const auto get_node = [&](const std::string& label) {
+    return ctx->graph_view.GetNode(matched_nodes_map->at(label))->node();
+  };
+  for (const char* label : {"scores", "softmax", "scale_op", "mask_add"}) {
+    if (matched_nodes_map->count(label) > 0 &&
+        !HaveSameDataType(node_def, get_node(label))) {
+      return false;
+    }
+  }
+
+  // The scores are query * key^T, and the output is softmax * value.
+  const NodeDef* scores_node = get_node("scores");
+  bool adj_x = false;
+  bool adj_y = false;
+  if (!TryGetNodeAttr(*scores_node, "adj_x", &adj_x) || adj_x ||
+      !TryGetNodeAttr(*scores_node, "adj_y", &adj_y) || !adj_y) {
+    return false;
+  }
+  if (!TryGetNodeAttr(*node_def, "adj_x", &adj_x) || adj_x ||
+      !TryGetNodeAttr(*node_def, "adj_y", &adj_y) || adj_y) {
+    return false;
+  }
+
+  // The fused kernel does not broadcast the batch dimensions of query, key
+  // and value.
+  const auto& scores_inputs =
+      ctx->graph_properties.GetInputProperties(scores_node->name());
+  const auto& output_inputs =
+      ctx->graph_properties.GetInputProperties(node_def->name());
+  const auto& scores_outputs =
+      ctx->graph_properties.GetOutputProperties(scores_node->name());
+  if (scores_inputs.size() != 2 || output_inputs.size() != 2 ||
+      scores_outputs.empty()) {
+    return false;
+  }
+  const TensorShapeProto& query_shape = scores_inputs[0].shape();
+  if (!HaveSameOuterDims(query_shape, scores_inputs[1].shape(), 2) ||
+      !HaveSameOuterDims(query_shape, output_inputs[1].shape(), 2)) {
+    return false;
+  }
+  const TensorShapeProto& scores_shape = scores_outputs[0].shape();
+
+  *scale = 1.0f;
+  if (matched_nodes_map->count("scale") > 0) {
+    Tensor scale_tensor;
+    const NodeDef* scale_node = get_node("scale");
+    if (!scale_tensor.FromProto(scale_node->attr().at("value").tensor()) ||
+        scale_tensor.NumElements() != 1) {
+      return false;
+    }
+    if (scale_tensor.dtype() == DT_FLOAT) {
+      *scale = scale_tensor.flat<float>()(0);
+    } else if (scale_tensor.dtype() == DT_BFLOAT16) {
+      *scale = static_cast<float>(scale_tensor.flat<bfloat16>()(0));
+    } else {
+      return false;
+    }
+    if (IsRealDiv(*get_node("scale_op"))) *scale = 1.0f / *scale;
+  }
+
+  *is_causal = false;
+  if (matched_nodes_map->count("mask") > 0) {
+    const int mask_index = matched_nodes_map->at("mask");
+    const auto* mask_view = ctx->graph_view.GetNode(mask_index);
+    const auto* mask_add_view =
+        ctx->graph_view.GetNode(matched_nodes_map->at("mask_add"));
+    const int mask_port =
+        mask_add_view->GetRegularFanin(0).node_index() == mask_index ? 0 : 1;
+    const auto& mask_add_inputs =
+        ctx->graph_properties.GetInputProperties(mask_add_view->GetName());
+    if (mask_add_inputs.size() != 2 ||
+        !IsBroadcastableMask(mask_add_inputs[mask_port].shape(),
+                             scores_shape)) {
+      return false;
+    }
+    // A causal mask that is used only here is removed.
+    *is_causal = IsCausalMask(*mask_view->node(), scores_shape);
+    if (*is_causal && mask_view->NumRegularFanouts() == 1 &&
+        !HasControlFaninOrFanout(*mask_view) &&
+        !IsInPreserveSet(*ctx, mask_view->node())) {
+      remove_node_indices->insert(mask_index);
+    }
+  }
+  return true;
+}
+
 // Helper function to check if the reduction axes for a given input
 // shape align with instance normalization's mean computation.
 // Mean reduction axes for instance norm are expected to be:
@@ -4558,6 +4813,53 @@ absl::Status AddFusedBatchMatMul(
   return absl::OkStatus();
 }
 
+absl::Status AddFusedScaledDotProductAttention(
+    RemapperContext* ctx, const std::map<std::string, int>& matched_nodes_map,
+    const std::set<int>& remove_node_indices, float scale, bool is_causal,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const NodeDef* output_node =
+      ctx->graph_view.GetNode(matched_nodes_map.at("output"))->node();
+  const NodeDef* scores_node =
+      ctx->graph_view.GetNode(matched_nodes_map.at("scores"))->node();
+
+  NodeDef fused_node;
+  fused_node.set_name(output_node->name());
+  fused_node.set_op(kFusedScaledDotProductAttention);
+  fused_node.set_device(output_node->device());
+  fused_node.add_input(scores_node->input(0));
+  fused_node.add_input(scores_node->input(1));
+  fused_node.add_input(output_node->input(1));
+  int num_args = 0;
+  if (!is_causal && matched_nodes_map.count("mask") > 0) {
+    const auto* mask_add_view =
+        ctx->graph_view.GetNode(matched_nodes_map.at("mask_add"));
+    const int mask_port = mask_add_view->GetRegularFanin(0).node_index() ==
+                                  matched_nodes_map.at("mask")
+                              ? 0
+                              : 1;
+    fused_node.add_input(mask_add_view->node()->input(mask_port));
+    num_args = 1;
+  }
+
+  auto* attr = fused_node.mutable_attr();
+  (*attr)["T"] = output_node->attr().at("T");
+  SetAttrValue(num_args, &(*attr)["num_args"]);
+  SetAttrValue(scale, &(*attr)["scale"]);
+  SetAttrValue(is_causal, &(*attr)["is_causal"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  absl::Status status;
+  mutation->AddNode(std::move(fused_node), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+  (*invalidated_nodes)[matched_nodes_map.at("output")] = true;
+
+  for (const auto& node_idx : remove_node_indices) {
+    (*nodes_to_delete)[node_idx] = true;
+  }
+  return absl::OkStatus();
+}
+
 // Helper function to get data of type T from a given tensor and
 // return them in a vector and casted to type U.
 // Note - use this function only when type cast is safe from T to U.
@@ -4859,6 +5161,7 @@ absl::Status ReplaceSoftplusTanhAndMulWithMish(
 //   (3) Fusing Conv2D biasadd and relu on GPU
 //   (4) INTEL_MKL specific: Conv2D -> Add or Conv2D -> BiasAdd -> Add.
 //   (5) Fusing side output and/or activation into FusedBatchNormGrad.
+//   (6) Fusing BatchMatMulV2 + Softmax + BatchMatMulV2 attention.
 bool RequiresInferredShapes(const RemapperContext& ctx, int node_index,
                             const Cluster* cluster) {
   // Candidate for a FusedBatchNorm splitting.
@@ -4996,17 +5299,25 @@ bool RequiresInferredShapes(const RemapperContext& ctx, int node_index,
     return true;
   };
 
+  // Candidate for a _FusedScaledDotProductAttention, which needs the shapes
+  // of the query, key, value and mask.
+  const auto is_attention_candidate = [&]() -> bool {
+    if (node_def->op() != "BatchMatMulV2") return false;
+    if (node_view->NumRegularFanins() < 1) return false;
+    return IsSoftmax(*node_view->GetRegularFanin(0).node_view()->node());
+  };
+
   if (IsMKLEnabled())
     return is_batch_norm_candidate() || is_batch_norm_fusion_candidate() ||
            IsContractionWithAdd(ctx, node_index) ||
            is_act_biasadd_conv_candidate() || IsBiasAdd(*node_def) ||
-           IsTranspose(*node_def);
+           IsTranspose(*node_def) || is_attention_candidate();
 
   return is_act_biasadd_conv_candidate() || is_batch_norm_candidate() ||
          is_batch_norm_fusion_candidate() ||
          is_batch_norm_grad_fusion_candidate() ||
          is_matmul_gelu_exact_fusion_candidate() ||
-         is_act_biasadd_matmul_candidate();
+         is_act_biasadd_matmul_candidate() || is_attention_candidate();
 }
 
 inline bool IsXlaCpuGlobalJitOn() {
@@ -5016,6 +5327,188 @@ inline bool IsXlaCpuGlobalJitOn() {
   return std::find(tf_xla_flags.begin(), tf_xla_flags.end(),
                    tf_xla_cpu_global_jit) != tf_xla_flags.end();
 }
+
+// Replaces the CPU float MatMuls whose right-hand side is a constant by
+// UniformQuantizedDotHybrid, with the constant quantized symmetrically to int8
+// per output channel. The kernel quantizes the left-hand side per row when it
+// runs, so the graph keeps float inputs and outputs.
+absl::Status QuantizeMatMulWeights(RemapperContext* ctx) {
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  absl::Status status;
+  for (int i = 0; i < ctx->graph_view.NumNodes(); ++i) {
+    utils::MutableNodeView* node_view = ctx->graph_view.GetNode(i);
+    const NodeDef* matmul = node_view->node();
+    bool transpose_a = false;
+    bool transpose_b = false;
+    if (!IsMatMul(*matmul) || !NodeIsOnCpu(matmul) ||
+        !HasDataType(matmul, DT_FLOAT) ||
+        node_view->NumRegularFanins() != 2 ||
+        (TryGetNodeAttr(*matmul, "transpose_a", &transpose_a) &&
+         transpose_a)) {
+      continue;
+    }
+    TryGetNodeAttr(*matmul, "transpose_b", &transpose_b);
+
+    // Fed constants may take other values.
+    utils::MutableNodeView* weights_view =
+        node_view->GetRegularFanin(1).node_view();
+    const NodeDef* weights = weights_view->node();
+    Tensor value;
+    if (!IsConstant(*weights) || IsInPreserveSet(*ctx, weights) ||
+        !weights->attr().contains("value") ||
+        !value.FromProto(weights->attr().at("value").tensor()) ||
+        value.dtype() != DT_FLOAT || value.dims() != 2) {
+      continue;
+    }
+    const auto w = value.matrix<float>();
+    const int64_t depth = value.dim_size(transpose_b ? 1 : 0);
+    const int64_t channels = value.dim_size(transpose_b ? 0 : 1);
+    auto weight = [&](int64_t d, int64_t c) {
+      return transpose_b ? w(c, d) : w(d, c);
+    };
+
+    Tensor quantized(DT_QINT8, TensorShape({depth, channels}));
+    Tensor scales(DT_FLOAT, TensorShape({channels}));
+    Tensor zero_points(DT_INT32, TensorShape({channels}));
+    bool finite = true;
+    for (int64_t c = 0; c < channels && finite; ++c) {
+      float max_abs = 0.0f;
+      for (int64_t d = 0; d < depth; ++d) {
+        max_abs = std::max(max_abs, std::abs(weight(d, c)));
+      }
+      finite = std::isfinite(max_abs);
+      // Scales must be positive, even for channels that are all zeros.
+      const float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+      for (int64_t d = 0; d < depth; ++d) {
+        quantized.matrix<qint8>()(d, c) = static_cast<int8_t>(
+            std::clamp(std::round(weight(d, c) / scale), -127.0f, 127.0f));
+      }
+      scales.vec<float>()(c) = scale;
+      zero_points.vec<int32_t>()(c) = 0;
+    }
+    const std::string quantized_name = absl::StrCat(matmul->name(), "/int8");
+    const std::string scales_name = absl::StrCat(matmul->name(), "/scales");
+    const std::string zero_points_name =
+        absl::StrCat(matmul->name(), "/zero_points");
+    if (!finite || ctx->graph_view.HasNode(quantized_name) ||
+        ctx->graph_view.HasNode(scales_name) ||
+        ctx->graph_view.HasNode(zero_points_name)) {
+      continue;
+    }
+    VLOG(2) << "Quantize the weights of " << matmul->name() << " to int8";
+
+    // The constants keep the control inputs of the weights, which put them
+    // in the same frame.
+    auto add_constant = [&](const std::string& name, const Tensor& tensor) {
+      NodeDef constant;
+      constant.set_name(name);
+      constant.set_op("Const");
+      constant.set_device(matmul->device());
+      for (const std::string& input : weights->input()) {
+        if (IsControlInput(input)) constant.add_input(input);
+      }
+      (*constant.mutable_attr())["dtype"].set_type(tensor.dtype());
+      tensor.AsProtoTensorContent(
+          (*constant.mutable_attr())["value"].mutable_tensor());
+      mutation->AddNode(std::move(constant), &status);
+    };
+    add_constant(quantized_name, quantized);
+    TF_RETURN_IF_ERROR(status);
+    add_constant(scales_name, scales);
+    TF_RETURN_IF_ERROR(status);
+    add_constant(zero_points_name, zero_points);
+    TF_RETURN_IF_ERROR(status);
+
+    NodeDef dot;
+    dot.set_name(matmul->name());
+    dot.set_op("UniformQuantizedDotHybrid");
+    dot.set_device(matmul->device());
+    dot.add_input(matmul->input(0));
+    dot.add_input(quantized_name);
+    dot.add_input(scales_name);
+    dot.add_input(zero_points_name);
+    for (const std::string& input : matmul->input()) {
+      if (IsControlInput(input)) dot.add_input(input);
+    }
+    auto* attr = dot.mutable_attr();
+    (*attr)["Tlhs"].set_type(DT_FLOAT);
+    (*attr)["Trhs"].set_type(DT_QINT8);
+    (*attr)["Tout"].set_type(DT_FLOAT);
+    (*attr)["rhs_quantization_axis"].set_i(1);
+    (*attr)["rhs_quantization_min_val"].set_i(-127);
+    (*attr)["rhs_quantization_max_val"].set_i(127);
+    mutation->AddNode(std::move(dot), &status);
+    TF_RETURN_IF_ERROR(status);
+
+    if (weights_view->NumRegularFanouts() == 1 &&
+        weights_view->NumControlledFanouts() == 0) {
+      mutation->RemoveNode(weights_view);
+    }
+  }
+  return mutation->Apply();
+}
+
+// Returns true if `node` updates a variable the way training steps do.
+// Assignments are not counted, since inference graphs also contain them to
+// restore variables.
+bool IsVariableUpdate(const NodeDef& node) {
+  return absl::StartsWith(node.op(), "Apply") ||
+         absl::StartsWith(node.op(), "SparseApply") ||
+         absl::StartsWith(node.op(), "ResourceApply") ||
+         absl::StartsWith(node.op(), "ResourceSparseApply") ||
+         absl::StartsWith(node.op(), "ResourceScatter") ||
+         absl::StartsWith(node.op(), "Scatter") ||
+         node.op() == "AssignAdd" || node.op() == "AssignSub" ||
+         node.op() == "AssignAddVariableOp" ||
+         node.op() == "AssignSubVariableOp";
+}
+
+bool UpdatesVariables(const GraphDef& graph) {
+  for (const NodeDef& node : graph.node()) {
+    if (IsVariableUpdate(node)) return true;
+  }
+  for (const FunctionDef& function : graph.library().function()) {
+    for (const NodeDef& node : function.node_def()) {
+      if (IsVariableUpdate(node)) return true;
+    }
+  }
+  return false;
+}
+
+// Marks the float CPU matrix products whose right-hand side is the same
+// tensor on every run with kCachePackedWeights.
+//
+// Packing keeps a second copy of the weights, which only pays off when the
+// same weights are multiplied by many small batches, as in serving. Training
+// graphs, which are recognized by their variable updates, are left alone.
+// Constants never change, and values read from resource variables only change
+// when the variable is updated. Reference variables are updated in place,
+// which the kernels cannot detect, so their values are never marked.
+void MarkCachedPackedWeights(RemapperContext* ctx) {
+  if (UpdatesVariables(*ctx->graph_view.graph())) return;
+  for (int i = 0; i < ctx->graph_view.NumNodes(); ++i) {
+    utils::MutableNodeView* node_view = ctx->graph_view.GetNode(i);
+    NodeDef* node = node_view->node();
+    if (!IsMatMul(*node) && !IsAnyBatchMatMul(*node) &&
+        node->op() != kFusedMatMul) {
+      continue;
+    }
+    if (!NodeIsOnCpu(node) || !HasDataType(node, DT_FLOAT) ||
+        node_view->NumRegularFanins() < 2) {
+      continue;
+    }
+
+    const utils::MutableNodeView* weights =
+        node_view->GetRegularFanin(1).node_view();
+    while (IsIdentity(*weights->node()) && weights->NumRegularFanins() > 0) {
+      weights = weights->GetRegularFanin(0).node_view();
+    }
+    if (IsConstant(*weights->node()) || IsReadVariableOp(*weights->node())) {
+      (*node->mutable_attr())[kCachePackedWeights].set_b(true);
+    }
+  }
+}
+
 }  // namespace
 
 absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
@@ -5031,12 +5524,21 @@ absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
                       xla_auto_clustering_on_, xla_cpu_jit_disable_fusion);
   TF_RETURN_IF_ERROR(status);
 
+  // The quantized MatMuls are not fused with the ops that follow them, so
+  // they are rewritten before the fusions. UniformQuantizedDotHybrid has no
+  // gradient. The rewrite changes the results of the graph, so it must be
+  // enabled explicitly.
+  if (item.optimization_options().allow_non_differentiable_rewrites &&
+      quantize_matmul_weights_) {
+    TF_RETURN_IF_ERROR(QuantizeMatMulWeights(&ctx));
+  }
+
   // Processing graph in reverse-topological sorted order allows to remap
   // longer chains of dependent ops in one pass.
   TF_RETURN_IF_ERROR(
       ctx.graph_view.SortTopologically(/*ignore_cycles=*/false, {}));
 
-  const int num_nodes = item.graph.node_size();
+  const int num_nodes = ctx.graph_view.NumNodes();
   // Skip nodes that were invalidated by a remapper, e.g. do not process BiasAdd
   // and Activation nodes that were fused into a Conv2D node.
   std::vector<bool> invalidated_nodes(num_nodes);
@@ -5288,6 +5790,22 @@ absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap BatchMatMulV2+{Mul,RealDiv}+{Add,AddV2}+Softmax+BatchMatMulV2
+    // into the _FusedScaledDotProductAttention.
+    matched_nodes_map.clear();
+    remove_node_indices.clear();
+    float attention_scale = 1.0f;
+    bool attention_is_causal = false;
+    if (allow_non_differentiable_rewrites &&
+        FindScaledDotProductAttention(&ctx, i, &matched_nodes_map,
+                                      &remove_node_indices, &attention_scale,
+                                      &attention_is_causal)) {
+      TF_RETURN_IF_ERROR(AddFusedScaledDotProductAttention(
+          &ctx, matched_nodes_map, remove_node_indices, attention_scale,
+          attention_is_causal, &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
     // Fusions are disabled on XLA CPU in IsCpuCompatible(...) invoked by the
     // following fusions.
     //
@@ -5397,6 +5915,8 @@ absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
   }
   TF_RETURN_IF_ERROR(mutation->Apply());
 
+  MarkCachedPackedWeights(&ctx);
+
   *optimized_graph = std::move(mutable_item.graph);
 
   return absl::OkStatus();
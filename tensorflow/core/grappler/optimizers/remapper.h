@@ -29,10 +29,12 @@ class Remapper : public GraphOptimizer {
   explicit Remapper(RewriterConfig::Toggle opt_level,
                     RewriterConfig::CpuLayout cpu_layout_conversion =
                         RewriterConfig::NO_CONVERSION_ON_CPU,
-                    bool xla_auto_clustering_on = false)
+                    bool xla_auto_clustering_on = false,
+                    bool quantize_matmul_weights = false)
       : opt_level_(opt_level),
         cpu_layout_conversion_(cpu_layout_conversion),
-        xla_auto_clustering_on_(xla_auto_clustering_on) {}
+        xla_auto_clustering_on_(xla_auto_clustering_on),
+        quantize_matmul_weights_(quantize_matmul_weights) {}
 
   ~Remapper() override {}
 
@@ -47,6 +49,9 @@ class Remapper : public GraphOptimizer {
   RewriterConfig::Toggle opt_level_;
   RewriterConfig::CpuLayout cpu_layout_conversion_;
   bool xla_auto_clustering_on_;
+  // Whether float MatMuls with constant weights are replaced by
+  // UniformQuantizedDotHybrid with int8 weights.
+  bool quantize_matmul_weights_;
 };
 
 }  // end namespace grappler
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/cc/ops/nn_ops_internal.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
@@ -1568,6 +1571,106 @@ TEST_F(RemapperFuseSoftplusTanhMul, BF16) {
 }
 #endif
 
+TEST_F(RemapperTest, MarksCachedPackedWeights) {
+  for (bool updates_variables : {false, true}) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    auto lhs = ops::Placeholder(s.WithOpName("lhs"), DT_FLOAT,
+                                ops::Placeholder::Shape({8, 32}));
+    auto rhs = ops::Placeholder(s.WithOpName("rhs"), DT_FLOAT,
+                                ops::Placeholder::Shape({32, 16}));
+    auto weights = ops::Const(s.WithOpName("weights"), 1.0f, {32, 16});
+    auto weights_identity =
+        ops::Identity(s.WithOpName("weights_identity"), weights);
+    auto variable =
+        ops::VarHandleOp(s.WithOpName("variable"), DT_FLOAT, {32, 16});
+    auto read = ops::ReadVariableOp(s.WithOpName("read"), variable, DT_FLOAT);
+    auto double_lhs = ops::Placeholder(s.WithOpName("double_lhs"), DT_DOUBLE,
+                                       ops::Placeholder::Shape({8, 32}));
+    auto double_weights =
+        ops::Const(s.WithOpName("double_weights"), 1.0, {32, 16});
+    ops::MatMul(s.WithOpName("const_matmul"), lhs, weights_identity);
+    ops::MatMul(s.WithOpName("variable_matmul"), lhs, read);
+    ops::MatMul(s.WithOpName("placeholder_matmul"), lhs, rhs);
+    ops::MatMul(s.WithOpName("double_matmul"), double_lhs, double_weights);
+    if (updates_variables) {
+      ops::ResourceApplyGradientDescent(s.WithOpName("update"), variable,
+                                        0.1f, rhs);
+    }
+
+    GrapplerItem item;
+    item.fetch = {"const_matmul", "variable_matmul", "placeholder_matmul",
+                  "double_matmul"};
+    TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+    for (int i = 0; i < item.graph.node_size(); ++i) {
+      item.graph.mutable_node(i)->set_device("/device:CPU:0");
+    }
+
+    Remapper optimizer(RewriterConfig::ON);
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+    absl::flat_hash_set<std::string> marked;
+    for (const NodeDef& node : output.node()) {
+      auto it = node.attr().find("_cache_packed_weights");
+      if (it != node.attr().end() && it->second.b()) marked.insert(node.name());
+    }
+    // Training graphs are not marked, and only float products are.
+    if (updates_variables) {
+      EXPECT_THAT(marked, ::testing::IsEmpty());
+    } else {
+      EXPECT_THAT(marked, ::testing::UnorderedElementsAre("const_matmul",
+                                                          "variable_matmul"));
+    }
+  }
+}
+
+TEST_F(RemapperTest, QuantizesMatMulWeights) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto lhs = ops::Placeholder(s.WithOpName("lhs"), DT_FLOAT,
+                              ops::Placeholder::Shape({4, 32}));
+  Tensor weights_t = GenerateRandomTensor<DT_FLOAT>({16, 32});
+  auto weights = ops::Const(s.WithOpName("weights"), weights_t);
+  ops::MatMul(s.WithOpName("matmul"), lhs, weights,
+              ops::MatMul::TransposeB(true));
+
+  GrapplerItem item;
+  item.fetch = {"matmul"};
+  Tensor lhs_t = GenerateRandomTensor<DT_FLOAT>({4, 32});
+  item.feed = {{"lhs", lhs_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON, RewriterConfig::NO_CONVERSION_ON_CPU,
+                     /*xla_auto_clustering_on=*/false,
+                     /*quantize_matmul_weights=*/true);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  bool found = false;
+  for (const NodeDef& node : output.node()) {
+    // The float weights are no longer needed.
+    EXPECT_NE(node.name(), "weights");
+    if (node.name() == "matmul") {
+      EXPECT_EQ(node.op(), "UniformQuantizedDotHybrid");
+      ASSERT_EQ(node.input_size(), 4);
+      EXPECT_EQ(node.input(0), "lhs");
+      EXPECT_EQ(node.attr().at("Trhs").type(), DT_QINT8);
+      EXPECT_EQ(node.attr().at("rhs_quantization_axis").i(), 1);
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectClose(tensors[0], tensors_expected[0], /*atol=*/0.05,
+                    /*rtol=*/0.02);
+}
+
 TEST_F(RemapperTest, FuseMklLayerNorm) {
   if (!IsMKLEnabled()) GTEST_SKIP() << "Test only applicable to MKL.";
   using ::tensorflow::ops::Placeholder;
@@ -1873,6 +1976,155 @@ TEST_F(RemapperFuseMatMulWithBiasTest, Bf16) {
   RunTest<DT_BFLOAT16>();  // NOLINT
 }
 
+class RemapperFuseScaledDotProductAttentionTest : public RemapperTest {
+ public:
+  enum class Mask { kNone, kPlaceholder, kCausal };
+
+  template <DataType DTYPE>
+  void RunTest(Mask mask_kind) {
+    using T = typename EnumToDataType<DTYPE>::Type;
+    constexpr int kQueryLength = 40;
+    constexpr int kKeyLength = 70;
+
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    auto query = ops::Placeholder(
+        s.WithOpName("query"), DTYPE,
+        ops::Placeholder::Shape({2, 3, kQueryLength, 16}));
+    auto key =
+        ops::Placeholder(s.WithOpName("key"), DTYPE,
+                         ops::Placeholder::Shape({2, 3, kKeyLength, 16}));
+    auto value = ops::Placeholder(
+        s.WithOpName("value"), DTYPE,
+        ops::Placeholder::Shape({2, 3, kKeyLength, 8}));
+
+    // The causal graph divides the scores by 4, the others multiply them by
+    // 0.25.
+    auto scores = ops::BatchMatMulV2(s.WithOpName("scores"), query, key,
+                                     ops::BatchMatMulV2::AdjY(true));
+    Output logits;
+    if (mask_kind == Mask::kCausal) {
+      auto scale = ops::Const(s.WithOpName("scale"),
+                              test::AsScalar<T>(static_cast<T>(4.0f)));
+      logits = ops::RealDiv(s.WithOpName("scaled"), scores, scale);
+    } else {
+      auto scale = ops::Const(s.WithOpName("scale"),
+                              test::AsScalar<T>(static_cast<T>(0.25f)));
+      logits = ops::Mul(s.WithOpName("scaled"), scale, scores);
+    }
+    Tensor mask_t(DTYPE, TensorShape({kQueryLength, kKeyLength}));
+    if (mask_kind == Mask::kCausal) {
+      auto mask_values = mask_t.matrix<T>();
+      for (int i = 0; i < kQueryLength; ++i) {
+        for (int j = 0; j < kKeyLength; ++j) {
+          mask_values(i, j) = static_cast<T>(j <= i ? 0.0f : -1e9f);
+        }
+      }
+      auto mask = ops::Const(s.WithOpName("mask"), mask_t);
+      logits = ops::AddV2(s.WithOpName("masked"), logits, mask);
+    } else if (mask_kind == Mask::kPlaceholder) {
+      mask_t = GenerateTensorWithSetRandom<DTYPE>({kQueryLength, kKeyLength});
+      auto mask = ops::Placeholder(
+          s.WithOpName("mask"), DTYPE,
+          ops::Placeholder::Shape({kQueryLength, kKeyLength}));
+      logits = ops::AddV2(s.WithOpName("masked"), mask, logits);
+    }
+    auto softmax = ops::Softmax(s.WithOpName("softmax"), logits);
+    auto attention =
+        ops::BatchMatMulV2(s.WithOpName("attention"), softmax, value);
+    auto fetch = ops::Identity(s.WithOpName("fetch"), attention);
+
+    GrapplerItem item;
+    item.fetch = {"fetch"};
+    item.feed = {
+        {"query", GenerateTensorWithSetRandom<DTYPE>({2, 3, kQueryLength, 16})},
+        {"key", GenerateTensorWithSetRandom<DTYPE>({2, 3, kKeyLength, 16})},
+        {"value", GenerateTensorWithSetRandom<DTYPE>({2, 3, kKeyLength, 8})}};
+    if (mask_kind == Mask::kPlaceholder) item.feed.push_back({"mask", mask_t});
+    TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+    for (int i = 0; i < item.graph.node_size(); ++i) {
+      item.graph.mutable_node(i)->set_device("/device:CPU:0");
+    }
+
+    Remapper optimizer(RewriterConfig::ON);
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+    int found = 0;
+    for (const NodeDef& node : output.node()) {
+      EXPECT_NE(node.name(), "scores");
+      EXPECT_NE(node.name(), "softmax");
+      if (node.name() == "attention") {
+        EXPECT_EQ(node.op(), "_FusedScaledDotProductAttention");
+        const int num_args = mask_kind == Mask::kPlaceholder ? 1 : 0;
+        ASSERT_EQ(node.input_size(), 3 + num_args);
+        EXPECT_EQ(node.input(0), "query");
+        EXPECT_EQ(node.input(1), "key");
+        EXPECT_EQ(node.input(2), "value");
+        if (num_args == 1) EXPECT_EQ(node.input(3), "mask");
+        EXPECT_EQ(node.attr().at("num_args").i(), num_args);
+        EXPECT_FLOAT_EQ(node.attr().at("scale").f(), 0.25f);
+        EXPECT_EQ(node.attr().at("is_causal").b(), mask_kind == Mask::kCausal);
+        found++;
+      }
+    }
+    EXPECT_EQ(1, found);
+
+    auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+    ASSERT_EQ(tensors_expected.size(), 1);
+    auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+    ASSERT_EQ(tensors.size(), 1);
+    if (DTYPE == DT_BFLOAT16) {
+      test::ExpectClose(tensors[0], tensors_expected[0], 2e-2, 2e-2);
+    } else {
+      test::ExpectClose(tensors[0], tensors_expected[0], 1e-5);
+    }
+  }
+};
+
+TEST_F(RemapperFuseScaledDotProductAttentionTest, F32) {
+  RunTest<DT_FLOAT>(Mask::kNone);
+}
+
+TEST_F(RemapperFuseScaledDotProductAttentionTest, F32WithMask) {
+  RunTest<DT_FLOAT>(Mask::kPlaceholder);
+}
+
+TEST_F(RemapperFuseScaledDotProductAttentionTest, F32WithCausalMask) {
+  RunTest<DT_FLOAT>(Mask::kCausal);
+}
+
+TEST_F(RemapperFuseScaledDotProductAttentionTest, Bf16WithMask) {
+  RunTest<DT_BFLOAT16>(Mask::kPlaceholder);
+}
+
+TEST_F(RemapperTest, DoesNotFuseAttentionWithBroadcastBatch) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto query = ops::Placeholder(s.WithOpName("query"), DT_FLOAT,
+                                ops::Placeholder::Shape({2, 8, 16}));
+  auto key = ops::Placeholder(s.WithOpName("key"), DT_FLOAT,
+                              ops::Placeholder::Shape({1, 8, 16}));
+  auto value = ops::Placeholder(s.WithOpName("value"), DT_FLOAT,
+                                ops::Placeholder::Shape({2, 8, 16}));
+  auto scores = ops::BatchMatMulV2(s.WithOpName("scores"), query, key,
+                                   ops::BatchMatMulV2::AdjY(true));
+  auto softmax = ops::Softmax(s.WithOpName("softmax"), scores);
+  ops::BatchMatMulV2(s.WithOpName("attention"), softmax, value);
+
+  GrapplerItem item;
+  item.fetch = {"attention"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.op(), "_FusedScaledDotProductAttention");
+  }
+}
+
 // TODO(b/161005848): Fix flaky test.
 TEST_F(RemapperTest, DISABLED_FuseConv2DWithBiasAndActivationOnGPU) {
 #if !(GOOGLE_CUDA)
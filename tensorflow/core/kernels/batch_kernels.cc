@@ -44,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/batch_resource_base.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
 #include "tensorflow/core/kernels/batching_util/bounded_executor.h"
 #include "tensorflow/core/kernels/batching_util/concat_split_util.h"
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
@@ -374,6 +375,15 @@ BatchFunctionKernel::BatchFunctionKernel(OpKernelConstruction* c)
         c, c->GetAttr("num_warmup_batch_threads", &num_warmup_batch_threads_));
   }
 
+  if (c->HasAttr("latency_slo_micros")) {
+    OP_REQUIRES_OK(c, c->GetAttr("latency_slo_micros", &latency_slo_micros_));
+  }
+
+  if (c->HasAttr("enable_zero_copy_batching")) {
+    OP_REQUIRES_OK(c, c->GetAttr("enable_zero_copy_batching",
+                                 &enable_zero_copy_batching_));
+  }
+
   // Helper function `SetAdaptiveBatchSchedulerOptions` calls
   // `OP_REQUIRES_OK`, which exits the current function upon error.
   // So validate status of `op-kernel-construction`.
@@ -477,6 +487,7 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
           adaptive_shared_batch_scheduler_options, max_batch_size_,
           batch_timeout_micros_, max_enqueued_batches_, allowed_batch_sizes_,
           &new_resource));
+      new_resource->set_zero_copy_batching(enable_zero_copy_batching_);
       if (session_metadata) {
         new_resource->set_session_metadata(*session_metadata);
       }
@@ -484,8 +495,9 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
       return absl::OkStatus();
     };
   } else {
-    creator = [this,
-               session_metadata = c->session_metadata()](BatchResource** r) {
+    creator = [this, session_metadata = c->session_metadata(),
+               model_name = std::string(GetModelName(c)),
+               op_name = c->op_kernel().name()](BatchResource** r) {
       TF_ASSIGN_OR_RETURN(
           serving::MixedPriorityBatchingPolicy mixed_priority_batching_policy,
           serving::GetMixedPriorityBatchingPolicy(mixed_priority_policy_));
@@ -502,6 +514,12 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
           enable_priority_aware_batch_scheduler_resplit_,
           enable_batching_task_lazy_cancellation_, batch_padding_policy_,
           num_warmup_batch_threads_, &new_resource));
+      serving::ModelBatchStats& model_batch_stats =
+          serving::GlobalBatchStatsRegistry().model(model_name, op_name);
+      model_batch_stats.SetBatchTimeoutMicros(batch_timeout_micros_);
+      model_batch_stats.SetNumBatchThreads(num_batch_threads_);
+      model_batch_stats.SetLatencySloMicros(latency_slo_micros_);
+      new_resource->set_zero_copy_batching(enable_zero_copy_batching_);
       if (session_metadata) {
         new_resource->set_session_metadata(*session_metadata);
       }
@@ -24,6 +24,7 @@ limitations under the License.
 #include "xla/tsl/platform/types.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 
@@ -113,6 +114,8 @@ class BatchFunctionKernel : public AsyncOpKernel {
   std::string mixed_priority_policy_;
   std::string batch_padding_policy_;
   int32_t num_warmup_batch_threads_ = 0;
+  int64_t latency_slo_micros_ = serving::kLatencySloMicrosUnknown;
+  bool enable_zero_copy_batching_ = false;
   NameAttrList func_;
   absl::optional<FunctionLibraryRuntime::Handle> fhandle_ TF_GUARDED_BY(mu_);
   bool enable_large_batch_splitting_ = false;
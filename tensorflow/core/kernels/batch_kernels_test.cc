@@ -40,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/batch_kernel_test_util.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
 #include "tensorflow/core/kernels/batching_util/warmup.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/platform/env.h"
@@ -746,5 +747,81 @@ INSTANTIATE_TEST_SUITE_P(BatchFunctionKernelPaddingTestSuite,
                          ::testing::Values("PAD_UP", "BATCH_DOWN",
                                            "MINIMIZE_TPU_COST_PER_REQUEST"));
 
+class BatchFunctionLatencySloTestState : public SharedBatchFunctionTestState {
+ public:
+  // Init test fixture with a batch kernel instance.
+  absl::Status Init(int64_t latency_slo_micros) {
+    const TensorShape expected_output_shape({4, 2});
+    TF_ASSIGN_OR_RETURN(
+        NodeDefBuilder builder,
+        CreateBatchFunctionBuilder({4, 8}, 8, "MINIMIZE_LATENCY_PER_REQUEST",
+                                   expected_output_shape));
+    TF_RETURN_IF_ERROR(builder.Attr("latency_slo_micros", latency_slo_micros)
+                           .Finalize(node_def()));
+    return OpsTestBase::InitOp();
+  }
+
+  void TestBody() override {}
+};
+
+TEST(BatchFunctionLatencySloTest, SetsModelLatencySlo) {
+  SessionMetadata session_metadata;
+  session_metadata.set_name("latency_slo_model");
+  session_metadata.set_version(1);
+
+  BatchFunctionLatencySloTestState test_state;
+  test_state.set_session_metadata(session_metadata);
+  TF_ASSERT_OK(test_state.Init(/*latency_slo_micros=*/50000));
+  test_state.AddInputFromList<int64_t>(TensorShape({1, 2}), {123, 456});
+  TF_ASSERT_OK(test_state.RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(
+      *test_state.GetOutput(0),
+      test::AsTensor<int64_t>({123, 456}, TensorShape({1, 2})));
+
+  serving::ModelBatchStats& stats = serving::GlobalBatchStatsRegistry().model(
+      "latency_slo_model", test_state.op_kernel()->name());
+  EXPECT_EQ(stats.latency_slo_micros(), 50000);
+  EXPECT_EQ(stats.batch_timeout_micros(), 1000000);
+}
+
+class BatchFunctionZeroCopyTestState : public SharedBatchFunctionTestState {
+ public:
+  // Init test fixture with a batch kernel instance. The caller guarantees that
+  // the device pointer is valid throughout the life of this class.
+  absl::Status Init(Device *device) {
+    device_ = device;
+    TF_ASSIGN_OR_RETURN(
+        NodeDefBuilder builder,
+        CreateBatchFunctionBuilder({4, 8}, 8, "PAD_UP", TensorShape({4, 2})));
+    TF_RETURN_IF_ERROR(builder.Attr("enable_zero_copy_batching", true)
+                           .Finalize(node_def()));
+    return OpsTestBase::InitOp();
+  }
+
+  void TestBody() override {}
+};
+
+TEST_F(BatchFunctionTest, ZeroCopyBatchingReturnsEachRequestsRows) {
+  SessionMetadata session_metadata;
+  session_metadata.set_name("zero_copy_model");
+
+  tsl::BlockingCounter blocking_counter(2);
+  for (int i = 0; i < 2; ++i) {
+    Env::Default()->SchedClosure([&, i]() {
+      BatchFunctionZeroCopyTestState test_state;
+      test_state.set_session_metadata(session_metadata);
+      TF_ASSERT_OK(test_state.Init(cpu_device_.get()));
+      test_state.AddInputFromList<int64_t>(TensorShape({1, 2}), {i, i + 10});
+      TF_EXPECT_OK(test_state.RunOpKernel());
+
+      test::ExpectTensorEqual<int64_t>(
+          *test_state.GetOutput(0),
+          test::AsTensor<int64_t>({i, i + 10}, TensorShape({1, 2})));
+      blocking_counter.DecrementCount();
+    });
+  }
+  blocking_counter.Wait();
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -0,0 +1,239 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_buffer_pool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace serving {
+
+BatchBufferPool::BatchBufferPool(int64_t max_retained_bytes,
+                                 absl::Duration max_idle_time)
+    : max_retained_bytes_(max_retained_bytes), max_idle_time_(max_idle_time) {}
+
+absl::Status BatchBufferPool::Allocate(OpKernelContext* context,
+                                       DataType dtype,
+                                       const TensorShape& shape,
+                                       Tensor* buffer) {
+  DCHECK(DataTypeCanUseMemcpy(dtype));
+  const std::string key = absl::StrCat(dtype, ":", shape.DebugString());
+  {
+    absl::MutexLock l(&mu_);
+    const absl::Time now = absl::Now();
+    bool reused = false;
+    auto it = buffers_.find(key);
+    if (it != buffers_.end()) {
+      for (RetainedBuffer& retained : it->second) {
+        if (retained.tensor.RefCountIsOne()) {
+          retained.last_use = now;
+          *buffer = retained.tensor;
+          reused = true;
+          break;
+        }
+      }
+    }
+    // The reused buffer is no longer free, so it is not released here.
+    ReleaseIdleBuffers(now);
+    if (reused) {
+      return absl::OkStatus();
+    }
+  }
+
+  AllocatorAttributes attr;
+  attr.set_on_host(true);
+  TF_RETURN_IF_ERROR(context->allocate_temp(dtype, shape, buffer, attr));
+
+  const int64_t bytes = buffer->TotalBytes();
+  absl::MutexLock l(&mu_);
+  MakeRoom(bytes);
+  if (retained_bytes_ + bytes <= max_retained_bytes_) {
+    buffers_[key].push_back({*buffer, absl::Now()});
+    retained_bytes_ += bytes;
+  }
+  return absl::OkStatus();
+}
+
+void BatchBufferPool::ReleaseIdleBuffers(absl::Time now) {
+  for (auto it = buffers_.begin(); it != buffers_.end();) {
+    std::vector<RetainedBuffer>& retained = it->second;
+    for (size_t i = 0; i < retained.size();) {
+      if (retained[i].tensor.RefCountIsOne() &&
+          now - retained[i].last_use >= max_idle_time_) {
+        retained_bytes_ -= retained[i].tensor.TotalBytes();
+        retained[i] = std::move(retained.back());
+        retained.pop_back();
+      } else {
+        ++i;
+      }
+    }
+    if (retained.empty()) {
+      buffers_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void BatchBufferPool::MakeRoom(int64_t bytes) {
+  if (bytes > max_retained_bytes_) {
+    return;
+  }
+  while (retained_bytes_ + bytes > max_retained_bytes_) {
+    auto lru_it = buffers_.end();
+    size_t lru_index = 0;
+    for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+      for (size_t i = 0; i < it->second.size(); ++i) {
+        const RetainedBuffer& retained = it->second[i];
+        if (retained.tensor.RefCountIsOne() &&
+            (lru_it == buffers_.end() ||
+             retained.last_use < lru_it->second[lru_index].last_use)) {
+          lru_it = it;
+          lru_index = i;
+        }
+      }
+    }
+    if (lru_it == buffers_.end()) {
+      return;
+    }
+    std::vector<RetainedBuffer>& retained = lru_it->second;
+    retained_bytes_ -= retained[lru_index].tensor.TotalBytes();
+    retained[lru_index] = std::move(retained.back());
+    retained.pop_back();
+    if (retained.empty()) {
+      buffers_.erase(lru_it);
+    }
+  }
+}
+
+absl::Status BatchBufferPool::Assemble(OpKernelContext* context,
+                                       absl::Span<const Tensor> pieces,
+                                       Tensor* batch) {
+  if (pieces.empty()) {
+    return absl::InvalidArgumentError("Cannot assemble a batch of no tensors");
+  }
+  const Tensor& first = pieces[0];
+  if (first.dims() == 0) {
+    return absl::InvalidArgumentError(
+        "Cannot batch a zero-dimensional tensor");
+  }
+  if (pieces.size() == 1) {
+    *batch = first;
+    return absl::OkStatus();
+  }
+
+  int64_t batch_size = 0;
+  for (int i = 0; i < pieces.size(); ++i) {
+    const Tensor& piece = pieces[i];
+    if (piece.dtype() != first.dtype()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Cannot batch tensors that have different data types. Got ",
+          DataTypeString(first.dtype()), " and ",
+          DataTypeString(piece.dtype()), "."));
+    }
+    if (piece.dims() != first.dims()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Ranks of all input tensors should match: shape[0] = ",
+                       first.shape().DebugString(), " vs. shape[", i,
+                       "] = ", piece.shape().DebugString()));
+    }
+    for (int j = 1; j < first.dims(); ++j) {
+      if (piece.dim_size(j) != first.dim_size(j)) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Dimensions of inputs should match: shape[0] = ",
+                         first.shape().DebugString(), " vs. shape[", i,
+                         "] = ", piece.shape().DebugString()));
+      }
+    }
+    batch_size += piece.dim_size(0);
+  }
+
+  TensorShape batch_shape = first.shape();
+  batch_shape.set_dim(0, batch_size);
+  TF_RETURN_IF_ERROR(Allocate(context, first.dtype(), batch_shape, batch));
+
+  // Every piece is copied into its rows of the batch exactly once.
+  char* to_data = const_cast<char*>(batch->tensor_data().data());
+  int64_t offset = 0;
+  for (const Tensor& piece : pieces) {
+    const absl::string_view from_data = piece.tensor_data();
+    if (!from_data.empty()) {
+      std::memcpy(to_data + offset, from_data.data(), from_data.size());
+    }
+    offset += from_data.size();
+  }
+  DCHECK_EQ(offset, batch->TotalBytes());
+  return absl::OkStatus();
+}
+
+int64_t BatchBufferPool::retained_bytes() const {
+  absl::MutexLock l(&mu_);
+  return retained_bytes_;
+}
+
+absl::Status SplitBatchWithoutCopy(const Tensor& batch,
+                                   absl::Span<const int64_t> sizes,
+                                   std::vector<Tensor>* outputs) {
+  if (batch.dims() == 0) {
+    return absl::InvalidArgumentError("Cannot split a zero-dimensional tensor");
+  }
+  int64_t total_size = 0;
+  for (const int64_t size : sizes) {
+    total_size += size;
+  }
+  if (total_size != batch.dim_size(0)) {
+    return absl::InvalidArgumentError(
+        "The values in 'sizes' do not sum to the zeroth-dimension size of "
+        "'batch'");
+  }
+
+  outputs->reserve(outputs->size() + sizes.size());
+  int64_t position = 0;
+  for (const int64_t size : sizes) {
+    Tensor slice = batch.Slice(position, position + size);
+    // Kernels that consume the outputs access them through Eigen, which
+    // requires aligned buffers.
+    if (slice.IsAligned() || slice.NumElements() == 0) {
+      outputs->push_back(std::move(slice));
+    } else {
+      outputs->push_back(tensor::DeepCopy(slice));
+    }
+    position += size;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace serving
+}  // namespace tensorflow
@@ -0,0 +1,110 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_BUFFER_POOL_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_BUFFER_POOL_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+
+namespace tensorflow {
+namespace serving {
+
+// A pool of host buffers for batched input tensors, used by the batching ops
+// in zero-copy mode.
+//
+// A batch of a given padded size always has the same shape, so the buffer of
+// a previous batch can be reused once the batch function and every consumer
+// of its outputs have released it. A buffer is known to be free when the pool
+// holds the only reference to it.
+//
+// Free buffers that have not been reused for `max_idle_time` are released, as
+// are the least recently used free buffers when a new buffer would not fit in
+// `max_retained_bytes` otherwise.
+//
+// Thread-safe.
+class BatchBufferPool {
+ public:
+  // The pool keeps at most `max_retained_bytes` of buffers for reuse. Buffers
+  // allocated beyond that are handed out but not retained.
+  BatchBufferPool(int64_t max_retained_bytes, absl::Duration max_idle_time);
+
+  BatchBufferPool(const BatchBufferPool&) = delete;
+  BatchBufferPool& operator=(const BatchBufferPool&) = delete;
+
+  // Sets `buffer` to a host tensor of type `dtype` and shape `shape` with
+  // unspecified contents. A free retained buffer is reused if there is one,
+  // otherwise the buffer is allocated through `context`. `dtype` must be a
+  // type for which DataTypeCanUseMemcpy() is true.
+  absl::Status Allocate(OpKernelContext* context, DataType dtype,
+                        const TensorShape& shape, Tensor* buffer);
+
+  // Writes `pieces` into consecutive rows of a batch tensor, which is set in
+  // `batch`. All pieces must have the same dtype, rank and non-zeroth
+  // dimensions. A single piece is returned without copying.
+  absl::Status Assemble(OpKernelContext* context,
+                        absl::Span<const Tensor> pieces, Tensor* batch);
+
+  // Returns the number of bytes of buffers retained for reuse.
+  int64_t retained_bytes() const;
+
+ private:
+  struct RetainedBuffer {
+    Tensor tensor;
+    absl::Time last_use;
+  };
+
+  // Releases the free buffers that have been idle for `max_idle_time_` at
+  // `now`.
+  void ReleaseIdleBuffers(absl::Time now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Releases the least recently used free buffers until `bytes` more can be
+  // retained, if possible.
+  void MakeRoom(int64_t bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64_t max_retained_bytes_;
+  const absl::Duration max_idle_time_;
+
+  mutable absl::Mutex mu_;
+  int64_t retained_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  // Retained buffers, keyed on dtype and shape. Keys without buffers are
+  // erased.
+  absl::flat_hash_map<std::string, std::vector<RetainedBuffer>> buffers_
+      ABSL_GUARDED_BY(mu_);
+};
+
+// Splits `batch` into tensors whose zeroth-dimension sizes are `sizes`. The
+// outputs are views into `batch` rather than copies, except for those that
+// would not be suitably aligned for Eigen, which are copied.
+absl::Status SplitBatchWithoutCopy(const Tensor& batch,
+                                   absl::Span<const int64_t> sizes,
+                                   std::vector<Tensor>* outputs);
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_BUFFER_POOL_H_
@@ -0,0 +1,220 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_buffer_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/public/version.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+REGISTER_OP("BatchBufferPoolTestOp");
+
+class BatchBufferPoolTestOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* context) override {}
+};
+
+REGISTER_KERNEL_BUILDER(Name("BatchBufferPoolTestOp").Device(DEVICE_CPU),
+                        BatchBufferPoolTestOp);
+
+class BatchBufferPoolTest : public ::testing::Test {
+ protected:
+  BatchBufferPoolTest() {
+    device_ = DeviceFactory::NewDevice("CPU", SessionOptions{},
+                                       "/job:a/replica:0/task:0");
+    NodeDef node_def;
+    TF_CHECK_OK(
+        NodeDefBuilder("op", "BatchBufferPoolTestOp").Finalize(&node_def));
+    absl::Status status;
+    kernel_ = CreateOpKernel(DEVICE_CPU, device_.get(),
+                             device_->GetAllocator({}), node_def,
+                             TF_GRAPH_DEF_VERSION, &status);
+    TF_CHECK_OK(status);
+    params_.device = device_.get();
+    params_.op_kernel = kernel_.get();
+    context_ = std::make_unique<OpKernelContext>(&params_);
+  }
+
+  Tensor Allocate(BatchBufferPool& pool, DataType dtype,
+                  const TensorShape& shape) {
+    Tensor buffer;
+    TF_CHECK_OK(pool.Allocate(context_.get(), dtype, shape, &buffer));
+    return buffer;
+  }
+
+  std::unique_ptr<Device> device_;
+  std::unique_ptr<OpKernel> kernel_;
+  OpKernelContext::Params params_;
+  std::unique_ptr<OpKernelContext> context_;
+};
+
+TEST_F(BatchBufferPoolTest, ReusesReleasedBuffers) {
+  BatchBufferPool pool(/*max_retained_bytes=*/1 << 20, absl::Hours(1));
+  const void* data;
+  {
+    Tensor buffer = Allocate(pool, DT_FLOAT, TensorShape({4, 8}));
+    data = buffer.tensor_data().data();
+    // A buffer in use is not handed out again.
+    Tensor other = Allocate(pool, DT_FLOAT, TensorShape({4, 8}));
+    EXPECT_NE(other.tensor_data().data(), data);
+  }
+  Tensor buffer = Allocate(pool, DT_FLOAT, TensorShape({4, 8}));
+  EXPECT_EQ(buffer.tensor_data().data(), data);
+  EXPECT_EQ(pool.retained_bytes(), 2 * 4 * 8 * 4);
+}
+
+TEST_F(BatchBufferPoolTest, SlicesKeepBuffersInUse) {
+  BatchBufferPool pool(/*max_retained_bytes=*/1 << 20, absl::Hours(1));
+  Tensor slice;
+  const void* data;
+  {
+    Tensor buffer = Allocate(pool, DT_INT32, TensorShape({4, 4}));
+    data = buffer.tensor_data().data();
+    slice = buffer.Slice(2, 4);
+  }
+  EXPECT_NE(
+      Allocate(pool, DT_INT32, TensorShape({4, 4})).tensor_data().data(),
+      data);
+  slice = Tensor();
+  EXPECT_EQ(
+      Allocate(pool, DT_INT32, TensorShape({4, 4})).tensor_data().data(),
+      data);
+}
+
+TEST_F(BatchBufferPoolTest, RespectsMaxRetainedBytes) {
+  BatchBufferPool pool(/*max_retained_bytes=*/100, absl::Hours(1));
+  Tensor buffer = Allocate(pool, DT_FLOAT, TensorShape({4, 4}));
+  EXPECT_EQ(pool.retained_bytes(), 64);
+  Allocate(pool, DT_FLOAT, TensorShape({3, 4}));
+  EXPECT_EQ(pool.retained_bytes(), 64);
+}
+
+TEST_F(BatchBufferPoolTest, ReleasesLeastRecentlyUsedFreeBuffers) {
+  BatchBufferPool pool(/*max_retained_bytes=*/100, absl::Hours(1));
+  Allocate(pool, DT_FLOAT, TensorShape({4, 4}));
+  EXPECT_EQ(pool.retained_bytes(), 64);
+  // The free 64-byte buffer makes room for a buffer of another shape.
+  Tensor buffer = Allocate(pool, DT_FLOAT, TensorShape({2, 10}));
+  EXPECT_EQ(pool.retained_bytes(), 80);
+  EXPECT_EQ(Allocate(pool, DT_FLOAT, TensorShape({2, 10})).NumElements(), 20);
+  EXPECT_EQ(pool.retained_bytes(), 80);
+}
+
+TEST_F(BatchBufferPoolTest, ReleasesIdleBuffers) {
+  BatchBufferPool pool(/*max_retained_bytes=*/1 << 20, absl::ZeroDuration());
+  Allocate(pool, DT_FLOAT, TensorShape({4, 4}));
+  EXPECT_EQ(pool.retained_bytes(), 64);
+  Tensor buffer = Allocate(pool, DT_FLOAT, TensorShape({2, 4}));
+  EXPECT_EQ(pool.retained_bytes(), 32);
+}
+
+TEST_F(BatchBufferPoolTest, Assemble) {
+  BatchBufferPool pool(/*max_retained_bytes=*/1 << 20, absl::Hours(1));
+  std::vector<Tensor> pieces = {
+      test::AsTensor<int32_t>({1, 2, 3, 4}, {2, 2}),
+      test::AsTensor<int32_t>({5, 6}, {1, 2}),
+      test::AsTensor<int32_t>({5, 6}, {1, 2}),
+  };
+  Tensor batch;
+  TF_ASSERT_OK(pool.Assemble(context_.get(), pieces, &batch));
+  test::ExpectTensorEqual<int32_t>(
+      batch, test::AsTensor<int32_t>({1, 2, 3, 4, 5, 6, 5, 6}, {4, 2}));
+}
+
+TEST_F(BatchBufferPoolTest, AssembleSinglePieceDoesNotCopy) {
+  BatchBufferPool pool(/*max_retained_bytes=*/1 << 20, absl::Hours(1));
+  Tensor piece = test::AsTensor<float>({1, 2, 3}, {3});
+  Tensor batch;
+  TF_ASSERT_OK(pool.Assemble(context_.get(), {piece}, &batch));
+  EXPECT_TRUE(batch.SharesBufferWith(piece));
+  EXPECT_EQ(pool.retained_bytes(), 0);
+}
+
+TEST_F(BatchBufferPoolTest, AssembleRejectsMismatchedShapes) {
+  BatchBufferPool pool(/*max_retained_bytes=*/1 << 20, absl::Hours(1));
+  Tensor batch;
+  EXPECT_EQ(pool.Assemble(context_.get(),
+                          {test::AsTensor<int32_t>({1, 2}, {1, 2}),
+                           test::AsTensor<int32_t>({1, 2, 3}, {1, 3})},
+                          &batch)
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(pool.Assemble(context_.get(),
+                          {test::AsTensor<int32_t>({1, 2}, {1, 2}),
+                           test::AsTensor<float>({1, 2}, {1, 2})},
+                          &batch)
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(SplitBatchWithoutCopyTest, ReturnsViews) {
+  // 16 floats per row keep every slice aligned.
+  Tensor batch(DT_FLOAT, TensorShape({4, 16}));
+  test::FillIota<float>(&batch, 0);
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(SplitBatchWithoutCopy(batch, {1, 3}, &outputs));
+  ASSERT_EQ(outputs.size(), 2);
+  EXPECT_TRUE(outputs[0].SharesBufferWith(batch));
+  EXPECT_TRUE(outputs[1].SharesBufferWith(batch));
+  test::ExpectTensorEqual<float>(outputs[0], batch.Slice(0, 1));
+  test::ExpectTensorEqual<float>(outputs[1], batch.Slice(1, 4));
+}
+
+TEST(SplitBatchWithoutCopyTest, CopiesUnalignedSlices) {
+  Tensor batch = test::AsTensor<int32_t>({1, 2, 3, 4, 5}, {5});
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(SplitBatchWithoutCopy(batch, {2, 3}, &outputs));
+  ASSERT_EQ(outputs.size(), 2);
+  EXPECT_TRUE(outputs[0].SharesBufferWith(batch));
+  EXPECT_TRUE(outputs[1].IsAligned());
+  test::ExpectTensorEqual<int32_t>(outputs[0],
+                                   test::AsTensor<int32_t>({1, 2}, {2}));
+  test::ExpectTensorEqual<int32_t>(outputs[1],
+                                   test::AsTensor<int32_t>({3, 4, 5}, {3}));
+}
+
+TEST(SplitBatchWithoutCopyTest, RejectsWrongSizes) {
+  Tensor batch = test::AsTensor<int32_t>({1, 2, 3}, {3});
+  std::vector<Tensor> outputs;
+  EXPECT_EQ(SplitBatchWithoutCopy(batch, {1, 1}, &outputs).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
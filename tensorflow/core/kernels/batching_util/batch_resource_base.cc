@@ -56,6 +56,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/kernels/batching_util/batch_buffer_pool.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
@@ -90,6 +91,11 @@ constexpr int64_t kCriticalCapacityFractionDenom = 4;
 constexpr int64_t kSheddablePlusCapacityFractionDenom = 8;
 constexpr int64_t kSheddableCapacityFractionDenom = 16;
 
+// The most memory a batch resource keeps for recycled input buffers in
+// zero-copy mode, and how long a buffer is kept without being reused.
+constexpr int64_t kMaxRetainedBatchBufferBytes = int64_t{256} << 20;
+constexpr absl::Duration kMaxBatchBufferIdleTime = absl::Seconds(60);
+
 using ::tensorflow::concat_split_util::Concat;
 using ::tensorflow::concat_split_util::Split;
 using TensorMatrix = std::vector<std::vector<Tensor>>;
@@ -932,8 +938,14 @@ absl::Status BatchResourceBase::ConcatInputTensors(
     }
 
     Tensor concatenated_tensor;
-    absl::Status concat_status =
-        Concat(context, to_concatenate, &concatenated_tensor);
+    absl::Status concat_status;
+    if (batch_buffer_pool_ != nullptr &&
+        DataTypeCanUseMemcpy(to_concatenate[0].dtype())) {
+      concat_status = batch_buffer_pool_->Assemble(context, to_concatenate,
+                                                   &concatenated_tensor);
+    } else {
+      concat_status = Concat(context, to_concatenate, &concatenated_tensor);
+    }
     TF_RETURN_IF_ERROR(concat_status);
     concatenated_tensors->push_back(concatenated_tensor);
   }
@@ -1119,8 +1131,13 @@ absl::Status BatchResourceBase::SplitOutputTensors(
     }
 
     std::vector<Tensor> split_tensor;
-    const absl::Status split_status = tensor::Split(
-        output_tensor, task_sizes_plus_optional_padding, &split_tensor);
+    const absl::Status split_status =
+        batch_buffer_pool_ != nullptr
+            ? SplitBatchWithoutCopy(output_tensor,
+                                    task_sizes_plus_optional_padding,
+                                    &split_tensor)
+            : tensor::Split(output_tensor, task_sizes_plus_optional_padding,
+                            &split_tensor);
     DCHECK(split_status.ok()) << split_status;
     if (!split_status.ok()) {
       return absl::InternalError(absl::StrCat("Tensor split operation failed: ",
@@ -1251,6 +1268,7 @@ void BatchResourceBase::ProcessFuncBatch(
   // Releases the cleanup method here, because the callback of the function
   // library runtime will handle it now.
   finally.release();
+  const uint64_t run_start_time_ns = EnvTime::NowNanos();
   ProcessFuncBatchImpl(last_task, args, &combined_outputs,
                        [&](const absl::Status& run_status) {
                          absl::Status final_status;
@@ -1267,6 +1285,14 @@ void BatchResourceBase::ProcessFuncBatch(
                          if (!final_status.ok()) {
                            return;
                          }
+                         // Feeds the latency curve used by the
+                         // MINIMIZE_LATENCY_PER_REQUEST padding policy.
+                         GlobalBatchStatsRegistry()
+                             .model(model_name, op_name)
+                             .batch_size(processed_size)
+                             .processing_latency()
+                             .Register(absl::Nanoseconds(EnvTime::NowNanos() -
+                                                         run_start_time_ns));
                          if (last_task.forced_warmup_batch_size == 0) {
                            final_status = SplitOutputTensors(
                                combined_outputs, batch.get(), unbatched_tasks);
@@ -1447,6 +1473,15 @@ absl::Status BatchResourceBase::LookupOrCreateBatcherQueue(
   return absl::OkStatus();
 }
 
+void BatchResourceBase::set_zero_copy_batching(bool zero_copy_batching) {
+  if (!zero_copy_batching) {
+    batch_buffer_pool_ = nullptr;
+  } else if (batch_buffer_pool_ == nullptr) {
+    batch_buffer_pool_ = std::make_unique<BatchBufferPool>(
+        kMaxRetainedBatchBufferBytes, kMaxBatchBufferIdleTime);
+  }
+}
+
 std::optional<absl::Duration> BatchResourceBase::GetBatchTimeout() const {
   if (batcher_) {
     return absl::Microseconds(batcher_queue_options_.batch_timeout_micros);
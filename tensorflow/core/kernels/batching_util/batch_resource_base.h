@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/batching_util/adaptive_shared_batch_scheduler.h"
+#include "tensorflow/core/kernels/batching_util/batch_buffer_pool.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
@@ -245,6 +246,12 @@ class BatchResourceBase : public ResourceBase {
     session_metadata_ = std::move(session_metadata);
   }
 
+  // Enables or disables zero-copy batching. In zero-copy mode, batched inputs
+  // are written into recycled buffers, and the outputs are returned to the
+  // tasks as views into the batched outputs instead of copies. Must be called
+  // before any input is registered.
+  void set_zero_copy_batching(bool zero_copy_batching);
+
   const SessionMetadata& session_metadata() const { return session_metadata_; }
 
   using CreateBatchTaskFn =
@@ -448,6 +455,10 @@ class BatchResourceBase : public ResourceBase {
   // A concatenated string of <allowed_batch_sizes_>, separated by ",". This is
   // used to record batching parameter.
   string allowed_batch_sizes_str_;
+
+  // Recycled buffers for batched inputs. Non-null iff zero-copy batching is
+  // enabled.
+  std::unique_ptr<BatchBufferPool> batch_buffer_pool_;
 };
 
 }  // namespace serving
@@ -52,6 +52,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
@@ -61,6 +62,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/threadsafe_status.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/public/session_options.h"
@@ -1540,6 +1542,110 @@ TEST_F(BatchResourceBaseTest, ProcessFuncBatchPropagatesError) {
               ::testing::HasSubstr("Function was cancelled"));
 }
 
+TEST(BatchResourceBaseZeroCopyTest, ReturnsBatchedOutputsToEachTask) {
+  using BatchTask = BatchResourceBase::BatchTask;
+
+  std::unique_ptr<Device> device = DeviceFactory::NewDevice(
+      "CPU", SessionOptions{}, "/job:a/replica:0/task:0");
+  NodeDefBuilder batch_function_builder("my_batch_node", "BatchFunction");
+  batch_function_builder.Attr("max_batch_size", 8);
+  batch_function_builder.Attr("num_batch_threads", 1);
+  batch_function_builder.Attr("allowed_batch_sizes", {8});
+  batch_function_builder.Attr("batch_timeout_micros", 1000000);
+  batch_function_builder.Attr("max_enqueued_batches", 10);
+  batch_function_builder.Attr("Tin", {DataType::DT_INT64});
+  batch_function_builder.Input(std::vector<NodeDefBuilder::NodeOut>{
+      NodeDefBuilder::NodeOut({"n1", 0, DataType::DT_INT64})});
+  batch_function_builder.Attr("Tcaptured", std::vector<DataType>{});
+  batch_function_builder.Input(std::vector<NodeDefBuilder::NodeOut>{});
+  batch_function_builder.Attr("Tout", {DataType::DT_INT64});
+  NameAttrList f;
+  f.set_name("func_to_batch");
+  batch_function_builder.Attr("f", f);
+  NodeDef batch_kernel_node_def;
+  TF_ASSERT_OK(batch_function_builder.Finalize(&batch_kernel_node_def));
+  absl::Status op_kernel_creation_status;
+  std::unique_ptr<OpKernel> batch_kernel =
+      CreateOpKernel(DEVICE_CPU, device.get(), device->GetAllocator({}),
+                     batch_kernel_node_def, TF_GRAPH_DEF_VERSION,
+                     &op_kernel_creation_status);
+  TF_ASSERT_OK(op_kernel_creation_status);
+  SessionMetadata session_metadata;
+  session_metadata.set_name("my_model_name");
+
+  std::shared_ptr<SharedBatchScheduler<BatchResourceBase::BatchTask>> batcher;
+  TF_ASSERT_OK(SharedBatchScheduler<BatchResourceBase::BatchTask>::Create(
+      SharedBatchScheduler<BatchResourceBase::BatchTask>::Options(), &batcher));
+  tsl::core::RefCountPtr<BatchResourceBase> batch_resource(
+      new TestBatchResourceBase(
+          /*has_process_batch_function=*/true, batcher,
+          TestBatchResourceBase::GetBatcherQueueOptions(
+              /*num_batch_threads=*/1, /*max_batch_size=*/8,
+              /*batch_timeout_micros=*/1000000, /*max_enqueued_batches=*/10,
+              /*allowed_batch_sizes=*/{8},
+              /*enable_large_batch_splitting=*/false,
+              /*disable_padding=*/false),
+          /*allowed_batch_sizes=*/{8}));
+  batch_resource->set_zero_copy_batching(true);
+
+  // Four requests of two rows fill a batch of 8. The batch function returns
+  // its input, so every request must get its own rows back.
+  struct Request {
+    Tensor input;
+    std::vector<TensorValue> inputs;
+    OpKernelContext::Params params;
+    std::unique_ptr<OpKernelContext> context;
+  };
+  constexpr int kNumRequests = 4;
+  auto run_batch = [&](int round) {
+    std::vector<std::unique_ptr<Request>> requests;
+    absl::BlockingCounter blocking_counter(kNumRequests);
+    for (int i = 0; i < kNumRequests; ++i) {
+      auto request = std::make_unique<Request>();
+      request->input = Tensor(DataType::DT_INT64, TensorShape({2, 3}));
+      test::FillIota<int64_t>(&request->input, round * 1000 + i * 10);
+      request->inputs = {TensorValue(&request->input)};
+      request->params.device = device.get();
+      request->params.op_kernel = batch_kernel.get();
+      request->params.inputs = request->inputs;
+      request->params.session_metadata = &session_metadata;
+      request->context = std::make_unique<OpKernelContext>(&request->params);
+      TF_CHECK_OK(batch_resource->RegisterInput(
+          /*guid=*/round * kNumRequests + i, request->context.get(),
+          /*batcher_queue_name=*/"batcher_queue_name",
+          /*create_batch_task_fn=*/
+          []() -> absl::StatusOr<std::unique_ptr<BatchTask>> {
+            return std::make_unique<BatchTask>();
+          },
+          /*done_callback=*/[&]() { blocking_counter.DecrementCount(); },
+          /*forced_warmup_batch_size=*/0));
+      requests.push_back(std::move(request));
+    }
+    blocking_counter.Wait();
+    return requests;
+  };
+  auto expect_outputs_match_inputs =
+      [](const std::vector<std::unique_ptr<Request>>& requests) {
+        for (const auto& request : requests) {
+          TF_EXPECT_OK(request->context->status());
+          test::ExpectTensorEqual<int64_t>(*request->context->mutable_output(0),
+                                           request->input);
+        }
+      };
+
+  // The outputs of the first batch may still be views into its buffer while
+  // the second batch is assembled.
+  std::vector<std::unique_ptr<Request>> first = run_batch(/*round=*/0);
+  std::vector<std::unique_ptr<Request>> second = run_batch(/*round=*/1);
+  expect_outputs_match_inputs(first);
+  expect_outputs_match_inputs(second);
+
+  // Once released, the buffer of the first batch can be reused.
+  first.clear();
+  expect_outputs_match_inputs(run_batch(/*round=*/2));
+  expect_outputs_match_inputs(second);
+}
+
 TEST_F(BatchResourceBaseTest, ConfiguredBatchPaddingPolicyMetric) {
   tensorflow::monitoring::testing::CellReader<std::string> metric(
       "/tensorflow/serving/batching/configured_batch_padding_policy");
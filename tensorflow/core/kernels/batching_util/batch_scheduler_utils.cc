@@ -75,6 +75,62 @@ int32_t GetPrevAllowedBatchSize(int batch_size,
   return *result;
 }
 
+namespace {
+
+// Returns whether batching `candidate_size` requests down to
+// `batch_down_size` is expected to give a lower latency per real request than
+// padding them up to `pad_up_size`, according to the processing latencies in
+// `model_batch_stats`. Returns std::nullopt if there is not enough data.
+std::optional<bool> BatchDownHasLowerLatency(
+    int32_t candidate_size, int32_t pad_up_size, int32_t batch_down_size,
+    const std::vector<int32_t>& allowed_batch_sizes, bool disable_padding,
+    ModelBatchStats& model_batch_stats) {
+  std::optional<absl::Duration> up_latency =
+      model_batch_stats.batch_size(pad_up_size).processing_latency().mean();
+  std::optional<absl::Duration> down_latency =
+      model_batch_stats.batch_size(batch_down_size).processing_latency().mean();
+  if (!up_latency.has_value() || !down_latency.has_value()) {
+    return std::nullopt;
+  }
+
+  // The requests left behind by batching down start the next batch. They
+  // wait for at most the batch timeout and are then padded up to the next
+  // allowed size, which is never larger than `pad_up_size`.
+  const int32_t remainder_size = candidate_size - batch_down_size;
+  const int32_t remainder_batch_size = GetNextAllowedBatchSize(
+      remainder_size, allowed_batch_sizes, disable_padding);
+  absl::Duration remainder_latency =
+      model_batch_stats.batch_size(remainder_batch_size)
+          .processing_latency()
+          .mean()
+          .value_or(*up_latency);
+  const int64_t batch_timeout_micros = model_batch_stats.batch_timeout_micros();
+  if (batch_timeout_micros != kBatchTimeoutMicrosUnknown) {
+    remainder_latency += absl::Microseconds(batch_timeout_micros);
+  }
+
+  // If exactly one of the two options meets the SLO for all of its requests,
+  // that option wins regardless of the average latency.
+  const int64_t latency_slo_micros = model_batch_stats.latency_slo_micros();
+  if (latency_slo_micros != kLatencySloMicrosUnknown) {
+    const absl::Duration slo = absl::Microseconds(latency_slo_micros);
+    const bool pad_up_meets_slo = *up_latency <= slo;
+    const bool batch_down_meets_slo =
+        std::max(*down_latency, remainder_latency) <= slo;
+    if (pad_up_meets_slo != batch_down_meets_slo) {
+      return batch_down_meets_slo;
+    }
+  }
+
+  // Compare the total latency of all real requests in the two options.
+  const absl::Duration pad_up_total = *up_latency * candidate_size;
+  const absl::Duration batch_down_total =
+      *down_latency * batch_down_size + remainder_latency * remainder_size;
+  return batch_down_total < pad_up_total;
+}
+
+}  // namespace
+
 int ApplyBatchPaddingPolicy(int candidate_size,
                             const std::vector<int32_t>& allowed_batch_sizes,
                             bool disable_padding,
@@ -86,20 +142,25 @@ int ApplyBatchPaddingPolicy(int candidate_size,
   if (batch_padding_policy == kPadUpPolicy) {
     return candidate_size;
   }
-  bool minimize_tpu_cost_per_request;
+  bool minimize_tpu_cost_per_request = false;
+  bool minimize_latency_per_request = false;
   if (batch_padding_policy == kBatchDownPolicy) {
-    minimize_tpu_cost_per_request = false;
-  } else if (batch_padding_policy == kMinimizeTpuCostPerRequestPolicy) {
+    // Nothing to set.
+  } else if (batch_padding_policy == kMinimizeTpuCostPerRequestPolicy ||
+             batch_padding_policy == kMinimizeLatencyPerRequestPolicy) {
     if (model_batch_stats == nullptr) {
       LOG_FIRST_N(ERROR, 1)
-          << kMinimizeTpuCostPerRequestPolicy
+          << batch_padding_policy
           << " batch padding policy has been chosen "
              "but no ModelBatchStats passed to the batch scheduler; will "
              "fall back on the "
           << kPadUpPolicy << " policy.";
       return candidate_size;
     }
-    minimize_tpu_cost_per_request = true;
+    minimize_tpu_cost_per_request =
+        batch_padding_policy == kMinimizeTpuCostPerRequestPolicy;
+    minimize_latency_per_request =
+        batch_padding_policy == kMinimizeLatencyPerRequestPolicy;
   } else {
     LOG_FIRST_N(ERROR, 1) << "Unsupported batch_padding_policy: "
                           << batch_padding_policy << ", falling back on the "
@@ -153,6 +214,17 @@ int ApplyBatchPaddingPolicy(int candidate_size,
     }
   }
 
+  if (minimize_latency_per_request) {
+    std::optional<bool> batch_down = BatchDownHasLowerLatency(
+        candidate_size, pad_up_size, batch_down_size, allowed_batch_sizes,
+        disable_padding, *model_batch_stats);
+    if (!batch_down.has_value() || !*batch_down) {
+      // Pad up if there is no latency data for either size yet, or if it is
+      // expected to be faster.
+      return candidate_size;
+    }
+  }
+
   return batch_down_size;
 }
 
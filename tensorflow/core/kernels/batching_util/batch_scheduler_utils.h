@@ -65,11 +65,28 @@ int ApplyBatchPaddingPolicy(int candidate_size,
 //     to either PAD_UP or BATCH_DOWN so as to minimize the TPU costs per
 //     real request. In this case, it would compare (batch_16_cost / 16) and
 //     (batch_32_cost / 18).
+//   - MINIMIZE_LATENCY_PER_REQUEST: a greedy policy for latency-bound serving
+//     that chooses to either PAD_UP or BATCH_DOWN so as to minimize the
+//     expected latency per real request, using the processing latency curve
+//     learned in ModelBatchStats. Padding up makes all 18 requests wait for
+//     a batch of 32. Batching down finishes 16 requests with a batch of 16,
+//     while the remaining 2 wait up to the batch timeout for the next batch
+//     and are then processed in a batch of the next allowed size. If the
+//     model has a latency SLO, an option whose slowest request would miss the
+//     SLO is avoided when the other option meets it.
+//     Limitations: the latency curve is only recorded for batches that run a
+//     function (BatchResourceBase::ProcessFuncBatch), so batch resources that
+//     process batches without one always pad up, as if no data was available.
+//     Large batch splitting is not modelled either: a batch is charged the
+//     latency recorded for its padded size, even when it is run as several
+//     smaller splits.
 //
 inline constexpr absl::string_view kBatchDownPolicy = "BATCH_DOWN";
 inline constexpr absl::string_view kPadUpPolicy = "PAD_UP";
 inline constexpr absl::string_view kMinimizeTpuCostPerRequestPolicy =
     "MINIMIZE_TPU_COST_PER_REQUEST";
+inline constexpr absl::string_view kMinimizeLatencyPerRequestPolicy =
+    "MINIMIZE_LATENCY_PER_REQUEST";
 
 // Trims the batch to the next allowed batch size when possible and when
 // configured by batch_padding_policy.
@@ -245,6 +245,78 @@ TEST(ApplyBatchPaddingPolicyTest,
             3);
 }
 
+TEST(ApplyBatchPaddingPolicyTest, MinimizeLatencyPerRequestPicksBatchDown) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(2).processing_latency().Register(
+      absl::Seconds(1));
+  model_batch_stats.batch_size(4).processing_latency().Register(
+      absl::Seconds(3));
+
+  // Batching down: 2 requests take 1s and the last one takes another 1s in a
+  // batch of 2. Padding up: 3 requests take 3s each.
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMinimizeLatencyPerRequestPolicy,
+                                    &model_batch_stats),
+            2);
+}
+
+TEST(ApplyBatchPaddingPolicyTest, MinimizeLatencyPerRequestPicksPadUp) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.SetBatchTimeoutMicros(1'000'000);
+  model_batch_stats.batch_size(2).processing_latency().Register(
+      absl::Seconds(1));
+  model_batch_stats.batch_size(4).processing_latency().Register(
+      absl::Seconds(1.2));
+
+  // The request left behind by batching down waits for the 1s timeout, which
+  // makes padding up faster on average.
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMinimizeLatencyPerRequestPolicy,
+                                    &model_batch_stats),
+            3);
+}
+
+TEST(ApplyBatchPaddingPolicyTest, MinimizeLatencyPerRequestRespectsSlo) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.SetBatchTimeoutMicros(1'500'000);
+  model_batch_stats.batch_size(2).processing_latency().Register(
+      absl::Seconds(1));
+  model_batch_stats.batch_size(4).processing_latency().Register(
+      absl::Seconds(2));
+
+  // Batching down has the lower average latency (4.5s vs 6s in total)...
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMinimizeLatencyPerRequestPolicy,
+                                    &model_batch_stats),
+            2);
+
+  // ... but the request left behind takes 2.5s, which misses the SLO.
+  model_batch_stats.SetLatencySloMicros(2'000'000);
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMinimizeLatencyPerRequestPolicy,
+                                    &model_batch_stats),
+            3);
+}
+
+TEST(ApplyBatchPaddingPolicyTest,
+     MinimizeLatencyPerRequestMissingLatenciesReturnsCandidateSize) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(2).processing_latency().Register(
+      absl::Seconds(1));
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMinimizeLatencyPerRequestPolicy,
+                                    &model_batch_stats),
+            3);
+}
+
+TEST(ApplyBatchPaddingPolicyTest,
+     MinimizeLatencyPerRequestNoModelStatsReturnsCandidateSize) {
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMinimizeLatencyPerRequestPolicy, nullptr),
+            3);
+}
+
 TEST(ApplyBatchPaddingPolicyTest, UnsupportedPolicy) {
   EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false, "UNSUPPORTED", nullptr),
             3);
@@ -50,11 +50,13 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_STATS_H_
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_STATS_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <optional>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "absl/container/node_hash_map.h"
@@ -69,6 +71,7 @@ namespace tensorflow::serving {
 // Default values for when there is no recorded statistic in ModelBatchStats.
 constexpr int64_t kNumBatchThreadsUnknown = -1;
 constexpr int64_t kBatchTimeoutMicrosUnknown = -1;
+constexpr int64_t kLatencySloMicrosUnknown = -1;
 
 // Tracks the average cost of registered samples.
 //
@@ -115,6 +118,51 @@ class CostTracker {
   absl::Duration sample_sum_ TF_GUARDED_BY(mu_);
 };
 
+// Tracks an exponentially-decaying average of registered latency samples, so
+// that the average follows changes in load and in the serving machine.
+//
+// Thread-safe.
+class LatencyTracker {
+ public:
+  // The weight of the newest sample in the average. With 0.05, the average
+  // is dominated by roughly the last 50 samples.
+  static constexpr double kNewSampleWeight = 0.05;
+
+  // Registers a latency sample.
+  void Register(absl::Duration latency) {
+    DCHECK_GE(latency, absl::ZeroDuration());
+
+    mutex_lock l(mu_);
+    if (sample_count_ == 0) {
+      average_ = latency;
+    } else {
+      average_ += (latency - average_) * kNewSampleWeight;
+    }
+    sample_count_++;
+  }
+
+  // Returns the decaying average of the registered samples.
+  //
+  // Returns std::nullopt if no samples have been registered.
+  std::optional<absl::Duration> mean() const {
+    mutex_lock l(mu_);
+    if (sample_count_ == 0) return std::nullopt;
+    return average_;
+  }
+
+  // Returns the number of registered samples.
+  int64_t sample_count() const {
+    mutex_lock l(mu_);
+    return sample_count_;
+  }
+
+ private:
+  mutable mutex mu_;
+
+  int64_t sample_count_ TF_GUARDED_BY(mu_) = 0;
+  absl::Duration average_ TF_GUARDED_BY(mu_);
+};
+
 // Tracks statistics for a particular model and batch size.
 //
 // Thread-safe.
@@ -122,8 +170,13 @@ class BatchSizeStats {
  public:
   CostTracker& tpu_cost() { return tpu_cost_; };
 
+  // The wall time from the start of processing a batch of this size to the
+  // moment its outputs are ready, as measured by BatchResourceBase.
+  LatencyTracker& processing_latency() { return processing_latency_; };
+
  private:
   CostTracker tpu_cost_;
+  LatencyTracker processing_latency_;
 };
 
 // Tracks statistics for a particular model.
@@ -188,6 +241,32 @@ class ModelBatchStats {
     return batch_timeout_micros_.load(std::memory_order_relaxed);
   }
 
+  // Sets the latency that a request of this model should not exceed. Used by
+  // the MINIMIZE_LATENCY_PER_REQUEST batch padding policy.
+  void SetLatencySloMicros(int64_t latency_slo_micros) {
+    latency_slo_micros_.store(latency_slo_micros, std::memory_order_relaxed);
+  }
+
+  int64_t latency_slo_micros() const {
+    return latency_slo_micros_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the learned batch processing latency curve: the average
+  // processing latency of every batch size that has latency samples, sorted
+  // by batch size.
+  std::vector<std::pair<int32_t, absl::Duration>> LatencyCurve() {
+    std::vector<std::pair<int32_t, absl::Duration>> curve;
+    for (int32_t size : BatchSizes()) {
+      std::optional<absl::Duration> latency =
+          batch_size(size).processing_latency().mean();
+      if (latency.has_value()) {
+        curve.emplace_back(size, *latency);
+      }
+    }
+    std::sort(curve.begin(), curve.end());
+    return curve;
+  }
+
  private:
   mutable mutex mu_;
 
@@ -212,6 +291,9 @@ class ModelBatchStats {
   // The timeout in microseconds for this model (after which the current batch
   // is sent to be processed by the TPU).
   std::atomic<int64_t> batch_timeout_micros_ = kBatchTimeoutMicrosUnknown;
+
+  // The per-request latency objective in microseconds for this model.
+  std::atomic<int64_t> latency_slo_micros_ = kLatencySloMicrosUnknown;
 };
 
 // Tracks batch statistics for all models.
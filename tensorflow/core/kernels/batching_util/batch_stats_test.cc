@@ -25,6 +25,8 @@ limitations under the License.
 namespace tensorflow::serving {
 namespace {
 
+using ::testing::ElementsAre;
+using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
 
 TEST(BatchStatsTest, GlobalBatchStatsRegistryAlwaysReturnsTheSameInstance) {
@@ -69,6 +71,25 @@ TEST(BatchStatsTest, CostTrackerMeanIsCorrect) {
   ASSERT_EQ(*tracker.mean(), absl::Hours(6));
 }
 
+TEST(BatchStatsTest, LatencyTrackerStartsWithNoMean) {
+  LatencyTracker tracker;
+
+  ASSERT_FALSE(tracker.mean().has_value());
+  ASSERT_EQ(tracker.sample_count(), 0);
+}
+
+TEST(BatchStatsTest, LatencyTrackerFollowsRecentSamples) {
+  LatencyTracker tracker;
+  tracker.Register(absl::Milliseconds(100));
+  ASSERT_EQ(*tracker.mean(), absl::Milliseconds(100));
+
+  for (int i = 0; i < 1000; ++i) {
+    tracker.Register(absl::Milliseconds(10));
+  }
+  EXPECT_LT(*tracker.mean(), absl::Milliseconds(11));
+  EXPECT_EQ(tracker.sample_count(), 1001);
+}
+
 TEST(BatchStatsTest, ProcessedSizeIsCorrect) {
   ModelBatchStats stats;
 
@@ -137,6 +158,27 @@ TEST(BatchStatsTest, BatchTimeoutIsCorrect) {
   ASSERT_EQ(stats.batch_timeout_micros(), 100);
 }
 
+TEST(BatchStatsTest, LatencySloIsCorrect) {
+  ModelBatchStats stats;
+
+  // Originally the latency SLO is -1 if unassigned.
+  ASSERT_EQ(stats.latency_slo_micros(), -1);
+
+  stats.SetLatencySloMicros(50000);
+  ASSERT_EQ(stats.latency_slo_micros(), 50000);
+}
+
+TEST(BatchStatsTest, LatencyCurveIsSortedAndSkipsSizesWithoutSamples) {
+  ModelBatchStats stats;
+  stats.batch_size(8).processing_latency().Register(absl::Milliseconds(8));
+  stats.batch_size(2).processing_latency().Register(absl::Milliseconds(3));
+  stats.batch_size(4).tpu_cost().Register(absl::Milliseconds(1));
+
+  ASSERT_THAT(stats.LatencyCurve(),
+              ElementsAre(Pair(2, absl::Milliseconds(3)),
+                          Pair(8, absl::Milliseconds(8))));
+}
+
 TEST(BatchStatsTest, NumBatchThreadsIsCorrect) {
   ModelBatchStats stats;
 
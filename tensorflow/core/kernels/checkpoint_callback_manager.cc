@@ -14,16 +14,22 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/checkpoint_callback_manager.h"
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -106,6 +112,24 @@ void TriggerRestoreCallbackIfFileExists(absl::string_view checkpoint_id,
 
 }  // namespace
 
+CheckpointCallbackManager::~CheckpointCallbackManager() {
+  std::unique_ptr<thread::ThreadPool> async_save_thread;
+  {
+    mutex_lock l(async_mu_);
+    async_save_thread = std::move(async_save_thread_);
+  }
+  // Scheduled saves hold a reference, so none is pending anymore. The last
+  // reference may have been dropped by a save finishing on the background
+  // thread though, which cannot join itself.
+  if (async_save_thread != nullptr &&
+      async_save_thread->CurrentThreadId() >= 0) {
+    Env::Default()->SchedClosure(
+        [async_save_thread = std::move(async_save_thread)]() mutable {
+          async_save_thread.reset();
+        });
+  }
+}
+
 //  Examples:
 //    "/foo/bar/checkpoint-1_temp/part-00000-of-00001" -->
 //        ("checkpoint-1", "/foo/bar");
@@ -260,5 +284,88 @@ void CheckpointCallbackManager::Restore(absl::string_view prefix) {
   }
 }
 
+void CheckpointCallbackManager::EnableAsyncSave(
+    const AsyncSaveOptions& options) {
+  mutex_lock l(async_mu_);
+  async_save_options_ = options;
+  if (async_save_thread_ == nullptr) {
+    async_save_thread_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "async_checkpoint", 1);
+  }
+}
+
+bool CheckpointCallbackManager::IsAsyncSaveEnabled() const {
+  tf_shared_lock l(async_mu_);
+  return async_save_thread_ != nullptr;
+}
+
+void CheckpointCallbackManager::RegisterAsyncSaveDoneCallback(
+    AsyncSaveDoneCallback callback) {
+  mutex_lock l(async_mu_);
+  async_save_done_callbacks_.push_back(std::move(callback));
+}
+
+absl::Status CheckpointCallbackManager::ReserveAsyncSave(int64_t bytes) {
+  mutex_lock l(async_mu_);
+  // Admits a save once it fits, or once nothing else is pending so that a
+  // save larger than the budget cannot wait forever.
+  while (async_save_status_.ok() && bytes > 0 && pending_bytes_ > 0 &&
+         pending_bytes_ + bytes > async_save_options_.max_pending_bytes) {
+    async_cv_.wait(l);
+  }
+  if (!async_save_status_.ok()) {
+    absl::Status status = async_save_status_;
+    async_save_status_ = absl::OkStatus();
+    return status;
+  }
+  pending_bytes_ += bytes;
+  return absl::OkStatus();
+}
+
+void CheckpointCallbackManager::ScheduleAsyncSave(
+    absl::string_view prefix, int64_t bytes,
+    std::function<absl::Status()> write) {
+  mutex_lock l(async_mu_);
+  DCHECK(async_save_thread_ != nullptr);
+  ++num_pending_saves_;
+  // The ops that schedule saves do not wait for them, so the manager is kept
+  // alive until "write" has finished.
+  Ref();
+  async_save_thread_->Schedule([this, prefix = std::string(prefix), bytes,
+                                write = std::move(write)]() {
+    absl::Status status = write();
+    if (!status.ok()) {
+      LOG(WARNING) << "Asynchronous checkpoint save to " << prefix
+                   << " failed: " << status;
+    }
+    std::vector<AsyncSaveDoneCallback> done_callbacks;
+    {
+      tf_shared_lock l(async_mu_);
+      done_callbacks = async_save_done_callbacks_;
+    }
+    for (const AsyncSaveDoneCallback& callback : done_callbacks) {
+      callback(prefix, status);
+    }
+    {
+      mutex_lock l(async_mu_);
+      pending_bytes_ -= bytes;
+      --num_pending_saves_;
+      async_save_status_.Update(status);
+      async_cv_.notify_all();
+    }
+    Unref();
+  });
+}
+
+absl::Status CheckpointCallbackManager::WaitForAsyncSaves() {
+  mutex_lock l(async_mu_);
+  while (num_pending_saves_ > 0) {
+    async_cv_.wait(l);
+  }
+  absl::Status status = async_save_status_;
+  async_save_status_ = absl::OkStatus();
+  return status;
+}
+
 }  // namespace checkpoint
 }  // namespace tensorflow
@@ -15,14 +15,18 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_CHECKPOINT_CALLBACK_MANAGER_H_
 #define TENSORFLOW_CORE_KERNELS_CHECKPOINT_CALLBACK_MANAGER_H_
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/resource_base.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
@@ -43,10 +47,24 @@ using SaveCallback =
 using RestoreCallback =
     std::function<absl::Status(absl::string_view, absl::string_view)>;
 
+// void async_save_done_callback(absl::string_view prefix,
+//                               const absl::Status& status);
+using AsyncSaveDoneCallback =
+    std::function<void(absl::string_view, const absl::Status&)>;
+
+struct AsyncSaveOptions {
+  // Upper bound on the bytes of the inputs held by saves that have not been
+  // written yet, which variable updates copy rather than overwrite.  A save
+  // that does not fit waits for earlier saves to finish; a save larger than
+  // the budget waits for all of them.
+  int64_t max_pending_bytes = int64_t{4} << 30;  // 4GB
+};
+
 // A class to save and restore additional information for checkpointing.
 class CheckpointCallbackManager : public ResourceBase {
  public:
   CheckpointCallbackManager() = default;
+  ~CheckpointCallbackManager() override;
 
   // Not copyable or movable
   CheckpointCallbackManager(const CheckpointCallbackManager&) = delete;
@@ -89,6 +107,36 @@ class CheckpointCallbackManager : public ResourceBase {
   // Should be triggered from RestoreV2()::Compute().
   void Restore(absl::string_view prefix);
 
+  // Enables asynchronous saves: SaveV2 keeps references to its inputs and
+  // returns, and the checkpoint is written on a background thread.  Also
+  // enabled by the first SaveV2 op with "background_write" set.
+  // MergeV2Checkpoints is deferred to the same thread, after the saves it
+  // merges, and RestoreV2 waits for all pending saves first.
+  void EnableAsyncSave(const AsyncSaveOptions& options = AsyncSaveOptions());
+  bool IsAsyncSaveEnabled() const;
+
+  // Registers a callback that is run on the background thread with the
+  // outcome of every asynchronous save or merge.
+  void RegisterAsyncSaveDoneCallback(AsyncSaveDoneCallback callback);
+
+  // Blocks until the snapshots of pending saves leave room for "bytes" more,
+  // then reserves them for a ScheduleAsyncSave() call.  Reserves nothing and
+  // returns the error if an earlier asynchronous save failed since the last
+  // report, so that failures surface at the next save.
+  // REQUIRES: IsAsyncSaveEnabled()
+  absl::Status ReserveAsyncSave(int64_t bytes);
+
+  // Runs "write" on the background thread after all previously scheduled
+  // work, then releases "bytes" reserved by ReserveAsyncSave().  Holds a
+  // reference to this manager until then, so "write" may use it.
+  // REQUIRES: IsAsyncSaveEnabled()
+  void ScheduleAsyncSave(absl::string_view prefix, int64_t bytes,
+                         std::function<absl::Status()> write);
+
+  // Blocks until all scheduled work has finished.  Returns the error of any
+  // asynchronous save that failed since the last report.
+  absl::Status WaitForAsyncSaves();
+
  private:
   mutable mutex mu_;
 
@@ -105,6 +153,21 @@ class CheckpointCallbackManager : public ResourceBase {
 
   std::pair<std::string, std::string> last_saved_checkpoint_id_and_dir_
       TF_GUARDED_BY(mu_);
+
+  // State of asynchronous saves.  Kept apart from mu_, which callbacks of
+  // the background writes acquire.
+  mutable mutex async_mu_;
+  condition_variable async_cv_;
+  AsyncSaveOptions async_save_options_ TF_GUARDED_BY(async_mu_);
+  std::vector<AsyncSaveDoneCallback> async_save_done_callbacks_
+      TF_GUARDED_BY(async_mu_);
+  int64_t pending_bytes_ TF_GUARDED_BY(async_mu_) = 0;
+  int num_pending_saves_ TF_GUARDED_BY(async_mu_) = 0;
+  absl::Status async_save_status_ TF_GUARDED_BY(async_mu_);
+  // Single background thread, so that saves and merges run in order.
+  // Non-null iff asynchronous saves are enabled.
+  std::unique_ptr<thread::ThreadPool> async_save_thread_
+      TF_GUARDED_BY(async_mu_);
 };
 
 }  // namespace checkpoint
@@ -14,11 +14,17 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/checkpoint_callback_manager.h"
 
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "tensorflow/core/framework/resource_handle.h"
 #include "tensorflow/core/platform/env.h"
@@ -330,6 +336,103 @@ TEST_F(CheckpointCallbackManagerTest, RestoreLazyCallback) {
   EXPECT_EQ(callback_call_count, 1);
 }
 
+TEST_F(CheckpointCallbackManagerTest, AsyncSavesRunInOrder) {
+  EXPECT_FALSE(checkpoint_callback_manager_->IsAsyncSaveEnabled());
+  checkpoint_callback_manager_->EnableAsyncSave();
+  EXPECT_TRUE(checkpoint_callback_manager_->IsAsyncSaveEnabled());
+
+  std::vector<std::string> written;
+  std::vector<std::string> done;
+  checkpoint_callback_manager_->RegisterAsyncSaveDoneCallback(
+      [&done](absl::string_view prefix, const absl::Status& status) {
+        TF_EXPECT_OK(status);
+        done.emplace_back(prefix);
+      });
+  for (const std::string prefix : {"a", "b", "c"}) {
+    TF_ASSERT_OK(checkpoint_callback_manager_->ReserveAsyncSave(1));
+    checkpoint_callback_manager_->ScheduleAsyncSave(prefix, 1,
+                                                    [&written, prefix]() {
+                                                      written.push_back(prefix);
+                                                      return absl::OkStatus();
+                                                    });
+  }
+  TF_ASSERT_OK(checkpoint_callback_manager_->WaitForAsyncSaves());
+  EXPECT_THAT(written, ::testing::ElementsAre("a", "b", "c"));
+  EXPECT_THAT(done, ::testing::ElementsAre("a", "b", "c"));
+}
+
+TEST_F(CheckpointCallbackManagerTest, AsyncSaveFailureIsReported) {
+  AsyncSaveOptions options;
+  options.max_pending_bytes = 10;
+  checkpoint_callback_manager_->EnableAsyncSave(options);
+
+  TF_ASSERT_OK(checkpoint_callback_manager_->ReserveAsyncSave(10));
+  checkpoint_callback_manager_->ScheduleAsyncSave(
+      "a", 10, []() { return absl::DataLossError("disk full"); });
+  // Waits for the failed save to release its budget, then reports it.
+  EXPECT_TRUE(
+      absl::IsDataLoss(checkpoint_callback_manager_->ReserveAsyncSave(10)));
+  // The failure is reported once.
+  TF_ASSERT_OK(checkpoint_callback_manager_->ReserveAsyncSave(10));
+  checkpoint_callback_manager_->ScheduleAsyncSave(
+      "b", 10, []() { return absl::OkStatus(); });
+  TF_EXPECT_OK(checkpoint_callback_manager_->WaitForAsyncSaves());
+
+  checkpoint_callback_manager_->ScheduleAsyncSave(
+      "c", 0, []() { return absl::DataLossError("disk full"); });
+  EXPECT_TRUE(
+      absl::IsDataLoss(checkpoint_callback_manager_->WaitForAsyncSaves()));
+}
+
+TEST_F(CheckpointCallbackManagerTest, AsyncSaveBackpressure) {
+  AsyncSaveOptions options;
+  options.max_pending_bytes = 10;
+  checkpoint_callback_manager_->EnableAsyncSave(options);
+
+  absl::Notification release_first_save;
+  TF_ASSERT_OK(checkpoint_callback_manager_->ReserveAsyncSave(8));
+  checkpoint_callback_manager_->ScheduleAsyncSave(
+      "first", 8, [&release_first_save]() {
+        release_first_save.WaitForNotification();
+        return absl::OkStatus();
+      });
+
+  // A second save does not fit next to the first one, so it waits.
+  absl::Notification second_save_admitted;
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      {}, "second_save", [this, &second_save_admitted]() {
+        TF_EXPECT_OK(checkpoint_callback_manager_->ReserveAsyncSave(8));
+        second_save_admitted.Notify();
+        checkpoint_callback_manager_->ScheduleAsyncSave(
+            "second", 8, []() { return absl::OkStatus(); });
+      }));
+  EXPECT_FALSE(second_save_admitted.WaitForNotificationWithTimeout(
+      absl::Milliseconds(100)));
+
+  release_first_save.Notify();
+  second_save_admitted.WaitForNotification();
+  thread.reset();
+  TF_EXPECT_OK(checkpoint_callback_manager_->WaitForAsyncSaves());
+}
+
+TEST(CheckpointCallbackManagerAsyncTest, PendingSaveOutlivesLastReference) {
+  auto* manager = new CheckpointCallbackManager();
+  manager->EnableAsyncSave();
+  absl::Notification release_save;
+  absl::Notification saved;
+  TF_ASSERT_OK(manager->ReserveAsyncSave(1));
+  manager->ScheduleAsyncSave("a", 1, [manager, &release_save, &saved]() {
+    release_save.WaitForNotification();
+    // The manager is still usable, although the caller dropped it.
+    EXPECT_TRUE(manager->IsAsyncSaveEnabled());
+    saved.Notify();
+    return absl::OkStatus();
+  });
+  manager->Unref();
+  release_save.Notify();
+  saved.WaitForNotification();
+}
+
 }  // namespace
 }  // namespace checkpoint
 }  // namespace tensorflow
@@ -0,0 +1,110 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_CSV_UTIL_H_
+#define TENSORFLOW_CORE_KERNELS_CSV_UTIL_H_
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#define CSV_UTIL_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define CSV_UTIL_USE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace tensorflow {
+namespace csv {
+
+// Classifies the bytes of CSV input that end or interrupt a field: the field
+// delimiter, the quote character (if quotes are enabled) and CR/LF.
+//
+// FindSpecial() compares 16 bytes at a time against all special characters
+// and turns the result into a bitmask, in the style of simdjson, so that the
+// body of a field is skipped without looking at every byte individually.
+class SpecialCharFinder {
+ public:
+  SpecialCharFinder(char delim, bool use_quote_delim)
+      : delim_(delim), quote_(use_quote_delim ? '"' : '\n') {}
+
+  // Returns a pointer to the first special character in [begin, end), or
+  // `end` if there is none.
+  const char* FindSpecial(const char* begin, const char* end) const {
+    const char* p = begin;
+#if defined(CSV_UTIL_USE_SSE2)
+    const __m128i delim = _mm_set1_epi8(delim_);
+    const __m128i quote = _mm_set1_epi8(quote_);
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    for (; end - p >= 16; p += 16) {
+      const __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const __m128i matches = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, delim),
+                       _mm_cmpeq_epi8(chunk, quote)),
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr)));
+      const uint32_t mask = _mm_movemask_epi8(matches);
+      if (mask != 0) return p + __builtin_ctz(mask);
+    }
+#elif defined(CSV_UTIL_USE_NEON)
+    const uint8x16_t delim = vdupq_n_u8(delim_);
+    const uint8x16_t quote = vdupq_n_u8(quote_);
+    const uint8x16_t lf = vdupq_n_u8('\n');
+    const uint8x16_t cr = vdupq_n_u8('\r');
+    for (; end - p >= 16; p += 16) {
+      const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+      const uint8x16_t matches =
+          vorrq_u8(vorrq_u8(vceqq_u8(chunk, delim), vceqq_u8(chunk, quote)),
+                   vorrq_u8(vceqq_u8(chunk, lf), vceqq_u8(chunk, cr)));
+      // Narrow each byte of the comparison result to 4 bits of a 64-bit mask.
+      const uint64_t mask = vget_lane_u64(
+          vreinterpret_u64_u8(
+              vshrn_n_u16(vreinterpretq_u16_u8(matches), /*n=*/4)),
+          0);
+      if (mask != 0) return p + (__builtin_ctzll(mask) >> 2);
+    }
+#endif
+    for (; p < end; ++p) {
+      if (IsSpecial(*p)) return p;
+    }
+    return end;
+  }
+
+  bool IsSpecial(char c) const {
+    return c == delim_ || c == quote_ || c == '\n' || c == '\r';
+  }
+
+ private:
+  const char delim_;
+  // '\n' when quotes are disabled, so that a quote is not special.
+  const char quote_;
+};
+
+// Returns a pointer to the first '"' in [begin, end), or `end` if there is
+// none.
+inline const char* FindQuote(const char* begin, const char* end) {
+  const void* found = std::memchr(begin, '"', end - begin);
+  return found == nullptr ? end : static_cast<const char*>(found);
+}
+
+}  // namespace csv
+}  // namespace tensorflow
+
+#undef CSV_UTIL_USE_SSE2
+#undef CSV_UTIL_USE_NEON
+
+#endif  // TENSORFLOW_CORE_KERNELS_CSV_UTIL_H_
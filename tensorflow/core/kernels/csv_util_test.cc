@@ -0,0 +1,78 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/csv_util.h"
+
+#include <string>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace csv {
+namespace {
+
+// Returns the offset of the first special character in `s`, checking that it
+// agrees with a byte-by-byte scan.
+size_t FindSpecialOffset(const SpecialCharFinder& finder,
+                         const std::string& s) {
+  size_t expected = 0;
+  while (expected < s.size() && !finder.IsSpecial(s[expected])) ++expected;
+  const size_t offset =
+      finder.FindSpecial(s.data(), s.data() + s.size()) - s.data();
+  EXPECT_EQ(expected, offset) << s;
+  return offset;
+}
+
+TEST(CsvUtilTest, FindSpecial) {
+  const SpecialCharFinder finder(',', /*use_quote_delim=*/true);
+  EXPECT_EQ(0, FindSpecialOffset(finder, ""));
+  EXPECT_EQ(3, FindSpecialOffset(finder, "abc"));
+  EXPECT_EQ(3, FindSpecialOffset(finder, "abc,def"));
+  EXPECT_EQ(1, FindSpecialOffset(finder, "a\"bc"));
+  EXPECT_EQ(2, FindSpecialOffset(finder, "ab\ncd"));
+  EXPECT_EQ(2, FindSpecialOffset(finder, "ab\r\ncd"));
+}
+
+TEST(CsvUtilTest, FindSpecialAtEveryOffset) {
+  // Covers both the vectorized body and the scalar tail.
+  for (const char special : {';', '"', '\n', '\r'}) {
+    const SpecialCharFinder finder(';', /*use_quote_delim=*/true);
+    for (int len = 0; len < 70; ++len) {
+      for (int i = 0; i < len; ++i) {
+        std::string s(len, 'x');
+        s[i] = special;
+        EXPECT_EQ(i, FindSpecialOffset(finder, s));
+      }
+      EXPECT_EQ(len, FindSpecialOffset(finder, std::string(len, 'x')));
+    }
+  }
+}
+
+TEST(CsvUtilTest, QuoteIsNotSpecialWithoutQuoteDelim) {
+  const SpecialCharFinder finder('|', /*use_quote_delim=*/false);
+  EXPECT_FALSE(finder.IsSpecial('"'));
+  EXPECT_TRUE(finder.IsSpecial('|'));
+  EXPECT_EQ(21, FindSpecialOffset(finder, "\"quoted\" \"and more\" \"|"));
+}
+
+TEST(CsvUtilTest, FindQuote) {
+  const std::string s = "abcdefghijklmnopqrstuvwxyz\"";
+  EXPECT_EQ(s.data() + 26, FindQuote(s.data(), s.data() + s.size()));
+  EXPECT_EQ(s.data() + 20, FindQuote(s.data(), s.data() + 20));
+}
+
+}  // namespace
+}  // namespace csv
+}  // namespace tensorflow
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/kernels/csv_util.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
@@ -516,7 +517,7 @@ class CSVDatasetOp : public DatasetOpKernel {
         pos_++;  // Starting quotation mark
 
         absl::Status parse_result;
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        while (true) {  // Each iter skips to the next quote, refilling buffer
           if (pos_ >= buffer_.size()) {
             absl::Status s =
                 SaveAndFillBuffer(&earlier_pieces, &start, include);
@@ -529,8 +530,11 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
-          char ch = buffer_[pos_];
-          if (ch == '"') {
+          // Only quotes are interesting inside a quoted field.
+          pos_ = csv::FindQuote(buffer_.data() + pos_,
+                                buffer_.data() + buffer_.size()) -
+                 buffer_.data();
+          if (pos_ < buffer_.size()) {
             // When we encounter a quote, we look ahead to the next character to
             // decide what to do
             pos_++;
@@ -571,9 +575,6 @@ class CSVDatasetOp : public DatasetOpKernel {
               parse_result.Update(absl::InvalidArgumentError(
                   "Quote inside a string has to be escaped by another quote"));
             }
-
-          } else {
-            pos_++;
           }
         }
       }
@@ -650,11 +651,13 @@ class CSVDatasetOp : public DatasetOpKernel {
                                       std::vector<Tensor>* out_tensors,
                                       bool* end_of_record, bool include)
           TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const csv::SpecialCharFinder finder(dataset()->delim_,
+                                            dataset()->use_quote_delim_);
         std::vector<Piece> earlier_pieces;
         size_t start = pos_;
         absl::Status parse_result;
 
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        while (true) {  // Each iter skips to the next delim, quote or CRLF
           if (pos_ >= buffer_.size()) {
             absl::Status s =
                 SaveAndFillBuffer(&earlier_pieces, &start, include);
@@ -671,6 +674,10 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
+          pos_ = finder.FindSpecial(buffer_.data() + pos_,
+                                    buffer_.data() + buffer_.size()) -
+                 buffer_.data();
+          if (pos_ >= buffer_.size()) continue;
           char ch = buffer_[pos_];
 
           if (ch == dataset()->delim_) {
@@ -34,13 +34,32 @@ limitations under the License.
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/stringprintf.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/snapshot.pb.h"
 
 namespace tensorflow {
 namespace data {
 namespace experimental {
+namespace {
+
+// Returns the pool that compresses the files of all shards of a save on
+// `compression_threads` threads, in addition to the writer threads, or nullptr
+// if each file is compressed by its writer thread. Compressed files are then
+// written as independently compressed blocks (see
+// `io::RecordWriterOptions::compression_threads`).
+std::unique_ptr<thread::ThreadPool> MakeCompressionPool(
+    Env* env, int64_t compression_threads) {
+  if (compression_threads <= 1) return nullptr;
+  return std::make_unique<thread::ThreadPool>(
+      env, "tf_data_save_compression",
+      static_cast<int>(
+          std::min<int64_t>(compression_threads, port::MaxParallelism())));
+}
+
+}  // namespace
 
 /* static */ constexpr const char* const SaveDatasetOp::kCompression;
+/* static */ constexpr const char* const SaveDatasetOp::kCompressionThreads;
 /* static */ constexpr const char* const SaveDatasetOp::kPath;
 /* static */ constexpr const char* const SaveDatasetOp::kShardFunc;
 /* static */ constexpr const char* const SaveDatasetOp::kShardFuncOtherArgs;
@@ -49,6 +68,7 @@ namespace experimental {
 /* static */ constexpr const char* const SaveDatasetV2Op::kInputDataset;
 /* static */ constexpr const char* const SaveDatasetV2Op::kPath;
 /* static */ constexpr const char* const SaveDatasetV2Op::kCompression;
+/* static */ constexpr const char* const SaveDatasetV2Op::kCompressionThreads;
 /* static */ constexpr const char* const SaveDatasetV2Op::kDatasetType;
 /* static */ constexpr const char* const SaveDatasetV2Op::kOutputTypes;
 /* static */ constexpr const char* const SaveDatasetV2Op::kOutputShapes;
@@ -64,6 +84,7 @@ SaveDatasetOp::SaveDatasetOp(OpKernelConstruction* ctx)
   OP_REQUIRES_OK(ctx, FunctionMetadata::Create(ctx, kShardFunc, /*params=*/{},
                                                &func_metadata_));
   OP_REQUIRES_OK(ctx, ctx->GetAttr(kUseShardFunc, &use_shard_func_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kCompressionThreads, &compression_threads_));
 }
 
 absl::Status SaveDatasetOp::DoCompute(OpKernelContext* ctx) {
@@ -122,6 +143,9 @@ absl::Status SaveDatasetOp::WriteData(
 
   mutex mu;
   absl::Status status;
+  // Declared before the writers, which use it until they are destroyed.
+  std::unique_ptr<thread::ThreadPool> compression_pool =
+      MakeCompressionPool(ctx->env(), compression_threads_);
   absl::flat_hash_map<int64_t, std::unique_ptr<snapshot_util::AsyncWriter>>
       writers;
   while (true) {
@@ -148,10 +172,12 @@ absl::Status SaveDatasetOp::WriteData(
       auto writer_thread = std::make_unique<snapshot_util::AsyncWriter>(
           ctx->env(), shard_index, snapshot_shard_directory,
           /*checkpoint_id=*/0, compression_, kFileFormatVersion,
-          finalized_dataset->output_dtypes(), [&mu, &status](absl::Status s) {
+          finalized_dataset->output_dtypes(),
+          [&mu, &status](absl::Status s) {
             mutex_lock l(mu);
             status.Update(s);
-          });
+          },
+          compression_pool.get());
       writers.insert({shard_index, std::move(writer_thread)});
     }
     writers[shard_index]->Write(element);
@@ -208,13 +234,15 @@ class SaveDatasetV2Op::Dataset : public DatasetBase {
  public:
   Dataset(OpKernelContext* ctx, const DatasetBase* input, const tstring& path,
           const std::string& compression,
-          std::unique_ptr<CapturedFunction> shard_func, bool use_shard_func)
+          std::unique_ptr<CapturedFunction> shard_func, bool use_shard_func,
+          int64_t compression_threads)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
         path_(path),
         compression_(compression),
         shard_func_(std::move(shard_func)),
-        use_shard_func_(use_shard_func) {
+        use_shard_func_(use_shard_func),
+        compression_threads_(compression_threads) {
     input_->Ref();
   }
 
@@ -284,6 +312,10 @@ class SaveDatasetV2Op::Dataset : public DatasetBase {
     b->BuildAttrValue(shard_func_other_args_types,
                       &shard_func_arguments_types_attr);
 
+    // Attr: compression_threads
+    AttrValue compression_threads_attr;
+    b->BuildAttrValue(compression_threads_, &compression_threads_attr);
+
     TF_RETURN_IF_ERROR(b->AddDataset(
         this,
         /*inputs=*/
@@ -294,7 +326,8 @@ class SaveDatasetV2Op::Dataset : public DatasetBase {
         {std::make_pair(kCompression, compression_attr),
          std::make_pair(kShardFunc, shard_func_attr),
          std::make_pair(kUseShardFunc, use_shard_func_attr),
-         std::make_pair(kShardFuncTarguments, shard_func_arguments_types_attr)},
+         std::make_pair(kShardFuncTarguments, shard_func_arguments_types_attr),
+         std::make_pair(kCompressionThreads, compression_threads_attr)},
         output));
 
     return absl::OkStatus();
@@ -323,6 +356,8 @@ class SaveDatasetV2Op::Dataset : public DatasetBase {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(
           dataset()->shard_func_->Instantiate(ctx, &instantiated_shard_func_));
+      compression_pool_ =
+          MakeCompressionPool(ctx->env(), dataset()->compression_threads_);
 
       // If we are restoring from a checkpointed iterator, we initialize
       // the run directory within the RestoreInternal method.
@@ -391,7 +426,8 @@ class SaveDatasetV2Op::Dataset : public DatasetBase {
                   mutex_lock l(writer_status_mu_);
                   writer_status_ = s;
                 }
-              });
+              },
+              compression_pool_.get());
           writers_.insert({shard_index, std::move(writer)});
         }
         current_writer = writers_[shard_index].get();
@@ -498,6 +534,9 @@ class SaveDatasetV2Op::Dataset : public DatasetBase {
     std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
     int64_t num_elements_;
 
+    // Shared by the writers of all shards, and declared before them since
+    // they use it until they are destroyed.
+    std::unique_ptr<thread::ThreadPool> compression_pool_ TF_GUARDED_BY(mu_);
     absl::flat_hash_map<int64_t, std::unique_ptr<snapshot_util::AsyncWriter>>
         writers_ TF_GUARDED_BY(mu_);
     absl::Status writer_status_ TF_GUARDED_BY(writer_status_mu_);
@@ -516,6 +555,7 @@ class SaveDatasetV2Op::Dataset : public DatasetBase {
   const std::string compression_;
   const std::unique_ptr<CapturedFunction> shard_func_;
   const bool use_shard_func_;
+  const int64_t compression_threads_;
   const DataTypeVector output_types_;
   const std::vector<PartialTensorShape> output_shapes_;
   const std::shared_ptr<FunctionMetadata> func_metadata_;
@@ -530,6 +570,7 @@ SaveDatasetV2Op::SaveDatasetV2Op(OpKernelConstruction* ctx)
   OP_REQUIRES_OK(ctx, ctx->GetAttr(kUseShardFunc, &use_shard_func_));
   OP_REQUIRES_OK(ctx, FunctionMetadata::Create(ctx, kShardFunc, /*params=*/{},
                                                &func_metadata_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kCompressionThreads, &compression_threads_));
 }
 
 void SaveDatasetV2Op::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
@@ -546,7 +587,7 @@ void SaveDatasetV2Op::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
                                     &shard_func));
 
   *output = new Dataset(ctx, dataset, path, compression_, std::move(shard_func),
-                        use_shard_func_);
+                        use_shard_func_, compression_threads_);
 }
 
 namespace {
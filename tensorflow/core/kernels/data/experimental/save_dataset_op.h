@@ -34,6 +34,8 @@ namespace experimental {
 class SaveDatasetOp : public HybridAsyncOpKernel {
  public:
   static constexpr const char* const kCompression = "compression";
+  static constexpr const char* const kCompressionThreads =
+      "compression_threads";
   static constexpr const char* const kPath = "path";
   static constexpr const char* const kShardFunc = "shard_func";
   static constexpr const char* const kShardFuncOtherArgs =
@@ -65,6 +67,7 @@ class SaveDatasetOp : public HybridAsyncOpKernel {
 
   bool use_shard_func_;
   std::string compression_;
+  int64_t compression_threads_;
   std::shared_ptr<FunctionMetadata> func_metadata_;
 };
 
@@ -76,6 +79,8 @@ class SaveDatasetV2Op : public UnaryDatasetOpKernel {
   static constexpr const char* const kInputDataset = "input_dataset";
   static constexpr const char* const kPath = "path";
   static constexpr const char* const kCompression = "compression";
+  static constexpr const char* const kCompressionThreads =
+      "compression_threads";
 
   static constexpr const char* const kDatasetType = "SaveV2";
   static constexpr const char* const kOutputTypes = "output_types";
@@ -101,6 +106,7 @@ class SaveDatasetV2Op : public UnaryDatasetOpKernel {
   std::string compression_;
   std::unique_ptr<CapturedFunction> shard_func_;
   bool use_shard_func_;
+  int64_t compression_threads_;
   DataTypeVector output_types_;
   std::vector<PartialTensorShape> output_shapes_;
   std::shared_ptr<FunctionMetadata> func_metadata_;
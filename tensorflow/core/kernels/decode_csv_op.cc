@@ -14,13 +14,18 @@ limitations under the License.
 ==============================================================================*/
 
 // See docs in ../ops/parsing_ops.cc.
+#include <deque>
 #include <vector>
+
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/csv_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -81,121 +86,37 @@ class DecodeCSVOp : public OpKernel {
       OP_REQUIRES_OK(ctx, output.allocate(i, records->shape(), &out));
     }
 
-    for (int64_t i = 0; i < records_size; ++i) {
-      const absl::string_view record(records_t(i));
-      std::vector<string> fields;
-      ExtractFields(ctx, record, &fields);
-      OP_REQUIRES(ctx, fields.size() == out_type_.size(),
-                  errors::InvalidArgument("Expect ", out_type_.size(),
-                                          " fields but have ", fields.size(),
-                                          " in record ", i));
-
-      // Check each field in the record
-      for (int f = 0; f < static_cast<int>(out_type_.size()); ++f) {
-        const DataType& dtype = out_type_[f];
-        switch (dtype) {
-          case DT_INT32: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-
-              output[f]->flat<int32>()(i) = record_defaults[f].flat<int32>()(0);
-            } else {
-              int32_t value;
-              OP_REQUIRES(ctx, absl::SimpleAtoi(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid int32: ", fields[f]));
-              output[f]->flat<int32>()(i) = value;
-            }
-            break;
-          }
-          case DT_INT64: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-
-              output[f]->flat<int64_t>()(i) =
-                  record_defaults[f].flat<int64_t>()(0);
-            } else {
-              int64_t value;
-              OP_REQUIRES(ctx, absl::SimpleAtoi(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid int64: ", fields[f]));
-              output[f]->flat<int64_t>()(i) = value;
-            }
-            break;
-          }
-          case DT_FLOAT: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-              output[f]->flat<float>()(i) = record_defaults[f].flat<float>()(0);
-            } else {
-              float value;
-              OP_REQUIRES(ctx, absl::SimpleAtof(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid float: ", fields[f]));
-              output[f]->flat<float>()(i) = value;
-            }
-            break;
+    // Records are parsed independently, so they are split across the
+    // intra-op threads. Each shard stops at its first bad record and the error
+    // of the lowest failing record is reported, matching a serial scan.
+    mutex mu;
+    int64_t first_error_record = records_size;
+    absl::Status first_error;
+    auto parse_records = [&](int64_t start, int64_t limit) {
+      std::vector<absl::string_view> fields;
+      std::deque<string> unescaped;
+      for (int64_t i = start; i < limit; ++i) {
+        fields.clear();
+        unescaped.clear();
+        absl::Status s = ParseRecord(records_t(i), i, record_defaults, &fields,
+                                     &unescaped, &output);
+        if (!s.ok()) {
+          mutex_lock l(mu);
+          if (i < first_error_record) {
+            first_error_record = i;
+            first_error = std::move(s);
           }
-          case DT_DOUBLE: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-              output[f]->flat<double>()(i) =
-                  record_defaults[f].flat<double>()(0);
-            } else {
-              double value;
-              OP_REQUIRES(ctx, absl::SimpleAtod(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid double: ", fields[f]));
-              output[f]->flat<double>()(i) = value;
-            }
-            break;
-          }
-          case DT_STRING: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-              output[f]->flat<tstring>()(i) =
-                  record_defaults[f].flat<tstring>()(0);
-            } else {
-              output[f]->flat<tstring>()(i) = std::move(fields[f]);
-            }
-            break;
-          }
-          default:
-            OP_REQUIRES(ctx, false,
-                        errors::InvalidArgument("csv: data type ", dtype,
-                                                " not supported in field ", f));
+          return;
         }
       }
-    }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *(ctx->device()->tensorflow_cpu_worker_threads());
+    const int64_t cost_per_record =
+        records_size == 0 ? 0 : records->TotalBytes() / records_size * 10;
+    Shard(worker_threads.num_threads, worker_threads.workers, records_size,
+          cost_per_record, parse_records);
+    OP_REQUIRES_OK(ctx, first_error);
   }
 
  private:
@@ -206,8 +127,111 @@ class DecodeCSVOp : public OpKernel {
   bool select_all_cols_;
   string na_value_;
 
-  void ExtractFields(OpKernelContext* ctx, absl::string_view input,
-                     std::vector<string>* result) {
+  // Parses record `i` into the outputs. Fields that contain escaped quotes
+  // are unescaped into `unescaped`; all other fields point into `record`.
+  absl::Status ParseRecord(absl::string_view record, int64_t i,
+                           const OpInputList& record_defaults,
+                           std::vector<absl::string_view>* fields,
+                           std::deque<string>* unescaped,
+                           OpOutputList* output) {
+    TF_RETURN_IF_ERROR(ExtractFields(record, fields, unescaped));
+    if (fields->size() != out_type_.size()) {
+      return errors::InvalidArgument("Expect ", out_type_.size(),
+                                     " fields but have ", fields->size(),
+                                     " in record ", i);
+    }
+
+    // Check each field in the record
+    for (int f = 0; f < static_cast<int>(out_type_.size()); ++f) {
+      const absl::string_view field = (*fields)[f];
+      const DataType& dtype = out_type_[f];
+      // If this field is empty or NA value, check if default is given:
+      // If yes, use default value; Otherwise report error.
+      if (field.empty() || field == na_value_) {
+        if (record_defaults[f].NumElements() != 1) {
+          return errors::InvalidArgument(
+              "Field ", f, " is required but missing in record ", i, "!");
+        }
+        switch (dtype) {
+          case DT_INT32:
+            (*output)[f]->flat<int32>()(i) =
+                record_defaults[f].flat<int32>()(0);
+            break;
+          case DT_INT64:
+            (*output)[f]->flat<int64_t>()(i) =
+                record_defaults[f].flat<int64_t>()(0);
+            break;
+          case DT_FLOAT:
+            (*output)[f]->flat<float>()(i) =
+                record_defaults[f].flat<float>()(0);
+            break;
+          case DT_DOUBLE:
+            (*output)[f]->flat<double>()(i) =
+                record_defaults[f].flat<double>()(0);
+            break;
+          case DT_STRING:
+            (*output)[f]->flat<tstring>()(i) =
+                record_defaults[f].flat<tstring>()(0);
+            break;
+          default:
+            return errors::InvalidArgument("csv: data type ", dtype,
+                                           " not supported in field ", f);
+        }
+        continue;
+      }
+      switch (dtype) {
+        case DT_INT32: {
+          int32_t value;
+          if (!absl::SimpleAtoi(field, &value)) {
+            return errors::InvalidArgument("Field ", f, " in record ", i,
+                                           " is not a valid int32: ", field);
+          }
+          (*output)[f]->flat<int32>()(i) = value;
+          break;
+        }
+        case DT_INT64: {
+          int64_t value;
+          if (!absl::SimpleAtoi(field, &value)) {
+            return errors::InvalidArgument("Field ", f, " in record ", i,
+                                           " is not a valid int64: ", field);
+          }
+          (*output)[f]->flat<int64_t>()(i) = value;
+          break;
+        }
+        case DT_FLOAT: {
+          float value;
+          if (!absl::SimpleAtof(field, &value)) {
+            return errors::InvalidArgument("Field ", f, " in record ", i,
+                                           " is not a valid float: ", field);
+          }
+          (*output)[f]->flat<float>()(i) = value;
+          break;
+        }
+        case DT_DOUBLE: {
+          double value;
+          if (!absl::SimpleAtod(field, &value)) {
+            return errors::InvalidArgument("Field ", f, " in record ", i,
+                                           " is not a valid double: ", field);
+          }
+          (*output)[f]->flat<double>()(i) = value;
+          break;
+        }
+        case DT_STRING:
+          (*output)[f]->flat<tstring>()(i).assign(field.data(), field.size());
+          break;
+        default:
+          return errors::InvalidArgument("csv: data type ", dtype,
+                                         " not supported in field ", f);
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status ExtractFields(absl::string_view input,
+                             std::vector<absl::string_view>* result,
+                             std::deque<string>* unescaped) {
+    const csv::SpecialCharFinder finder(delim_, use_quote_delim_);
+    const char* const input_end = input.data() + input.size();
     int64_t current_idx = 0;
     int64_t num_fields_parsed = 0;
     int64_t selector_idx = 0;  // Keep track of index into select_cols
@@ -230,57 +254,69 @@ class DecodeCSVOp : public OpKernel {
         }
 
         // This is the body of the field;
-        string field;
+        absl::string_view field;
         if (!quoted) {
-          while (static_cast<size_t>(current_idx) < input.size() &&
-                 input[current_idx] != delim_) {
-            OP_REQUIRES(ctx,
-                        (!use_quote_delim_ || input[current_idx] != '"') &&
-                            input[current_idx] != '\n' &&
-                            input[current_idx] != '\r',
-                        errors::InvalidArgument(
-                            "Unquoted fields cannot have quotes/CRLFs inside"));
-            if (include) field += input[current_idx];
-            current_idx++;
+          // The field ends at the first special character, which must be the
+          // delimiter or the end of the input.
+          const int64_t field_end =
+              finder.FindSpecial(input.data() + current_idx, input_end) -
+              input.data();
+          if (static_cast<size_t>(field_end) < input.size() &&
+              input[field_end] != delim_) {
+            return errors::InvalidArgument(
+                "Unquoted fields cannot have quotes/CRLFs inside");
           }
+          field = input.substr(current_idx, field_end - current_idx);
 
           // Go to next field or the end
-          current_idx++;
+          current_idx = field_end + 1;
         } else if (use_quote_delim_) {
-          // Quoted field needs to be ended with '"' and delim or end
-          while (
-              (static_cast<size_t>(current_idx) < input.size() - 1) &&
-              (input[current_idx] != '"' || input[current_idx + 1] != delim_)) {
-            if (input[current_idx] != '"') {
-              if (include) field += input[current_idx];
-              current_idx++;
-            } else {
-              OP_REQUIRES(
-                  ctx, input[current_idx + 1] == '"',
-                  errors::InvalidArgument("Quote inside a string has to be "
-                                          "escaped by another quote"));
-              if (include) field += '"';
-              current_idx += 2;
+          // Quoted field needs to be ended with '"' and delim or end. Escaped
+          // quotes are only unescaped into a copy if the field has any.
+          string* field_copy = nullptr;
+          while (true) {
+            const int64_t quote_idx =
+                csv::FindQuote(input.data() + current_idx, input_end) -
+                input.data();
+            if (static_cast<size_t>(quote_idx) == input.size()) {
+              return errors::InvalidArgument(
+                  "Quoted field has to end with quote followed by delim or "
+                  "end");
+            }
+            const absl::string_view chunk =
+                input.substr(current_idx, quote_idx - current_idx);
+            if (static_cast<size_t>(quote_idx) == input.size() - 1 ||
+                input[quote_idx + 1] == delim_) {
+              // The closing quote.
+              if (field_copy == nullptr) {
+                field = chunk;
+              } else {
+                if (include) field_copy->append(chunk.data(), chunk.size());
+                field = *field_copy;
+              }
+              current_idx = quote_idx + 2;
+              break;
+            }
+            if (input[quote_idx + 1] != '"') {
+              return errors::InvalidArgument(
+                  "Quote inside a string has to be escaped by another quote");
             }
+            // An escaped quote; keep the first of the pair.
+            if (include) {
+              if (field_copy == nullptr) {
+                field_copy = &unescaped->emplace_back();
+              }
+              field_copy->append(chunk.data(), chunk.size() + 1);
+            }
+            current_idx = quote_idx + 2;
           }
-
-          OP_REQUIRES(
-              ctx,
-              (static_cast<size_t>(current_idx) < input.size() &&
-               input[current_idx] == '"' &&
-               (static_cast<size_t>(current_idx) == input.size() - 1 ||
-                input[current_idx + 1] == delim_)),
-              errors::InvalidArgument("Quoted field has to end with quote "
-                                      "followed by delim or end"));
-
-          current_idx += 2;
         }
 
         num_fields_parsed++;
         if (include) {
           result->push_back(field);
           selector_idx++;
-          if (selector_idx == select_cols_.size()) return;
+          if (selector_idx == select_cols_.size()) return absl::OkStatus();
         }
       }
 
@@ -289,8 +325,9 @@ class DecodeCSVOp : public OpKernel {
                                    static_cast<size_t>(num_fields_parsed));
       // Check if the last field is missing
       if (include && input[input.size() - 1] == delim_)
-        result->push_back(string());
+        result->push_back(absl::string_view());
     }
+    return absl::OkStatus();
   }
 };
 
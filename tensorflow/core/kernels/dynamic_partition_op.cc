@@ -15,6 +15,8 @@ limitations under the License.
 
 // See docs in ../ops/data_flow_ops.cc.
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -26,9 +28,14 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
+// Inputs with fewer than this many elements are partitioned on the calling
+// thread; below it the cost of scheduling work dominates the copy.
+constexpr int64_t kMinElementsPerBlock = 1 << 15;
+
 // Shared code that is not dependent on the type of T.  We do this to reduce
 // code size by not duplicating all this for all T (float, double, int32, etc.)
 class DynamicPartitionOp_Shared : public OpKernel {
@@ -42,9 +49,17 @@ class DynamicPartitionOp_Shared : public OpKernel {
     //   in the graph?
   }
 
+  // Validates the inputs and allocates the outputs.
+  //
+  // The rows of `data` are split into `*num_blocks` contiguous blocks that
+  // can be scattered independently. On return, `(*block_offsets)[b *
+  // num_partitions_ + p]` is the first row of output `p` written by block `b`.
+  // Since blocks are laid out in input order, the result is identical to a
+  // serial walk over `data` regardless of how many blocks are used.
   void ValidateAndAllocateOutputs(OpKernelContext* c, const Tensor** data,
                                   const Tensor** partitions,
-                                  OpOutputList* Tout) {
+                                  OpOutputList* Tout, int64_t* num_blocks,
+                                  std::vector<int64_t>* block_offsets) {
     OP_REQUIRES_OK(c, c->input("data", data));
     OP_REQUIRES_OK(c, c->input("partitions", partitions));
     OP_REQUIRES(
@@ -55,17 +70,61 @@ class DynamicPartitionOp_Shared : public OpKernel {
             "got data.shape = ", (*data)->shape().DebugString(),
             ", partitions.shape = ", (*partitions)->shape().DebugString())));
 
-    // Count how many occurrences of each partition id we have in partitions
-    absl::InlinedVector<int, 32UL> partition_count(num_partitions_);
     auto e_partitions = (*partitions)->flat<int32_t>();
     const int64_t N = e_partitions.dimension(0);
-    for (int64_t i = 0; i < N; i++) {
-      const int32_t p = internal::SubtleMustCopy(e_partitions(i));
-      OP_REQUIRES(c, FastBoundsCheck(p, num_partitions_),
+    const int64_t slice_size = N == 0 ? 0 : (*data)->NumElements() / N;
+
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *(c->device()->tensorflow_cpu_worker_threads());
+    *num_blocks = std::max<int64_t>(
+        1, std::min<int64_t>({static_cast<int64_t>(worker_threads.num_threads),
+                              N * slice_size / kMinElementsPerBlock, N}));
+    const int64_t rows_per_block = N == 0 ? 0 : Eigen::divup(N, *num_blocks);
+
+    // Count how many occurrences of each partition id each block has. Blocks
+    // record the first invalid index they see so that the error reported is
+    // the same as the one a serial scan would produce.
+    std::vector<int64_t> block_counts(*num_blocks * num_partitions_, 0);
+    std::vector<int64_t> first_bad_index(*num_blocks, -1);
+    auto count_blocks = [&](int64_t begin_block, int64_t end_block) {
+      for (int64_t b = begin_block; b < end_block; ++b) {
+        int64_t* counts = block_counts.data() + b * num_partitions_;
+        const int64_t begin = b * rows_per_block;
+        const int64_t end = std::min(N, begin + rows_per_block);
+        for (int64_t i = begin; i < end; i++) {
+          const int32_t p = internal::SubtleMustCopy(e_partitions(i));
+          if (!FastBoundsCheck(p, num_partitions_)) {
+            first_bad_index[b] = i;
+            break;
+          }
+          counts[p]++;
+        }
+      }
+    };
+    if (*num_blocks == 1) {
+      count_blocks(0, 1);
+    } else {
+      Shard(worker_threads.num_threads, worker_threads.workers, *num_blocks,
+            rows_per_block, count_blocks);
+    }
+    for (int64_t b = 0; b < *num_blocks; ++b) {
+      const int64_t i = first_bad_index[b];
+      OP_REQUIRES(c, i < 0,
                   absl::InvalidArgumentError(absl::StrCat(
                       "partitions", SliceDebugString((*partitions)->shape(), i),
-                      " = ", p, " is not in [0, ", num_partitions_, ")")));
-      partition_count[p]++;
+                      " = ", e_partitions(i), " is not in [0, ",
+                      num_partitions_, ")")));
+    }
+
+    // Turn the per-block counts into per-block starting offsets.
+    block_offsets->resize(*num_blocks * num_partitions_);
+    absl::InlinedVector<int64_t, 32UL> partition_count(num_partitions_);
+    for (int64_t b = 0; b < *num_blocks; ++b) {
+      for (int p = 0; p < num_partitions_; p++) {
+        const int64_t idx = b * num_partitions_ + p;
+        (*block_offsets)[idx] = partition_count[p];
+        partition_count[p] += block_counts[idx];
+      }
     }
 
     // Allocate output tensors of the right size
@@ -94,70 +153,70 @@ class DynamicPartitionOp : public DynamicPartitionOp_Shared {
     const Tensor* data;
     const Tensor* partitions;
     OpOutputList outputs;
-    ValidateAndAllocateOutputs(c, &data, &partitions, &outputs);
+    int64_t num_blocks;
+    std::vector<int64_t> block_offsets;
+    ValidateAndAllocateOutputs(c, &data, &partitions, &outputs, &num_blocks,
+                               &block_offsets);
     if (!c->status().ok()) return;
     if (num_partitions_ == 0 || data->NumElements() == 0) return;
 
     auto e_partitions = partitions->flat<int32_t>();
     const int64_t N = e_partitions.dimension(0);
-    absl::InlinedVector<int, 32UL> output_index(num_partitions_);
-
-    if (partitions->dims() == data->dims()) {
-      // Walk through data and copy the data to the appropriate output tensor
-      const auto data_flat = data->flat<T>();
-      std::vector<Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor>,
-                                   Eigen::Aligned> >
-          out_vec;
-      out_vec.reserve(num_partitions_);
-      for (int p = 0; p < num_partitions_; p++) {
-        out_vec.push_back(outputs[p]->vec<T>());
-      }
-      for (int64_t i = 0; i < N; i++) {
-        const int32_t p = internal::SubtleMustCopy(e_partitions(i));
-        OP_REQUIRES(c, FastBoundsCheck(p, num_partitions_),
-                    absl::InvalidArgumentError(
-                        absl::StrCat("indices[", i, "] is out of range")));
-        auto oi = output_index[p];
-        OP_REQUIRES(c, FastBoundsCheck(oi, out_vec[p].size()),
-                    absl::InvalidArgumentError(absl::StrCat(
-                        "out_vec[", p, "] size: ", out_vec[p].size(),
-                        " is not LTE output_index[", p, "] : ", oi)));
-        out_vec[p](oi) = data_flat(i);
-        output_index[p]++;
-      }
-    } else {
-      // If data has extra dimensions, use Eigen slices
-      std::vector<Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
-                                   Eigen::Aligned> >
-          out_flat;
-      out_flat.reserve(num_partitions_);
-      for (int p = 0; p < num_partitions_; p++) {
-        out_flat.push_back(outputs[p]->flat_outer_dims<T>());
-      }
+    const int64_t slice_size = data->NumElements() / N;
+    const int64_t rows_per_block = Eigen::divup(N, num_blocks);
+    const T* data_ptr = data->flat<T>().data();
+
+    std::vector<T*> out_ptr(num_partitions_);
+    std::vector<int64_t> out_rows(num_partitions_);
+    for (int p = 0; p < num_partitions_; p++) {
+      out_ptr[p] = outputs[p]->flat<T>().data();
+      out_rows[p] = outputs[p]->dim_size(0);
+    }
 
-      // Walk through data and copy the data to the appropriate output tensor
-      const int64_t slice_size = data->NumElements() / N;
-      const auto data_flat = data->shaped<T, 2>({N, slice_size});
-      Eigen::DSizes<Eigen::DenseIndex, 2> sizes(1, slice_size);
-      for (int64_t i = 0; i < N; i++) {
-        // outputs[p][output_index[p]++] = data[i]
-        const int32_t p = internal::SubtleMustCopy(e_partitions(i));
-        OP_REQUIRES(c, FastBoundsCheck(p, num_partitions_),
-                    absl::InvalidArgumentError(absl::StrCat(
-                        "indices[", i,
-                        "] has been asynchronously overwritten and "
-                        "is no longer in range!")));
-        auto oi = output_index[p];
-        OP_REQUIRES(
-            c, FastBoundsCheck(oi, out_flat[p].dimension(0)),
-            absl::InvalidArgumentError(absl::StrCat(
-                "Size of output_index: ", oi, " is no longer in range.")));
-        Eigen::DSizes<Eigen::DenseIndex, 2> out_indices(oi, 0);
-        Eigen::DSizes<Eigen::DenseIndex, 2> data_indices(i, 0);
-        out_flat[p].slice(out_indices, sizes) =
-            data_flat.slice(data_indices, sizes);
-        output_index[p]++;
+    // Each block copies its rows into the range of each output reserved for
+    // it by ValidateAndAllocateOutputs. Blocks never write to the same rows,
+    // so no synchronization is needed. `partitions` may have been
+    // asynchronously overwritten since it was counted, so every index is
+    // checked again and a block stops at the first inconsistency.
+    std::vector<int64_t> first_bad_index(num_blocks, -1);
+    auto scatter_blocks = [&](int64_t begin_block, int64_t end_block) {
+      absl::InlinedVector<int64_t, 32UL> output_index(num_partitions_);
+      for (int64_t b = begin_block; b < end_block; ++b) {
+        const int64_t* offsets = block_offsets.data() + b * num_partitions_;
+        const int64_t* limits = b + 1 < num_blocks
+                                    ? offsets + num_partitions_
+                                    : out_rows.data();
+        std::copy_n(offsets, num_partitions_, output_index.begin());
+        const int64_t begin = b * rows_per_block;
+        const int64_t end = std::min(N, begin + rows_per_block);
+        for (int64_t i = begin; i < end; i++) {
+          // outputs[p][output_index[p]++] = data[i]
+          const int32_t p = internal::SubtleMustCopy(e_partitions(i));
+          if (!FastBoundsCheck(p, num_partitions_) ||
+              output_index[p] >= limits[p]) {
+            first_bad_index[b] = i;
+            break;
+          }
+          std::copy_n(data_ptr + i * slice_size, slice_size,
+                      out_ptr[p] + output_index[p] * slice_size);
+          output_index[p]++;
+        }
       }
+    };
+    if (num_blocks == 1) {
+      scatter_blocks(0, 1);
+    } else {
+      const DeviceBase::CpuWorkerThreads& worker_threads =
+          *(c->device()->tensorflow_cpu_worker_threads());
+      Shard(worker_threads.num_threads, worker_threads.workers, num_blocks,
+            rows_per_block * slice_size * sizeof(T), scatter_blocks);
+    }
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      OP_REQUIRES(c, first_bad_index[b] < 0,
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "partitions[", first_bad_index[b],
+                      "] has been asynchronously overwritten and "
+                      "is no longer in range!")));
     }
   }
 };
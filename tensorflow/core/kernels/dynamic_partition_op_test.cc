@@ -15,6 +15,7 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -159,6 +160,57 @@ TEST_F(DynamicPartitionOpTest, Error_IndexOutOfRange) {
       << s;
 }
 
+TEST_F(DynamicPartitionOpTest, Large_PreservesOrder) {
+  MakeOp();
+
+  // Large enough to be split into several blocks that are partitioned in
+  // parallel; the outputs must still be in input order.
+  const int kRows = 1 << 16;
+  const int kDim = 3;
+  std::vector<float> data(kRows * kDim);
+  std::vector<int32_t> partitions(kRows);
+  std::vector<std::vector<float>> expected_values(4);
+  for (int i = 0; i < kRows; i++) {
+    partitions[i] = (i * 7 + i / 5) % 4;
+    for (int j = 0; j < kDim; j++) {
+      data[i * kDim + j] = i * kDim + j;
+      expected_values[partitions[i]].push_back(i * kDim + j);
+    }
+  }
+
+  // Feed and run
+  AddInputFromArray<float>(TensorShape({kRows, kDim}), data);
+  AddInputFromArray<int32_t>(TensorShape({kRows}), partitions);
+  TF_ASSERT_OK(RunOpKernel());
+
+  for (int p = 0; p < 4; p++) {
+    const int64_t rows = expected_values[p].size() / kDim;
+    Tensor expected(allocator(), DT_FLOAT, TensorShape({rows, kDim}));
+    test::FillValues<float>(&expected, expected_values[p]);
+    test::ExpectTensorEqual<float>(expected, *GetOutput(p));
+  }
+}
+
+TEST_F(DynamicPartitionOpTest, Large_Error_IndexOutOfRange) {
+  MakeOp();
+
+  // The first invalid index is reported even when a later block also sees
+  // an invalid index.
+  const int kRows = 1 << 16;
+  std::vector<float> data(kRows);
+  std::vector<int32_t> partitions(kRows, 1);
+  partitions[kRows - 1] = -1;
+  partitions[40000] = 4;
+
+  // Feed and run
+  AddInputFromArray<float>(TensorShape({kRows}), data);
+  AddInputFromArray<int32_t>(TensorShape({kRows}), partitions);
+  absl::Status s = RunOpKernel();
+  EXPECT_TRUE(absl::StrContains(s.ToString(),
+                                "partitions[40000] = 4 is not in [0, 4)"))
+      << s;
+}
+
 Node* DynamicPartitionNode(Graph* g, Node* in0, Node* in1, int num_partitions) {
   Node* ret;
   TF_CHECK_OK(NodeBuilder(g->NewName("n"), "DynamicPartition")
@@ -15,7 +15,9 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/node_def_builder.h"
@@ -23,13 +25,17 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 
 namespace tensorflow {
 namespace {
@@ -156,5 +162,66 @@ TEST_F(DynamicStitchOpTest, Error_DataAndIndicesSizeMismatch) {
       << s;
 }
 
+// Builds the inverse of the DynamicPartition benchmark graph: the rows of a
+// 128MB buffer are randomly assigned to `num_partitions` inputs, which are
+// then stitched back together.
+template <typename T>
+static Graph* DynamicStitch(int num_partitions, int dim) {
+  Graph* g = new Graph(OpRegistry::Global());
+  // Always use a 128MB buffer.
+  const int kRows = ((128 << 20) / sizeof(T)) / dim;
+
+  random::PhiloxRandom philox(301, 17);
+  random::SimplePhilox rnd(&philox);
+  std::vector<std::vector<int32_t>> partition_rows(num_partitions);
+  for (int i = 0; i < kRows; i++) {
+    partition_rows[rnd.Uniform(num_partitions)].push_back(i);
+  }
+
+  std::vector<NodeBuilder::NodeOut> indices;
+  std::vector<NodeBuilder::NodeOut> data;
+  for (int p = 0; p < num_partitions; p++) {
+    const int64_t rows = partition_rows[p].size();
+    Tensor index(DT_INT32, TensorShape({rows}));
+    std::copy(partition_rows[p].begin(), partition_rows[p].end(),
+              index.flat<int32_t>().data());
+    Tensor values(DataTypeToEnum<T>::value, TensorShape({rows, dim}));
+    values.flat<T>().setRandom();
+    indices.push_back(test::graph::Constant(g, index));
+    data.push_back(test::graph::Constant(g, values));
+  }
+
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "DynamicStitch")
+                  .Input(indices)
+                  .Input(data)
+                  .Finalize(g, &ret));
+  return g;
+}
+
+#define BM_DYNAMIC_STITCH(DEVICE, T, num)                                 \
+  static void BM_##DEVICE##_dynstitch_##T##_##num(                        \
+      ::testing::benchmark::State& state) {                               \
+    const int dim = state.range(0);                                       \
+                                                                          \
+    const int64_t items = ((128 << 20) / sizeof(T));                      \
+    test::Benchmark(#DEVICE, DynamicStitch<T>(num, dim),                  \
+                    /*old_benchmark_api=*/false)                          \
+        .Run(state);                                                      \
+    const int64_t tot = static_cast<int64_t>(state.iterations()) * items; \
+    state.SetItemsProcessed(tot);                                         \
+  }                                                                       \
+  BENCHMARK(BM_##DEVICE##_dynstitch_##T##_##num)                          \
+      ->UseRealTime()                                                     \
+      ->Arg(1)                                                            \
+      ->Arg(256)
+
+BM_DYNAMIC_STITCH(cpu, float, 2);
+BM_DYNAMIC_STITCH(cpu, float, 100);
+BM_DYNAMIC_STITCH(cpu, double, 2);
+BM_DYNAMIC_STITCH(cpu, double, 100);
+BM_DYNAMIC_STITCH(cpu, complex64, 2);
+BM_DYNAMIC_STITCH(cpu, complex64, 100);
+
 }  // namespace
 }  // namespace tensorflow
@@ -0,0 +1,83 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_FINGERPRINT_UTIL_H_
+#define TENSORFLOW_CORE_KERNELS_FINGERPRINT_UTIL_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+// Approximate cost, in cycles, of fingerprinting a short string.
+inline constexpr int64_t kFingerprintCostPerString = 100;
+
+// Sets `fingerprints(i)` to Fingerprint64(`strings(i)`) for every element,
+// sharding the strings over the CPU worker threads of `ctx`.
+inline void ParallelFingerprint64(OpKernelContext* ctx,
+                                  TTypes<tstring>::ConstFlat strings,
+                                  TTypes<int64_t>::Flat fingerprints) {
+  const DeviceBase::CpuWorkerThreads& worker_threads =
+      *(ctx->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers, strings.size(),
+        kFingerprintCostPerString, [&](int64_t start, int64_t limit) {
+          for (int64_t i = start; i < limit; ++i) {
+            fingerprints(i) = static_cast<int64_t>(Fingerprint64(strings(i)));
+          }
+        });
+}
+
+// Copies the tensors of `inputs` into `outputs`, replacing every DT_STRING
+// tensor with a DT_INT64 tensor of the same shape that holds the fingerprint
+// of each string.
+//
+// Hashed feature crosses use Fingerprint64 of string features and int64
+// features as they are, so they can fingerprint every string once up front
+// instead of once for each cross that it takes part in. `outputs` is reserved
+// up front, so references to its elements stay valid.
+inline absl::Status FingerprintStringInputs(OpKernelContext* ctx,
+                                            const OpInputList& inputs,
+                                            std::vector<Tensor>* outputs) {
+  outputs->clear();
+  outputs->reserve(inputs.size());
+  for (int i = 0; i < inputs.size(); ++i) {
+    const Tensor& input = inputs[i];
+    if (input.dtype() != DT_STRING) {
+      outputs->push_back(input);
+      continue;
+    }
+    Tensor fingerprints;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_temp(DT_INT64, input.shape(), &fingerprints));
+    ParallelFingerprint64(ctx, input.flat<tstring>(),
+                          fingerprints.flat<int64_t>());
+    outputs->push_back(std::move(fingerprints));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_FINGERPRINT_UTIL_H_
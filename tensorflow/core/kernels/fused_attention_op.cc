@@ -0,0 +1,322 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/nn_ops.cc.
+//
+// _FusedScaledDotProductAttention is created by the Grappler remapper from
+// BatchMatMulV2 + {Mul, RealDiv} + {Add, AddV2} + Softmax + BatchMatMulV2.
+// The unfused ops write the full [query_length, key_length] score matrix
+// several times. Here each block of queries is multiplied by the keys one
+// block at a time, and the softmax is computed on the fly: every row keeps
+// the largest score seen so far, the sum of the exponentials and the
+// weighted sum of the values, which are rescaled when a larger score shows
+// up. The score blocks stay in cache, and the fully masked blocks of the
+// causal mode are never computed.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Eigen/Core"  // from @eigen_archive
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+namespace {
+
+// The number of queries and keys in a block. A block of float scores is
+// 64 KB, and the query, key and value blocks are about as large for the
+// usual head depths of 64 and 128.
+constexpr int64_t kQueryBlockSize = 64;
+constexpr int64_t kKeyBlockSize = 256;
+
+using FloatMatrix =
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+template <typename T>
+using ConstMatrixMap = Eigen::Map<
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
+
+// The offsets of the mask values that are added to the scores. Dimensions of
+// size 1 are broadcast with a stride of 0.
+struct MaskStrides {
+  std::vector<int64_t> batch_offsets;
+  int64_t row_stride = 0;
+  int64_t column_stride = 0;
+};
+
+}  // namespace
+
+template <typename T>
+class FusedScaledDotProductAttentionOp : public OpKernel {
+ public:
+  explicit FusedScaledDotProductAttentionOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    int num_args;
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args));
+    OP_REQUIRES(context, num_args <= 1,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "_FusedScaledDotProductAttention takes at most one mask, ",
+                    "got ", num_args)));
+    has_mask_ = num_args == 1;
+    OP_REQUIRES_OK(context, context->GetAttr("scale", &scale_));
+    OP_REQUIRES_OK(context, context->GetAttr("is_causal", &is_causal_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& query = context->input(0);
+    const Tensor& key = context->input(1);
+    const Tensor& value = context->input(2);
+
+    const int rank = query.dims();
+    OP_REQUIRES(context, rank >= 2,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "query must be at least rank 2 but is rank ", rank)));
+    OP_REQUIRES(
+        context, key.dims() == rank && value.dims() == rank,
+        absl::InvalidArgumentError(absl::StrCat(
+            "query, key and value must have the same rank, got shapes ",
+            query.shape().DebugString(), ", ", key.shape().DebugString(),
+            " and ", value.shape().DebugString())));
+    int64_t num_batches = 1;
+    for (int i = 0; i < rank - 2; ++i) {
+      OP_REQUIRES(
+          context,
+          key.dim_size(i) == query.dim_size(i) &&
+              value.dim_size(i) == query.dim_size(i),
+          absl::InvalidArgumentError(absl::StrCat(
+              "query, key and value must have the same batch dimensions, got "
+              "shapes ",
+              query.shape().DebugString(), ", ", key.shape().DebugString(),
+              " and ", value.shape().DebugString())));
+      num_batches *= query.dim_size(i);
+    }
+    const int64_t query_length = query.dim_size(rank - 2);
+    const int64_t depth = query.dim_size(rank - 1);
+    const int64_t key_length = key.dim_size(rank - 2);
+    const int64_t value_depth = value.dim_size(rank - 1);
+    OP_REQUIRES(context, key.dim_size(rank - 1) == depth,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "query and key must have the same depth, got shapes ",
+                    query.shape().DebugString(), " and ",
+                    key.shape().DebugString())));
+    OP_REQUIRES(context, value.dim_size(rank - 2) == key_length,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "key and value must have the same length, got shapes ",
+                    key.shape().DebugString(), " and ",
+                    value.shape().DebugString())));
+
+    MaskStrides mask_strides;
+    const T* mask_data = nullptr;
+    if (has_mask_) {
+      const Tensor& mask = context->input(3);
+      OP_REQUIRES_OK(context, ComputeMaskStrides(query, key_length, mask,
+                                                 num_batches, &mask_strides));
+      mask_data = mask.flat<T>().data();
+    }
+
+    TensorShape output_shape = query.shape();
+    output_shape.set_dim(rank - 1, value_depth);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, output_shape, &output));
+    if (output->NumElements() == 0) return;
+    if (key_length == 0) {
+      // The softmax of no scores is empty, and the weighted sum of no values
+      // is zero.
+      output->flat<T>().setZero();
+      return;
+    }
+
+    const T* query_data = query.flat<T>().data();
+    const T* key_data = key.flat<T>().data();
+    const T* value_data = value.flat<T>().data();
+    T* output_data = output->flat<T>().data();
+
+    const int64_t num_query_blocks =
+        (query_length + kQueryBlockSize - 1) / kQueryBlockSize;
+    const float scale = scale_;
+    const bool is_causal = is_causal_;
+    auto compute_blocks = [&](int64_t begin, int64_t end) {
+      FloatMatrix scaled_query;
+      FloatMatrix scores;
+      FloatMatrix weighted_values;
+      std::vector<float> row_max;
+      std::vector<float> row_sum;
+      for (int64_t block = begin; block < end; ++block) {
+        const int64_t batch = block / num_query_blocks;
+        const int64_t query_begin =
+            (block % num_query_blocks) * kQueryBlockSize;
+        const int64_t num_queries =
+            std::min(kQueryBlockSize, query_length - query_begin);
+
+        scaled_query =
+            ConstMatrixMap<T>(
+                query_data + (batch * query_length + query_begin) * depth,
+                num_queries, depth)
+                .template cast<float>() *
+            scale;
+        weighted_values.setZero(num_queries, value_depth);
+        row_max.assign(num_queries, -std::numeric_limits<float>::infinity());
+        row_sum.assign(num_queries, 0.0f);
+
+        // In causal mode, no query of the block attends to the keys after
+        // the last query.
+        const int64_t key_end =
+            is_causal ? std::min(key_length, query_begin + num_queries)
+                      : key_length;
+        for (int64_t key_begin = 0; key_begin < key_end;
+             key_begin += kKeyBlockSize) {
+          const int64_t num_keys = std::min(kKeyBlockSize, key_end - key_begin);
+          const int64_t key_offset = batch * key_length + key_begin;
+          scores.noalias() =
+              scaled_query *
+              ConstMatrixMap<T>(key_data + key_offset * depth, num_keys, depth)
+                  .template cast<float>()
+                  .transpose();
+
+          for (int64_t i = 0; i < num_queries; ++i) {
+            auto row = scores.row(i).array();
+            if (mask_data != nullptr) {
+              const T* mask_row =
+                  mask_data + mask_strides.batch_offsets[batch] +
+                  (query_begin + i) * mask_strides.row_stride +
+                  key_begin * mask_strides.column_stride;
+              for (int64_t j = 0; j < num_keys; ++j) {
+                row(j) += static_cast<float>(
+                    mask_row[j * mask_strides.column_stride]);
+              }
+            }
+            if (is_causal) {
+              const int64_t num_visible = query_begin + i - key_begin + 1;
+              if (num_visible < num_keys) {
+                row.tail(num_keys - num_visible)
+                    .setConstant(-std::numeric_limits<float>::infinity());
+              }
+            }
+
+            const float new_max = std::max(row_max[i], row.maxCoeff());
+            if (new_max == -std::numeric_limits<float>::infinity()) {
+              // All the scores so far are masked out. They are left out of
+              // the sums instead of turning them into NaN.
+              row.setZero();
+              continue;
+            }
+            const float correction = std::exp(row_max[i] - new_max);
+            row = (row - new_max).exp();
+            row_sum[i] = row_sum[i] * correction + row.sum();
+            row_max[i] = new_max;
+            if (correction != 1.0f) weighted_values.row(i) *= correction;
+          }
+
+          weighted_values.noalias() +=
+              scores * ConstMatrixMap<T>(value_data + key_offset * value_depth,
+                                         num_keys, value_depth)
+                           .template cast<float>();
+        }
+
+        // Rows where every score is masked out have a zero sum, and are NaN
+        // like the softmax of the unfused graph.
+        T* output_block =
+            output_data + (batch * query_length + query_begin) * value_depth;
+        for (int64_t i = 0; i < num_queries; ++i) {
+          const float inverse_sum = 1.0f / row_sum[i];
+          for (int64_t j = 0; j < value_depth; ++j) {
+            output_block[i * value_depth + j] =
+                static_cast<T>(weighted_values(i, j) * inverse_sum);
+          }
+        }
+      }
+    };
+
+    const int64_t cost_per_block =
+        kQueryBlockSize * key_length * (2 * (depth + value_depth) + 10);
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          num_batches * num_query_blocks, cost_per_block, compute_blocks);
+  }
+
+ private:
+  // Checks that `mask` broadcasts to the [..., query_length, key_length]
+  // scores, aligning the trailing dimensions, and computes its strides.
+  static absl::Status ComputeMaskStrides(const Tensor& query,
+                                         int64_t key_length,
+                                         const Tensor& mask,
+                                         int64_t num_batches,
+                                         MaskStrides* strides) {
+    const int rank = query.dims();
+    TensorShape scores_shape = query.shape();
+    scores_shape.set_dim(rank - 1, key_length);
+    if (mask.dims() > rank) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "mask must be at most rank ", rank, " but is rank ", mask.dims()));
+    }
+
+    // The stride of every dimension of the scores in the mask.
+    std::vector<int64_t> dim_strides(rank, 0);
+    int64_t stride = 1;
+    for (int i = mask.dims() - 1; i >= 0; --i) {
+      const int dim = rank - mask.dims() + i;
+      const int64_t size = mask.dim_size(i);
+      if (size != 1 && size != scores_shape.dim_size(dim)) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "mask of shape ", mask.shape().DebugString(),
+            " does not broadcast to the scores of shape ",
+            scores_shape.DebugString()));
+      }
+      if (size != 1) dim_strides[dim] = stride;
+      stride *= size;
+    }
+    strides->row_stride = dim_strides[rank - 2];
+    strides->column_stride = dim_strides[rank - 1];
+
+    strides->batch_offsets.resize(num_batches);
+    for (int64_t batch = 0; batch < num_batches; ++batch) {
+      int64_t remainder = batch;
+      int64_t offset = 0;
+      for (int i = rank - 3; i >= 0; --i) {
+        offset += (remainder % query.dim_size(i)) * dim_strides[i];
+        remainder /= query.dim_size(i);
+      }
+      strides->batch_offsets[batch] = offset;
+    }
+    return absl::OkStatus();
+  }
+
+  bool has_mask_;
+  float scale_;
+  bool is_causal_;
+};
+
+#define REGISTER_KERNEL(T)                                         \
+  REGISTER_KERNEL_BUILDER(Name("_FusedScaledDotProductAttention")  \
+                              .Device(DEVICE_CPU)                  \
+                              .TypeConstraint<T>("T"),             \
+                          FusedScaledDotProductAttentionOp<T>);
+
+TF_CALL_float(REGISTER_KERNEL);
+TF_CALL_bfloat16(REGISTER_KERNEL);
+
+#undef REGISTER_KERNEL
+
+}  // namespace tensorflow
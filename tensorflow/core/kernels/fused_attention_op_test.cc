@@ -0,0 +1,286 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+// Computes softmax(scale * query * key^T + mask) * value in double. The mask
+// has shape [query_length, key_length] and is shared by the batches.
+Tensor ReferenceAttention(const Tensor& query, const Tensor& key,
+                          const Tensor& value, const Tensor* mask, float scale,
+                          bool is_causal) {
+  const int64_t num_batches = query.dim_size(0);
+  const int64_t query_length = query.dim_size(1);
+  const int64_t depth = query.dim_size(2);
+  const int64_t key_length = key.dim_size(1);
+  const int64_t value_depth = value.dim_size(2);
+  auto q = query.tensor<float, 3>();
+  auto k = key.tensor<float, 3>();
+  auto v = value.tensor<float, 3>();
+
+  Tensor output(DT_FLOAT,
+                TensorShape({num_batches, query_length, value_depth}));
+  auto out = output.tensor<float, 3>();
+  std::vector<double> scores(key_length);
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t i = 0; i < query_length; ++i) {
+      double max_score = -std::numeric_limits<double>::infinity();
+      for (int64_t j = 0; j < key_length; ++j) {
+        double score = 0;
+        for (int64_t d = 0; d < depth; ++d) score += q(b, i, d) * k(b, j, d);
+        score *= scale;
+        if (mask != nullptr) score += mask->matrix<float>()(i, j);
+        if (is_causal && j > i) {
+          score = -std::numeric_limits<double>::infinity();
+        }
+        scores[j] = score;
+        max_score = std::max(max_score, score);
+      }
+      double sum = 0;
+      for (int64_t j = 0; j < key_length; ++j) {
+        scores[j] = std::exp(scores[j] - max_score);
+        sum += scores[j];
+      }
+      for (int64_t e = 0; e < value_depth; ++e) {
+        double result = 0;
+        for (int64_t j = 0; j < key_length; ++j) {
+          result += scores[j] * v(b, j, e);
+        }
+        out(b, i, e) = result / sum;
+      }
+    }
+  }
+  return output;
+}
+
+class FusedScaledDotProductAttentionOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(DataType dtype, int num_args, float scale, bool is_causal) {
+    TF_EXPECT_OK(
+        NodeDefBuilder("attention", "_FusedScaledDotProductAttention")
+            .Input(FakeInput(dtype))
+            .Input(FakeInput(dtype))
+            .Input(FakeInput(dtype))
+            .Input(FakeInput(num_args, dtype))
+            .Attr("num_args", num_args)
+            .Attr("scale", scale)
+            .Attr("is_causal", is_causal)
+            .Finalize(node_def()));
+    TF_EXPECT_OK(InitOp());
+  }
+
+  // Runs the op on random float inputs with more queries and keys than fit in
+  // one block, and compares the result with ReferenceAttention.
+  void RunAndCompare(bool with_mask, bool is_causal) {
+    constexpr int kBatches = 3;
+    constexpr int kQueryLength = 100;
+    constexpr int kKeyLength = 300;
+    constexpr float kScale = 0.25f;
+    MakeOp(DT_FLOAT, with_mask ? 1 : 0, kScale, is_causal);
+
+    Tensor query(DT_FLOAT, TensorShape({kBatches, kQueryLength, 16}));
+    Tensor key(DT_FLOAT, TensorShape({kBatches, kKeyLength, 16}));
+    Tensor value(DT_FLOAT, TensorShape({kBatches, kKeyLength, 8}));
+    Tensor mask(DT_FLOAT, TensorShape({kQueryLength, kKeyLength}));
+    query.flat<float>().setRandom();
+    key.flat<float>().setRandom();
+    value.flat<float>().setRandom();
+    mask.flat<float>().setRandom();
+    // Mask out every third key with a large negative value.
+    for (int i = 0; i < kQueryLength; ++i) {
+      for (int j = 0; j < kKeyLength; j += 3) {
+        mask.matrix<float>()(i, j) = -1e9f;
+      }
+    }
+
+    AddInputFromArray<float>(query.shape(), query.flat<float>());
+    AddInputFromArray<float>(key.shape(), key.flat<float>());
+    AddInputFromArray<float>(value.shape(), value.flat<float>());
+    if (with_mask) AddInputFromArray<float>(mask.shape(), mask.flat<float>());
+    TF_ASSERT_OK(RunOpKernel());
+
+    test::ExpectClose(*GetOutput(0),
+                      ReferenceAttention(query, key, value,
+                                         with_mask ? &mask : nullptr, kScale,
+                                         is_causal),
+                      /*atol=*/1e-5, /*rtol=*/1e-5);
+  }
+};
+
+TEST_F(FusedScaledDotProductAttentionOpTest, NoMask) {
+  RunAndCompare(/*with_mask=*/false, /*is_causal=*/false);
+}
+
+TEST_F(FusedScaledDotProductAttentionOpTest, Mask) {
+  RunAndCompare(/*with_mask=*/true, /*is_causal=*/false);
+}
+
+TEST_F(FusedScaledDotProductAttentionOpTest, Causal) {
+  RunAndCompare(/*with_mask=*/false, /*is_causal=*/true);
+}
+
+TEST_F(FusedScaledDotProductAttentionOpTest, MaskAndCausal) {
+  RunAndCompare(/*with_mask=*/true, /*is_causal=*/true);
+}
+
+TEST_F(FusedScaledDotProductAttentionOpTest, BroadcastMask) {
+  MakeOp(DT_FLOAT, /*num_args=*/1, /*scale=*/1.0f, /*is_causal=*/false);
+  // The mask of shape [2, 1, 1, 3] is broadcast over the heads and queries.
+  AddInputFromArray<float>(TensorShape({2, 2, 1, 1}), {1, 1, 1, 1});
+  AddInputFromArray<float>(TensorShape({2, 2, 3, 1}),
+                           {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+  AddInputFromArray<float>(TensorShape({2, 2, 3, 1}),
+                           {1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3});
+  const float inf = std::numeric_limits<float>::infinity();
+  AddInputFromArray<float>(TensorShape({2, 1, 1, 3}),
+                           {0, 0, -inf, -inf, 0, -inf});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({2, 2, 1, 1}));
+  test::FillValues<float>(&expected, {1.5, 1.5, 2, 2});
+  test::ExpectClose(*GetOutput(0), expected);
+}
+
+TEST_F(FusedScaledDotProductAttentionOpTest, FullyMaskedKeyBlock) {
+  MakeOp(DT_FLOAT, /*num_args=*/1, /*scale=*/1.0f, /*is_causal=*/false);
+  // Only the last of 300 keys is visible, so the first block of keys is
+  // skipped and the output is the last value.
+  constexpr int kKeyLength = 300;
+  Tensor mask(DT_FLOAT, TensorShape({1, kKeyLength}));
+  mask.flat<float>().setConstant(-std::numeric_limits<float>::infinity());
+  mask.flat<float>()(kKeyLength - 1) = 0;
+  std::vector<float> value(kKeyLength, 1.0f);
+  value.back() = 5.0f;
+  AddInputFromArray<float>(TensorShape({1, 1, 1}), {1});
+  AddInputFromArray<float>(TensorShape({1, kKeyLength, 1}),
+                           std::vector<float>(kKeyLength, 1.0f));
+  AddInputFromArray<float>(TensorShape({1, kKeyLength, 1}), value);
+  AddInputFromArray<float>(mask.shape(), mask.flat<float>());
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({1, 1, 1}));
+  test::FillValues<float>(&expected, {5});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(FusedScaledDotProductAttentionOpTest, Bfloat16) {
+  MakeOp(DT_BFLOAT16, /*num_args=*/0, /*scale=*/0.5f, /*is_causal=*/true);
+  AddInputFromArray<bfloat16>(
+      TensorShape({1, 2, 2}),
+      {bfloat16(1.0f), bfloat16(0.0f), bfloat16(0.0f), bfloat16(2.0f)});
+  AddInputFromArray<bfloat16>(
+      TensorShape({1, 2, 2}),
+      {bfloat16(1.0f), bfloat16(0.0f), bfloat16(0.0f), bfloat16(1.0f)});
+  AddInputFromArray<bfloat16>(TensorShape({1, 2, 1}),
+                              {bfloat16(2.0f), bfloat16(4.0f)});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // The first query sees only the first key. The second query has the scores
+  // 0 and 1.
+  const float weight = 1.0f / (1.0f + std::exp(-1.0f));
+  Tensor expected(DT_BFLOAT16, TensorShape({1, 2, 1}));
+  test::FillValues<bfloat16>(
+      &expected,
+      {bfloat16(2.0f), bfloat16(2.0f * (1.0f - weight) + 4.0f * weight)});
+  test::ExpectClose(*GetOutput(0), expected, /*atol=*/1e-2, /*rtol=*/1e-2);
+}
+
+TEST_F(FusedScaledDotProductAttentionOpTest, MismatchedDepth) {
+  MakeOp(DT_FLOAT, /*num_args=*/0, /*scale=*/1.0f, /*is_causal=*/false);
+  AddInputFromArray<float>(TensorShape({1, 2, 3}), {0, 0, 0, 0, 0, 0});
+  AddInputFromArray<float>(TensorShape({1, 2, 2}), {0, 0, 0, 0});
+  AddInputFromArray<float>(TensorShape({1, 2, 2}), {0, 0, 0, 0});
+  absl::Status status = RunOpKernel();
+  EXPECT_TRUE(absl::IsInvalidArgument(status));
+  EXPECT_TRUE(absl::StrContains(status.message(), "same depth")) << status;
+}
+
+// Attention of `num_heads` heads over `length` queries and keys of depth 64,
+// computed by the fused op or by the ops it replaces.
+Graph* Attention(int num_heads, int length, bool fused) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor input(DT_FLOAT, TensorShape({1, num_heads, length, 64}));
+  input.flat<float>().setRandom();
+  Node* query = test::graph::Constant(g, input, "query");
+  Node* key = test::graph::Constant(g, input, "key");
+  Node* value = test::graph::Constant(g, input, "value");
+
+  Node* attention;
+  if (fused) {
+    TF_CHECK_OK(NodeBuilder(g->NewName("attention"),
+                            "_FusedScaledDotProductAttention")
+                    .Input(query)
+                    .Input(key)
+                    .Input(value)
+                    .Input(std::vector<NodeBuilder::NodeOut>())
+                    .Attr("T", DT_FLOAT)
+                    .Attr("num_args", 0)
+                    .Attr("scale", 0.125f)
+                    .Finalize(g, &attention));
+    return g;
+  }
+  Node* scores;
+  TF_CHECK_OK(NodeBuilder(g->NewName("scores"), "BatchMatMulV2")
+                  .Input(query)
+                  .Input(key)
+                  .Attr("adj_y", true)
+                  .Finalize(g, &scores));
+  Node* scaled = test::graph::Binary(
+      g, "Mul", scores, test::graph::Constant(g, test::AsScalar(0.125f)));
+  Node* softmax = test::graph::Unary(g, "Softmax", scaled);
+  TF_CHECK_OK(NodeBuilder(g->NewName("attention"), "BatchMatMulV2")
+                  .Input(softmax)
+                  .Input(value)
+                  .Finalize(g, &attention));
+  return g;
+}
+
+#define BM_Attention(HEADS, LENGTH, FUSED)                                   \
+  static void BM_Attention_##HEADS##_##LENGTH##_##FUSED(                     \
+      ::testing::benchmark::State& state) {                                  \
+    test::Benchmark("cpu", Attention(HEADS, LENGTH, FUSED),                  \
+                    /*old_benchmark_api=*/false)                             \
+        .Run(state);                                                         \
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *       \
+                            HEADS * LENGTH * LENGTH);                        \
+  }                                                                          \
+  BENCHMARK(BM_Attention_##HEADS##_##LENGTH##_##FUSED)->UseRealTime();
+
+BM_Attention(8, 512, false);
+BM_Attention(8, 512, true);
+BM_Attention(8, 2048, false);
+BM_Attention(8, 2048, true);
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,304 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Decoding dominates the cost of an image, so every image is worth its own
+// shard.
+constexpr int64_t kCostPerImage = 1 << 20;
+
+// The source rows or columns and the weight of the upper one for one output
+// row or column, as in ResizeBilinear.
+struct Interpolation {
+  int64_t lower;
+  int64_t upper;
+  float lerp;
+};
+
+// Computes the interpolation of `out_size` output pixels that cover a crop
+// window of `crop_size` full-size pixels starting at `crop_start`, from an
+// image that was decoded at 1/`ratio` scale starting at scaled pixel
+// `decoded_start`, with `decoded_size` pixels.
+//
+// Pixel centers are mapped as in ResizeBilinear with half_pixel_centers=true,
+// so that with ratio 1 the results are the same as DecodeAndCropJpeg followed
+// by ResizeBilinear.
+void ComputeInterpolation(int64_t crop_start, int64_t crop_size,
+                          int64_t out_size, int ratio, int64_t decoded_start,
+                          int64_t decoded_size,
+                          std::vector<Interpolation>* interpolation) {
+  const float scale =
+      static_cast<float>(crop_size) / static_cast<float>(out_size);
+  // The offset of the crop window within the first decoded pixel, in
+  // full-size pixels.
+  const float offset =
+      static_cast<float>(crop_start - decoded_start * ratio);
+  interpolation->resize(out_size);
+  for (int64_t i = 0; i < out_size; ++i) {
+    const float in =
+        ((static_cast<float>(i) + 0.5f) * scale + offset) / ratio - 0.5f;
+    const float in_f = std::floor(in);
+    Interpolation& interp = (*interpolation)[i];
+    interp.lower = std::max(static_cast<int64_t>(in_f), int64_t{0});
+    interp.upper =
+        std::min(static_cast<int64_t>(std::ceil(in)), decoded_size - 1);
+    interp.lower = std::min(interp.lower, interp.upper);
+    interp.lerp = in - in_f;
+  }
+}
+
+// Returns the largest libjpeg scaling denominator at which a crop window of
+// `crop_height` x `crop_width` still has at least `out_height` x `out_width`
+// pixels.
+int ChooseRatio(int crop_height, int crop_width, int out_height,
+                int out_width) {
+  int ratio = 8;
+  while (ratio > 1 &&
+         (crop_height / ratio < out_height || crop_width / ratio < out_width)) {
+    ratio /= 2;
+  }
+  return ratio;
+}
+
+class DecodeCropAndResizeJpegOp : public OpKernel {
+ public:
+  explicit DecodeCropAndResizeJpegOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 1 || channels_ == 3,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "channels must be 1 or 3, got ", channels_)));
+    flags_.components = channels_;
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("try_recover_truncated",
+                                    &flags_.try_recover_truncated_jpeg));
+    OP_REQUIRES_OK(context, context->GetAttr("acceptable_fraction",
+                                             &flags_.min_acceptable_fraction));
+    std::string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        absl::InvalidArgumentError("dct_method must be one of {'', "
+                                   "'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    // The TensorFlow-chosen default for JPEG decoding is IFAST, sacrificing
+    // image quality for speed.
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+    flags_.crop = true;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    const Tensor& crop_windows = context->input(1);
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(contents.shape()),
+                absl::InvalidArgumentError(
+                    absl::StrCat("contents must be 1-D, got shape ",
+                                 contents.shape().DebugString())));
+    const int64_t batch_size = contents.dim_size(0);
+    OP_REQUIRES(context,
+                crop_windows.dims() == 2 &&
+                    crop_windows.dim_size(0) == batch_size &&
+                    crop_windows.dim_size(1) == 4,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "crop_windows must have shape [", batch_size,
+                    ", 4], got ", crop_windows.shape().DebugString())));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(size.shape()) &&
+                    size.NumElements() == 2,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "size must be 1-dimensional and have 2 elements, got ",
+                    size.shape().DebugString())));
+    auto size_vec = size.vec<int32_t>();
+    const int out_height = size_vec(0);
+    const int out_width = size_vec(1);
+    OP_REQUIRES(context, out_height > 0 && out_width > 0,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "size must be positive, got [", out_height, ", ",
+                    out_width, "]")));
+
+    Tensor* images = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0,
+                       TensorShape({batch_size, out_height, out_width,
+                                    static_cast<int64_t>(channels_)}),
+                       &images));
+    auto contents_vec = contents.vec<tstring>();
+    auto crop_windows_mat = crop_windows.matrix<int32_t>();
+    float* images_data = images->flat<float>().data();
+    const int64_t image_size =
+        static_cast<int64_t>(out_height) * out_width * channels_;
+
+    // The error of the lowest failing image is reported, matching a serial
+    // loop.
+    mutex mu;
+    int64_t first_error_image = batch_size;
+    absl::Status first_error;
+    auto decode_images = [&](int64_t start, int64_t limit) {
+      std::vector<uint8_t> decoded;
+      std::vector<Interpolation> ys;
+      std::vector<Interpolation> xs;
+      for (int64_t i = start; i < limit; ++i) {
+        absl::Status s = DecodeCropAndResize(
+            contents_vec(i), crop_windows_mat(i, 0), crop_windows_mat(i, 1),
+            crop_windows_mat(i, 2), crop_windows_mat(i, 3), out_height,
+            out_width, &decoded, &ys, &xs, images_data + i * image_size);
+        if (!s.ok()) {
+          mutex_lock l(mu);
+          if (i < first_error_image) {
+            first_error_image = i;
+            first_error = absl::InvalidArgumentError(
+                absl::StrCat("Image ", i, ": ", s.message()));
+          }
+          return;
+        }
+      }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *(context->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
+          kCostPerImage, decode_images);
+    OP_REQUIRES_OK(context, first_error);
+  }
+
+ private:
+  // Decodes the crop window of `input` at the smallest scale that still covers
+  // the output size into `decoded`, and resamples it into `output`.
+  absl::Status DecodeCropAndResize(absl::string_view input, int crop_y,
+                                   int crop_x, int crop_height, int crop_width,
+                                   int out_height, int out_width,
+                                   std::vector<uint8_t>* decoded,
+                                   std::vector<Interpolation>* ys,
+                                   std::vector<Interpolation>* xs,
+                                   float* output) const {
+    if (input.size() > std::numeric_limits<int>::max()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "JPEG contents are too large for int: ", input.size()));
+    }
+    int width, height;
+    if (!jpeg::GetImageInfo(input.data(), input.size(), &width, &height,
+                            /*components=*/nullptr)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid JPEG data, size ", input.size()));
+    }
+    if (crop_y < 0 || crop_x < 0 || crop_height <= 0 || crop_width <= 0 ||
+        static_cast<int64_t>(crop_y) + crop_height > height ||
+        static_cast<int64_t>(crop_x) + crop_width > width) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Invalid crop window [", crop_y, ", ", crop_x, ", ", crop_height,
+          ", ", crop_width, "] for an image of size ", height, "x", width));
+    }
+
+    // Map the crop window to the pixels of the scaled image that cover it.
+    // libjpeg rounds the scaled image size up.
+    const int ratio = ChooseRatio(crop_height, crop_width, out_height,
+                                  out_width);
+    const int scaled_height = (height + ratio - 1) / ratio;
+    const int scaled_width = (width + ratio - 1) / ratio;
+    jpeg::UncompressFlags flags = flags_;
+    flags.ratio = ratio;
+    flags.crop_y = crop_y / ratio;
+    flags.crop_x = crop_x / ratio;
+    flags.crop_height =
+        std::min(scaled_height, (crop_y + crop_height + ratio - 1) / ratio) -
+        flags.crop_y;
+    flags.crop_width =
+        std::min(scaled_width, (crop_x + crop_width + ratio - 1) / ratio) -
+        flags.crop_x;
+
+    int decoded_height = 0;
+    int decoded_width = 0;
+    uint8_t* decoded_data = jpeg::Uncompress(
+        input.data(), input.size(), flags, /*nwarn=*/nullptr,
+        [&](int w, int h, int channels) -> uint8_t* {
+          decoded_height = h;
+          decoded_width = w;
+          decoded->resize(static_cast<int64_t>(h) * w * channels);
+          return decoded->data();
+        });
+    if (decoded_data == nullptr) {
+      return absl::InvalidArgumentError(
+          "jpeg::Uncompress failed. Invalid JPEG data or crop window.");
+    }
+
+    ComputeInterpolation(crop_y, crop_height, out_height, ratio, flags.crop_y,
+                         decoded_height, ys);
+    ComputeInterpolation(crop_x, crop_width, out_width, ratio, flags.crop_x,
+                         decoded_width, xs);
+    for (Interpolation& x : *xs) {
+      x.lower *= channels_;
+      x.upper *= channels_;
+    }
+
+    const int64_t in_row_size = static_cast<int64_t>(decoded_width) * channels_;
+    for (int y = 0; y < out_height; ++y) {
+      const Interpolation& yi = (*ys)[y];
+      const uint8_t* top = decoded_data + yi.lower * in_row_size;
+      const uint8_t* bottom = decoded_data + yi.upper * in_row_size;
+      for (int x = 0; x < out_width; ++x) {
+        const Interpolation& xi = (*xs)[x];
+        for (int c = 0; c < channels_; ++c) {
+          const float top_left = top[xi.lower + c];
+          const float top_right = top[xi.upper + c];
+          const float bottom_left = bottom[xi.lower + c];
+          const float bottom_right = bottom[xi.upper + c];
+          const float top_value = top_left + (top_right - top_left) * xi.lerp;
+          const float bottom_value =
+              bottom_left + (bottom_right - bottom_left) * xi.lerp;
+          *output++ = top_value + (bottom_value - top_value) * yi.lerp;
+        }
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  int channels_;
+  jpeg::UncompressFlags flags_;
+};
+
+}  // namespace
+
+REGISTER_KERNEL_BUILDER(Name("DecodeCropAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeCropAndResizeJpegOp);
+
+}  // namespace tensorflow
@@ -0,0 +1,317 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns an RGB image whose pixels are given by `pixel(y, x, c)`.
+template <typename PixelFn>
+std::vector<uint8_t> MakeImage(int height, int width, PixelFn pixel) {
+  std::vector<uint8_t> image(height * width * 3);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      for (int c = 0; c < 3; ++c) {
+        image[(y * width + x) * 3 + c] = pixel(y, x, c);
+      }
+    }
+  }
+  return image;
+}
+
+tstring EncodeJpeg(const std::vector<uint8_t>& image, int height, int width) {
+  jpeg::CompressFlags flags;
+  flags.format = jpeg::FORMAT_RGB;
+  flags.quality = 100;
+  flags.chroma_downsampling = false;
+  tstring encoded;
+  CHECK(jpeg::Compress(image.data(), width, height, flags, &encoded));
+  return encoded;
+}
+
+tstring SmoothJpeg(int height, int width) {
+  return EncodeJpeg(MakeImage(height, width,
+                              [](int y, int x, int c) {
+                                return (c == 0   ? 2 * x
+                                        : c == 1 ? 2 * y
+                                                 : x + y) %
+                                       256;
+                              }),
+                    height, width);
+}
+
+// Decodes `contents` at full scale, crops it and resizes it with
+// ResizeBilinear's half-pixel-centers sampling.
+std::vector<float> ReferenceDecodeCropAndResize(const tstring& contents,
+                                                int crop_y, int crop_x,
+                                                int crop_height, int crop_width,
+                                                int out_height, int out_width) {
+  jpeg::UncompressFlags flags;
+  flags.components = 3;
+  flags.dct_method = JDCT_ISLOW;
+  int width, height, channels;
+  std::unique_ptr<uint8_t[]> image(
+      jpeg::Uncompress(contents.data(), contents.size(), flags, &width, &height,
+                       &channels, /*nwarn=*/nullptr));
+  CHECK(image != nullptr);
+  auto sample = [](int64_t out, int64_t crop_size, int64_t out_size,
+                   int64_t* lower, int64_t* upper, float* lerp) {
+    const float in = (out + 0.5f) * (static_cast<float>(crop_size) / out_size) -
+                     0.5f;
+    const float in_f = std::floor(in);
+    *upper = std::min(static_cast<int64_t>(std::ceil(in)), crop_size - 1);
+    *lower = std::min(std::max(static_cast<int64_t>(in_f), int64_t{0}), *upper);
+    *lerp = in - in_f;
+  };
+  std::vector<float> out;
+  for (int y = 0; y < out_height; ++y) {
+    int64_t y0, y1;
+    float y_lerp;
+    sample(y, crop_height, out_height, &y0, &y1, &y_lerp);
+    for (int x = 0; x < out_width; ++x) {
+      int64_t x0, x1;
+      float x_lerp;
+      sample(x, crop_width, out_width, &x0, &x1, &x_lerp);
+      for (int c = 0; c < 3; ++c) {
+        auto at = [&](int64_t yy, int64_t xx) -> float {
+          return image[((crop_y + yy) * width + crop_x + xx) * 3 + c];
+        };
+        const float top = at(y0, x0) + (at(y0, x1) - at(y0, x0)) * x_lerp;
+        const float bottom = at(y1, x0) + (at(y1, x1) - at(y1, x0)) * x_lerp;
+        out.push_back(top + (bottom - top) * y_lerp);
+      }
+    }
+  }
+  return out;
+}
+
+class DecodeCropAndResizeJpegOpTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("op", "DecodeCropAndResizeJpeg")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("dct_method", "INTEGER_ACCURATE")
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Checks image `index` of the output against the reference pipeline.
+  void ExpectImageNear(int index, const tstring& contents,
+                       const std::vector<int32_t>& window, int out_height,
+                       int out_width, float tolerance) {
+    const Tensor& output = *GetOutput(0);
+    const int64_t image_size = out_height * out_width * 3;
+    const float* image = output.flat<float>().data() + index * image_size;
+    const std::vector<float> expected = ReferenceDecodeCropAndResize(
+        contents, window[0], window[1], window[2], window[3], out_height,
+        out_width);
+    ASSERT_EQ(expected.size(), image_size);
+    for (int64_t i = 0; i < image_size; ++i) {
+      EXPECT_NEAR(image[i], expected[i], tolerance) << "at " << i;
+    }
+  }
+};
+
+TEST_F(DecodeCropAndResizeJpegOpTest, MatchesDecodeAndResizeAtFullScale) {
+  MakeOp();
+  const tstring image = SmoothJpeg(96, 128);
+  // The crop windows are less than twice the output size, so they are decoded
+  // at full scale.
+  AddInputFromArray<tstring>(TensorShape({2}), {image, image});
+  AddInputFromArray<int32_t>(TensorShape({2, 4}),
+                             {10, 20, 50, 60, 0, 7, 96, 100});
+  AddInputFromArray<int32_t>(TensorShape({2}), {40, 56});
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(GetOutput(0)->shape(), TensorShape({2, 40, 56, 3}));
+  ExpectImageNear(0, image, {10, 20, 50, 60}, 40, 56, 1e-3);
+  ExpectImageNear(1, image, {0, 7, 96, 100}, 40, 56, 1e-3);
+}
+
+TEST_F(DecodeCropAndResizeJpegOpTest, ScaledDecodeIsCloseToFullScale) {
+  MakeOp();
+  const tstring image = SmoothJpeg(96, 128);
+  // These crops are decoded at 1/4 and 1/2 scale.
+  AddInputFromArray<tstring>(TensorShape({2}), {image, image});
+  AddInputFromArray<int32_t>(TensorShape({2, 4}),
+                             {0, 0, 96, 128, 6, 5, 80, 90});
+  AddInputFromArray<int32_t>(TensorShape({2}), {24, 32});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectImageNear(0, image, {0, 0, 96, 128}, 24, 32, 4.0);
+  ExpectImageNear(1, image, {6, 5, 80, 90}, 24, 32, 4.0);
+}
+
+TEST_F(DecodeCropAndResizeJpegOpTest, InvalidCropWindow) {
+  MakeOp();
+  const tstring image = SmoothJpeg(32, 32);
+  AddInputFromArray<tstring>(TensorShape({2}), {image, image});
+  AddInputFromArray<int32_t>(TensorShape({2, 4}), {0, 0, 32, 32, 8, 8, 32, 8});
+  AddInputFromArray<int32_t>(TensorShape({2}), {8, 8});
+  absl::Status status = RunOpKernel();
+  EXPECT_TRUE(absl::IsInvalidArgument(status));
+  EXPECT_TRUE(
+      absl::StartsWith(status.message(), "Image 1: Invalid crop window"))
+      << status;
+}
+
+TEST_F(DecodeCropAndResizeJpegOpTest, InvalidJpeg) {
+  MakeOp();
+  AddInputFromArray<tstring>(TensorShape({1}), {"not a jpeg"});
+  AddInputFromArray<int32_t>(TensorShape({1, 4}), {0, 0, 1, 1});
+  AddInputFromArray<int32_t>(TensorShape({2}), {1, 1});
+  EXPECT_TRUE(absl::IsInvalidArgument(RunOpKernel()));
+}
+
+// ImageNet-sized JPEGs with a random-crop-like window covering 80% of each
+// side, i.e. 300x400 pixels. The windows are resized to 224x224, which needs
+// the full decoded resolution, and to 112x112 and 64x64, which the fused op
+// decodes with DCT scaling at ratios 2 and 4.
+constexpr int kBenchmarkHeight = 375;
+constexpr int kBenchmarkWidth = 500;
+
+Tensor BenchmarkImages(int batch_size) {
+  uint32_t state = 1;
+  const tstring image = EncodeJpeg(
+      MakeImage(kBenchmarkHeight, kBenchmarkWidth,
+                [&state](int y, int x, int c) {
+                  state = state * 1664525u + 1013904223u;
+                  return (x * (c + 1) + y * 3 + (state >> 28)) % 256;
+                }),
+      kBenchmarkHeight, kBenchmarkWidth);
+  Tensor contents(DT_STRING, TensorShape({batch_size}));
+  contents.flat<tstring>().setConstant(image);
+  return contents;
+}
+
+std::vector<int32_t> BenchmarkWindow(int i) {
+  const int crop_height = kBenchmarkHeight * 4 / 5;
+  const int crop_width = kBenchmarkWidth * 4 / 5;
+  return {(i * 7) % (kBenchmarkHeight - crop_height),
+          (i * 13) % (kBenchmarkWidth - crop_width), crop_height, crop_width};
+}
+
+Graph* FusedGraph(int batch_size, int size) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor windows(DT_INT32, TensorShape({batch_size, 4}));
+  for (int i = 0; i < batch_size; ++i) {
+    const std::vector<int32_t> window = BenchmarkWindow(i);
+    for (int j = 0; j < 4; ++j) windows.matrix<int32_t>()(i, j) = window[j];
+  }
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "DecodeCropAndResizeJpeg")
+                  .Input(test::graph::Constant(g, BenchmarkImages(batch_size)))
+                  .Input(test::graph::Constant(g, windows))
+                  .Input(test::graph::Constant(
+                      g, test::AsTensor<int32_t>({size, size})))
+                  .Finalize(g, &node));
+  return g;
+}
+
+// DecodeAndCropJpeg, ResizeBilinear and a concat per batch.
+Graph* UnfusedGraph(int batch_size, int size) {
+  Graph* g = new Graph(OpRegistry::Global());
+  const Tensor contents = BenchmarkImages(batch_size);
+  Node* size_node =
+      test::graph::Constant(g, test::AsTensor<int32_t>({size, size}));
+  Node* zero = test::graph::Constant(g, test::AsScalar<int32_t>(0));
+  std::vector<NodeBuilder::NodeOut> resized;
+  for (int i = 0; i < batch_size; ++i) {
+    Node* decoded;
+    TF_CHECK_OK(
+        NodeBuilder(g->NewName("decode"), "DecodeAndCropJpeg")
+            .Input(test::graph::Constant(
+                g, test::AsScalar<tstring>(contents.flat<tstring>()(i))))
+            .Input(test::graph::Constant(
+                g, test::AsTensor<int32_t>(BenchmarkWindow(i))))
+            .Attr("channels", 3)
+            .Finalize(g, &decoded));
+    Node* expanded;
+    TF_CHECK_OK(NodeBuilder(g->NewName("expand"), "ExpandDims")
+                    .Input(decoded)
+                    .Input(zero)
+                    .Finalize(g, &expanded));
+    Node* resize;
+    TF_CHECK_OK(NodeBuilder(g->NewName("resize"), "ResizeBilinear")
+                    .Input(expanded)
+                    .Input(size_node)
+                    .Attr("half_pixel_centers", true)
+                    .Finalize(g, &resize));
+    resized.emplace_back(resize);
+  }
+  Node* batch;
+  TF_CHECK_OK(NodeBuilder(g->NewName("batch"), "ConcatV2")
+                  .Input(resized)
+                  .Input(zero)
+                  .Finalize(g, &batch));
+  return g;
+}
+
+void BM_DecodeCropAndResizeJpeg(::testing::benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const int size = state.range(1);
+  test::Benchmark("cpu", FusedGraph(batch_size, size),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_DecodeCropAndResizeJpeg)
+    ->UseRealTime()
+    ->ArgPair(1, 224)
+    ->ArgPair(32, 224)
+    ->ArgPair(1, 112)
+    ->ArgPair(32, 112)
+    ->ArgPair(32, 64);
+
+void BM_DecodeAndCropJpegThenResize(::testing::benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const int size = state.range(1);
+  test::Benchmark("cpu", UnfusedGraph(batch_size, size),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_DecodeAndCropJpegThenResize)
+    ->UseRealTime()
+    ->ArgPair(1, 224)
+    ->ArgPair(32, 224)
+    ->ArgPair(1, 112)
+    ->ArgPair(32, 112)
+    ->ArgPair(32, 64);
+
+}  // namespace
+}  // namespace tensorflow
@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
+#include <memory>
 #include <vector>
 #define EIGEN_USE_THREADS
 
@@ -26,12 +27,15 @@ limitations under the License.
 #include <algorithm>
 #include <array>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/image/separable_resampler.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/image_resizer_state.h"
@@ -139,24 +143,6 @@ inline void GetWeightsAndIndices(const float scale, const int64_t out_loc,
   }
 }
 
-template <typename T>
-inline float Interpolate1D(const float weight_0, const float weight_1,
-                           const float weight_2, const float weight_3,
-                           const T value_0, const T value_1, const T value_2,
-                           const T value_3) {
-  return static_cast<float>(value_0) * weight_0 +
-         static_cast<float>(value_1) * weight_1 +
-         static_cast<float>(value_2) * weight_2 +
-         static_cast<float>(value_3) * weight_3;
-}
-
-// Compute the 1D interpolation for a given X index using the y_weights
-static float Compute(float values_[4], const float xw_0, const float xw_1,
-                     const float xw_2, const float xw_3) {
-  return Interpolate1D(xw_0, xw_1, xw_2, xw_3, values_[0], values_[1],
-                       values_[2], values_[3]);
-}
-
 // In order to compute a single output value, we look at a 4x4 patch in the
 // source image. As we iterate increasing X across the image, the new 4x4 patch
 // often overlaps with the previous 4x4 patch we just looked at.
@@ -211,36 +197,6 @@ class CachedInterpolationCalculator {
   int64_t indexes_[4];
 };
 
-static void ComputeXWeightsAndIndices(const ImageResizerState& resizer_state,
-                                      const bool half_pixel_centers,
-                                      std::vector<WeightsAndIndices>* x_wais) {
-  CachedInterpolationCalculator calc;
-  if (half_pixel_centers) {
-    for (int64_t x = 0; x < resizer_state.out_width; ++x) {
-      GetWeightsAndIndices<HalfPixelScaler, true>(
-          resizer_state.width_scale, x, resizer_state.in_width, &(*x_wais)[x]);
-      auto& x_wai = (*x_wais)[x];
-      x_wai.advance = calc.Advance(x_wai.index_0, x_wai.index_1, x_wai.index_2,
-                                   x_wai.index_3);
-    }
-  } else {
-    for (int64_t x = 0; x < resizer_state.out_width; ++x) {
-      GetWeightsAndIndices<LegacyScaler, false>(
-          resizer_state.width_scale, x, resizer_state.in_width, &(*x_wais)[x]);
-      auto& x_wai = (*x_wais)[x];
-      x_wai.advance = calc.Advance(x_wai.index_0, x_wai.index_1, x_wai.index_2,
-                                   x_wai.index_3);
-    }
-  }
-  // Scale the values so they can be used as offsets into buffers.
-  for (int x = 0; x < resizer_state.out_width; ++x) {
-    (*x_wais)[x].index_0 *= resizer_state.channels;
-    (*x_wais)[x].index_1 *= resizer_state.channels;
-    (*x_wais)[x].index_2 *= resizer_state.channels;
-    (*x_wais)[x].index_3 *= resizer_state.channels;
-  }
-}
-
 static void ComputeGradientXWeightsAndIndices(
     const ImageResizerGradientState& resizer_state,
     const bool half_pixel_centers, std::vector<WeightsAndIndices>* x_wais) {
@@ -269,208 +225,20 @@ static void ComputeGradientXWeightsAndIndices(
   // gradient pass.
 }
 
-template <typename T>
-static EIGEN_ALWAYS_INLINE float ComputeYInterpolation(
-    int which, int channel_num, const WeightsAndIndices& y_wai,
-    const T* y_ptr_0, const T* y_ptr_1, const T* y_ptr_2, const T* y_ptr_3,
-    const WeightsAndIndices& x_wai) {
-  int x_index;
-  switch (which) {
-    case 0:
-      x_index = x_wai.index_0;
-      break;
-    case 1:
-      x_index = x_wai.index_1;
-      break;
-    case 2:
-      x_index = x_wai.index_2;
-      break;
-    default:
-      x_index = x_wai.index_3;
-      break;
-  }
-  const int64_t pt_index = x_index + channel_num;
-  return Interpolate1D<T>(y_wai.weight_0, y_wai.weight_1, y_wai.weight_2,
-                          y_wai.weight_3, y_ptr_0[pt_index], y_ptr_1[pt_index],
-                          y_ptr_2[pt_index], y_ptr_3[pt_index]);
-}
-
-template <typename T>
-inline void interpolate_with_caching(
-    const typename TTypes<T, 4>::ConstTensor& input_data,
-    const ImageResizerState& resizer_state, const bool half_pixel_centers,
-    typename TTypes<float, 4>::Tensor output_data) {
-  std::vector<WeightsAndIndices> x_wais(resizer_state.out_width);
-  ComputeXWeightsAndIndices(resizer_state, half_pixel_centers, &x_wais);
-
-  const auto num_channels = resizer_state.channels;
-  const int64_t in_row_width = resizer_state.in_width * num_channels;
-  const int64_t in_batch_width = resizer_state.in_height * in_row_width;
-
-  const T* input_b_ptr = input_data.data();
-  float* output_y_ptr = output_data.data();
-  std::vector<float> cached_value(num_channels == 3 ? 0 : 4 * num_channels, 0);
-
-  for (int64_t b = 0; b < resizer_state.batch_size;
-       ++b, input_b_ptr += in_batch_width) {
-    for (int64_t y = 0; y < resizer_state.out_height;
-         ++y, output_y_ptr += resizer_state.out_width * num_channels) {
-      WeightsAndIndices y_wai;
-      if (half_pixel_centers) {
-        GetWeightsAndIndices<HalfPixelScaler, true>(
-            resizer_state.height_scale, y, resizer_state.in_height, &y_wai);
-      } else {
-        GetWeightsAndIndices<LegacyScaler, false>(
-            resizer_state.height_scale, y, resizer_state.in_height, &y_wai);
-      }
-      // Make pointers represent offsets of data in input_b_ptr.
-      const T* y_ptr_0 = input_b_ptr + y_wai.index_0 * in_row_width;
-      const T* y_ptr_1 = input_b_ptr + y_wai.index_1 * in_row_width;
-      const T* y_ptr_2 = input_b_ptr + y_wai.index_2 * in_row_width;
-      const T* y_ptr_3 = input_b_ptr + y_wai.index_3 * in_row_width;
-
-      if (num_channels == 3) {
-        // Manually unroll case of 3 channels.
-        float cached_value_0[4] = {0};
-        float cached_value_1[4] = {0};
-        float cached_value_2[4] = {0};
-        for (int64_t x = 0; x < resizer_state.out_width; ++x) {
-          const WeightsAndIndices& x_wai = x_wais[x];
-          // Shift values in cached_value_* to fill first 'advance' values.
-          switch (x_wai.advance) {
-            case 3:
-              cached_value_0[0] = cached_value_0[1];
-              cached_value_0[1] = cached_value_0[2];
-              cached_value_0[2] = cached_value_0[3];
-              cached_value_1[0] = cached_value_1[1];
-              cached_value_1[1] = cached_value_1[2];
-              cached_value_1[2] = cached_value_1[3];
-              cached_value_2[0] = cached_value_2[1];
-              cached_value_2[1] = cached_value_2[2];
-              cached_value_2[2] = cached_value_2[3];
-              break;
-            case 2:
-              cached_value_0[0] = cached_value_0[2];
-              cached_value_0[1] = cached_value_0[3];
-              cached_value_1[0] = cached_value_1[2];
-              cached_value_1[1] = cached_value_1[3];
-              cached_value_2[0] = cached_value_2[2];
-              cached_value_2[1] = cached_value_2[3];
-              break;
-            case 1: {
-              cached_value_0[0] = cached_value_0[3];
-              cached_value_1[0] = cached_value_1[3];
-              cached_value_2[0] = cached_value_2[3];
-              break;
-            }
-          }
-
-          // Set the remaining '4-advance' values by computing.
-          switch (x_wai.advance) {
-            case 0:
-              cached_value_0[0] = ComputeYInterpolation(
-                  0, 0, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_1[0] = ComputeYInterpolation(
-                  0, 1, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_2[0] = ComputeYInterpolation(
-                  0, 2, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              TF_FALLTHROUGH_INTENDED;
-            case 1:
-              cached_value_0[1] = ComputeYInterpolation(
-                  1, 0, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_1[1] = ComputeYInterpolation(
-                  1, 1, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_2[1] = ComputeYInterpolation(
-                  1, 2, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              TF_FALLTHROUGH_INTENDED;
-            case 2:
-              cached_value_0[2] = ComputeYInterpolation(
-                  2, 0, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_1[2] = ComputeYInterpolation(
-                  2, 1, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_2[2] = ComputeYInterpolation(
-                  2, 2, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              TF_FALLTHROUGH_INTENDED;
-            case 3:
-              cached_value_0[3] = ComputeYInterpolation(
-                  3, 0, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_1[3] = ComputeYInterpolation(
-                  3, 1, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              cached_value_2[3] = ComputeYInterpolation(
-                  3, 2, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              break;
-          }
-          output_y_ptr[x * num_channels + 0] =
-              Compute(cached_value_0, x_wai.weight_0, x_wai.weight_1,
-                      x_wai.weight_2, x_wai.weight_3);
-          output_y_ptr[x * num_channels + 1] =
-              Compute(cached_value_1, x_wai.weight_0, x_wai.weight_1,
-                      x_wai.weight_2, x_wai.weight_3);
-          output_y_ptr[x * num_channels + 2] =
-              Compute(cached_value_2, x_wai.weight_0, x_wai.weight_1,
-                      x_wai.weight_2, x_wai.weight_3);
-        }
-      } else {
-        for (int64_t x = 0; x < resizer_state.out_width; ++x) {
-          const WeightsAndIndices& x_wai = x_wais[x];
-          // Shift values in cached_value to fill first 'advance' values.
-          switch (x_wai.advance) {
-            case 3:
-              for (int64_t c = 0; c < num_channels; ++c) {
-                cached_value[4 * c + 0] = cached_value[4 * c + 1];
-                cached_value[4 * c + 1] = cached_value[4 * c + 2];
-                cached_value[4 * c + 2] = cached_value[4 * c + 3];
-              }
-              break;
-            case 2:
-              for (int64_t c = 0; c < num_channels; ++c) {
-                cached_value[4 * c + 0] = cached_value[4 * c + 2];
-                cached_value[4 * c + 1] = cached_value[4 * c + 3];
-              }
-              break;
-            case 1: {
-              for (int64_t c = 0; c < num_channels; ++c) {
-                cached_value[4 * c + 0] = cached_value[4 * c + 3];
-              }
-              break;
-            }
-          }
-
-          // Set the remaining '4-advance' values by computing.
-          switch (x_wai.advance) {
-            case 0:
-              for (int64_t c = 0; c < num_channels; ++c) {
-                cached_value[4 * c + 0] = ComputeYInterpolation(
-                    0, c, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              }
-              TF_FALLTHROUGH_INTENDED;
-            case 1:
-              for (int64_t c = 0; c < num_channels; ++c) {
-                cached_value[4 * c + 1] = ComputeYInterpolation(
-                    1, c, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              }
-              TF_FALLTHROUGH_INTENDED;
-            case 2:
-              for (int64_t c = 0; c < num_channels; ++c) {
-                cached_value[4 * c + 2] = ComputeYInterpolation(
-                    2, c, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              }
-              TF_FALLTHROUGH_INTENDED;
-            case 3:
-              for (int64_t c = 0; c < num_channels; ++c) {
-                cached_value[4 * c + 3] = ComputeYInterpolation(
-                    3, c, y_wai, y_ptr_0, y_ptr_1, y_ptr_2, y_ptr_3, x_wai);
-              }
-              break;
-          }
-          for (int64_t c = 0; c < num_channels; ++c) {
-            output_y_ptr[x * num_channels + c] =
-                Compute(&cached_value[4 * c], x_wai.weight_0, x_wai.weight_1,
-                        x_wai.weight_2, x_wai.weight_3);
-          }
-        }
-      }
-    }
+// Computes the taps of bicubic interpolation from `in_size` to `out_size`
+// pixels along one dimension.
+template <typename Scaler, bool use_keys_cubic>
+void ComputeCubicCoefficients(const float scale, const int64_t out_size,
+                              const int64_t in_size,
+                              ResamplingCoefficients* coefficients) {
+  for (int64_t i = 0; i < out_size; ++i) {
+    WeightsAndIndices wai;
+    GetWeightsAndIndices<Scaler, use_keys_cubic>(scale, i, in_size, &wai);
+    coefficients->AddTap(wai.index_0, wai.weight_0);
+    coefficients->AddTap(wai.index_1, wai.weight_1);
+    coefficients->AddTap(wai.index_2, wai.weight_2);
+    coefficients->AddTap(wai.index_3, wai.weight_3);
+    coefficients->FinishOutput();
   }
 }
 
@@ -571,13 +339,37 @@ class ResizeBicubicOp : public OpKernel {
         context->input(0).tensor<T, 4>());
     TTypes<float, 4>::Tensor output_data = st.output->tensor<float, 4>();
 
-    interpolate_with_caching<T>(input_data, st, half_pixel_centers_,
-                                output_data);
+    auto rows = GetCoefficients(st.in_height, st.out_height, st.height_scale);
+    OP_REQUIRES_OK(context, rows.status());
+    auto cols = GetCoefficients(st.in_width, st.out_width, st.width_scale);
+    OP_REQUIRES_OK(context, cols.status());
+    // Interpolating along the height first keeps the rounding of the
+    // original implementation.
+    SeparableResample<T>(context->eigen_device<CPUDevice>(), **rows, **cols,
+                         SeparableResampleOrder::kHeightFirst,
+                         /*output_scale=*/1.0f, input_data, output_data);
   }
 
  private:
+  absl::StatusOr<std::shared_ptr<const ResamplingCoefficients>>
+  GetCoefficients(int64_t in_size, int64_t out_size, float scale) {
+    return coefficients_cache_.Get(
+        {in_size, out_size, scale, /*translate=*/0.0f},
+        [&](ResamplingCoefficients* coefficients) {
+          if (half_pixel_centers_) {
+            ComputeCubicCoefficients<HalfPixelScaler, true>(
+                scale, out_size, in_size, coefficients);
+          } else {
+            ComputeCubicCoefficients<LegacyScaler, false>(
+                scale, out_size, in_size, coefficients);
+          }
+          return absl::OkStatus();
+        });
+  }
+
   bool align_corners_;
   bool half_pixel_centers_;
+  ResamplingCoefficientsCache coefficients_cache_;
 };
 
 template <typename Device, typename T>
@@ -22,15 +22,15 @@ limitations under the License.
 namespace tensorflow {
 
 static Graph* Resize(const char* algorithm, int batches, int width,
-                     int height) {
+                     int height, int out_width, int out_height) {
   Graph* g = new Graph(OpRegistry::Global());
   Tensor in(DT_FLOAT, TensorShape({batches, width, height, 3}));
   in.flat<float>().setRandom();
 
   Tensor out_size(DT_INT32, TensorShape({2}));
   auto out_size_flat = out_size.flat<int32_t>();
-  out_size_flat(0) = width * 2;
-  out_size_flat(1) = height * 2;
+  out_size_flat(0) = out_width;
+  out_size_flat(1) = out_height;
 
   Node* ret;
   absl::Status s = NodeBuilder(g->NewName("n"), algorithm)
@@ -44,15 +44,33 @@ static Graph* Resize(const char* algorithm, int batches, int width,
 #define BM_ResizeDev(DEVICE, ALGORITHM, B, W, H)                  \
   static void BM_Resize_##ALGORITHM##_##DEVICE##_##B##_##W##_##H( \
       ::testing::benchmark::State& state) {                       \
-    test::Benchmark(#DEVICE, Resize(#ALGORITHM, B, W, H),         \
-                    /*old_benchmark_api*/ false)                  \
-        .Run(state);                                              \
-    state.SetItemsProcessed(state.iterations() * B * W * H * 3);  \
-  }                                                               \
+    test::Benchmark(#DEVICE, Resize(#ALGORITHM, B, W, H, W * 2, H * 2), \
+                    /*old_benchmark_api*/ false)                        \
+        .Run(state);                                                    \
+    state.SetItemsProcessed(state.iterations() * B * W * H * 3);        \
+  }                                                                     \
   BENCHMARK(BM_Resize_##ALGORITHM##_##DEVICE##_##B##_##W##_##H)
 
+// Downscales a W x H image by a factor of S.
+#define BM_DownscaleDev(DEVICE, ALGORITHM, B, W, H, S)                      \
+  static void                                                               \
+      BM_Downscale_##ALGORITHM##_##DEVICE##_##B##_##W##_##H##_##S(          \
+          ::testing::benchmark::State& state) {                             \
+    test::Benchmark(#DEVICE, Resize(#ALGORITHM, B, W, H, W / S, H / S),     \
+                    /*old_benchmark_api*/ false)                            \
+        .Run(state);                                                        \
+    state.SetItemsProcessed(state.iterations() * B * W * H * 3);            \
+  }                                                                         \
+  BENCHMARK(BM_Downscale_##ALGORITHM##_##DEVICE##_##B##_##W##_##H##_##S)
+
 BM_ResizeDev(cpu, ResizeNearestNeighbor, 10, 499, 499);
 BM_ResizeDev(cpu, ResizeBilinear, 10, 499, 499);
+BM_ResizeDev(cpu, ResizeBicubic, 10, 499, 499);
+BM_ResizeDev(cpu, ResizeArea, 10, 499, 499);
+BM_DownscaleDev(cpu, ResizeBicubic, 10, 1024, 1024, 2);
+BM_DownscaleDev(cpu, ResizeBicubic, 10, 1024, 1024, 8);
+BM_DownscaleDev(cpu, ResizeArea, 10, 1024, 1024, 2);
+BM_DownscaleDev(cpu, ResizeArea, 10, 1024, 1024, 8);
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 BM_ResizeDev(gpu, ResizeNearestNeighbor, 10, 499, 499);
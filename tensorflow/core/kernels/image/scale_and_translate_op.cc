@@ -17,11 +17,13 @@ limitations under the License.
 #include <algorithm>
 #include <cstdlib>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #define EIGEN_USE_THREADS
 
@@ -35,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/image/sampling_kernels.h"
 #include "tensorflow/core/kernels/image/scale_and_translate_op.h"
+#include "tensorflow/core/kernels/image/separable_resampler.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
@@ -314,7 +317,6 @@ class ScaleAndTranslateOp : public OpKernel {
                 absl::InvalidArgumentError(
                     "input sizes must be between 0 and max int32"));
 
-    const int64_t batch_size = input.dim_size(0);
     const int64_t input_height = input.dim_size(1);
     const int64_t input_width = input.dim_size(2);
     const int64_t channels = input.dim_size(3);
@@ -350,41 +352,46 @@ class ScaleAndTranslateOp : public OpKernel {
     typename TTypes<T, 4>::ConstTensor image_data(input.tensor<T, 4>());
     TTypes<float, 4>::Tensor output_data = output->tensor<float, 4>();
 
-    functor::Spans col_spans;
-    OP_REQUIRES_OK(
-        context,
-        ComputeSpans(context, kernel_type_, output_width, input_width,
-                     col_scale, col_translation, antialias_, &col_spans));
-    functor::Spans row_spans;
-    OP_REQUIRES_OK(
-        context,
-        ComputeSpans(context, kernel_type_, output_height, input_height,
-                     row_scale, row_translation, antialias_, &row_spans));
-    Tensor intermediate_t;
-    OP_REQUIRES_OK(
-        context, context->allocate_temp(DT_FLOAT,
-                                        TensorShape({batch_size, output_height,
-                                                     input_width, channels}),
-                                        &intermediate_t));
-    TTypes<float, 4>::Tensor intermediate_data =
-        intermediate_t.tensor<float, 4>();
-
-    const functor::Spans& const_row_spans = row_spans;
-    typename TTypes<int32_t, 1>::ConstTensor row_starts(
-        const_row_spans.starts.tensor<int32_t, 1>());
-    typename TTypes<float, 1>::ConstTensor row_weights(
-        const_row_spans.weights.tensor<float, 1>());
-    const functor::Spans& const_col_spans = col_spans;
-    typename TTypes<int32_t, 1>::ConstTensor col_starts(
-        const_col_spans.starts.tensor<int32_t, 1>());
-    typename TTypes<float, 1>::ConstTensor col_weights(
-        const_col_spans.weights.tensor<float, 1>());
+    auto row_coefficients = GetCoefficients(
+        context, output_height, input_height, row_scale, row_translation);
+    OP_REQUIRES_OK(context, row_coefficients.status());
+    auto col_coefficients = GetCoefficients(
+        context, output_width, input_width, col_scale, col_translation);
+    OP_REQUIRES_OK(context, col_coefficients.status());
+    SeparableResample<T>(context->eigen_device<Device>(), **row_coefficients,
+                         **col_coefficients,
+                         SeparableResampleOrder::kWidthFirst,
+                         /*output_scale=*/1.0f, image_data, output_data);
+  }
 
-    functor::GatherSpans<Device, T>()(
-        context, context->eigen_device<Device>(), row_spans.span_size,
-        row_starts, row_weights, col_spans.span_size, col_starts, col_weights,
-        image_data, intermediate_data, output_data);
+ private:
+  // Returns the taps of the spans for one dimension, see ComputeSpans.
+  absl::StatusOr<std::shared_ptr<const ResamplingCoefficients>>
+  GetCoefficients(OpKernelContext* context, int64_t output_size,
+                  int64_t input_size, float scale, float translate) {
+    return coefficients_cache_.Get(
+        {input_size, output_size, scale, translate},
+        [&](ResamplingCoefficients* coefficients) -> absl::Status {
+          Spans spans;
+          TF_RETURN_IF_ERROR(ComputeSpans(context, kernel_type_, output_size,
+                                          input_size, scale, translate,
+                                          antialias_, &spans));
+          auto starts = spans.starts.vec<int32_t>();
+          auto weights = spans.weights.vec<float>();
+          for (int64_t x = 0; x < output_size; ++x) {
+            const int64_t start = starts(x);
+            const int64_t end =
+                std::min<int64_t>(start + spans.span_size, input_size);
+            for (int64_t i = start; i < end; ++i) {
+              coefficients->AddTap(i, weights(x * spans.span_size + i - start));
+            }
+            coefficients->FinishOutput();
+          }
+          return absl::OkStatus();
+        });
   }
+
+  ResamplingCoefficientsCache coefficients_cache_;
   functor::SamplingKernelType kernel_type_;
   bool antialias_;
 };
@@ -47,5 +47,42 @@ void BM_ScaleAndTranslateOp(benchmark::State& state) {
 
 BENCHMARK(BM_ScaleAndTranslateOp)->UseRealTime()->MeasureProcessCPUTime();
 
+// Downscales a 1024x1024 image by a factor of state.range(0) with the
+// kernel_type state.range(1) selects.
+void BM_ScaleAndTranslateOpDownscale(benchmark::State& state) {
+  const int factor = state.range(0);
+  const char* kernel_type = state.range(1) == 0 ? "triangle" : "lanczos3";
+  auto* g = new Graph(OpRegistry::Global());
+  Tensor in(DT_FLOAT, TensorShape({1, 1024, 1024, 3}));
+  in.flat<float>().setRandom();
+  Tensor size(DT_INT32, TensorShape({2}));
+  size.flat<int32_t>()(0) = 1024 / factor;
+  size.flat<int32_t>()(1) = 1024 / factor;
+  Tensor scale(DT_FLOAT, TensorShape({2}));
+  scale.flat<float>()(0) = 1.0f / factor;
+  scale.flat<float>()(1) = 1.0f / factor;
+  Tensor translate(DT_FLOAT, TensorShape({2}));
+  translate.flat<float>()(0) = 0.0;
+  translate.flat<float>()(1) = 0.0;
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "ScaleAndTranslate")
+                  .Input(test::graph::Constant(g, in))
+                  .Input(test::graph::Constant(g, size))
+                  .Input(test::graph::Constant(g, scale))
+                  .Input(test::graph::Constant(g, translate))
+                  .Attr("kernel_type", kernel_type)
+                  .Attr("antialias", true)
+                  .Finalize(g, &ret));
+  test::Benchmark("cpu", g).Run(state);
+}
+
+BENCHMARK(BM_ScaleAndTranslateOpDownscale)
+    ->ArgPair(2, 0)
+    ->ArgPair(2, 1)
+    ->ArgPair(8, 0)
+    ->ArgPair(8, 1)
+    ->UseRealTime()
+    ->MeasureProcessCPUTime();
+
 }  // namespace
 }  // namespace tensorflow
@@ -0,0 +1,375 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/kernels/image/separable_resampler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+
+absl::StatusOr<std::shared_ptr<const ResamplingCoefficients>>
+ResamplingCoefficientsCache::Get(
+    const Key& key,
+    absl::FunctionRef<absl::Status(ResamplingCoefficients*)> compute) {
+  {
+    mutex_lock l(mu_);
+    for (Entry& entry : entries_) {
+      if (entry.key == key) {
+        entry.last_use = ++use_count_;
+        return entry.coefficients;
+      }
+    }
+  }
+
+  auto coefficients = std::make_shared<ResamplingCoefficients>();
+  TF_RETURN_IF_ERROR(compute(coefficients.get()));
+
+  mutex_lock l(mu_);
+  for (Entry& entry : entries_) {
+    // Another call computed the same coefficients in the meantime.
+    if (entry.key == key) {
+      entry.last_use = ++use_count_;
+      return entry.coefficients;
+    }
+  }
+  if (entries_.size() >= kMaxEntries) {
+    entries_.erase(std::min_element(entries_.begin(), entries_.end(),
+                                    [](const Entry& a, const Entry& b) {
+                                      return a.last_use < b.last_use;
+                                    }));
+  }
+  entries_.push_back(Entry{key, coefficients, ++use_count_});
+  return std::shared_ptr<const ResamplingCoefficients>(std::move(coefficients));
+}
+
+namespace {
+
+using ConstRow = Eigen::Map<const Eigen::ArrayXf>;
+using Row = Eigen::Map<Eigen::ArrayXf>;
+
+// Filters one row of `in` along the width with `cols` into `out`. The number
+// of channels is a template parameter for the common image layouts, so that
+// the loops over channels are unrolled, and `kChannels` is 0 otherwise.
+template <typename T, int kChannels>
+void FilterRow(const T* in, const ResamplingCoefficients& cols,
+               const int dynamic_channels, float* out) {
+  const int channels = kChannels > 0 ? kChannels : dynamic_channels;
+  const int64_t* offsets = cols.offsets.data();
+  const int64_t* indices = cols.indices.data();
+  const float* weights = cols.weights.data();
+  const int64_t out_width = cols.output_size();
+
+  for (int64_t x = 0; x < out_width; ++x, out += channels) {
+    const int64_t begin = offsets[x];
+    const int64_t end = offsets[x + 1];
+    if (begin == end) {
+      std::fill(out, out + channels, 0.0f);
+      continue;
+    }
+    const T* pixel = in + indices[begin] * channels;
+    for (int c = 0; c < channels; ++c) {
+      out[c] = static_cast<float>(pixel[c]) * weights[begin];
+    }
+    for (int64_t tap = begin + 1; tap < end; ++tap) {
+      pixel = in + indices[tap] * channels;
+      for (int c = 0; c < channels; ++c) {
+        out[c] += static_cast<float>(pixel[c]) * weights[tap];
+      }
+    }
+  }
+}
+
+template <typename T>
+using FilterRowFn = void (*)(const T*, const ResamplingCoefficients&, int,
+                             float*);
+
+template <typename T>
+FilterRowFn<T> GetFilterRow(int channels) {
+  switch (channels) {
+    case 1:
+      return FilterRow<T, 1>;
+    case 3:
+      return FilterRow<T, 3>;
+    case 4:
+      return FilterRow<T, 4>;
+    default:
+      return FilterRow<T, 0>;
+  }
+}
+
+// The horizontally filtered input rows of one image that the output rows
+// being computed need.
+//
+// The taps of successive output rows move forward through the input, so the
+// rows are kept in a window that holds the taps of any one output row. Input
+// row i is kept in slot i % num_slots, where it stays until a later row
+// replaces it. Each input row is thus filtered once per run of consecutive
+// output rows, and the window stays small enough to be in cache.
+template <typename T>
+class FilteredRowWindow {
+ public:
+  FilteredRowWindow(const ResamplingCoefficients& cols, int channels,
+                    int64_t num_slots)
+      : cols_(cols),
+        channels_(channels),
+        filter_row_(GetFilterRow<T>(channels)),
+        row_size_(cols.output_size() * channels),
+        rows_(num_slots, -1),
+        buffer_(num_slots * row_size_) {}
+
+  // Returns input row `row` of `image` filtered along the width. `image` must
+  // be the same as in the previous calls for rows to be reused, see Reset.
+  ConstRow Get(const T* image, int64_t in_row_size, int64_t row) {
+    const int64_t slot = row % rows_.size();
+    float* filtered = buffer_.data() + slot * row_size_;
+    if (rows_[slot] != row) {
+      filter_row_(image + row * in_row_size, cols_, channels_, filtered);
+      rows_[slot] = row;
+    }
+    return ConstRow(filtered, row_size_);
+  }
+
+  // Drops the rows of the previous image.
+  void Reset() { std::fill(rows_.begin(), rows_.end(), -1); }
+
+ private:
+  const ResamplingCoefficients& cols_;
+  const int channels_;
+  const FilterRowFn<T> filter_row_;
+  const int64_t row_size_;
+  std::vector<int64_t> rows_;
+  std::vector<float> buffer_;
+};
+
+// Computes output row `y` from the rows of `image` filtered along the width.
+template <typename T>
+void FilterColumn(const ResamplingCoefficients& rows, int64_t y,
+                  float output_scale, const T* image, int64_t in_row_size,
+                  FilteredRowWindow<T>* window, float* out_row,
+                  int64_t out_row_size) {
+  Row out(out_row, out_row_size);
+  auto filtered_row = [&](int64_t tap) {
+    return window->Get(image, in_row_size, rows.indices[tap]);
+  };
+
+  const int64_t begin = rows.offsets[y];
+  const int64_t end = rows.offsets[y + 1];
+  if (begin == end) {
+    out.setZero();
+  } else {
+    out = filtered_row(begin) * rows.weights[begin];
+    for (int64_t tap = begin + 1; tap < end; ++tap) {
+      out += filtered_row(tap) * rows.weights[tap];
+    }
+  }
+  if (output_scale != 1.0f) {
+    out *= output_scale;
+  }
+}
+
+// A run of consecutive values of an input row, as an offset and a size in
+// values.
+struct ColumnRun {
+  int64_t start;
+  int64_t size;
+};
+
+// Returns the runs of consecutive input columns that `cols` reads, in order.
+// When downscaling, these cover only a fraction of the row.
+std::vector<ColumnRun> UsedColumnRuns(const ResamplingCoefficients& cols,
+                                      int64_t in_width, int channels) {
+  std::vector<bool> used(in_width, false);
+  for (const int64_t index : cols.indices) {
+    DCHECK(index >= 0 && index < in_width);
+    used[index] = true;
+  }
+  std::vector<ColumnRun> runs;
+  int64_t x = 0;
+  while (x < in_width) {
+    if (!used[x]) {
+      ++x;
+      continue;
+    }
+    const int64_t begin = x;
+    while (x < in_width && used[x]) ++x;
+    runs.push_back(ColumnRun{begin * channels, (x - begin) * channels});
+  }
+  return runs;
+}
+
+// Computes output row `y` by combining the input rows of `image` along the
+// height into `combined`, which holds one input row, and then filtering it
+// along the width. Only the `column_runs` of `combined` that the width filter
+// reads are computed.
+template <typename T>
+void FilterHeightThenWidth(const ResamplingCoefficients& rows,
+                           const ResamplingCoefficients& cols,
+                           const std::vector<ColumnRun>& column_runs,
+                           int64_t y, float output_scale, const T* image,
+                           int64_t in_row_size, int channels,
+                           FilterRowFn<float> filter_row, float* combined,
+                           float* out_row, int64_t out_row_size) {
+  Row out(out_row, out_row_size);
+
+  const int64_t begin = rows.offsets[y];
+  const int64_t end = rows.offsets[y + 1];
+  if (begin == end) {
+    out.setZero();
+    return;
+  }
+  for (const ColumnRun& run : column_runs) {
+    Row combined_run(combined + run.start, run.size);
+    auto input_run = [&](int64_t tap) {
+      return Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
+                 image + rows.indices[tap] * in_row_size + run.start,
+                 run.size)
+          .template cast<float>();
+    };
+    combined_run = input_run(begin) * rows.weights[begin];
+    for (int64_t tap = begin + 1; tap < end; ++tap) {
+      combined_run += input_run(tap) * rows.weights[tap];
+    }
+  }
+  filter_row(combined, cols, channels, out_row);
+  if (output_scale != 1.0f) {
+    out *= output_scale;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void SeparableResample(const Eigen::ThreadPoolDevice& d,
+                       const ResamplingCoefficients& rows,
+                       const ResamplingCoefficients& cols,
+                       SeparableResampleOrder order, float output_scale,
+                       typename TTypes<T, 4>::ConstTensor images,
+                       typename TTypes<float, 4>::Tensor output) {
+  const int64_t batch_size = images.dimension(0);
+  const int64_t in_height = images.dimension(1);
+  const int64_t in_width = images.dimension(2);
+  const int channels = images.dimension(3);
+  const int64_t out_height = output.dimension(1);
+  const int64_t out_width = output.dimension(2);
+  DCHECK_EQ(rows.output_size(), out_height);
+  DCHECK_EQ(cols.output_size(), out_width);
+  if (output.size() == 0) return;
+
+  const int64_t in_row_size = in_width * channels;
+  const int64_t in_image_size = in_height * in_row_size;
+  const int64_t out_row_size = out_width * channels;
+  const double vertical_taps_per_row =
+      static_cast<double>(rows.indices.size()) / out_height;
+
+  if (order == SeparableResampleOrder::kHeightFirst) {
+    const std::vector<ColumnRun> column_runs =
+        UsedColumnRuns(cols, in_width, channels);
+    int64_t used_row_size = 0;
+    for (const ColumnRun& run : column_runs) used_row_size += run.size;
+    const double vertical_ops = vertical_taps_per_row * used_row_size;
+    const double horizontal_ops =
+        static_cast<double>(cols.indices.size()) * channels;
+    const Eigen::TensorOpCost cost(vertical_ops * sizeof(T),
+                                   out_row_size * sizeof(float),
+                                   2 * (horizontal_ops + vertical_ops));
+    const FilterRowFn<float> filter_row = GetFilterRow<float>(channels);
+    d.parallelFor(batch_size * out_height, cost,
+                  [&](Eigen::Index first, Eigen::Index last) {
+                    std::vector<float> combined(in_row_size);
+                    for (Eigen::Index i = first; i < last; ++i) {
+                      const int64_t b = i / out_height;
+                      FilterHeightThenWidth(
+                          rows, cols, column_runs, i % out_height, output_scale,
+                          images.data() + b * in_image_size, in_row_size,
+                          channels, filter_row, combined.data(),
+                          output.data() + i * out_row_size, out_row_size);
+                    }
+                  });
+    return;
+  }
+
+  // The window must hold the rows between the first and last tap of any
+  // output row, since they all map to different slots.
+  int64_t num_slots = 1;
+  for (int64_t y = 0; y < out_height; ++y) {
+    const auto begin = rows.indices.begin() + rows.offsets[y];
+    const auto end = rows.indices.begin() + rows.offsets[y + 1];
+    if (begin == end) continue;
+    const auto [min_row, max_row] = std::minmax_element(begin, end);
+    DCHECK(*min_row >= 0 && *max_row < in_height);
+    num_slots = std::max(num_slots, *max_row - *min_row + 1);
+  }
+
+  // Each input row is filtered about once, so its cost is shared by the
+  // output rows.
+  const double rows_filtered_per_output_row =
+      std::min<double>(static_cast<double>(rows.indices.size()), in_height) /
+      out_height;
+  const double horizontal_ops =
+      rows_filtered_per_output_row * cols.indices.size() * channels;
+  const double vertical_ops = vertical_taps_per_row * out_row_size;
+  const Eigen::TensorOpCost cost(
+      horizontal_ops * sizeof(T) + vertical_ops * sizeof(float),
+      out_row_size * sizeof(float), 2 * (horizontal_ops + vertical_ops));
+
+  d.parallelFor(batch_size * out_height, cost,
+                [&](Eigen::Index first, Eigen::Index last) {
+                  FilteredRowWindow<T> window(cols, channels, num_slots);
+                  int64_t b = first / out_height;
+                  for (Eigen::Index i = first; i < last; ++i) {
+                    const int64_t y = i % out_height;
+                    if (i != first && y == 0) {
+                      ++b;
+                      window.Reset();
+                    }
+                    FilterColumn(rows, y, output_scale,
+                                 images.data() + b * in_image_size,
+                                 in_row_size, &window,
+                                 output.data() + i * out_row_size,
+                                 out_row_size);
+                  }
+                });
+}
+
+#define INSTANTIATE(T)                                            \
+  template void SeparableResample<T>(                             \
+      const Eigen::ThreadPoolDevice& d,                           \
+      const ResamplingCoefficients& rows,                         \
+      const ResamplingCoefficients& cols,                         \
+      SeparableResampleOrder order, float output_scale,           \
+      typename TTypes<T, 4>::ConstTensor images,                  \
+      typename TTypes<float, 4>::Tensor output);
+
+TF_CALL_REAL_NUMBER_TYPES(INSTANTIATE);
+
+#undef INSTANTIATE
+
+}  // namespace tensorflow
@@ -0,0 +1,145 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_IMAGE_SEPARABLE_RESAMPLER_H_
+#define TENSORFLOW_CORE_KERNELS_IMAGE_SEPARABLE_RESAMPLER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/statusor.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// The CPU resize ops ResizeBicubic, ResizeArea and ScaleAndTranslate all
+// compute each output pixel as a weighted sum over a separable 2-D
+// neighborhood of input pixels. They differ only in how the weights along
+// each dimension are computed, so they describe those weights as
+// ResamplingCoefficients and share SeparableResample() to apply them.
+// ResizeBilinear keeps its own kernel, which is specialized for two taps.
+
+// The filter taps that map an input dimension to an output dimension.
+//
+// Output i is the sum of weights[k] * input[indices[k]] for k in
+// [offsets[i], offsets[i + 1]), accumulated in order. An output with no taps
+// is zero.
+struct ResamplingCoefficients {
+  ResamplingCoefficients() : offsets(1, 0) {}
+
+  // Appends a tap to the output that is being built.
+  void AddTap(int64_t index, float weight) {
+    indices.push_back(index);
+    weights.push_back(weight);
+  }
+  // Finishes the output that is being built and starts the next one.
+  void FinishOutput() { offsets.push_back(indices.size()); }
+
+  int64_t output_size() const { return offsets.size() - 1; }
+
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> indices;
+  std::vector<float> weights;
+};
+
+// The order in which SeparableResample() applies the two filters. Both give
+// the same results up to float rounding; ops keep the order they have always
+// used so that their results do not change.
+enum class SeparableResampleOrder {
+  // Filters input rows along the width, then combines them along the height.
+  kWidthFirst,
+  // Combines input rows along the height, then filters the result along the
+  // width.
+  kHeightFirst,
+};
+
+// A small cache of the coefficients of one op kernel, so that they are
+// computed once for each input and output size rather than on every call.
+//
+// Thread-safe.
+class ResamplingCoefficientsCache {
+ public:
+  // Identifies the coefficients along one dimension. The parameters that are
+  // fixed for the lifetime of a kernel, such as its attrs, are not part of
+  // the key.
+  struct Key {
+    int64_t in_size;
+    int64_t out_size;
+    float scale;
+    float translate;
+
+    bool operator==(const Key& other) const {
+      return in_size == other.in_size && out_size == other.out_size &&
+             scale == other.scale && translate == other.translate;
+    }
+  };
+
+  ResamplingCoefficientsCache() = default;
+
+  ResamplingCoefficientsCache(const ResamplingCoefficientsCache&) = delete;
+  ResamplingCoefficientsCache& operator=(const ResamplingCoefficientsCache&) =
+      delete;
+
+  // Returns the coefficients for `key`, calling `compute` to compute them if
+  // they are not cached. Errors from `compute` are returned and not cached.
+  absl::StatusOr<std::shared_ptr<const ResamplingCoefficients>> Get(
+      const Key& key,
+      absl::FunctionRef<absl::Status(ResamplingCoefficients*)> compute);
+
+  // The number of sets of coefficients kept. A kernel typically sees a single
+  // size per dimension; the least recently used entry is evicted beyond this.
+  static constexpr int kMaxEntries = 8;
+
+ private:
+  struct Entry {
+    Key key;
+    std::shared_ptr<const ResamplingCoefficients> coefficients;
+    uint64_t last_use;
+  };
+
+  mutex mu_;
+  std::vector<Entry> entries_ TF_GUARDED_BY(mu_);
+  uint64_t use_count_ TF_GUARDED_BY(mu_) = 0;
+};
+
+// Resamples `images` into `output`, applying `rows` along the height and
+// `cols` along the width in the given `order`, and multiplying the results by
+// `output_scale`. `rows` must have one output per output row and indices
+// within the input height, and likewise for `cols`.
+//
+// The output rows are spread over the threads of `d`. With kWidthFirst, each
+// thread filters the input rows its output rows use along the width into a
+// small window of float rows, where they are reused by the following output
+// rows, and then combines whole rows of the window along the height. With
+// kHeightFirst, each output row combines the input rows along the height,
+// over only the input columns that `cols` reads, and filters that row along
+// the width. The combination of rows vectorizes over the row width in both
+// cases.
+template <typename T>
+void SeparableResample(const Eigen::ThreadPoolDevice& d,
+                       const ResamplingCoefficients& rows,
+                       const ResamplingCoefficients& cols,
+                       SeparableResampleOrder order, float output_scale,
+                       typename TTypes<T, 4>::ConstTensor images,
+                       typename TTypes<float, 4>::Tensor output);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_IMAGE_SEPARABLE_RESAMPLER_H_
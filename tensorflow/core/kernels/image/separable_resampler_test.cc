@@ -0,0 +1,239 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/kernels/image/separable_resampler.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+
+namespace tensorflow {
+namespace {
+
+class SeparableResampleTest : public ::testing::Test {
+ protected:
+  SeparableResampleTest()
+      : pool_(Env::Default(), "separable_resample_test", /*num_threads=*/4),
+        device_(pool_.AsEigenThreadPool(), /*num_cores=*/4) {}
+
+  // Resamples `images` by `rows` and `cols` and returns the result.
+  template <typename T>
+  Tensor Resample(const Tensor& images, const ResamplingCoefficients& rows,
+                  const ResamplingCoefficients& cols,
+                  float output_scale = 1.0f,
+                  SeparableResampleOrder order =
+                      SeparableResampleOrder::kWidthFirst) {
+    Tensor output(DT_FLOAT,
+                  TensorShape({images.dim_size(0), rows.output_size(),
+                               cols.output_size(), images.dim_size(3)}));
+    SeparableResample<T>(device_, rows, cols, order, output_scale,
+                         images.tensor<T, 4>(), output.tensor<float, 4>());
+    return output;
+  }
+
+  thread::ThreadPool pool_;
+  Eigen::ThreadPoolDevice device_;
+};
+
+// Returns coefficients that copy `indices` of the input, in order.
+ResamplingCoefficients Gather(const std::vector<int64_t>& indices) {
+  ResamplingCoefficients coefficients;
+  for (int64_t index : indices) {
+    coefficients.AddTap(index, 1.0f);
+    coefficients.FinishOutput();
+  }
+  return coefficients;
+}
+
+TEST_F(SeparableResampleTest, Gathers) {
+  Tensor images(DT_UINT8, TensorShape({1, 3, 3, 1}));
+  test::FillIota<uint8_t>(&images, 0);
+  // Rows that go back to earlier input rows must be filtered again.
+  const Tensor output =
+      Resample<uint8_t>(images, Gather({2, 0, 2, 1}), Gather({1, 1, 0}));
+  test::ExpectTensorEqual<float>(
+      output, test::AsTensor<float>({7, 7, 6, 1, 1, 0, 7, 7, 6, 4, 4, 3},
+                                    {1, 4, 3, 1}));
+}
+
+TEST_F(SeparableResampleTest, WeightedSums) {
+  Tensor images = test::AsTensor<float>({1, 2, 3, 4}, {1, 2, 2, 1});
+  ResamplingCoefficients rows;
+  rows.AddTap(0, 0.5f);
+  rows.AddTap(1, 0.5f);
+  rows.FinishOutput();
+  // An output without taps is zero.
+  rows.FinishOutput();
+  ResamplingCoefficients cols;
+  cols.AddTap(1, 2.0f);
+  cols.FinishOutput();
+  cols.AddTap(0, 1.0f);
+  cols.AddTap(1, -1.0f);
+  cols.FinishOutput();
+
+  const Tensor output =
+      Resample<float>(images, rows, cols, /*output_scale=*/2.0f);
+  test::ExpectTensorEqual<float>(
+      output, test::AsTensor<float>({12, -2, 0, 0}, {1, 2, 2, 1}));
+}
+
+TEST_F(SeparableResampleTest, HeightFirst) {
+  Tensor images = test::AsTensor<uint8_t>({1, 2, 3, 4, 5, 6}, {1, 2, 3, 1});
+  ResamplingCoefficients rows;
+  rows.AddTap(0, 0.5f);
+  rows.AddTap(1, 0.5f);
+  rows.FinishOutput();
+  rows.FinishOutput();
+  ResamplingCoefficients cols;
+  cols.AddTap(2, 1.0f);
+  cols.AddTap(0, -1.0f);
+  cols.FinishOutput();
+  cols.AddTap(1, 1.0f);
+  cols.FinishOutput();
+
+  const Tensor output = Resample<uint8_t>(
+      images, rows, cols, /*output_scale=*/2.0f,
+      SeparableResampleOrder::kHeightFirst);
+  test::ExpectTensorEqual<float>(
+      output, test::AsTensor<float>({4, 7, 0, 0}, {1, 2, 2, 1}));
+}
+
+TEST_F(SeparableResampleTest, BatchesAndChannels) {
+  // Enough output rows to be split between threads within an image, with a
+  // channel count that is not specialized.
+  constexpr int kBatch = 3, kHeight = 40, kWidth = 5, kChannels = 2;
+  Tensor images(DT_FLOAT, TensorShape({kBatch, kHeight, kWidth, kChannels}));
+  test::FillIota<float>(&images, 0);
+  std::vector<int64_t> rows(kHeight), cols(kWidth);
+  for (int i = 0; i < kHeight; ++i) rows[i] = kHeight - 1 - i;
+  for (int i = 0; i < kWidth; ++i) cols[i] = i;
+
+  Tensor expected(DT_FLOAT, images.shape());
+  expected.tensor<float, 4>() = images.tensor<float, 4>().reverse(
+      Eigen::array<bool, 4>{false, true, false, false});
+  for (const SeparableResampleOrder order :
+       {SeparableResampleOrder::kWidthFirst,
+        SeparableResampleOrder::kHeightFirst}) {
+    test::ExpectTensorEqual<float>(
+        Resample<float>(images, Gather(rows), Gather(cols),
+                        /*output_scale=*/1.0f, order),
+        expected);
+  }
+}
+
+TEST_F(SeparableResampleTest, DownscalesWithGapsBetweenColumns) {
+  // The width filter reads runs of columns with unused columns between and
+  // after them, which kHeightFirst does not combine.
+  constexpr int kHeight = 6, kWidth = 9, kChannels = 3;
+  Tensor images(DT_FLOAT, TensorShape({2, kHeight, kWidth, kChannels}));
+  test::FillIota<float>(&images, 0);
+  ResamplingCoefficients rows;
+  for (int y = 0; y < kHeight / 2; ++y) {
+    rows.AddTap(2 * y, 0.5f);
+    rows.AddTap(2 * y + 1, 0.5f);
+    rows.FinishOutput();
+  }
+  const ResamplingCoefficients cols = Gather({7, 0, 1, 4});
+
+  const Tensor width_first = Resample<float>(
+      images, rows, cols, /*output_scale=*/1.0f,
+      SeparableResampleOrder::kWidthFirst);
+  const Tensor height_first = Resample<float>(
+      images, rows, cols, /*output_scale=*/1.0f,
+      SeparableResampleOrder::kHeightFirst);
+  test::ExpectTensorEqual<float>(height_first, width_first);
+  // Pixel (1, 2, 0) averages input rows 4 and 5 at column 7.
+  const float row_size = kWidth * kChannels;
+  const float pixel = 1 * kHeight * row_size + 4.5f * row_size + 7 * kChannels;
+  EXPECT_EQ(height_first.tensor<float, 4>()(1, 2, 0, 0), pixel);
+}
+
+TEST(ResamplingCoefficientsCacheTest, ComputesOncePerKey) {
+  ResamplingCoefficientsCache cache;
+  int num_computed = 0;
+  auto compute = [&](ResamplingCoefficients* coefficients) {
+    ++num_computed;
+    coefficients->AddTap(0, 1.0f);
+    coefficients->FinishOutput();
+    return absl::OkStatus();
+  };
+
+  const ResamplingCoefficientsCache::Key key{10, 1, 10.0f, 0.0f};
+  auto first = cache.Get(key, compute);
+  TF_ASSERT_OK(first.status());
+  auto second = cache.Get(key, compute);
+  TF_ASSERT_OK(second.status());
+  EXPECT_EQ(first->get(), second->get());
+  EXPECT_EQ(num_computed, 1);
+
+  TF_ASSERT_OK(cache.Get({10, 2, 5.0f, 0.0f}, compute).status());
+  EXPECT_EQ(num_computed, 2);
+}
+
+TEST(ResamplingCoefficientsCacheTest, EvictsLeastRecentlyUsed) {
+  ResamplingCoefficientsCache cache;
+  int num_computed = 0;
+  auto compute = [&](ResamplingCoefficients*) {
+    ++num_computed;
+    return absl::OkStatus();
+  };
+  auto key = [](int64_t in_size) {
+    return ResamplingCoefficientsCache::Key{in_size, 1, 1.0f, 0.0f};
+  };
+
+  for (int i = 0; i < ResamplingCoefficientsCache::kMaxEntries; ++i) {
+    TF_ASSERT_OK(cache.Get(key(i), compute).status());
+  }
+  TF_ASSERT_OK(cache.Get(key(0), compute).status());
+  TF_ASSERT_OK(cache.Get(key(-1), compute).status());
+  EXPECT_EQ(num_computed, ResamplingCoefficientsCache::kMaxEntries + 1);
+
+  // Key 0 was used recently and is kept, key 1 was evicted.
+  TF_ASSERT_OK(cache.Get(key(0), compute).status());
+  EXPECT_EQ(num_computed, ResamplingCoefficientsCache::kMaxEntries + 1);
+  TF_ASSERT_OK(cache.Get(key(1), compute).status());
+  EXPECT_EQ(num_computed, ResamplingCoefficientsCache::kMaxEntries + 2);
+}
+
+TEST(ResamplingCoefficientsCacheTest, DoesNotCacheErrors) {
+  ResamplingCoefficientsCache cache;
+  const ResamplingCoefficientsCache::Key key{1, 1, 1.0f, 0.0f};
+  EXPECT_EQ(cache
+                .Get(key,
+                     [](ResamplingCoefficients*) {
+                       return absl::InvalidArgumentError("bad");
+                     })
+                .status()
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+  TF_EXPECT_OK(
+      cache.Get(key, [](ResamplingCoefficients*) { return absl::OkStatus(); })
+          .status());
+}
+
+}  // namespace
+}  // namespace tensorflow
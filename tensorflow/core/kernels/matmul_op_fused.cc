@@ -33,6 +33,7 @@ limitations under the License.
 #endif  // GOOGLE_CUDA
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -48,6 +49,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/fill_functor.h"
 #include "tensorflow/core/kernels/fused_eigen_output_kernels.h"
+#include "tensorflow/core/kernels/matmul_op_packed_weights.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/util/matmul_autotune.h"
 #include "tensorflow/core/util/tensor_format.h"
@@ -117,6 +119,13 @@ struct LaunchFusedMatMulOp<CPUDevice, T> {
             output_kernel(output_mapper, params, i, j, num_rows, num_cols);
           });
 
+      if constexpr (std::is_same_v<T, float>) {
+        if (packed_b != nullptr) {
+          packed_b->Multiply(d, lhs, /*transpose_lhs=*/dim_pair[0].first == 0,
+                             out, output_kernel_wrapper);
+          return;
+        }
+      }
       if constexpr (std::is_same_v<ComputeType, T>) {
         out.device(d) = lhs.contract(rhs, dim_pair, output_kernel_wrapper);
       } else {
@@ -169,6 +178,10 @@ struct LaunchFusedMatMulOp<CPUDevice, T> {
     }
   }
 
+  // If set, `b` packed by PackedMatMulWeights, which is multiplied instead of
+  // `b`.
+  std::shared_ptr<const PackedMatMulWeights<T>> packed_b;
+
  private:
   // Wrap output_kernel into type erased struct to reduce the number of unique
   // template instantiations for Eigen Tensor contraction expressions.
@@ -659,6 +672,17 @@ class FusedMatMulOp : public OpKernel {
                       "only DT_HALF data type."));
     }
     use_autotune_ = MatmulAutotuneEnable();
+    if constexpr (std::is_same_v<Device, CPUDevice> &&
+                  std::is_same_v<T, float>) {
+      if (context->HasAttr(kCachePackedWeightsAttr)) {
+        OP_REQUIRES_OK(context, context->GetAttr(kCachePackedWeightsAttr,
+                                                 &cache_packed_weights_));
+      }
+      if (cache_packed_weights_) {
+        packed_weights_cache_ =
+            std::make_unique<PackedMatMulWeightsCache<float>>();
+      }
+    }
   }
 
   void Compute(OpKernelContext* ctx) override {
@@ -711,6 +735,14 @@ class FusedMatMulOp : public OpKernel {
     }
 
     auto launch = LaunchFusedMatMulOp<Device, T>();
+    if constexpr (std::is_same_v<Device, CPUDevice> &&
+                  std::is_same_v<T, float>) {
+      // A single row is a matrix-vector product, which does not pack `b`.
+      if (cache_packed_weights_ && out->dim_size(0) > 1) {
+        launch.packed_b = packed_weights_cache_->Get(
+            ctx->eigen_device<Device>(), b, transpose_b_);
+      }
+    }
     launch(ctx, a, b, dim_pair, fused_computation_, fused_computation_args_,
            out, use_autotune_);
   }
@@ -719,6 +751,9 @@ class FusedMatMulOp : public OpKernel {
   bool transpose_a_;
   bool transpose_b_;
   bool use_autotune_;
+  bool cache_packed_weights_ = false;
+  // Only created for float CPU kernels with kCachePackedWeightsAttr set.
+  std::unique_ptr<PackedMatMulWeightsCache<float>> packed_weights_cache_;
 
   FusedComputationType fused_computation_ = FusedComputationType::kUndefined;
   FusedComputationArgs fused_computation_args_;
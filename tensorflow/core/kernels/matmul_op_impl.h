@@ -23,6 +23,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -37,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/framework/type_traits.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/kernels/matmul_op_packed_weights.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/platform/bfloat16.h"
@@ -903,6 +905,17 @@ class BaseBatchMatMulOp : public OpKernel {
       OP_REQUIRES_OK(context, context->GetAttr("grad_x", &grad_input_1_));
       OP_REQUIRES_OK(context, context->GetAttr("grad_y", &grad_input_2_));
     }
+    if constexpr (std::is_same_v<Device, CPUDevice> &&
+                  std::is_same_v<Tout, float>) {
+      if (context->HasAttr(kCachePackedWeightsAttr)) {
+        OP_REQUIRES_OK(context, context->GetAttr(kCachePackedWeightsAttr,
+                                                 &cache_packed_weights_));
+      }
+      if (cache_packed_weights_) {
+        packed_weights_cache_ =
+            std::make_unique<PackedMatMulWeightsCache<float>>();
+      }
+    }
   }
 
   ~BaseBatchMatMulOp() override {}
@@ -1008,6 +1021,28 @@ class BaseBatchMatMulOp : public OpKernel {
       if constexpr (!std::is_same<Tb, Tout>::value) {
         in1_reshaped = CastTensor<Tb, Tout>(in1_reshaped);
       }
+      if constexpr (std::is_same_v<Device, CPUDevice> &&
+                    std::is_same_v<Ta, float> && std::is_same_v<Tb, float> &&
+                    std::is_same_v<Tout, float>) {
+        if (cache_packed_weights_ && bcast.y_batch_size() == 1 &&
+            (bcast.x_batch_size() == 1 || !(adj_x_ || trans_x_)) &&
+            batch_size * d0 > 1) {
+          // Every batch of In[0] is multiplied by the same In[1], so the
+          // batches are stacked into one matrix. A single row is a
+          // matrix-vector product, which does not pack In[1].
+          const CPUDevice& device = ctx->eigen_device<CPUDevice>();
+          std::shared_ptr<const PackedMatMulWeights<float>> packed_weights =
+              packed_weights_cache_->Get(device, in1,
+                                         /*transpose=*/adj_y_ || trans_y_);
+          if (packed_weights != nullptr) {
+            packed_weights->Multiply(
+                device, std::as_const(in0_reshaped).flat_inner_dims<float, 2>(),
+                /*transpose_lhs=*/adj_x_ || trans_x_,
+                out_reshaped.flat_inner_dims<float, 2>());
+            return;
+          }
+        }
+      }
       LaunchBatchMatMul<Device, Tout>::Launch(
           ctx, in0_reshaped, in1_reshaped, adj_x_, adj_y_, trans_x_, trans_y_,
           grad_input_1_, grad_input_2_, bcast, &out_reshaped);
@@ -1027,6 +1062,9 @@ class BaseBatchMatMulOp : public OpKernel {
   bool trans_y_ = false;
   bool grad_input_1_ = false;
   bool grad_input_2_ = false;
+  bool cache_packed_weights_ = false;
+  // Only created for float CPU kernels with kCachePackedWeightsAttr set.
+  std::unique_ptr<PackedMatMulWeightsCache<float>> packed_weights_cache_;
 
   // Cast `t` from `SrcT` to `DstT`.
   template <typename SrcT, typename DstT>
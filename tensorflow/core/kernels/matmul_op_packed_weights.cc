@@ -0,0 +1,310 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/kernels/matmul_op_packed_weights.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "Eigen/Core"  // from @eigen_archive
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+namespace {
+
+using Eigen::Index;
+
+// Eigen multiplies column-major matrices, so the product out = lhs * weights
+// of row-major matrices is computed as out^T = weights^T * lhs^T. The weights
+// are thus the left-hand side of Eigen's GEMM kernel, and `lhs` its right-hand
+// side.
+template <typename T>
+using Traits = Eigen::internal::gebp_traits<T, T>;
+
+template <typename T, int StorageOrder>
+using ConstMapper =
+    Eigen::internal::const_blas_data_mapper<T, Index, StorageOrder>;
+
+// Packed blocks start at offsets that are a multiple of this number of
+// elements, as the GEMM kernel loads them with aligned packet loads.
+template <typename T>
+constexpr Index kAlignment =
+    std::max<Index>(1, EIGEN_MAX_ALIGN_BYTES / sizeof(T));
+
+Index AlignUp(Index size, Index alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+// The bytes of packed weights currently held in the process.
+std::atomic<int64_t> packed_weights_bytes{0};
+
+int64_t MaxPackedWeightsBytes() {
+  int64_t max_mb;
+  absl::Status status = ReadInt64FromEnvVar(
+      kPackedWeightsMaxMbEnvVar, kDefaultPackedWeightsMaxMb, &max_mb);
+  if (!status.ok()) {
+    LOG(ERROR) << status.message();
+    max_mb = kDefaultPackedWeightsMaxMb;
+  }
+  return std::clamp<int64_t>(max_mb, 0,
+                             std::numeric_limits<int64_t>::max() >> 20)
+         << 20;
+}
+
+// Accounts for `bytes` more packed weights, unless that exceeds the limit.
+bool ReservePackedWeightsBytes(int64_t bytes) {
+  const int64_t max_bytes = MaxPackedWeightsBytes();
+  int64_t current = packed_weights_bytes.load(std::memory_order_relaxed);
+  do {
+    if (current + bytes > max_bytes) return false;
+  } while (!packed_weights_bytes.compare_exchange_weak(
+      current, current + bytes, std::memory_order_relaxed));
+  return true;
+}
+
+// Packs `depth` x `rows` of the column-major left-hand side `lhs`, starting
+// at (row, k).
+template <typename T, int StorageOrder>
+void PackLhs(const T* lhs, Index stride, Index row, Index k, Index rows,
+             Index depth, T* packed) {
+  using Mapper = ConstMapper<T, StorageOrder>;
+  Eigen::internal::gemm_pack_lhs<T, Index, Mapper, Traits<T>::mr,
+                                 Traits<T>::LhsProgress,
+                                 typename Traits<T>::LhsPacket4Packing,
+                                 StorageOrder>
+      pack;
+  pack(packed, Mapper(lhs, stride).getSubMapper(row, k), depth, rows);
+}
+
+// Packs `depth` x `cols` of the column-major right-hand side `rhs`, starting
+// at (k, col).
+template <typename T, int StorageOrder>
+void PackRhs(const T* rhs, Index stride, Index k, Index col, Index depth,
+             Index cols, T* packed) {
+  using Mapper = ConstMapper<T, StorageOrder>;
+  Eigen::internal::gemm_pack_rhs<T, Index, Mapper, Traits<T>::nr,
+                                 StorageOrder>
+      pack;
+  pack(packed, Mapper(rhs, stride).getSubMapper(k, col), depth, cols);
+}
+
+}  // namespace
+
+template <typename T>
+PackedMatMulWeights<T>::PackedMatMulWeights(Index depth, Index cols)
+    : depth_(depth), cols_(cols) {
+  // Sizes the blocks for a product with as many rows as columns, and then
+  // splits the columns finer so that the few rows of a serving batch still
+  // spread over the threads.
+  block_depth_ = depth;
+  block_cols_ = cols;
+  block_rows_ = cols;
+  Eigen::internal::computeProductBlockingSizes<T, T>(block_depth_, block_cols_,
+                                                     block_rows_);
+  block_depth_ = std::max<Index>(block_depth_, 1);
+  block_cols_ = std::max<Index>(
+      std::min<Index>(block_cols_, AlignUp(Eigen::divup<Index>(cols, 16),
+                                           Traits<T>::mr)),
+      1);
+  block_rows_ = std::max<Index>(block_rows_, 1);
+}
+
+template <typename T>
+PackedMatMulWeights<T>::~PackedMatMulWeights() {
+  packed_weights_bytes.fetch_sub(packed_.size() * sizeof(T),
+                                 std::memory_order_relaxed);
+}
+
+template <typename T>
+Index PackedMatMulWeights<T>::BlockOffset(Index col, Index k) const {
+  // Each block of columns holds its depth blocks one after the other.
+  const Index num_cols = std::min(block_cols_, cols_ - col);
+  const Index depth_stride = AlignUp(block_depth_ * num_cols, kAlignment<T>);
+  const Index col_stride =
+      AlignUp(Eigen::divup(depth_, block_depth_) *
+                  AlignUp(block_depth_ * block_cols_, kAlignment<T>),
+              kAlignment<T>);
+  return col / block_cols_ * col_stride + k / block_depth_ * depth_stride;
+}
+
+template <typename T>
+std::unique_ptr<const PackedMatMulWeights<T>> PackedMatMulWeights<T>::Pack(
+    const Eigen::ThreadPoolDevice& d, typename TTypes<T>::ConstMatrix weights,
+    bool transpose) {
+  const Index depth = transpose ? weights.dimension(1) : weights.dimension(0);
+  const Index cols = transpose ? weights.dimension(0) : weights.dimension(1);
+  std::unique_ptr<PackedMatMulWeights> packed(
+      new PackedMatMulWeights(depth, cols));
+
+  const Index num_col_blocks = Eigen::divup(cols, packed->block_cols_);
+  const Index col_stride =
+      AlignUp(Eigen::divup(depth, packed->block_depth_) *
+                  AlignUp(packed->block_depth_ * packed->block_cols_,
+                          kAlignment<T>),
+              kAlignment<T>);
+  // The destructor releases the bytes of `packed_`, which is empty until the
+  // reservation succeeds.
+  if (!ReservePackedWeightsBytes(num_col_blocks * col_stride * sizeof(T))) {
+    return nullptr;
+  }
+  packed->packed_.resize(num_col_blocks * col_stride);
+
+  // weights^T is [cols, depth], and column-major unless `transpose`.
+  const T* data = weights.data();
+  const Eigen::TensorOpCost cost(depth * packed->block_cols_ * sizeof(T),
+                                 depth * packed->block_cols_ * sizeof(T),
+                                 depth * packed->block_cols_);
+  d.parallelFor(num_col_blocks, cost, [&](Index first, Index last) {
+    for (Index block = first; block < last; ++block) {
+      const Index col = block * packed->block_cols_;
+      const Index num_cols = std::min(packed->block_cols_, cols - col);
+      for (Index k = 0; k < depth; k += packed->block_depth_) {
+        const Index block_depth = std::min(packed->block_depth_, depth - k);
+        T* dst = packed->packed_.data() + packed->BlockOffset(col, k);
+        if (transpose) {
+          PackLhs<T, Eigen::RowMajor>(data, depth, col, k, num_cols,
+                                      block_depth, dst);
+        } else {
+          PackLhs<T, Eigen::ColMajor>(data, cols, col, k, num_cols,
+                                      block_depth, dst);
+        }
+      }
+    }
+  });
+  return packed;
+}
+
+template <typename T>
+void PackedMatMulWeights<T>::Multiply(const Eigen::ThreadPoolDevice& d,
+                                      typename TTypes<T>::ConstMatrix lhs,
+                                      bool transpose_lhs,
+                                      typename TTypes<T>::Matrix out,
+                                      const OutputKernel& output_kernel) const {
+  const Index rows = out.dimension(0);
+  DCHECK_EQ(out.dimension(1), cols_);
+  DCHECK_EQ(transpose_lhs ? lhs.dimension(0) : lhs.dimension(1), depth_);
+  if (rows == 0 || cols_ == 0) return;
+
+  const Index block_rows = std::min(rows, block_rows_);
+  const Index num_row_blocks = Eigen::divup(rows, block_rows);
+  const Index num_col_blocks = Eigen::divup(cols_, block_cols_);
+  const Index depth_stride =
+      AlignUp(block_depth_ * block_rows, kAlignment<T>);
+
+  // lhs^T is [depth, rows], and column-major unless `transpose_lhs`.
+  auto pack_rows = [&](Index row, Index num_rows, T* packed) {
+    for (Index k = 0; k < depth_; k += block_depth_) {
+      const Index block_depth = std::min(block_depth_, depth_ - k);
+      T* dst = packed + k / block_depth_ * depth_stride;
+      if (transpose_lhs) {
+        PackRhs<T, Eigen::RowMajor>(lhs.data(), rows, k, row, block_depth,
+                                    num_rows, dst);
+      } else {
+        PackRhs<T, Eigen::ColMajor>(lhs.data(), depth_, k, row, block_depth,
+                                    num_rows, dst);
+      }
+    }
+  };
+
+  const OutputMapper output(out.data(), cols_);
+  const Eigen::TensorContractionParams params{/*swapped_arguments=*/true};
+  const double block_flops = 2.0 * block_rows * block_cols_ * depth_;
+  const Eigen::TensorOpCost cost(
+      (block_rows + block_cols_) * depth_ * sizeof(T),
+      block_rows * block_cols_ * sizeof(T), block_flops);
+
+  // Blocks that share rows are adjacent, so that each task packs the rows of
+  // `lhs` it multiplies by once.
+  d.parallelFor(
+      num_row_blocks * num_col_blocks, cost, [&](Index first, Index last) {
+        std::vector<T, Eigen::aligned_allocator<T>> packed_rows(
+            Eigen::divup(depth_, block_depth_) * depth_stride);
+        Index packed_row_block = -1;
+        Eigen::internal::gebp_kernel<T, T, Index, OutputMapper, Traits<T>::mr,
+                                     Traits<T>::nr>
+            gebp;
+        for (Index block = first; block < last; ++block) {
+          const Index row_block = block / num_col_blocks;
+          const Index row = row_block * block_rows;
+          const Index num_rows = std::min(block_rows, rows - row);
+          const Index col = block % num_col_blocks * block_cols_;
+          const Index num_cols = std::min(block_cols_, cols_ - col);
+          if (row_block != packed_row_block) {
+            pack_rows(row, num_rows, packed_rows.data());
+            packed_row_block = row_block;
+          }
+
+          const OutputMapper block_output = output.getSubMapper(col, row);
+          for (Index j = 0; j < num_rows; ++j) {
+            std::fill_n(&block_output(0, j), num_cols, T(0));
+          }
+          for (Index k = 0; k < depth_; k += block_depth_) {
+            gebp(block_output, packed_.data() + BlockOffset(col, k),
+                 packed_rows.data() + k / block_depth_ * depth_stride,
+                 num_cols, std::min(block_depth_, depth_ - k), num_rows,
+                 T(1));
+          }
+          if (output_kernel) {
+            output_kernel(block_output, params, col, row, num_cols, num_rows);
+          }
+        }
+      });
+}
+
+template <typename T>
+std::shared_ptr<const PackedMatMulWeights<T>> PackedMatMulWeightsCache<T>::Get(
+    const Eigen::ThreadPoolDevice& d, const Tensor& weights, bool transpose) {
+  {
+    mutex_lock l(mu_);
+    if (packed_ != nullptr && transpose_ == transpose &&
+        weights_.data() == weights.data() &&
+        weights_.shape() == weights.shape()) {
+      return packed_;
+    }
+    // Releases the weights that are replaced first, so that they do not count
+    // against the limit while the new ones are packed.
+    weights_ = Tensor();
+    packed_ = nullptr;
+  }
+
+  std::shared_ptr<const PackedMatMulWeights<T>> packed =
+      PackedMatMulWeights<T>::Pack(
+          d, weights.flat_inner_dims<T, 2>(), transpose);
+  if (packed == nullptr) return nullptr;
+  mutex_lock l(mu_);
+  weights_ = weights;
+  transpose_ = transpose;
+  packed_ = packed;
+  return packed;
+}
+
+template class PackedMatMulWeights<float>;
+template class PackedMatMulWeightsCache<float>;
+
+}  // namespace tensorflow
@@ -0,0 +1,138 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_MATMUL_OP_PACKED_WEIGHTS_H_
+#define TENSORFLOW_CORE_KERNELS_MATMUL_OP_PACKED_WEIGHTS_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Eigen/Core"  // from @eigen_archive
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Boolean node attribute that allows a CPU MatMul, BatchMatMul or _FusedMatMul
+// kernel to keep its right-hand side packed between calls. The remapper sets
+// it on float products in graphs that do not update variables, when the
+// right-hand side is a constant or is read from a resource variable.
+inline constexpr char kCachePackedWeightsAttr[] = "_cache_packed_weights";
+
+// Environment variable that limits the memory, in MiB, used by the packed
+// weights of all the kernels of the process. Setting it to 0 disables
+// packing.
+inline constexpr char kPackedWeightsMaxMbEnvVar[] =
+    "TF_MATMUL_PACKED_WEIGHTS_MAX_MB";
+inline constexpr int64_t kDefaultPackedWeightsMaxMb = 1024;
+
+// The right-hand side of a matrix product, packed once into the panel layout
+// of Eigen's GEMM kernel.
+//
+// Eigen packs both operands of a product into cache-sized panels before
+// multiplying them. For the small batches of serving, packing the weights
+// costs about as much as the product itself, so weights that do not change
+// between calls are better packed once and reused.
+//
+// Only float is supported, since Eigen packs the operands of float products
+// with gemm_pack_lhs and gebp_kernel from Eigen::internal, which this relies
+// on. Products of other types always go through Eigen tensor contractions.
+template <typename T>
+class PackedMatMulWeights {
+ public:
+  using OutputMapper =
+      Eigen::internal::blas_data_mapper<T, Eigen::Index, Eigen::ColMajor>;
+  // Applied to each block of the output once it is computed, like the output
+  // kernels of Eigen tensor contractions: the output is mapped column-major
+  // as [n, m] and `swapped_arguments` is set.
+  using OutputKernel = std::function<void(
+      const OutputMapper&, const Eigen::TensorContractionParams&, Eigen::Index,
+      Eigen::Index, Eigen::Index, Eigen::Index)>;
+
+  // Packs `weights`, a [k, n] matrix, or [n, k] if `transpose` is true.
+  // Returns nullptr if the packed weights of the process would exceed the
+  // limit set by kPackedWeightsMaxMbEnvVar.
+  static std::unique_ptr<const PackedMatMulWeights> Pack(
+      const Eigen::ThreadPoolDevice& d,
+      typename TTypes<T>::ConstMatrix weights, bool transpose);
+
+  // Computes `out` = `lhs` * weights, where `lhs` is [m, k], or [k, m] if
+  // `transpose_lhs` is true, and `out` is [m, n].
+  void Multiply(const Eigen::ThreadPoolDevice& d,
+                typename TTypes<T>::ConstMatrix lhs, bool transpose_lhs,
+                typename TTypes<T>::Matrix out,
+                const OutputKernel& output_kernel = nullptr) const;
+
+  Eigen::Index depth() const { return depth_; }
+  Eigen::Index cols() const { return cols_; }
+
+  ~PackedMatMulWeights();
+
+ private:
+  PackedMatMulWeights(Eigen::Index depth, Eigen::Index cols);
+
+  // Returns the offset in `packed_` of the block of columns starting at `col`
+  // and depth starting at `k`, both multiples of the block sizes.
+  Eigen::Index BlockOffset(Eigen::Index col, Eigen::Index k) const;
+
+  const Eigen::Index depth_;
+  const Eigen::Index cols_;
+  Eigen::Index block_depth_;
+  Eigen::Index block_cols_;
+  Eigen::Index block_rows_;
+  std::vector<T, Eigen::aligned_allocator<T>> packed_;
+};
+
+// Keeps the packed form of the last right-hand side of a MatMul kernel.
+//
+// The cache holds a reference to the buffer of the weights it packed.
+// Resource variables and ops that forward their inputs only write to a buffer
+// in place while nothing else references it, so a cached buffer never changes:
+// assigning to a variable gives it a new buffer, which misses the cache and
+// replaces the entry. Reference variables are updated in place regardless and
+// must not be cached.
+//
+// Thread-safe.
+template <typename T>
+class PackedMatMulWeightsCache {
+ public:
+  PackedMatMulWeightsCache() = default;
+
+  PackedMatMulWeightsCache(const PackedMatMulWeightsCache&) = delete;
+  PackedMatMulWeightsCache& operator=(const PackedMatMulWeightsCache&) =
+      delete;
+
+  // Returns `weights` packed as by PackedMatMulWeights<T>::Pack, or nullptr
+  // if there is no memory left to pack them, in which case the product must
+  // be computed without them. `weights` is a matrix, possibly with leading
+  // dimensions of size 1.
+  std::shared_ptr<const PackedMatMulWeights<T>> Get(
+      const Eigen::ThreadPoolDevice& d, const Tensor& weights, bool transpose);
+
+ private:
+  mutex mu_;
+  Tensor weights_ TF_GUARDED_BY(mu_);
+  bool transpose_ TF_GUARDED_BY(mu_) = false;
+  std::shared_ptr<const PackedMatMulWeights<T>> packed_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_MATMUL_OP_PACKED_WEIGHTS_H_
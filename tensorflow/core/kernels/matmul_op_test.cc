@@ -13,22 +13,34 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/strings/match.h"
+#include "absl/types/span.h"
 #include "tensorflow/cc/ops/nn_ops_internal.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "xla/tsl/platform/status.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/ops_util.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/matmul_op_packed_weights.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/public/session.h"
 
@@ -417,6 +429,187 @@ using FusedBiasAddDataTypes = ::testing::Types<float, Eigen::half>;
 INSTANTIATE_TYPED_TEST_SUITE_P(Test, FusedMatMulWithBiasOpTest,
                                FusedBiasAddDataTypes);
 
+// Runs MatMul, BatchMatMulV2 and _FusedMatMul with their right-hand side
+// packed once and cached by the kernel.
+class CachedPackedWeightsMatMulOpTest : public OpsTestBase {
+ protected:
+  static Tensor Random(const TensorShape& shape) {
+    Tensor t(DT_FLOAT, shape);
+    t.flat<float>().setRandom();
+    t.flat<float>() -= t.flat<float>().constant(0.5f);
+    return t;
+  }
+
+  // Returns `lhs` * `rhs`, with the last two dimensions of `lhs` multiplied
+  // as matrices.
+  static Tensor Reference(const Tensor& lhs, const Tensor& rhs,
+                          bool transpose_a, bool transpose_b) {
+    const auto a = lhs.flat_inner_dims<float, 2>();
+    const auto b = rhs.flat_inner_dims<float, 2>();
+    const int64_t k = transpose_b ? b.dimension(1) : b.dimension(0);
+    const int64_t n = transpose_b ? b.dimension(0) : b.dimension(1);
+    const int64_t m = transpose_a ? a.dimension(1) : a.size() / k;
+    Tensor out(DT_FLOAT, TensorShape({m, n}));
+    auto c = out.matrix<float>();
+    for (int64_t i = 0; i < m; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        float sum = 0;
+        for (int64_t l = 0; l < k; ++l) {
+          sum += (transpose_a ? a(l, i) : a.data()[i * k + l]) *
+                 (transpose_b ? b(j, l) : b(l, j));
+        }
+        c(i, j) = sum;
+      }
+    }
+    return out;
+  }
+
+  // Runs the op with `lhs` and `weights`, which is not copied so that the
+  // kernel sees the same buffer on every run with the same tensor.
+  Tensor Run(const Tensor& lhs, Tensor* weights,
+             const std::vector<Tensor>& args = {}) {
+    inputs_.clear();
+    auto add_input = [this](const Tensor& t) {
+      AddInputFromArray<float>(t.shape(),
+                               absl::MakeConstSpan(t.flat<float>().data(),
+                                                   t.NumElements()));
+    };
+    add_input(lhs);
+    inputs_.push_back(TensorValue(weights));
+    for (const Tensor& arg : args) add_input(arg);
+    TF_EXPECT_OK(RunOpKernel());
+    return *GetOutput(0);
+  }
+
+  void ExpectMatches(const Tensor& output, const Tensor& expected) {
+    ASSERT_EQ(output.NumElements(), expected.NumElements());
+    Tensor reshaped;
+    ASSERT_TRUE(reshaped.CopyFrom(output, expected.shape()));
+    test::ExpectClose(reshaped, expected, /*atol=*/1e-4);
+  }
+};
+
+TEST_F(CachedPackedWeightsMatMulOpTest, MatMul) {
+  for (bool transpose_a : {false, true}) {
+    for (bool transpose_b : {false, true}) {
+      TF_ASSERT_OK(NodeDefBuilder("matmul", "MatMul")
+                       .Input(FakeInput(DT_FLOAT))
+                       .Input(FakeInput(DT_FLOAT))
+                       .Attr("transpose_a", transpose_a)
+                       .Attr("transpose_b", transpose_b)
+                       .Attr(kCachePackedWeightsAttr, true)
+                       .Finalize(node_def()));
+      TF_ASSERT_OK(InitOp());
+
+      // Sizes that are not multiples of the blocks of the GEMM kernel.
+      constexpr int kM = 13, kK = 301, kN = 70;
+      Tensor weights = Random(transpose_b ? TensorShape({kN, kK})
+                                          : TensorShape({kK, kN}));
+      for (int run = 0; run < 2; ++run) {
+        const Tensor lhs = Random(transpose_a ? TensorShape({kK, kM})
+                                              : TensorShape({kM, kK}));
+        ExpectMatches(Run(lhs, &weights),
+                      Reference(lhs, weights, transpose_a, transpose_b));
+      }
+
+      // New weights are packed again.
+      Tensor new_weights = Random(weights.shape());
+      const Tensor lhs = Random(transpose_a ? TensorShape({kK, kM})
+                                            : TensorShape({kM, kK}));
+      ExpectMatches(Run(lhs, &new_weights),
+                    Reference(lhs, new_weights, transpose_a, transpose_b));
+    }
+  }
+}
+
+TEST_F(CachedPackedWeightsMatMulOpTest, BatchMatMul) {
+  TF_ASSERT_OK(NodeDefBuilder("batch_matmul", "BatchMatMulV2")
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Attr(kCachePackedWeightsAttr, true)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+
+  Tensor weights = Random(TensorShape({1, 40, 24}));
+  for (int run = 0; run < 2; ++run) {
+    const Tensor lhs = Random(TensorShape({3, 5, 40}));
+    const Tensor output = Run(lhs, &weights);
+    EXPECT_EQ(output.shape(), TensorShape({3, 5, 24}));
+    ExpectMatches(output, Reference(lhs, weights, false, false));
+  }
+}
+
+TEST_F(CachedPackedWeightsMatMulOpTest, FusedMatMul) {
+  TF_ASSERT_OK(NodeDefBuilder("fused_matmul", "_FusedMatMul")
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(1, DT_FLOAT))
+                   .Attr("num_args", 1)
+                   .Attr("fused_ops", {"BiasAdd", "Relu"})
+                   .Attr("transpose_b", true)
+                   .Attr(kCachePackedWeightsAttr, true)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+
+  Tensor weights = Random(TensorShape({33, 64}));
+  const Tensor bias = Random(TensorShape({33}));
+  for (int run = 0; run < 2; ++run) {
+    const Tensor lhs = Random(TensorShape({6, 64}));
+    Tensor expected = Reference(lhs, weights, false, true);
+    auto e = expected.matrix<float>();
+    for (int i = 0; i < e.dimension(0); ++i) {
+      for (int j = 0; j < e.dimension(1); ++j) {
+        e(i, j) = std::max(e(i, j) + bias.vec<float>()(j), 0.0f);
+      }
+    }
+    ExpectMatches(Run(lhs, &weights, {bias}), expected);
+  }
+}
+
+TEST_F(CachedPackedWeightsMatMulOpTest, WithoutMemoryForPackedWeights) {
+  TF_ASSERT_OK(NodeDefBuilder("matmul", "MatMul")
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Attr(kCachePackedWeightsAttr, true)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+
+  tensorflow::setenv(kPackedWeightsMaxMbEnvVar, "0", /*overwrite=*/1);
+  Tensor weights = Random(TensorShape({40, 24}));
+  const Tensor lhs = Random(TensorShape({5, 40}));
+  ExpectMatches(Run(lhs, &weights), Reference(lhs, weights, false, false));
+  tensorflow::unsetenv(kPackedWeightsMaxMbEnvVar);
+}
+
+TEST(PackedMatMulWeightsCacheTest, LimitsMemory) {
+  thread::ThreadPool pool(Env::Default(), "packed_weights_test",
+                          /*num_threads=*/2);
+  Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), /*num_cores=*/2);
+  // Each packs into a bit more than 600 KiB.
+  Tensor weights(DT_FLOAT, TensorShape({256, 600}));
+  weights.flat<float>().setRandom();
+  Tensor other_weights(DT_FLOAT, weights.shape());
+  other_weights.flat<float>().setRandom();
+
+  tensorflow::setenv(kPackedWeightsMaxMbEnvVar, "1", /*overwrite=*/1);
+  auto cache = std::make_unique<PackedMatMulWeightsCache<float>>();
+  PackedMatMulWeightsCache<float> other_cache;
+  EXPECT_NE(cache->Get(device, weights, /*transpose=*/false), nullptr);
+  EXPECT_EQ(other_cache.Get(device, other_weights, /*transpose=*/false),
+            nullptr);
+  // The packed weights are released with their cache.
+  cache.reset();
+  EXPECT_NE(other_cache.Get(device, other_weights, /*transpose=*/false),
+            nullptr);
+
+  tensorflow::setenv(kPackedWeightsMaxMbEnvVar, "0", /*overwrite=*/1);
+  // Weights that are already packed are kept.
+  EXPECT_NE(other_cache.Get(device, other_weights, /*transpose=*/false),
+            nullptr);
+  EXPECT_EQ(other_cache.Get(device, weights, /*transpose=*/false), nullptr);
+  tensorflow::unsetenv(kPackedWeightsMaxMbEnvVar);
+}
+
 //----------------------------------------------------------------------------//
 // Performance benchmarks are below.                                          //
 //----------------------------------------------------------------------------//
@@ -542,6 +735,32 @@ BM_Matmul(2000, 1, 2000, true, true);
 
 // LINT.ThenChange(//tensorflow/core/kernels/mkl/mkl_matmul_op_benchmark.cc)
 
+// Small batches with constant weights, which the kernel packs once.
+template <typename T>
+static Graph* CachedMatmul(int m, int k, int n, DataType type) {
+  Graph* g = Matmul<T>(m, k, n, false, false, type);
+  for (Node* node : g->op_nodes()) {
+    if (node->type_string() == "MatMul") {
+      node->AddAttr(kCachePackedWeightsAttr, true);
+    }
+  }
+  return g;
+}
+
+#define BM_CachedMatmul(M, K, N)                                               \
+  static void BM_CachedMatmul##_##M##_##K##_##N(                               \
+      ::testing::benchmark::State& state) {                                    \
+    test::Benchmark("cpu", CachedMatmul<float>(M, K, N, DT_FLOAT)).Run(state); \
+    state.SetItemsProcessed(state.iterations() * M * K * N * 2);               \
+  }                                                                            \
+  BENCHMARK(BM_CachedMatmul##_##M##_##K##_##N)->MeasureProcessCPUTime();
+
+BM_CachedMatmul(2, 1024, 1024);
+BM_CachedMatmul(4, 1024, 1024);
+BM_CachedMatmul(8, 1024, 1024);
+BM_CachedMatmul(16, 1024, 1024);
+BM_CachedMatmul(64, 1024, 1024);
+
 // Benchmarks for batched matmul with broadcasting.
 Node* BroadcastTo(Graph* g, Node* input, Node* shape) {
   Node* ret;
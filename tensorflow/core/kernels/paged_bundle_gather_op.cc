@@ -0,0 +1,249 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/io_ops.cc.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Target size of the pages read from the checkpoint. A page holds at least one
+// row.
+constexpr int64_t kPageBytes = 64 << 10;
+
+// The rows of checkpoint tensors, read in pages on first access and cached in
+// memory up to a limit. Shared by all the _PagedBundleGather ops reading from
+// the same checkpoint.
+class PagedBundleStore : public ResourceBase {
+ public:
+  PagedBundleStore(Env* env, const std::string& prefix, int64_t cache_bytes)
+      : prefix_(prefix),
+        cache_bytes_(cache_bytes),
+        reader_(env, prefix) {}
+
+  std::string DebugString() const override {
+    return absl::StrCat("PagedBundleStore(", prefix_, ")");
+  }
+
+  int64_t MemoryUsed() const override {
+    mutex_lock l(mu_);
+    return cached_bytes_;
+  }
+
+  // Returns rows [first_row, first_row + num_rows) of the checkpoint tensor
+  // `tensor_name` in `page`, which must have dtype `dtype` and rows of shape
+  // `row_shape`.
+  absl::Status GetPage(const std::string& tensor_name, DataType dtype,
+                       const TensorShape& row_shape, int64_t first_row,
+                       int64_t num_rows, std::shared_ptr<const Tensor>* page) {
+    const std::string key = absl::StrCat(tensor_name, ":", first_row, ":",
+                                         num_rows);
+    {
+      mutex_lock l(mu_);
+      auto it = pages_.find(key);
+      if (it != pages_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+        *page = it->second.page;
+        return absl::OkStatus();
+      }
+    }
+
+    auto rows = std::make_shared<Tensor>();
+    {
+      // Reads outside of `mu_`, so that cached pages are served while a page
+      // is read. Concurrent misses of the same page may read it twice.
+      mutex_lock l(reader_mu_);
+      TF_RETURN_IF_ERROR(reader_.status());
+      TF_RETURN_IF_ERROR(
+          reader_.LookupRows(tensor_name, first_row, num_rows, rows.get()));
+    }
+    TensorShape expected_shape = row_shape;
+    expected_shape.InsertDim(0, num_rows);
+    if (rows->dtype() != dtype || rows->shape() != expected_shape) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected rows of ", DataTypeString(dtype), " ",
+          expected_shape.DebugString(), " from tensor ", tensor_name,
+          " in checkpoint ", prefix_, ", got ", DataTypeString(rows->dtype()),
+          " ", rows->shape().DebugString()));
+    }
+
+    mutex_lock l(mu_);
+    auto [it, inserted] = pages_.try_emplace(key);
+    if (inserted) {
+      lru_.push_front(key);
+      it->second.page = std::move(rows);
+      it->second.lru_position = lru_.begin();
+      cached_bytes_ += it->second.page->TotalBytes();
+      Evict();
+    }
+    *page = it->second.page;
+    return absl::OkStatus();
+  }
+
+ private:
+  struct CachedPage {
+    std::shared_ptr<const Tensor> page;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  // Drops the least recently used pages until the cache is within its limit,
+  // but always keeps the most recently used page. Pages that are being copied
+  // by ops stay alive until they are done.
+  void Evict() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    while (cached_bytes_ > cache_bytes_ && lru_.size() > 1) {
+      auto it = pages_.find(lru_.back());
+      cached_bytes_ -= it->second.page->TotalBytes();
+      pages_.erase(it);
+      lru_.pop_back();
+    }
+  }
+
+  const std::string prefix_;
+  const int64_t cache_bytes_;
+
+  mutex reader_mu_;
+  BundleReader reader_ TF_GUARDED_BY(reader_mu_);
+
+  mutable mutex mu_;
+  // Keys of the cached pages, most recently used first.
+  std::list<std::string> lru_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, CachedPage> pages_ TF_GUARDED_BY(mu_);
+  int64_t cached_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+template <typename Index>
+class PagedBundleGatherOp : public OpKernel {
+ public:
+  explicit PagedBundleGatherOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("dtype", &dtype_));
+    OP_REQUIRES_OK(context, context->GetAttr("prefix", &prefix_));
+    OP_REQUIRES_OK(context, context->GetAttr("tensor_name", &tensor_name_));
+    OP_REQUIRES_OK(context, context->GetAttr("row_offset", &row_offset_));
+    OP_REQUIRES_OK(context, context->GetAttr("cache_bytes", &cache_bytes_));
+    PartialTensorShape shape;
+    OP_REQUIRES_OK(context, context->GetAttr("shape", &shape));
+    OP_REQUIRES(context, shape.dims() >= 1 && shape.AsTensorShape(&shape_),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "shape must be fully defined and have rank >= 1, got ",
+                    shape.DebugString())));
+    OP_REQUIRES(context, DataTypeCanUseMemcpy(dtype_),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Unsupported dtype ", DataTypeString(dtype_))));
+    OP_REQUIRES(context, row_offset_ >= 0,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "row_offset must be non-negative, got ", row_offset_)));
+    row_shape_ = shape_;
+    row_shape_.RemoveDim(0);
+    row_bytes_ = row_shape_.num_elements() * DataTypeSize(dtype_);
+    rows_per_page_ =
+        std::max<int64_t>(1, kPageBytes / std::max<int64_t>(row_bytes_, 1));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    PagedBundleStore* store = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->resource_manager()->LookupOrCreate<PagedBundleStore>(
+            context->resource_manager()->default_container(), prefix_, &store,
+            [&](PagedBundleStore** out) {
+              *out = new PagedBundleStore(context->env(), prefix_,
+                                          cache_bytes_);
+              return absl::OkStatus();
+            }));
+    core::ScopedUnref unref(store);
+
+    const Tensor& indices = context->input(0);
+    TensorShape output_shape = indices.shape();
+    output_shape.AppendShape(row_shape_);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, output_shape, &output));
+    if (row_bytes_ == 0) return;
+
+    const int64_t num_rows = shape_.dim_size(0);
+    const auto indices_flat = indices.flat<Index>();
+    char* out = const_cast<char*>(output->tensor_data().data());
+    std::shared_ptr<const Tensor> page;
+    int64_t page_index = -1;
+    for (int64_t i = 0; i < indices_flat.size(); ++i) {
+      const Index index = indices_flat(i);
+      OP_REQUIRES(context, FastBoundsCheck(index, num_rows),
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "indices[", i, "] = ", index, " is not in [0, ",
+                      num_rows, ")")));
+      if (index / rows_per_page_ != page_index) {
+        page_index = index / rows_per_page_;
+        const int64_t first_row = page_index * rows_per_page_;
+        OP_REQUIRES_OK(
+            context,
+            store->GetPage(tensor_name_, dtype_, row_shape_,
+                           row_offset_ + first_row,
+                           std::min(rows_per_page_, num_rows - first_row),
+                           &page));
+      }
+      std::memcpy(out + i * row_bytes_,
+                  page->tensor_data().data() +
+                      (index - page_index * rows_per_page_) * row_bytes_,
+                  row_bytes_);
+    }
+  }
+
+ private:
+  DataType dtype_;
+  std::string prefix_;
+  std::string tensor_name_;
+  int64_t row_offset_;
+  int64_t cache_bytes_;
+  TensorShape shape_;
+  TensorShape row_shape_;
+  int64_t row_bytes_;
+  int64_t rows_per_page_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("_PagedBundleGather")
+                            .Device(DEVICE_CPU)
+                            .TypeConstraint<int32_t>("Tindices"),
+                        PagedBundleGatherOp<int32_t>);
+REGISTER_KERNEL_BUILDER(Name("_PagedBundleGather")
+                            .Device(DEVICE_CPU)
+                            .TypeConstraint<int64_t>("Tindices"),
+                        PagedBundleGatherOp<int64_t>);
+
+}  // namespace
+
+}  // namespace tensorflow
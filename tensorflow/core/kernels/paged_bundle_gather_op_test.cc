@@ -0,0 +1,151 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+// Rows of 8KiB, i.e. eight rows per page.
+constexpr int64_t kRows = 40;
+constexpr int64_t kRowSize = 2048;
+
+class PagedBundleGatherOpTest : public OpsTestBase {
+ protected:
+  void SetUp() override {
+    prefix_ = io::JoinPath(testing::TmpDir(), "paged_bundle_gather");
+    full_ = Tensor(DT_FLOAT, TensorShape({kRows, kRowSize}));
+    test::FillIota<float>(&full_, 0);
+    BundleWriter writer(Env::Default(), prefix_);
+    TF_ASSERT_OK(writer.Add("full", full_));
+    // Stored as two partitions of 20 rows.
+    const TensorShape full_shape = full_.shape();
+    TF_ASSERT_OK(writer.AddSlice("partitioned", full_shape,
+                                 TensorSlice::ParseOrDie("0,20:-"),
+                                 full_.Slice(0, 20)));
+    TF_ASSERT_OK(writer.AddSlice("partitioned", full_shape,
+                                 TensorSlice::ParseOrDie("20,20:-"),
+                                 full_.Slice(20, 40)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  void MakeOp(const std::string& tensor_name, int64_t row_offset,
+              int64_t rows, int64_t cache_bytes) {
+    TF_ASSERT_OK(NodeDefBuilder("gather", "_PagedBundleGather")
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("dtype", DT_FLOAT)
+                     .Attr("prefix", prefix_)
+                     .Attr("tensor_name", tensor_name)
+                     .Attr("row_offset", row_offset)
+                     .Attr("shape", TensorShape({rows, kRowSize}))
+                     .Attr("cache_bytes", cache_bytes)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Returns the rows `indices` of `full_`, offset by `row_offset`.
+  Tensor ExpectedRows(const std::vector<int32_t>& indices,
+                      int64_t row_offset) {
+    Tensor expected(DT_FLOAT,
+                    TensorShape({static_cast<int64_t>(indices.size()),
+                                 kRowSize}));
+    for (int i = 0; i < indices.size(); ++i) {
+      expected.SubSlice(i).unaligned_flat<float>() =
+          full_.SubSlice(row_offset + indices[i]).unaligned_flat<float>();
+    }
+    return expected;
+  }
+
+  std::string prefix_;
+  Tensor full_;
+};
+
+TEST_F(PagedBundleGatherOpTest, Gather) {
+  MakeOp("full", 0, kRows, 1 << 30);
+  const std::vector<int32_t> indices = {0, 39, 8, 0, 17, 17, 7};
+  AddInputFromArray<int32_t>(TensorShape({7}), indices);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<float>(*GetOutput(0), ExpectedRows(indices, 0));
+}
+
+TEST_F(PagedBundleGatherOpTest, GatherWithEviction) {
+  // Room for a single page, so that every page change reads from file.
+  MakeOp("full", 0, kRows, 1);
+  const std::vector<int32_t> indices = {0, 39, 8, 0, 17, 39, 1, 33};
+  for (int run = 0; run < 2; ++run) {
+    inputs_.clear();
+    AddInputFromArray<int32_t>(TensorShape({2, 4}), indices);
+    TF_ASSERT_OK(RunOpKernel());
+    Tensor expected;
+    ASSERT_TRUE(expected.CopyFrom(ExpectedRows(indices, 0),
+                                  TensorShape({2, 4, kRowSize})));
+    test::ExpectTensorEqual<float>(*GetOutput(0), expected);
+  }
+}
+
+TEST_F(PagedBundleGatherOpTest, GatherFromPartition) {
+  // The second half of "partitioned", as a variable of 30 rows starting at
+  // row 10, spans both stored slices.
+  MakeOp("partitioned", 10, 30, 1 << 30);
+  const std::vector<int32_t> indices = {29, 0, 9, 10, 15};
+  AddInputFromArray<int32_t>(TensorShape({5}), indices);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<float>(*GetOutput(0), ExpectedRows(indices, 10));
+}
+
+TEST_F(PagedBundleGatherOpTest, IndexOutOfRange) {
+  MakeOp("full", 0, kRows, 1 << 30);
+  AddInputFromArray<int32_t>(TensorShape({2}), {3, kRows});
+  const absl::Status status = RunOpKernel();
+  EXPECT_TRUE(absl::IsInvalidArgument(status));
+  EXPECT_TRUE(absl::StrContains(status.message(), "indices[1] = 40"))
+      << status;
+}
+
+TEST_F(PagedBundleGatherOpTest, ShapeMismatch) {
+  // The variable is wider than the checkpoint tensor.
+  TF_ASSERT_OK(NodeDefBuilder("gather", "_PagedBundleGather")
+                   .Input(FakeInput(DT_INT32))
+                   .Attr("dtype", DT_FLOAT)
+                   .Attr("prefix", prefix_)
+                   .Attr("tensor_name", "full")
+                   .Attr("shape", TensorShape({kRows, kRowSize + 1}))
+                   .Attr("cache_bytes", 1 << 30)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<int32_t>(TensorShape({1}), {0});
+  EXPECT_TRUE(absl::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/fingerprint_util.h"
 #include "tensorflow/core/kernels/ragged_utils.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/fingerprint.h"
@@ -351,11 +352,31 @@ class RaggedCrossOp : public OpKernel {
     int64_t batch_size =
         CalculateBatchSize(ragged_splits_list, sparse_shape_list, dense_list);
 
+    // Hashed crosses fingerprint every string feature. Do that once per string
+    // up front, in parallel, instead of once per cross the string is part of.
+    std::vector<Tensor> ragged_values;
+    std::vector<Tensor> sparse_values;
+    std::vector<Tensor> dense_values;
+    if (context->expected_output_dtype(0) == DT_INT64) {
+      OP_REQUIRES_OK(context, FingerprintStringInputs(
+                                  context, ragged_values_list, &ragged_values));
+      OP_REQUIRES_OK(context, FingerprintStringInputs(
+                                  context, sparse_values_list, &sparse_values));
+      OP_REQUIRES_OK(context, FingerprintStringInputs(context, dense_list,
+                                                      &dense_values));
+    } else {
+      ragged_values.assign(ragged_values_list.begin(),
+                           ragged_values_list.end());
+      sparse_values.assign(sparse_values_list.begin(),
+                           sparse_values_list.end());
+      dense_values.assign(dense_list.begin(), dense_list.end());
+    }
+
     FeatureReaders features;
     OP_REQUIRES_OK(context,
-                   BuildFeatureReaders(ragged_values_list, ragged_splits_list,
-                                       sparse_indices_list, sparse_values_list,
-                                       dense_list, batch_size, &features));
+                   BuildFeatureReaders(ragged_values, ragged_splits_list,
+                                       sparse_indices_list, sparse_values,
+                                       dense_values, batch_size, &features));
 
     Tensor* values_out;
     Tensor* row_splits_out;
@@ -460,13 +481,13 @@ class RaggedCrossOp : public OpKernel {
   }
 
   // Build a feature reader for each input tensor, and store them in `features`.
-  absl::Status BuildFeatureReaders(const OpInputList& ragged_values_list,
-                                   const OpInputList& ragged_splits_list,
-                                   const OpInputList& sparse_indices_list,
-                                   const OpInputList& sparse_values_list,
-                                   const OpInputList& dense_list,
-                                   int64_t batch_size,
-                                   FeatureReaders* features) {
+  absl::Status BuildFeatureReaders(
+      const std::vector<Tensor>& ragged_values_list,
+      const OpInputList& ragged_splits_list,
+      const OpInputList& sparse_indices_list,
+      const std::vector<Tensor>& sparse_values_list,
+      const std::vector<Tensor>& dense_list, int64_t batch_size,
+      FeatureReaders* features) {
     features->reserve(input_order_.size());
 
     int next_ragged = 0;
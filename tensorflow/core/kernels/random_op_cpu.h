@@ -20,7 +20,9 @@ limitations under the License.
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -29,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/random_op.h"
 #include "tensorflow/core/kernels/random_ops_util.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/random/philox_random_batch.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/logging.h"
@@ -76,6 +79,36 @@ struct FillPhiloxRandom {
 template <class Distribution, bool VariableSamplesPerOutput>
 struct FillPhiloxRandomTask;
 
+// Maps a distribution over PhiloxRandom to the same distribution over
+// PhiloxRandomBatch, which yields the same samples but computes several
+// Philox blocks at once. Only distributions without parameters are mapped,
+// since the batched distribution is default-constructed; for all others
+// `type` is void and the samples are drawn from PhiloxRandom directly.
+template <class Distribution>
+struct BatchedPhiloxDistribution {
+  typedef void type;
+};
+
+#define BATCHED_PHILOX_DISTRIBUTION(DIST, T)                        \
+  template <>                                                       \
+  struct BatchedPhiloxDistribution<random::DIST<PhiloxRandom, T>> { \
+    typedef random::DIST<random::PhiloxRandomBatch, T> type;        \
+  }
+
+BATCHED_PHILOX_DISTRIBUTION(UniformDistribution, Eigen::half);
+BATCHED_PHILOX_DISTRIBUTION(UniformDistribution, bfloat16);
+BATCHED_PHILOX_DISTRIBUTION(UniformDistribution, float);
+BATCHED_PHILOX_DISTRIBUTION(UniformDistribution, double);
+BATCHED_PHILOX_DISTRIBUTION(NormalDistribution, Eigen::half);
+BATCHED_PHILOX_DISTRIBUTION(NormalDistribution, bfloat16);
+BATCHED_PHILOX_DISTRIBUTION(NormalDistribution, float);
+BATCHED_PHILOX_DISTRIBUTION(NormalDistribution, double);
+BATCHED_PHILOX_DISTRIBUTION(UniformFullIntDistribution, int32_t);
+BATCHED_PHILOX_DISTRIBUTION(UniformFullIntDistribution, int64_t);
+BATCHED_PHILOX_DISTRIBUTION(UniformFullIntDistribution, uint32_t);
+BATCHED_PHILOX_DISTRIBUTION(UniformFullIntDistribution, uint64_t);
+#undef BATCHED_PHILOX_DISTRIBUTION
+
 // Specialization for distribution that takes a fixed number of samples for
 // each output.
 template <class Distribution>
@@ -83,15 +116,66 @@ struct FillPhiloxRandomTask<Distribution, false> {
   typedef typename Distribution::ResultElementType T;
   static void Run(random::PhiloxRandom gen, T* data, int64_t size,
                   int64_t start_group, int64_t limit_group, Distribution dist) {
-    const int kGroupSize = Distribution::kResultElementCount;
+    typedef typename BatchedPhiloxDistribution<Distribution>::type
+        BatchedDistribution;
 
     gen.Skip(start_group);
+    if constexpr (std::is_void_v<BatchedDistribution>) {
+      FillGroups(&gen, data, size, start_group, limit_group, dist);
+    } else {
+      // Every group consumes exactly one Philox sample, so the batched
+      // generator yields the same values for each group as `gen` would.
+      random::PhiloxRandomBatch batch_gen(gen);
+      if constexpr (std::is_same_v<Distribution,
+                                   random::UniformDistribution<
+                                       random::PhiloxRandom, float>>) {
+        start_group = FillUniformFloatBatches(&batch_gen, data, start_group,
+                                              limit_group, size);
+      }
+      FillGroups(&batch_gen, data, size, start_group, limit_group,
+                 BatchedDistribution());
+    }
+  }
+
+ private:
+  // Fills whole batches of full groups of uniform floats, from `start_group`
+  // up to `limit_group`, and returns the first group that is left. Converts
+  // each batch of Philox samples to floats in one loop, which vectorizes,
+  // instead of one group at a time. Gives the same values as
+  // UniformDistribution<PhiloxRandom, float>.
+  static int64_t FillUniformFloatBatches(random::PhiloxRandomBatch* gen,
+                                         float* data, int64_t start_group,
+                                         int64_t limit_group, int64_t size) {
+    constexpr int kGroupSize = random::PhiloxRandom::kResultElementCount;
+    constexpr int kBatchValues =
+        random::PhiloxRandomBatch::kBatchSize * kGroupSize;
+    const int64_t limit_group_full = std::min(limit_group, size / kGroupSize);
+
+    uint32_t samples[kBatchValues];
+    int64_t group = start_group;
+    for (; group + random::PhiloxRandomBatch::kBatchSize <= limit_group_full;
+         group += random::PhiloxRandomBatch::kBatchSize) {
+      gen->NextBatch(samples);
+      float* out = data + group * kGroupSize;
+      for (int i = 0; i < kBatchValues; ++i) {
+        out[i] = random::Uint32ToFloat(samples[i]);
+      }
+    }
+    return group;
+  }
+
+  template <class Generator, class GroupDistribution>
+  static void FillGroups(Generator* gen, T* data, int64_t size,
+                         int64_t start_group, int64_t limit_group,
+                         GroupDistribution dist) {
+    const int kGroupSize = Distribution::kResultElementCount;
+
     int64_t offset = start_group * kGroupSize;
 
     // First fill all the full-size groups
     int64_t limit_group_full = std::min(limit_group, size / kGroupSize);
     for (int64_t index = start_group; index < limit_group_full; ++index) {
-      auto samples = dist(&gen);
+      auto samples = dist(gen);
       std::copy(&samples[0], &samples[0] + kGroupSize, data + offset);
       offset += kGroupSize;
     }
@@ -99,7 +183,7 @@ struct FillPhiloxRandomTask<Distribution, false> {
     // If there are any remaining elements that need to be filled, process them
     if (limit_group_full < limit_group) {
       int64_t remaining_size = size - limit_group_full * kGroupSize;
-      auto samples = dist(&gen);
+      auto samples = dist(gen);
       std::copy(&samples[0], &samples[0] + remaining_size, data + offset);
     }
   }
@@ -13,12 +13,17 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <cstdint>
 #include <random>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/math/math_util.h"
 #include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/philox_random_batch.h"
+#include "tensorflow/core/lib/random/random_distributions.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 
@@ -116,6 +121,61 @@ void BM_PhiloxRandom(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_PhiloxRandom);
 
+void BM_PhiloxRandomBatch(::testing::benchmark::State& state) {
+  // Fill 2M random numbers
+  int count = 2 << 20;
+  random::PhiloxRandomBatch gen(random::PhiloxRandom(0x12345));
+
+  for (auto s : state) {
+    for (int j = 0; j < count; j += 4) {
+      auto samples = gen();
+      tensorflow::testing::DoNotOptimize(samples);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK(BM_PhiloxRandomBatch);
+
+// Fills 2M uniform floats one group at a time, as RandomUniform did before it
+// converted whole batches of samples.
+void BM_UniformFloat(::testing::benchmark::State& state) {
+  const int count = 2 << 20;
+  std::vector<float> data(count);
+  random::PhiloxRandom gen(0x12345);
+  random::UniformDistribution<random::PhiloxRandom, float> dist;
+
+  for (auto s : state) {
+    for (int j = 0; j < count; j += 4) {
+      const auto samples = dist(&gen);
+      std::copy(&samples[0], &samples[0] + 4, data.data() + j);
+    }
+    tensorflow::testing::DoNotOptimize(data.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK(BM_UniformFloat);
+
+// Fills 2M uniform floats a batch at a time, as RandomUniform does.
+void BM_UniformFloatBatch(::testing::benchmark::State& state) {
+  const int count = 2 << 20;
+  constexpr int kBatchValues = random::PhiloxRandomBatch::kBatchSize * 4;
+  std::vector<float> data(count);
+  random::PhiloxRandomBatch gen(random::PhiloxRandom(0x12345));
+  uint32_t samples[kBatchValues];
+
+  for (auto s : state) {
+    for (int j = 0; j < count; j += kBatchValues) {
+      gen.NextBatch(samples);
+      for (int i = 0; i < kBatchValues; ++i) {
+        data[j + i] = random::Uint32ToFloat(samples[i]);
+      }
+    }
+    tensorflow::testing::DoNotOptimize(data.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK(BM_UniformFloatBatch);
+
 void BM_StdMTRandom(::testing::benchmark::State& state) {
   // Fill 2M random numbers
   int count = 2 << 20;
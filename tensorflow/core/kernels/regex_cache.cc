@@ -0,0 +1,106 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/regex_cache.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "re2/re2.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns a key that identifies `pattern` compiled with `options`.
+std::string CacheKey(const std::string& pattern, const RE2::Options& options) {
+  std::string key =
+      absl::StrCat(options.encoding(), ":", options.max_mem(), ":");
+  for (const bool flag :
+       {options.posix_syntax(), options.longest_match(), options.log_errors(),
+        options.literal(), options.never_nl(), options.dot_nl(),
+        options.never_capture(), options.case_sensitive(),
+        options.perl_classes(), options.word_boundary(), options.one_line()}) {
+    key.push_back(flag ? '1' : '0');
+  }
+  absl::StrAppend(&key, ":", pattern);
+  return key;
+}
+
+class RegexCache {
+ public:
+  std::shared_ptr<const RE2> Get(const std::string& pattern,
+                                 const RE2::Options& options) {
+    const std::string key = CacheKey(pattern, options);
+    {
+      mutex_lock l(mu_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+        return it->second.regex;
+      }
+    }
+
+    // Compile the regex without holding the lock. Threads that miss the cache
+    // at the same time may each compile it, and the first one is kept.
+    auto regex = std::make_shared<const RE2>(pattern, options);
+    // Destroy the evicted regex, if any, after releasing the lock.
+    std::shared_ptr<const RE2> evicted;
+    mutex_lock l(mu_);
+    auto inserted = entries_.try_emplace(key);
+    Entry& entry = inserted.first->second;
+    if (!inserted.second) {
+      lru_.splice(lru_.begin(), lru_, entry.lru_position);
+      return entry.regex;
+    }
+    entry.regex = std::move(regex);
+    lru_.push_front(key);
+    entry.lru_position = lru_.begin();
+    std::shared_ptr<const RE2> result = entry.regex;
+    if (lru_.size() > kRegexCacheCapacity) {
+      auto last = entries_.find(lru_.back());
+      evicted = std::move(last->second.regex);
+      entries_.erase(last);
+      lru_.pop_back();
+    }
+    return result;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<const RE2> regex;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  mutex mu_;
+  // The keys of the entries, the most recently used first.
+  std::list<std::string> lru_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, Entry> entries_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+std::shared_ptr<const RE2> GetCachedRE2(const std::string& pattern,
+                                        const RE2::Options& options) {
+  static RegexCache* cache = new RegexCache;
+  return cache->Get(pattern, options);
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,45 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_REGEX_CACHE_H_
+#define TENSORFLOW_CORE_KERNELS_REGEX_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "re2/re2.h"
+
+namespace tensorflow {
+
+// Number of compiled regexes kept by GetCachedRE2.
+inline constexpr int kRegexCacheCapacity = 256;
+
+// Returns `pattern` compiled with `options`, from a cache shared by all the
+// kernels of the process.
+//
+// Kernels that take their pattern as an input would otherwise compile it
+// whenever it differs from the pattern of their previous call, and every
+// kernel would hold its own copy. The cache keeps the kRegexCacheCapacity
+// most recently used regexes. Invalid patterns are cached too, so callers
+// must check RE2::ok().
+//
+// Thread-safe.
+std::shared_ptr<const RE2> GetCachedRE2(
+    const std::string& pattern,
+    const RE2::Options& options = RE2::DefaultOptions);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_REGEX_CACHE_H_
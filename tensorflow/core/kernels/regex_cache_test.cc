@@ -0,0 +1,64 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/regex_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "re2/re2.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(RegexCacheTest, SharesCompiledPatterns) {
+  std::shared_ptr<const RE2> regex = GetCachedRE2("a+b");
+  ASSERT_TRUE(regex->ok());
+  EXPECT_TRUE(RE2::FullMatch("aab", *regex));
+  EXPECT_EQ(GetCachedRE2("a+b"), regex);
+  EXPECT_NE(GetCachedRE2("a+c"), regex);
+}
+
+TEST(RegexCacheTest, KeysOnOptions) {
+  RE2::Options options;
+  options.set_case_sensitive(false);
+  std::shared_ptr<const RE2> regex = GetCachedRE2("abc", options);
+  EXPECT_NE(GetCachedRE2("abc"), regex);
+  EXPECT_EQ(GetCachedRE2("abc", options), regex);
+  EXPECT_TRUE(RE2::FullMatch("ABC", *regex));
+}
+
+TEST(RegexCacheTest, CachesInvalidPatterns) {
+  std::shared_ptr<const RE2> regex = GetCachedRE2("(");
+  EXPECT_FALSE(regex->ok());
+  EXPECT_EQ(GetCachedRE2("("), regex);
+}
+
+TEST(RegexCacheTest, EvictsLeastRecentlyUsed) {
+  std::shared_ptr<const RE2> first = GetCachedRE2("first");
+  std::shared_ptr<const RE2> second = GetCachedRE2("second");
+  for (int i = 0; i < kRegexCacheCapacity - 1; ++i) {
+    GetCachedRE2(absl::StrCat("pattern", i));
+    // Keeps "second" recently used.
+    EXPECT_EQ(GetCachedRE2("second"), second);
+  }
+  EXPECT_EQ(GetCachedRE2("second"), second);
+  EXPECT_NE(GetCachedRE2("first"), first);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -13,17 +13,46 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include "re2/re2.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/regex_cache.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
+namespace {
+
+// Sets each element of `output` to whether the corresponding element of
+// `input` fully matches `regex`, sharding the elements over the threads.
+void FullMatch(OpKernelContext* ctx, const RE2& regex,
+               TTypes<tstring>::ConstFlat input, TTypes<bool>::Flat output) {
+  int64_t total_size = 0;
+  for (int64_t i = 0; i < input.size(); ++i) {
+    total_size += input(i).size();
+  }
+  // Rough cost of matching a string, per byte.
+  const int64_t kCostPerByte = 20;
+  const int64_t cost_per_string =
+      kCostPerByte * (total_size / std::max<int64_t>(input.size(), 1) + 1);
+  auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers, input.size(),
+        cost_per_string, [&](int64_t start, int64_t limit) {
+          for (int64_t i = start; i < limit; ++i) {
+            output(i) = RE2::FullMatch(input(i), regex);
+          }
+        });
+}
+
+}  // namespace
 
 class RegexFullMatchOp : public OpKernel {
  public:
@@ -42,7 +71,7 @@ class RegexFullMatchOp : public OpKernel {
                 errors::InvalidArgument("Pattern must be scalar, but received ",
                                         pattern_tensor->shape().DebugString()));
     const std::string pattern = pattern_tensor->flat<tstring>()(0);
-    std::shared_ptr<RE2> regex = CachedRE2(pattern);
+    std::shared_ptr<const RE2> regex = CachedRE2(pattern);
     OP_REQUIRES(ctx, regex->ok(),
                 errors::InvalidArgument("Invalid pattern: ", pattern,
                                         ", error: ", regex->error()));
@@ -50,22 +79,20 @@ class RegexFullMatchOp : public OpKernel {
     Tensor* output_tensor = nullptr;
     OP_REQUIRES_OK(ctx, ctx->allocate_output("output", input_tensor->shape(),
                                              &output_tensor));
-    auto output_flat = output_tensor->flat<bool>();
-    for (size_t i = 0; i < input_flat.size(); ++i) {
-      output_flat(i) = RE2::FullMatch(input_flat(i), *regex);
-    }
+    FullMatch(ctx, *regex, input_flat, output_tensor->flat<bool>());
   }
 
  private:
-  std::shared_ptr<RE2> CachedRE2(const std::string& pattern) {
+  std::shared_ptr<const RE2> CachedRE2(const std::string& pattern) {
     {
       tf_shared_lock l(mu_);
       if (regex_ != nullptr && regex_->pattern() == pattern) {
         return regex_;
       }
     }
-    // Construct the new RE2 object before acquiring the lock.
-    auto regex = std::make_shared<RE2>(pattern);
+    // Get the new RE2 object before acquiring the lock. The process-wide
+    // cache only compiles patterns that no kernel used recently.
+    std::shared_ptr<const RE2> regex = GetCachedRE2(pattern);
     {
       mutex_lock l(mu_);
       // Swap instead of assigning so that we destruct the old
@@ -76,7 +103,7 @@ class RegexFullMatchOp : public OpKernel {
   }
 
   mutex mu_;
-  std::shared_ptr<RE2> regex_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<const RE2> regex_ TF_GUARDED_BY(mu_);
 
   RegexFullMatchOp(const RegexFullMatchOp&) = delete;
   void operator=(const RegexFullMatchOp&) = delete;
@@ -104,10 +131,7 @@ class StaticRegexFullMatchOp : public OpKernel {
     Tensor* output_tensor = nullptr;
     OP_REQUIRES_OK(ctx, ctx->allocate_output("output", input_tensor->shape(),
                                              &output_tensor));
-    auto output_flat = output_tensor->flat<bool>();
-    for (size_t i = 0; i < input_flat.size(); ++i) {
-      output_flat(i) = RE2::FullMatch(input_flat(i), *re_);
-    }
+    FullMatch(ctx, *re_, input_flat, output_tensor->flat<bool>());
   }
 
  private:
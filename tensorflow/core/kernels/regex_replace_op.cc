@@ -13,15 +13,20 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include "re2/re2.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/regex_cache.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -48,17 +53,30 @@ absl::Status InternalCompute(const RE2& regex, const std::string& rewrite,
     output_tensor->flat<tstring>() = input_tensor->flat<tstring>();
   }
   auto output_flat = output_tensor->flat<tstring>();
-  for (size_t i = 0; i < output_flat.size(); ++i) {
-    // TODO(dero): Mitigate copy; Global and GlobalReplace below currently only
-    // accept std::string.
-    std::string buf = output_flat(i);
-    if (replace_global) {
-      RE2::GlobalReplace(&buf, regex, rewrite);
-    } else {
-      RE2::Replace(&buf, regex, rewrite);
+  auto replace = [&](int64_t start, int64_t limit) {
+    for (int64_t i = start; i < limit; ++i) {
+      // TODO(dero): Mitigate copy; Global and GlobalReplace below currently
+      // only accept std::string.
+      std::string buf = output_flat(i);
+      // Strings without a match are left as they are.
+      const bool replaced = replace_global
+                                ? RE2::GlobalReplace(&buf, regex, rewrite) > 0
+                                : RE2::Replace(&buf, regex, rewrite);
+      if (replaced) output_flat(i) = std::move(buf);
     }
-    output_flat(i) = std::move(buf);
+  };
+  const int64_t num_strings = output_flat.size();
+  int64_t total_size = 0;
+  for (int64_t i = 0; i < num_strings; ++i) {
+    total_size += output_flat(i).size();
   }
+  // Rough cost of matching and rewriting a string, per byte.
+  const int64_t kCostPerByte = 50;
+  const int64_t cost_per_string =
+      kCostPerByte * (total_size / std::max<int64_t>(num_strings, 1) + 1);
+  auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers, num_strings,
+        cost_per_string, replace);
   return absl::OkStatus();
 }
 }  // namespace
@@ -79,7 +97,7 @@ class RegexReplaceOp : public OpKernel {
                     absl::StrCat("Pattern must be scalar, but received ",
                                  pattern_tensor->shape().DebugString())));
     const std::string& pattern = pattern_tensor->scalar<tstring>()();
-    std::shared_ptr<RE2> regex = CachedRE2(pattern);
+    std::shared_ptr<const RE2> regex = CachedRE2(pattern);
     OP_REQUIRES(
         ctx, regex->ok(),
         absl::InvalidArgumentError(absl::StrCat("Invalid pattern: ", pattern,
@@ -96,15 +114,16 @@ class RegexReplaceOp : public OpKernel {
   }
 
  private:
-  std::shared_ptr<RE2> CachedRE2(const std::string& pattern) {
+  std::shared_ptr<const RE2> CachedRE2(const std::string& pattern) {
     {
       tf_shared_lock l(mu_);
       if (regex_ != nullptr && regex_->pattern() == pattern) {
         return regex_;
       }
     }
-    // Construct the new RE2 object before acquiring the lock.
-    auto regex = std::make_shared<RE2>(pattern);
+    // Get the new RE2 object before acquiring the lock. The process-wide
+    // cache only compiles patterns that no kernel used recently.
+    std::shared_ptr<const RE2> regex = GetCachedRE2(pattern);
     {
       mutex_lock l(mu_);
       // Swap instead of assigning so that we destruct the old
@@ -116,7 +135,7 @@ class RegexReplaceOp : public OpKernel {
 
   bool replace_global_;
   mutex mu_;
-  std::shared_ptr<RE2> regex_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<const RE2> regex_ TF_GUARDED_BY(mu_);
 
   RegexReplaceOp(const RegexReplaceOp&) = delete;
   void operator=(const RegexReplaceOp&) = delete;
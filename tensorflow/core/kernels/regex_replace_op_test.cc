@@ -102,7 +102,8 @@ BENCHMARK(BM_RegexReplace)
     ->Arg(32)
     ->Arg(64)
     ->Arg(128)
-    ->Arg(256);
+    ->Arg(256)
+    ->Arg(4096);
 
 Graph* SetupStaticGraph(const Tensor& input, const std::string& input_pattern,
                         const std::string& rewrite) {
@@ -133,6 +134,7 @@ BENCHMARK(BM_StaticRegexReplace)
     ->Arg(32)
     ->Arg(64)
     ->Arg(128)
-    ->Arg(256);
+    ->Arg(256)
+    ->Arg(4096);
 
 }  // end namespace tensorflow
@@ -56,6 +56,7 @@ class RestoreV2OpTest : public OpsTestBase {
                      .Input(FakeInput())    // tensor_names
                      .Input(FakeInput())    // shape_and_slices
                      .Attr("dtypes", {dt})  // dtypes
+                     .Attr("use_mmap", use_mmap_)
                      .Finalize(node_def()));
     TF_ASSERT_OK(InitOp());
   }
@@ -348,10 +349,16 @@ class RestoreV2OpTest : public OpsTestBase {
       }
     }
   }
+
+  bool use_mmap_ = false;
 };
 
 // The intended use case (write in V2, read in V2).
 TEST_F(RestoreV2OpTest, RestoreAfterSaveV2) { RunTest("SaveV2"); }
+TEST_F(RestoreV2OpTest, RestoreAfterSaveV2WithMmap) {
+  use_mmap_ = true;
+  RunTest("SaveV2");
+}
 // For backward compatibility.
 TEST_F(RestoreV2OpTest, RestoreAfterSaveSlicesV1) { RunTest("SaveSlices"); }
 TEST_F(RestoreV2OpTest, RestoreAfterSaveV1) { RunTest("Save"); }
@@ -286,8 +286,10 @@ struct RestoreOp {
   }
 
   // Run this restore operation using a new BundleReader.
-  void run_with_new_reader(BundleCache* cache) {
-    BundleReader reader(tsl::Env::Default(), reader_prefix, {cache, false});
+  void run_with_new_reader(BundleCache* cache, bool use_mmap) {
+    BundleReader reader(tsl::Env::Default(), reader_prefix,
+                        {cache, /*enable_multi_threading_for_testing=*/false,
+                         use_mmap});
     if (!reader.status().ok()) {
       status = reader.status();
       return;
@@ -305,10 +307,20 @@ struct RestoreOp {
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
     if (shape_and_slice.empty()) {
-      // Lookup the full tensor.
+      // Lookup the full tensor.  A tensor backed by the memory-mapped data
+      // file becomes the output as is, so only others need an output buffer.
+      Tensor mapped_tensor;
+      bool mapped = false;
       TF_RETURN_IF_ERROR(
-          context->allocate_output(idx, restored_full_shape, &restored_tensor));
-      TF_RETURN_IF_ERROR(reader->Lookup(tensor_name, restored_tensor));
+          reader->LookupMapped(tensor_name, &mapped_tensor, &mapped));
+      if (mapped) {
+        context->set_output(idx, std::move(mapped_tensor));
+        restored_tensor = context->mutable_output(idx);
+      } else {
+        TF_RETURN_IF_ERROR(context->allocate_output(idx, restored_full_shape,
+                                                    &restored_tensor));
+        TF_RETURN_IF_ERROR(reader->Lookup(tensor_name, restored_tensor));
+      }
     } else {
       // Lookup the slice.
       TensorShape parsed_full_shape;
@@ -367,7 +379,8 @@ struct RestoreOp {
 absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
                               const Tensor& tensor_names,
                               const Tensor& shape_and_slices,
-                              absl::Span<const DataType> dtypes) {
+                              absl::Span<const DataType> dtypes,
+                              bool use_mmap) {
   const std::string& prefix_string = prefix.scalar<tstring>()();
 
   const auto& tensor_names_flat = tensor_names.flat<tstring>();
@@ -382,7 +395,9 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
 
   tsl::Env* const env = tsl::Env::Default();
   BundleCache cache(env);
-  BundleReader default_reader(env, prefix_string, {&cache, false});
+  BundleReader default_reader(
+      env, prefix_string,
+      {&cache, /*enable_multi_threading_for_testing=*/false, use_mmap});
   TF_RETURN_IF_ERROR(default_reader.status());
 
   TF_RETURN_IF_ERROR(default_reader.SortForSequentialAccess<RestoreOp>(
@@ -429,12 +444,14 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
 
     // Schedule large ops first, followed by the small.
     for (auto* op : large_restore_ops) {
-      reader_pool->Schedule(
-          [op, &cache]() { op->run_with_new_reader(&cache); });
+      reader_pool->Schedule([op, &cache, use_mmap]() {
+        op->run_with_new_reader(&cache, use_mmap);
+      });
     }
     for (auto* op : small_restore_ops) {
-      reader_pool->Schedule(
-          [op, &cache]() { op->run_with_new_reader(&cache); });
+      reader_pool->Schedule([op, &cache, use_mmap]() {
+        op->run_with_new_reader(&cache, use_mmap);
+      });
     }
 
     // Wait for all scheduled work to finish and check the status of all
@@ -453,8 +470,9 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
       reader_pool.reset(
           new thread::ThreadPool(Env::Default(), "restore_tensors", 8));
       for (auto* op : large_restore_ops) {
-        reader_pool->Schedule(
-            [op, &cache]() { op->run_with_new_reader(&cache); });
+        reader_pool->Schedule([op, &cache, use_mmap]() {
+          op->run_with_new_reader(&cache, use_mmap);
+        });
       }
     }
 
@@ -59,6 +59,8 @@ void RestoreTensor(OpKernelContext* context,
 //
 // "context" is only used for allocating outputs.  In particular, the inputs are
 // explicitly provided and not accessed via the "input(i)" methods.
+// If "use_mmap" is true, the data files are read through memory-mapped
+// BundleReaders (see BundleReader::Options::use_mmap).
 // REQUIRES:
 //   * "prefix" has 1 element, DT_STRING.
 //   * "tensor_names" and "shape_and_slices" shaped {N}, both DT_STRING.
@@ -66,7 +68,8 @@ void RestoreTensor(OpKernelContext* context,
 absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
                               const Tensor& tensor_names,
                               const Tensor& shape_and_slices,
-                              absl::Span<const DataType> dtypes);
+                              absl::Span<const DataType> dtypes,
+                              bool use_mmap = false);
 
 }  // namespace tensorflow
 
@@ -16,10 +16,14 @@ limitations under the License.
 // See docs in ../ops/io_ops.cc.
 
 #include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -32,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"  // IWYU pragma: keep
+#include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
@@ -91,12 +96,100 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Looks up the CheckpointCallbackManager of the default container, creating
+// it if needed.  Sets "*manager" to nullptr if there is no resource manager.
+absl::Status LookupCheckpointCallbackManager(
+    OpKernelContext* context, checkpoint::CheckpointCallbackManager** manager) {
+  *manager = nullptr;
+  ResourceMgr* resource_manager = context->resource_manager();
+  if (resource_manager == nullptr) return absl::OkStatus();
+  return resource_manager
+      ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
+          resource_manager->default_container(),
+          std::string(checkpoint::kCheckpointCallbackManagerResourceName),
+          manager, [](checkpoint::CheckpointCallbackManager** out) {
+            *out = new checkpoint::CheckpointCallbackManager();
+            return absl::OkStatus();
+          });
+}
+
+// A tensor to save, with the full shape and slice it holds if it is a slice
+// of a partitioned tensor.
+struct SaveItem {
+  std::string name;
+  Tensor tensor;
+  std::optional<std::pair<TensorShape, TensorSlice>> shape_and_slice;
+};
+
+// Writes "items" as a tensor bundle under "prefix", compressing large tensors
+// if "compress" is true.
+absl::Status WriteBundle(const std::string& prefix,
+                         const std::vector<SaveItem>& items, bool compress) {
+  // Large checkpoints are written as several data files in parallel.
+  // Aligns tensor data so that restores can hand out memory-mapped tensors.
+  ShardedBundleWriter::Options writer_options;
+  writer_options.writer_options.data_alignment =
+      Allocator::kAllocatorAlignment;
+  writer_options.writer_options.compress = compress;
+  ShardedBundleWriter writer(Env::Default(), prefix, writer_options);
+  TF_RETURN_IF_ERROR(writer.status());
+  VLOG(1) << "ShardedBundleWriter, prefix_string: " << prefix;
+
+  for (const SaveItem& item : items) {
+    const Tensor& tensor = item.tensor;
+    VLOG(2) << "Starting save of " << item.name;
+    if (item.shape_and_slice.has_value()) {
+      TF_RETURN_IF_ERROR(writer.AddSlice(item.name,
+                                         item.shape_and_slice->first,
+                                         item.shape_and_slice->second, tensor));
+    } else {
+      TF_RETURN_IF_ERROR(writer.Add(item.name, tensor));
+    }
+
+    if (VLOG_IS_ON(5)) {
+      if (tensor.dtype() == DT_FLOAT) {
+        const float* t_data = tensor.flat<float>().data();
+        float min = std::numeric_limits<float>::infinity();
+        float max = -std::numeric_limits<float>::infinity();
+        double avg = 0.0;
+        for (int i = 0; i < tensor.NumElements(); ++i) {
+          if (t_data[i] < min) min = t_data[i];
+          if (t_data[i] > max) max = t_data[i];
+          avg += t_data[i];
+        }
+        VLOG(5) << " min " << min << " max " << max << " avg "
+                << avg / tensor.NumElements() << " total elts "
+                << tensor.NumElements();
+      }
+    }
+
+    VLOG(2) << "Done save of " << item.name;
+  }
+  TF_RETURN_IF_ERROR(writer.Finish());
+  VLOG(1) << "Done ShardedBundleWriter, prefix_string: " << prefix;
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
 class SaveV2 : public OpKernel {
  public:
-  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {
+    std::string compression;
+    OP_REQUIRES_OK(context, context->GetAttr("compression", &compression));
+    // Compressed checkpoints are smaller, which speeds up saves and restores
+    // on network storage, but older releases cannot read them.
+    OP_REQUIRES(context, compression.empty() || compression == "zstd",
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Unsupported checkpoint compression \"", compression,
+                    "\", expected \"\" or \"zstd\".")));
+    compress_ = compression == "zstd";
+    if (context->HasAttr("background_write")) {
+      OP_REQUIRES_OK(context,
+                     context->GetAttr("background_write", &background_write_));
+    }
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& prefix = context->input(0);
@@ -112,14 +205,12 @@ class SaveV2 : public OpKernel {
     const auto& tensor_names_flat = tensor_names.flat<tstring>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
 
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
+    std::vector<SaveItem> items(num_tensors);
     for (int i = 0; i < num_tensors; ++i) {
-      const std::string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
+      SaveItem& item = items[i];
+      item.name = tensor_names_flat(i);
+      item.tensor = context->input(i + kFixedInputs);
+      const Tensor& tensor = item.tensor;
 
       if (!shape_and_slices_flat(i).empty()) {
         const std::string& shape_spec = shape_and_slices_flat(i);
@@ -136,54 +227,54 @@ class SaveV2 : public OpKernel {
                 "specification does not match the "
                 "shape of the tensor to  save: ",
                 shape_spec, ", tensor: ", tensor.shape().DebugString())));
-
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
-      } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
+        item.shape_and_slice.emplace(shape, slice);
       }
+    }
 
-      if (VLOG_IS_ON(5)) {
-        if (tensor.dtype() == DT_FLOAT) {
-          const float* t_data = tensor.flat<float>().data();
-          float min = std::numeric_limits<float>::infinity();
-          float max = -std::numeric_limits<float>::infinity();
-          double avg = 0.0;
-          for (int i = 0; i < tensor.NumElements(); ++i) {
-            if (t_data[i] < min) min = t_data[i];
-            if (t_data[i] > max) max = t_data[i];
-            avg += t_data[i];
-          }
-          VLOG(5) << " min " << min << " max " << max << " avg "
-                  << avg / tensor.NumElements() << " total elts "
-                  << tensor.NumElements();
-        }
-      }
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
+    OP_REQUIRES_OK(context, LookupCheckpointCallbackManager(
+                                context, &checkpoint_callback_manager));
+    core::ScopedUnref unref_manager(checkpoint_callback_manager);
 
-      VLOG(2) << "Done save of " << tensor_name;
+    if (background_write_ && checkpoint_callback_manager != nullptr &&
+        !checkpoint_callback_manager->IsAsyncSaveEnabled()) {
+      checkpoint_callback_manager->EnableAsyncSave();
     }
-    OP_REQUIRES_OK(context, writer.Finish());
-    VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
-
-    ResourceMgr* resource_manager = context->resource_manager();
-    if (resource_manager != nullptr) {
-      checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
-      OP_REQUIRES_OK(
-          context,
-          resource_manager
-              ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
-                  resource_manager->default_container(),
-                  std::string(
-                      checkpoint::kCheckpointCallbackManagerResourceName),
-                  &checkpoint_callback_manager,
-                  [](checkpoint::CheckpointCallbackManager** out) {
-                    *out = new checkpoint::CheckpointCallbackManager();
-                    return absl::OkStatus();
-                  }));
+    if (checkpoint_callback_manager != nullptr &&
+        checkpoint_callback_manager->IsAsyncSaveEnabled()) {
+      int64_t bytes = 0;
+      for (const SaveItem& item : items) bytes += item.tensor.TotalBytes();
+      OP_REQUIRES_OK(context,
+                     checkpoint_callback_manager->ReserveAsyncSave(bytes));
+      // The background write holds references to the input buffers instead
+      // of copies.  Resource variables copy a buffer that is still referenced
+      // before updating it, so later steps leave these intact.  Reference
+      // variables (VariableV2) are updated in place, and must not be saved
+      // asynchronously.  The manager keeps itself alive until the write has
+      // finished.
+      checkpoint_callback_manager->ScheduleAsyncSave(
+          prefix_string, bytes,
+          [checkpoint_callback_manager, prefix_string, compress = compress_,
+           items = std::move(items)]() {
+            TF_RETURN_IF_ERROR(WriteBundle(prefix_string, items, compress));
+            checkpoint_callback_manager->Save(prefix_string);
+            return absl::OkStatus();
+          });
+      return;
+    }
+
+    OP_REQUIRES_OK(context, WriteBundle(prefix_string, items, compress_));
+    if (checkpoint_callback_manager != nullptr) {
       checkpoint_callback_manager->Save(prefix_string);
-      checkpoint_callback_manager->Unref();
     }
   }
+
+ private:
+  // Whether large tensors are compressed with zstd.
+  bool compress_;
+  // Whether the checkpoint is written in the background, after Compute()
+  // returns.
+  bool background_write_ = false;
 };
 REGISTER_KERNEL_BUILDER(Name("SaveV2").Device(DEVICE_CPU), SaveV2);
 
@@ -192,6 +283,7 @@ class RestoreV2 : public OpKernel {
  public:
   explicit RestoreV2(OpKernelConstruction* context) : OpKernel(context) {
     OP_REQUIRES_OK(context, context->GetAttr("dtypes", &dtypes_));
+    OP_REQUIRES_OK(context, context->GetAttr("use_mmap", &use_mmap_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -208,6 +300,17 @@ class RestoreV2 : public OpKernel {
 
     const std::string& prefix_string = prefix.scalar<tstring>()();
 
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
+    OP_REQUIRES_OK(context, LookupCheckpointCallbackManager(
+                                context, &checkpoint_callback_manager));
+    core::ScopedUnref unref_manager(checkpoint_callback_manager);
+    // Makes sure that asynchronous saves of the checkpoint have finished.
+    if (checkpoint_callback_manager != nullptr &&
+        checkpoint_callback_manager->IsAsyncSaveEnabled()) {
+      OP_REQUIRES_OK(context,
+                     checkpoint_callback_manager->WaitForAsyncSaves());
+    }
+
     VLOG(2) << "Started Restore at prefix: " << prefix_string;
     // Intention: we plan to use the RestoreV2 op as a backward-compatible
     // reader as we upgrade to the V2 format.  This allows transparent upgrade.
@@ -231,26 +334,12 @@ class RestoreV2 : public OpKernel {
       return;
     }
     // If found, invokes the V2 reader.
-    OP_REQUIRES_OK(context, RestoreTensorsV2(context, prefix, tensor_names,
-                                             shape_and_slices, dtypes_));
-
-    ResourceMgr* resource_manager = context->resource_manager();
-    if (resource_manager != nullptr) {
-      checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
-      OP_REQUIRES_OK(
-          context,
-          resource_manager
-              ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
-                  resource_manager->default_container(),
-                  std::string(
-                      checkpoint::kCheckpointCallbackManagerResourceName),
-                  &checkpoint_callback_manager,
-                  [](checkpoint::CheckpointCallbackManager** out) {
-                    *out = new checkpoint::CheckpointCallbackManager();
-                    return absl::OkStatus();
-                  }));
+    OP_REQUIRES_OK(context,
+                   RestoreTensorsV2(context, prefix, tensor_names,
+                                    shape_and_slices, dtypes_, use_mmap_));
+
+    if (checkpoint_callback_manager != nullptr) {
       checkpoint_callback_manager->Restore(prefix_string);
-      checkpoint_callback_manager->Unref();
     }
     VLOG(2) << "Finished Restore at prefix: " << prefix_string;
   }
@@ -258,6 +347,8 @@ class RestoreV2 : public OpKernel {
  private:
   // Expected dtypes of the to-restore tensors.
   std::vector<DataType> dtypes_;
+  // Whether the data files are memory-mapped.
+  bool use_mmap_;
 };
 REGISTER_KERNEL_BUILDER(Name("RestoreV2").Device(DEVICE_CPU), RestoreV2);
 
@@ -287,13 +378,43 @@ class MergeV2Checkpoints : public OpKernel {
 
     const absl::Span<const tstring> input_prefixes =
         absl::Span<const tstring>(checkpoint_prefixes.flat<tstring>());
-    Env* env = Env::Default();
     const std::string& merged_prefix = destination_prefix.scalar<tstring>()();
-    OP_REQUIRES_OK(context,
-                   tensorflow::MergeBundles(env, input_prefixes, merged_prefix,
-                                            allow_missing_files_));
 
-    if (delete_old_dirs_) {
+    // Asynchronous saves write the inputs later, so the merge follows them.
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
+    OP_REQUIRES_OK(context, LookupCheckpointCallbackManager(
+                                context, &checkpoint_callback_manager));
+    core::ScopedUnref unref_manager(checkpoint_callback_manager);
+    if (checkpoint_callback_manager != nullptr &&
+        checkpoint_callback_manager->IsAsyncSaveEnabled()) {
+      OP_REQUIRES_OK(context, checkpoint_callback_manager->ReserveAsyncSave(
+                                  /*bytes=*/0));
+      checkpoint_callback_manager->ScheduleAsyncSave(
+          merged_prefix, /*bytes=*/0,
+          [input_prefixes = std::vector<tstring>(input_prefixes.begin(),
+                                                 input_prefixes.end()),
+           merged_prefix, delete_old_dirs = delete_old_dirs_,
+           allow_missing_files = allow_missing_files_]() {
+            return Merge(input_prefixes, merged_prefix, delete_old_dirs,
+                         allow_missing_files);
+          });
+      return;
+    }
+
+    OP_REQUIRES_OK(context, Merge(input_prefixes, merged_prefix,
+                                  delete_old_dirs_, allow_missing_files_));
+  }
+
+ private:
+  static absl::Status Merge(absl::Span<const tstring> input_prefixes,
+                            const std::string& merged_prefix,
+                            bool delete_old_dirs, bool allow_missing_files) {
+    Env* env = Env::Default();
+    TF_RETURN_IF_ERROR(tensorflow::MergeBundles(env, input_prefixes,
+                                                merged_prefix,
+                                                allow_missing_files));
+
+    if (delete_old_dirs) {
       const std::string merged_dir(io::Dirname(merged_prefix));
       for (const std::string& input_prefix : input_prefixes) {
         const std::string dirname(io::Dirname(input_prefix));
@@ -304,9 +425,9 @@ class MergeV2Checkpoints : public OpKernel {
         if (!status.ok()) VLOG(1) << status;
       }
     }
+    return absl::OkStatus();
   }
 
- private:
   // On merge, whether or not to delete the input (temporary) directories.
   bool delete_old_dirs_;
 
@@ -317,4 +438,26 @@ class MergeV2Checkpoints : public OpKernel {
 REGISTER_KERNEL_BUILDER(Name("MergeV2Checkpoints").Device(DEVICE_CPU),
                         MergeV2Checkpoints);
 
+// Waits for the checkpoints that SaveV2 and MergeV2Checkpoints write in the
+// background on this device, and reports their errors.
+class WaitForCheckpointWrites : public OpKernel {
+ public:
+  explicit WaitForCheckpointWrites(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
+    OP_REQUIRES_OK(context, LookupCheckpointCallbackManager(
+                                context, &checkpoint_callback_manager));
+    core::ScopedUnref unref_manager(checkpoint_callback_manager);
+    if (checkpoint_callback_manager != nullptr &&
+        checkpoint_callback_manager->IsAsyncSaveEnabled()) {
+      OP_REQUIRES_OK(context,
+                     checkpoint_callback_manager->WaitForAsyncSaves());
+    }
+  }
+};
+REGISTER_KERNEL_BUILDER(Name("WaitForCheckpointWrites").Device(DEVICE_CPU),
+                        WaitForCheckpointWrites);
+
 }  // namespace tensorflow
@@ -14,19 +14,28 @@ limitations under the License.
 ==============================================================================*/
 
 #include <complex>
+#include <cstdint>
 #include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/checkpoint_callback_manager.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
@@ -340,5 +349,168 @@ TEST_F(SaveV2OpTest, Simple) {
   }
 }
 
+TEST_F(SaveV2OpTest, Async) {
+  const std::string prefix = io::JoinPath(testing::TmpDir(), "tensor_async");
+  TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                   .Input(FakeInput())  // prefix
+                   .Input(FakeInput())  // tensor_names
+                   .Input(FakeInput())  // shape_and_slices
+                   .Input(FakeInput({DT_FLOAT}))  // tensors
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+
+  auto* manager = new checkpoint::CheckpointCallbackManager();
+  manager->EnableAsyncSave();
+  std::vector<std::string> done_prefixes;
+  manager->RegisterAsyncSaveDoneCallback(
+      [&done_prefixes](absl::string_view prefix, const absl::Status& status) {
+        TF_EXPECT_OK(status);
+        done_prefixes.emplace_back(prefix);
+      });
+  ResourceMgr* resource_manager = device_->resource_manager();
+  TF_ASSERT_OK(resource_manager->Create(
+      resource_manager->default_container(),
+      std::string(checkpoint::kCheckpointCallbackManagerResourceName),
+      manager));
+  // Holds the background thread until the saved tensor has been updated.
+  Notification updated;
+  TF_ASSERT_OK(manager->ReserveAsyncSave(0));
+  manager->ScheduleAsyncSave("blocker", 0, [&updated]() {
+    updated.WaitForNotification();
+    return absl::OkStatus();
+  });
+
+  AddInput<tstring>(TensorShape({}),
+                    [&prefix](int x) -> tstring { return prefix; });
+  AddInput<tstring>(TensorShape({1}),
+                    [](int x) -> tstring { return "tensor_float"; });
+  AddInput<tstring>(TensorShape({1}), [](int x) -> tstring { return ""; });
+  AddInput<float>(TensorShape({2, 4}),
+                  [](int x) -> float { return static_cast<float>(x) / 10; });
+  TF_ASSERT_OK(RunOpKernel());
+  // The pending write references the saved tensor rather than a copy.  Like
+  // a resource variable update, replaces the shared buffer instead of
+  // overwriting it.
+  Tensor* saved = mutable_input(3).tensor;
+  EXPECT_FALSE(saved->RefCountIsOne());
+  Tensor new_value(DT_FLOAT, saved->shape());
+  new_value.flat<float>().setConstant(-1);
+  *saved = new_value;
+  updated.Notify();
+
+  TF_ASSERT_OK(manager->WaitForAsyncSaves());
+  EXPECT_THAT(done_prefixes, ::testing::ElementsAre("blocker", prefix));
+  BundleReader reader(Env::Default(), prefix);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("tensor_float", &val));
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(static_cast<float>(i) / 10, val.flat<float>()(i));
+  }
+}
+
+TEST_F(SaveV2OpTest, BackgroundWrite) {
+  const std::string prefix =
+      io::JoinPath(testing::TmpDir(), "tensor_background");
+  TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                   .Input(FakeInput())  // prefix
+                   .Input(FakeInput())  // tensor_names
+                   .Input(FakeInput())  // shape_and_slices
+                   .Input(FakeInput({DT_FLOAT}))  // tensors
+                   .Attr("background_write", true)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInput<tstring>(TensorShape({}),
+                    [&prefix](int x) -> tstring { return prefix; });
+  AddInput<tstring>(TensorShape({1}),
+                    [](int x) -> tstring { return "tensor_float"; });
+  AddInput<tstring>(TensorShape({1}), [](int x) -> tstring { return ""; });
+  AddInput<float>(TensorShape({2, 4}),
+                  [](int x) -> float { return static_cast<float>(x) / 10; });
+  TF_ASSERT_OK(RunOpKernel());
+
+  ResourceMgr* resource_manager = device_->resource_manager();
+  checkpoint::CheckpointCallbackManager* manager;
+  TF_ASSERT_OK(resource_manager->Lookup(
+      resource_manager->default_container(),
+      std::string(checkpoint::kCheckpointCallbackManagerResourceName),
+      &manager));
+  EXPECT_TRUE(manager->IsAsyncSaveEnabled());
+  manager->Unref();
+
+  TF_ASSERT_OK(NodeDefBuilder("wait", "WaitForCheckpointWrites")
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  inputs_.clear();
+  TF_ASSERT_OK(RunOpKernel());
+  BundleReader reader(Env::Default(), prefix);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("tensor_float", &val));
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(static_cast<float>(i) / 10, val.flat<float>()(i));
+  }
+}
+
+// Returns the total size of the data files of the bundle at "prefix".
+uint64_t DataFilesSize(const std::string& prefix) {
+  std::vector<std::string> paths;
+  TF_CHECK_OK(Env::Default()->GetMatchingPaths(prefix + ".data-*", &paths));
+  uint64_t total = 0;
+  for (const std::string& path : paths) {
+    uint64_t size;
+    TF_CHECK_OK(Env::Default()->GetFileSize(path, &size));
+    total += size;
+  }
+  return total;
+}
+
+TEST_F(SaveV2OpTest, Compression) {
+  uint64_t sizes[2];
+  for (const bool compress : {false, true}) {
+    const std::string prefix = io::JoinPath(
+        testing::TmpDir(), compress ? "tensor_zstd" : "tensor_uncompressed");
+    TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                     .Input(FakeInput())  // prefix
+                     .Input(FakeInput())  // tensor_names
+                     .Input(FakeInput())  // shape_and_slices
+                     .Input(FakeInput({DT_FLOAT}))  // tensors
+                     .Attr("compression", compress ? "zstd" : "")
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    inputs_.clear();
+    AddInput<tstring>(TensorShape({}),
+                      [&prefix](int x) -> tstring { return prefix; });
+    AddInput<tstring>(TensorShape({1}),
+                      [](int x) -> tstring { return "tensor_float"; });
+    AddInput<tstring>(TensorShape({1}), [](int x) -> tstring { return ""; });
+    // Large enough to be compressed.
+    AddInput<float>(TensorShape({64, 1024}),
+                    [](int x) -> float { return x % 16; });
+    TF_ASSERT_OK(RunOpKernel());
+
+    BundleReader reader(Env::Default(), prefix);
+    TF_ASSERT_OK(reader.status());
+    Tensor val;
+    TF_ASSERT_OK(reader.Lookup("tensor_float", &val));
+    for (int i = 0; i < val.NumElements(); ++i) {
+      ASSERT_EQ(i % 16, val.flat<float>()(i));
+    }
+    sizes[compress] = DataFilesSize(prefix);
+  }
+  EXPECT_LT(sizes[true], sizes[false] / 4);
+}
+
+TEST_F(SaveV2OpTest, UnsupportedCompression) {
+  TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                   .Input(FakeInput())  // prefix
+                   .Input(FakeInput())  // tensor_names
+                   .Input(FakeInput())  // shape_and_slices
+                   .Input(FakeInput({DT_FLOAT}))  // tensors
+                   .Attr("compression", "gzip")
+                   .Finalize(node_def()));
+  EXPECT_EQ(InitOp().code(), absl::StatusCode::kInvalidArgument);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -16,7 +16,10 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_SCATTER_FUNCTOR_H_
 #define TENSORFLOW_CORE_KERNELS_SCATTER_FUNCTOR_H_
 
+#include <algorithm>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 
 #include "Eigen/Core"  // from @eigen_archive
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
@@ -123,6 +126,56 @@ struct Assign<scatter_op::UpdateOp::MAX> {
   }
 };
 
+// Scatters are parallelized over this many ranges of rows per thread, so that
+// ranges that receive more updates than others are balanced over the threads.
+constexpr int kScatterRowRangesPerThread = 4;
+
+// Groups the updates of a scatter by ranges of their destination rows.
+//
+// The ranges can be updated in parallel, each by a single thread, while the
+// updates to every row are applied in the order of the updates. The results
+// are then the same as those of a serial scatter, even with duplicate
+// indices, which keeps the scatter deterministic without locks or atomics.
+template <typename Index>
+class UpdatesByRowRange {
+ public:
+  // `rows[i]` is the row of update i, in [0, num_rows), or negative if update
+  // i is skipped. The rows are split in at most `max_ranges` ranges.
+  UpdatesByRowRange(const std::vector<Index>& rows, Index num_rows,
+                    Index max_ranges) {
+    const Index num_ranges =
+        std::max<Index>(1, std::min<Index>(num_rows, max_ranges));
+    rows_per_range_ =
+        std::max<Index>(1, (num_rows + num_ranges - 1) / num_ranges);
+    // A counting sort of the updates by range, which keeps their order.
+    offsets_.assign((num_rows + rows_per_range_ - 1) / rows_per_range_ + 1, 0);
+    for (const Index row : rows) {
+      if (row >= 0) ++offsets_[row / rows_per_range_ + 1];
+    }
+    std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+    updates_.resize(offsets_.back());
+    std::vector<Index> next(offsets_.begin(), offsets_.end() - 1);
+    for (Index i = 0; i < static_cast<Index>(rows.size()); ++i) {
+      if (rows[i] >= 0) updates_[next[rows[i] / rows_per_range_]++] = i;
+    }
+  }
+
+  Index num_ranges() const { return offsets_.size() - 1; }
+  Index num_updates() const { return updates_.size(); }
+
+  // The updates to the rows of range `range`, in increasing order.
+  const Index* begin(Index range) const {
+    return updates_.data() + offsets_[range];
+  }
+  const Index* end(Index range) const {
+    return updates_.data() + offsets_[range + 1];
+  }
+
+ private:
+  Index rows_per_range_;
+  std::vector<Index> offsets_;
+  std::vector<Index> updates_;
+};
 
 }  // namespace internal
 }  // namespace scatter_op
@@ -144,39 +197,43 @@ struct ScatterFunctorBase {
                         typename TTypes<Index>::ConstFlat indices) {
     const Index N = static_cast<Index>(indices.size());
     const Index limit = static_cast<Index>(params.dimension(0));
-    const Index kMaxLocks = 1024;
-    const Index entries_per_lock = (limit + kMaxLocks - 1) / kMaxLocks;
-    // To reduce the number of locks and the memory usage, we divide the whole
-    // index space into kMaxLocks regions with each lock serializing access to
-    // a region.
-    mutex accessed[kMaxLocks];
-    std::atomic<Index> bad_index(-1);
-    auto ParallelScatter = [&](Index start, Index end) {
-      for (Index i = start; i < end; ++i) {
-        // Grab the index and check its validity.  Do this carefully,
-        // to avoid checking the value and grabbing it again from
-        // memory a second time (a security risk since it may change in
-        // between).
-        const Index index = ::tensorflow::internal::SubtleMustCopy(indices(i));
-        if (!FastBoundsCheck(index, limit)) {
-          bad_index = i;
-          return;
-        }
-        const Index lock_id = index / entries_per_lock;
-        // Copy last Ndim-1 dimensions of updates[i] to params[index]
-        {
-          mutex_lock l(accessed[lock_id]);
-          scatter_op::internal::Assign<op>::Run(params.template chip<0>(index),
-                                                updates.template chip<0>(i));
+    // Grab the indices and check their validity.  Do this carefully, to avoid
+    // checking the values and grabbing them again from memory a second time
+    // (a security risk since they may change in between).  As in
+    // SerialExecute, the updates before the first bad index are applied.
+    std::vector<Index> rows(N);
+    Index bad_index = -1;
+    for (Index i = 0; i < N; ++i) {
+      rows[i] = ::tensorflow::internal::SubtleMustCopy(indices(i));
+      if (!FastBoundsCheck(rows[i], limit)) {
+        bad_index = i;
+        rows.resize(i);
+        break;
+      }
+    }
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *(c->device()->tensorflow_cpu_worker_threads());
+    // Each range of rows is updated by a single thread, in the order of the
+    // updates, so duplicate indices need no locks.
+    const scatter_op::internal::UpdatesByRowRange<Index> ranges(
+        rows, limit,
+        scatter_op::internal::kScatterRowRangesPerThread *
+            worker_threads.num_threads);
+    auto ParallelScatter = [&](int64_t start, int64_t end) {
+      for (Index range = start; range < end; ++range) {
+        for (const Index* i = ranges.begin(range); i != ranges.end(range);
+             ++i) {
+          // Copy last Ndim-1 dimensions of updates[i] to params[index]
+          scatter_op::internal::Assign<op>::Run(
+              params.template chip<0>(rows[*i]), updates.template chip<0>(*i));
         }
       }
     };
     const float kMovingCost = 2.5f;
-    float shard_cost = kMovingCost * params.dimension(1);
-    const DeviceBase::CpuWorkerThreads& worker_threads =
-        *(c->device()->tensorflow_cpu_worker_threads());
-    Shard(worker_threads.num_threads, worker_threads.workers, N, shard_cost,
-          ParallelScatter);  // TODO: Come up with a good cost estimate.
+    const float shard_cost = kMovingCost * params.dimension(1) *
+                             ranges.num_updates() / ranges.num_ranges();
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          ranges.num_ranges(), shard_cost, ParallelScatter);
     return bad_index;
   }
   Index SerialExecute(OpKernelContext* c, const Device& d,
@@ -203,32 +260,23 @@ struct ScatterFunctorBase {
                    typename TTypes<T>::Matrix params,
                    typename TTypes<T>::ConstMatrix updates,
                    typename TTypes<Index>::ConstFlat indices) {
-#ifdef PLATFORM_GOOGLE
-    // The parallel version is significantly slower internally. Only call the
-    // serial version for now.
-    // TODO(penporn): Avoid locking in parallelization (sort beforehand).
-    return SerialExecute(c, d, params, updates, indices);
-#else
     // indices and params sizes were validated in DoCompute().
     const Index N = static_cast<Index>(indices.size());
     const Index limit = static_cast<Index>(params.dimension(0));
     const Index min_n_threshold = 1024;
-    const Index ser_par_ratio = 10000;
-    // For parallelizing the updates, duplicate entries need to be handled
-    // correctly. Multiple updates to the same index has to be serialized.
-    // This can lead to lock contention which may nullify the benefits of
-    // parallelization. Assuming uniform random distribution of the indices, we
-    // come up with a rough heuristic and determine whether the updates execute
-    // serially or parallelly. Also if 'N' is small, overheads of parallel
-    // execution outweigh its benefits and hence we check the value of N.
-    const bool execute_serial = N < min_n_threshold ||
-                                (N / limit) > ser_par_ratio ||
-                                OpDeterminismRequired();
+    // The parallel version applies the updates to each row in the same order
+    // as the serial version, so it is deterministic and can be used when
+    // OpDeterminismRequired(). It runs one thread per range of rows, so it
+    // only helps when there are several rows to update. Also if 'N' is small,
+    // overheads of parallel execution outweigh its benefits and hence we
+    // check the value of N.
+    const bool execute_serial =
+        N < min_n_threshold || limit < 2 ||
+        c->device()->tensorflow_cpu_worker_threads()->num_threads < 2;
     if (execute_serial)
       return SerialExecute(c, d, params, updates, indices);
     else
       return ParallelExecute(c, d, params, updates, indices);
-#endif  // PLATFORM_GOOGLE
   }
 };
 
@@ -20,7 +20,9 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <atomic>
+#include <vector>
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 
@@ -30,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/kernels/scatter_functor.h"
 #include "tensorflow/core/kernels/scatter_nd_op.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
@@ -127,6 +130,14 @@ struct ScatterNdFunctor<CPUDevice, T, Index, OP, IXDIM> {
           batch_strides[dim + 1] * output_shape_prefix[dim + 1];
     }
 
+    // Updates are applied in parallel to ranges of rows when there are enough
+    // of them, see ParallelExecute.
+    if (batch_size >= kMinParallelUpdates && d.numThreads() > 1 &&
+        Toutput.dimension(0) > 1) {
+      return ParallelExecute(d, batch_strides, output_shape_prefix, Tindices,
+                             Tupdates, Toutput);
+    }
+
     for (Eigen::DenseIndex loc = 0; loc < batch_size; ++loc) {
       Index i = 0;
       bool out_of_bounds = false;
@@ -153,6 +164,66 @@ struct ScatterNdFunctor<CPUDevice, T, Index, OP, IXDIM> {
 
     return error_loc;
   }
+
+ private:
+  static constexpr Eigen::DenseIndex kMinParallelUpdates = 1024;
+
+  // Groups the updates by ranges of output rows, and updates each range on a
+  // single thread in the order of the updates. The results are the same as
+  // those of the serial loop, including with duplicate indices.
+  static Index ParallelExecute(
+      const CPUDevice& d, const Index* batch_strides,
+      const Eigen::array<Eigen::DenseIndex, IXDIM>& output_shape_prefix,
+      typename TTypes<Index, 2>::ConstTensor Tindices,
+      typename TTypes<T, 2>::ConstTensor Tupdates,
+      typename TTypes<T, 2>::Tensor Toutput) {
+    Index error_loc = -1;
+    const Eigen::DenseIndex batch_size = Tindices.dimension(0);
+    std::vector<Index> rows(batch_size);
+    for (Eigen::DenseIndex loc = 0; loc < batch_size; ++loc) {
+      Index i = 0;
+      bool out_of_bounds = false;
+      for (int dim = 0; dim < IXDIM; ++dim) {
+        const Index ix_d = internal::SubtleMustCopy(Tindices(loc, dim));
+        out_of_bounds |= !FastBoundsCheck(ix_d, output_shape_prefix[dim]);
+        i += ix_d * batch_strides[dim];
+      }
+      if (TF_PREDICT_FALSE(out_of_bounds)) {
+        error_loc = loc;
+        rows[loc] = -1;
+      } else {
+        rows[loc] = i;
+      }
+    }
+
+    const scatter_op::internal::UpdatesByRowRange<Index> ranges(
+        rows, Toutput.dimension(0),
+        scatter_op::internal::kScatterRowRangesPerThread * d.numThreads());
+    const Eigen::DenseIndex slice_size = Toutput.dimension(1);
+    const double updates_per_range =
+        static_cast<double>(ranges.num_updates()) / ranges.num_ranges();
+    const Eigen::TensorOpCost cost(
+        2 * updates_per_range * slice_size * sizeof(T),
+        updates_per_range * slice_size * sizeof(T),
+        updates_per_range * slice_size);
+    auto update_ranges = [&](Eigen::Index first, Eigen::Index last) {
+      const Eigen::DefaultDevice device;
+      for (Index range = first; range < last; ++range) {
+        for (const Index* loc = ranges.begin(range); loc != ranges.end(range);
+             ++loc) {
+          auto input_chip = Toutput.template chip<0>(rows[*loc]);
+          auto output_chip = input_chip;
+          auto update_chip = Tupdates.template chip<0>(*loc);
+          update_executor::UpdateExecutor<
+              Eigen::DefaultDevice, decltype(input_chip),
+              decltype(update_chip), decltype(output_chip),
+              OP>::Execute(device, input_chip, update_chip, output_chip);
+        }
+      }
+    };
+    d.parallelFor(ranges.num_ranges(), cost, update_ranges);
+    return error_loc;
+  }
 };
 
 #define REGISTER_SCATTER_ND_FULL(T, Index, op)                               \
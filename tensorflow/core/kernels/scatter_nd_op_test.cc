@@ -522,6 +522,39 @@ TEST_F(ScatterNdOpTest, Simple_OneD) {
   test::ExpectTensorEqual<float>(expected, *GetOutput(0));
 }
 
+TEST_F(ScatterNdOpTest, ManyDuplicateIndices) {
+  MakeOp(DT_FLOAT, DT_INT32);
+
+  // Enough updates to be applied in parallel, most of them to a few rows.
+  const int kRows = 100;
+  const int kCols = 8;
+  const int kNumUpdates = 20000;
+  random::PhiloxRandom philox(1, 1);
+  random::SimplePhilox rnd(&philox);
+  std::vector<int32_t> indices(kNumUpdates);
+  for (int32_t& index : indices) {
+    index = rnd.OneIn(2) ? rnd.Uniform(3) : rnd.Uniform(kRows);
+  }
+  std::vector<float> updates(kNumUpdates * kCols);
+  for (float& update : updates) update = rnd.RandFloat();
+  AddInputFromArray<int32_t>(TensorShape({kNumUpdates, 1}), indices);
+  AddInputFromArray<float>(TensorShape({kNumUpdates, kCols}), updates);
+  AddInputFromArray<int32_t>(TensorShape({2}), {kRows, kCols});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // The updates to each row are added in order, so the sums are exactly
+  // those of a serial loop.
+  std::vector<float> sums(kRows * kCols, 0);
+  for (int i = 0; i < kNumUpdates; ++i) {
+    for (int j = 0; j < kCols; ++j) {
+      sums[indices[i] * kCols + j] += updates[i * kCols + j];
+    }
+  }
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({kRows, kCols}));
+  test::FillValues<float>(&expected, sums);
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
 TEST_F(ScatterNdOpTest, Error_IndexOutOfRange) {
   MakeOp(DT_FLOAT, DT_INT32);
 
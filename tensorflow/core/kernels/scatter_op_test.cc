@@ -217,6 +217,39 @@ TEST_F(ScatterSubOpTest, StressIndexTest) {
   test::ExpectTensorEqual<int32_t>(expected, params_tensor);
 }
 
+TEST_F(ScatterSubOpTest, ManyDuplicateIndices) {
+  MakeOp(DT_FLOAT_REF, DT_INT32);
+  // Enough updates to be applied in parallel, most of them to a few rows.
+  const int kRows = 100;
+  const int kCols = 8;
+  const int kNumUpdates = 20000;
+  random::PhiloxRandom philox(1, 1);
+  random::SimplePhilox rnd(&philox);
+  std::vector<float> values(kRows * kCols);
+  for (float& value : values) value = rnd.RandFloat();
+  std::vector<int32_t> indices(kNumUpdates);
+  for (int32_t& index : indices) {
+    index = rnd.OneIn(2) ? rnd.Uniform(3) : rnd.Uniform(kRows);
+  }
+  std::vector<float> updates(kNumUpdates * kCols);
+  for (float& update : updates) update = rnd.RandFloat();
+  AddInputFromArray<float>(TensorShape({kRows, kCols}), values);
+  AddInputFromArray<int32_t>(TensorShape({kNumUpdates}), indices);
+  AddInputFromArray<float>(TensorShape({kNumUpdates, kCols}), updates);
+  TF_ASSERT_OK(RunOpKernel());
+
+  // The updates to each row are applied in order, so the results are exactly
+  // those of a serial loop.
+  for (int i = 0; i < kNumUpdates; ++i) {
+    for (int j = 0; j < kCols; ++j) {
+      values[indices[i] * kCols + j] -= updates[i * kCols + j];
+    }
+  }
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({kRows, kCols}));
+  test::FillValues<float>(&expected, values);
+  test::ExpectTensorEqual<float>(expected, *mutable_input(0).tensor);
+}
+
 TEST_F(ScatterUpdateOpTest, Error_WrongDimsIndices) {
   MakeOp(DT_FLOAT_REF, DT_INT32);
 
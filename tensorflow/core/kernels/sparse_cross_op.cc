@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/fingerprint_util.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/errors.h"
@@ -463,8 +464,9 @@ struct CrossTraits<true, int64_t> {
 }  // namespace
 
 // Calculate the batch size from either the shapes input or the dense input.
+template <typename TensorList>
 int64_t CalculateBatchSize(const OpInputList& shapes_list_in,
-                           const OpInputList& dense_list_in) {
+                           const TensorList& dense_list_in) {
   if (shapes_list_in.size() > 0) {
     return shapes_list_in[0].vec<int64_t>()(0);
   }
@@ -637,12 +639,12 @@ int64_t CrossCountByBatchIndex(
 }
 
 // Generate the columns given the sparse and dense inputs.
-template <typename InternalType>
+template <typename InternalType, typename TensorList>
 std::vector<std::unique_ptr<ColumnInterface<InternalType>>>
 GenerateColumnsFromInput(const OpInputList& indices_list_in,
-                         const OpInputList& values_list_in,
+                         const TensorList& values_list_in,
                          const OpInputList& shapes_list_in,
-                         const OpInputList& dense_list_in) {
+                         const TensorList& dense_list_in) {
   std::vector<std::unique_ptr<ColumnInterface<InternalType>>> columns;
   const int64_t batch_size = CalculateBatchSize(shapes_list_in, dense_list_in);
   const int64_t number_of_columns = shapes_list_in.size();
@@ -767,9 +769,23 @@ class SparseCrossOp : public OpKernel {
         context, ValidateInput(indices_list_in, values_list_in, shapes_list_in,
                                dense_list_in, internal_type));
 
-    std::vector<std::unique_ptr<ColumnInterface<InternalType>>> columns =
-        GenerateColumnsFromInput<InternalType>(indices_list_in, values_list_in,
-                                               shapes_list_in, dense_list_in);
+    std::vector<std::unique_ptr<ColumnInterface<InternalType>>> columns;
+    // Hashed crosses fingerprint every string feature. Do that once per string
+    // up front, in parallel, instead of once per cross the string is part of.
+    std::vector<Tensor> fingerprinted_values;
+    std::vector<Tensor> fingerprinted_dense;
+    if (HASHED_OUTPUT) {
+      OP_REQUIRES_OK(context, FingerprintStringInputs(context, values_list_in,
+                                                      &fingerprinted_values));
+      OP_REQUIRES_OK(context, FingerprintStringInputs(context, dense_list_in,
+                                                      &fingerprinted_dense));
+      columns = GenerateColumnsFromInput<InternalType>(
+          indices_list_in, fingerprinted_values, shapes_list_in,
+          fingerprinted_dense);
+    } else {
+      columns = GenerateColumnsFromInput<InternalType>(
+          indices_list_in, values_list_in, shapes_list_in, dense_list_in);
+    }
 
     const tstring k_feature_separator = "_X_";
     typename CrossTraits<HASHED_OUTPUT, InternalType>::Crosser crosser(
@@ -0,0 +1,103 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+class StringToHashBucketFastOpTest : public OpsTestBase {
+ protected:
+  absl::Status Init(int64_t num_buckets) {
+    TF_CHECK_OK(NodeDefBuilder("op", "StringToHashBucketFast")
+                    .Input(FakeInput(DT_STRING))
+                    .Attr("num_buckets", num_buckets)
+                    .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(StringToHashBucketFastOpTest, IsForeverFrozen) {
+  TF_ASSERT_OK(Init(10));
+  AddInputFromArray<tstring>(TensorShape({4}), {"a", "b", "c", "d"});
+  TF_ASSERT_OK(RunOpKernel());
+  Tensor expected(allocator(), DT_INT64, TensorShape({4}));
+  test::FillValues<int64_t>(&expected, {9, 2, 2, 5});
+  test::ExpectTensorEqual<int64_t>(expected, *GetOutput(0));
+}
+
+TEST_F(StringToHashBucketFastOpTest, Large) {
+  // Enough strings to be split over several threads.
+  const int64_t kNumStrings = 100000;
+  const int64_t kNumBuckets = 1000003;
+  TF_ASSERT_OK(Init(kNumBuckets));
+  AddInput<tstring>(TensorShape({kNumStrings / 10, 10}),
+                    [](int i) -> tstring { return strings::StrCat("s", i); });
+  TF_ASSERT_OK(RunOpKernel());
+  Tensor expected(allocator(), DT_INT64, TensorShape({kNumStrings / 10, 10}));
+  auto expected_flat = expected.flat<int64_t>();
+  for (int64_t i = 0; i < kNumStrings; ++i) {
+    expected_flat(i) = Fingerprint64(strings::StrCat("s", i)) % kNumBuckets;
+  }
+  test::ExpectTensorEqual<int64_t>(expected, *GetOutput(0));
+}
+
+static Graph* StringToHashBucketFast(int num_strings, int length) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor input(DT_STRING, TensorShape({num_strings}));
+  auto input_flat = input.flat<tstring>();
+  for (int i = 0; i < num_strings; ++i) {
+    input_flat(i) = strings::StrCat(i);
+    input_flat(i).resize(length, 'x');
+  }
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "StringToHashBucketFast")
+                  .Input(test::graph::Constant(g, input))
+                  .Attr("num_buckets", 1000)
+                  .Finalize(g, nullptr));
+  return g;
+}
+
+static void BM_StringToHashBucketFast(::testing::benchmark::State& state) {
+  const int num_strings = state.range(0);
+  const int length = state.range(1);
+  test::Benchmark("cpu", StringToHashBucketFast(num_strings, length),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_strings);
+}
+
+BENCHMARK(BM_StringToHashBucketFast)
+    ->UseRealTime()
+    ->ArgPair(1 << 10, 8)
+    ->ArgPair(1 << 20, 8)
+    ->ArgPair(1 << 20, 32);
+
+}  // namespace
+}  // namespace tensorflow
@@ -34,7 +34,13 @@ REGISTER_KERNEL_BUILDER(Name("SummaryWriter").Device(DEVICE_CPU),
 class CreateSummaryFileWriterOp : public OpKernel {
  public:
   explicit CreateSummaryFileWriterOp(OpKernelConstruction* ctx)
-      : OpKernel(ctx) {}
+      : OpKernel(ctx) {
+    // Writes the events on a background thread, off the critical path of the
+    // ops writing summaries.
+    if (ctx->HasAttr("async_write")) {
+      OP_REQUIRES_OK(ctx, ctx->GetAttr("async_write", &async_));
+    }
+  }
 
   void Compute(OpKernelContext* ctx) override {
     const Tensor* tmp;
@@ -60,13 +66,16 @@ class CreateSummaryFileWriterOp : public OpKernel {
     OP_REQUIRES_OK(ctx, HandleFromInput(ctx, 0, &handle));
     OP_REQUIRES_OK(ctx, LookupOrCreateResource<SummaryWriterInterface>(
                             ctx, handle, &s,
-                            [max_queue, flush_millis, logdir, filename_suffix,
-                             ctx](SummaryWriterInterface** s) {
+                            [this, max_queue, flush_millis, logdir,
+                             filename_suffix, ctx](SummaryWriterInterface** s) {
                               return CreateSummaryFileWriter(
-                                  max_queue, flush_millis, logdir,
+                                  max_queue, flush_millis, async_, logdir,
                                   filename_suffix, ctx->env(), s);
                             }));
   }
+
+ private:
+  bool async_ = false;
 };
 REGISTER_KERNEL_BUILDER(Name("CreateSummaryFileWriter").Device(DEVICE_CPU),
                         CreateSummaryFileWriterOp);
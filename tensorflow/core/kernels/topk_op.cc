@@ -20,7 +20,10 @@ limitations under the License.
 #include "tensorflow/core/kernels/topk_op.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
@@ -132,6 +135,168 @@ class TopK : public OpKernel {
 
 namespace functor {
 
+namespace {
+
+// Values are compared to the smallest value of a full top-k in blocks of this
+// many values, so that the blocks that hold no larger value are skipped with
+// vector compares.
+constexpr int64_t kTopKFilterBlockSize = 256;
+
+// When there are fewer rows than threads, rows are split across threads in
+// chunks of at least this many values, and of at least this many times k, so
+// that merging the top-k of the chunks costs little compared to finding them.
+constexpr int64_t kTopKMinChunkSize = 16384;
+constexpr int64_t kTopKMinChunkSizePerK = 32;
+
+// Returns whether any of the `size` values at `data` is greater than
+// `threshold` or is NaN.
+template <typename T>
+bool AnyNotLessEqual(const T* data, int64_t size, T threshold) {
+  int64_t i = 0;
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    using Packet = typename Eigen::internal::packet_traits<T>::type;
+    constexpr int64_t kPacketSize = Eigen::internal::packet_traits<T>::size;
+    const Packet t = Eigen::internal::pset1<Packet>(threshold);
+    const auto above = [&](int64_t j) {
+      return Eigen::internal::pcmp_lt_or_nan(
+          t, Eigen::internal::ploadu<Packet>(data + j));
+    };
+    for (; i + 4 * kPacketSize <= size; i += 4 * kPacketSize) {
+      const Packet any = Eigen::internal::por(
+          Eigen::internal::por(above(i), above(i + kPacketSize)),
+          Eigen::internal::por(above(i + 2 * kPacketSize),
+                               above(i + 3 * kPacketSize)));
+      if (Eigen::internal::predux_any(any)) return true;
+    }
+  }
+  for (; i < size; ++i) {
+    if (!(data[i] <= threshold)) return true;
+  }
+  return false;
+}
+
+// Pushes the indices in [begin, end) of the row `input_data` to `filter`, a
+// gtl::TopN that prefers larger values and then lower indices, and that holds
+// indices lower than `begin`.
+//
+// Once the filter is full, a value that is not larger than its smallest value
+// would be dropped, so such values are skipped a block at a time. The filter
+// ends up as if all the indices were pushed.
+template <typename T, typename Tidx, typename Filter>
+void PushTopKCandidates(const T* input_data, int64_t begin, int64_t end,
+                        Filter* filter) {
+  int64_t c = begin;
+  for (; c < end && filter->size() < filter->limit(); ++c) {
+    filter->push(static_cast<Tidx>(c));
+  }
+  if (c == end) return;
+  T threshold = input_data[filter->peek_bottom()];
+  while (c < end) {
+    const int64_t block_end = std::min(c + kTopKFilterBlockSize, end);
+    if (AnyNotLessEqual(input_data + c, block_end - c, threshold)) {
+      for (; c < block_end; ++c) {
+        if (!(input_data[c] <= threshold)) {
+          filter->push(static_cast<Tidx>(c));
+          threshold = input_data[filter->peek_bottom()];
+        }
+      }
+    }
+    c = block_end;
+  }
+}
+
+// Orders the indices of the row `input_data` by decreasing value, and equal
+// values by increasing index.
+template <typename T, typename Tidx>
+auto StableTopKComparator(const T* input_data) {
+  return [input_data](const Tidx a, const Tidx b) {
+    if (input_data[b] < input_data[a]) {
+      return true;
+    } else if (input_data[b] > input_data[a]) {
+      return false;
+    } else {
+      return a < b;
+    }
+  };
+}
+
+// Computes the top k of rows that are too few to keep the threads busy, by
+// splitting each row in `chunks_per_row` chunks. The top k of each chunk is
+// found in parallel, and the top k of each row is then selected from those of
+// its chunks.
+template <typename T, typename Tidx>
+void TopKSplitRows(OpKernelContext* context, bool sorted, int k,
+                   const typename TTypes<T, 2>::ConstTensor& input,
+                   const int64_t num_rows, const int64_t num_cols,
+                   const int64_t chunks_per_row,
+                   typename TTypes<T, 2>::Tensor values,
+                   typename TTypes<Tidx, 2>::Tensor indices) {
+  using Comparator = decltype(StableTopKComparator<T, Tidx>(nullptr));
+  const int64_t chunk_size = Eigen::divup(num_cols, chunks_per_row);
+  std::vector<std::vector<Tidx>> candidates(num_rows * chunks_per_row);
+
+  auto select_chunks = [&](int64_t start, int64_t limit) {
+    for (int64_t chunk = start; chunk < limit; ++chunk) {
+      const T* input_data = &input(chunk / chunks_per_row, 0);
+      const int64_t begin = chunk % chunks_per_row * chunk_size;
+      gtl::TopN<Tidx, Comparator> filter(
+          k, StableTopKComparator<T, Tidx>(input_data));
+      filter.reserve(k + 1);
+      PushTopKCandidates<T, Tidx>(input_data, begin,
+                                  std::min(begin + chunk_size, num_cols),
+                                  &filter);
+      std::unique_ptr<std::vector<Tidx>> top_k(filter.ExtractUnsorted());
+      candidates[chunk].swap(*top_k);
+    }
+  };
+
+  auto merge_chunks = [&](int64_t start, int64_t limit) {
+    for (int64_t b = start; b < limit; ++b) {
+      const T* input_data = &input(b, 0);
+      gtl::TopN<Tidx, Comparator> filter(
+          k, StableTopKComparator<T, Tidx>(input_data));
+      filter.reserve(k + 1);
+      for (int64_t chunk = b * chunks_per_row;
+           chunk < (b + 1) * chunks_per_row; ++chunk) {
+        for (const Tidx c : candidates[chunk]) {
+          filter.push(c);
+        }
+      }
+
+      int32_t i = 0;
+      if (sorted) {
+        std::unique_ptr<std::vector<Tidx>> top_k(filter.Extract());
+        for (const Tidx c : *top_k) {
+          indices(b, i++) = c;
+        }
+      } else {
+        for (auto top_k_it = filter.unsorted_begin();
+             top_k_it != filter.unsorted_end(); ++top_k_it, ++i) {
+          indices(b, i) = *top_k_it;
+        }
+      }
+      std::transform(&indices(b, 0), &indices(b, k), &values(b, 0),
+                     [input_data](const Tidx loc) { return input_data[loc]; });
+    }
+  };
+
+  const double cmp_cost = 3 * Eigen::TensorOpCost::AddCost<Tidx>() +
+                          Eigen::TensorOpCost::AddCost<T>();
+  const double log_k = Eigen::numext::log2(static_cast<float>(k + 1));
+  auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+  // Most values of a chunk are only compared to the threshold.
+  Shard(worker_threads.num_threads, worker_threads.workers,
+        num_rows * chunks_per_row,
+        static_cast<int64_t>(chunk_size * Eigen::TensorOpCost::AddCost<T>() +
+                             4 * k * log_k * cmp_cost),
+        select_chunks);
+  Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
+        static_cast<int64_t>(4 * chunks_per_row * k * log_k * cmp_cost),
+        merge_chunks);
+}
+
+}  // namespace
+
 template <typename T, typename Tidx>
 struct TopKFunctor<CPUDevice, T, Tidx> {
   static EIGEN_ALWAYS_INLINE absl::Status Compute(
@@ -164,6 +329,22 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
       return absl::OkStatus();
     }
 
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    // A single row is sorted by a single thread below, so when there are
+    // fewer rows than threads, long rows are split across threads instead.
+    if (k < num_cols && num_rows < worker_threads.num_threads) {
+      const int64_t min_chunk_size =
+          std::max(kTopKMinChunkSize, kTopKMinChunkSizePerK * k);
+      const int64_t chunks_per_row = std::min<int64_t>(
+          Eigen::divup<int64_t>(worker_threads.num_threads, num_rows),
+          num_cols / min_chunk_size);
+      if (chunks_per_row > 1) {
+        TopKSplitRows<T, Tidx>(context, sorted, k, input, num_rows, num_cols,
+                               chunks_per_row, values, indices);
+        return absl::OkStatus();
+      }
+    }
+
     auto SortIndices = [&](int64_t start_batch, int64_t limit_batch) {
       for (int32_t b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
@@ -211,9 +392,7 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
           // Use the TopN heap object to sort.
           gtl::TopN<Tidx, decltype(stable_comp)> filter(k, stable_comp);
           filter.reserve(num_cols);
-          for (Tidx c = 0; c < num_cols; ++c) {
-            filter.push(c);
-          }
+          PushTopKCandidates<T, Tidx>(input_data, 0, num_cols, &filter);
 
           int32_t i = 0;
           if (sorted) {
@@ -251,7 +430,6 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
         (total_cost >= static_cast<double>(std::numeric_limits<int64_t>::max()))
             ? std::numeric_limits<int64_t>::max()
             : static_cast<int64_t>(total_cost);
-    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
@@ -15,7 +15,10 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <complex>
+#include <cstdint>
+#include <type_traits>
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/attr_value.pb.h"
@@ -68,12 +71,197 @@ void TransposeSimple(const CPUDevice& device, const Tensor& in,
   device.parallelFor(in.NumElements(), cost, std::move(transpose_fn));
 }
 
+// Maps an element size to an Eigen scalar type of the same size whose packets
+// support ptranspose(). Packets are only used to move bits, so e.g. uint32_t
+// elements can be transposed as floats.
+template <int kSize>
+struct TransposePacketScalar {
+  typedef void type;
+};
+template <>
+struct TransposePacketScalar<4> {
+  typedef float type;
+};
+template <>
+struct TransposePacketScalar<8> {
+  typedef double type;
+};
+
+// Writes the transpose of the `num_rows` x `num_cols` block at `src` to `dst`,
+// i.e. dst[c * dst_stride + r] = src[r * src_stride + c].
+template <typename T>
+void TransposeBlock(const T* src, int64_t src_stride, T* dst,
+                    int64_t dst_stride, int64_t num_rows, int64_t num_cols) {
+  typedef typename TransposePacketScalar<sizeof(T)>::type Scalar;
+  int64_t row_end = 0;
+  int64_t col_end = 0;
+  if constexpr (!std::is_void_v<Scalar>) {
+    typedef typename Eigen::internal::packet_traits<Scalar>::type Packet;
+    constexpr int kPacketSize = Eigen::internal::unpacket_traits<Packet>::size;
+    if constexpr (Eigen::internal::packet_traits<Scalar>::Vectorizable &&
+                  kPacketSize > 1) {
+      // Transpose kPacketSize x kPacketSize sub-blocks in registers.
+      row_end = num_rows - num_rows % kPacketSize;
+      col_end = num_cols - num_cols % kPacketSize;
+      const Scalar* s = reinterpret_cast<const Scalar*>(src);
+      Scalar* d = reinterpret_cast<Scalar*>(dst);
+      Eigen::internal::PacketBlock<Packet, kPacketSize> block;
+      for (int64_t r = 0; r < row_end; r += kPacketSize) {
+        for (int64_t c = 0; c < col_end; c += kPacketSize) {
+          for (int k = 0; k < kPacketSize; ++k) {
+            block.packet[k] = Eigen::internal::ploadu<Packet>(
+                s + (r + k) * src_stride + c);
+          }
+          Eigen::internal::ptranspose(block);
+          for (int k = 0; k < kPacketSize; ++k) {
+            Eigen::internal::pstoreu(d + (c + k) * dst_stride + r,
+                                     block.packet[k]);
+          }
+        }
+      }
+    }
+  }
+  // Scalar code for the remaining rows and columns, and for element sizes
+  // without a packet transpose.
+  for (int64_t r = 0; r < num_rows; ++r) {
+    for (int64_t c = r < row_end ? col_end : 0; c < num_cols; ++c) {
+      dst[c * dst_stride + r] = src[r * src_stride + c];
+    }
+  }
+}
+
+// Cache-blocked transpose for trivially copyable element types.
+//
+// Neighboring dimensions that stay adjacent in the output are first merged.
+// If the innermost dimension is preserved, every output row is a contiguous
+// copy of an input row. Otherwise the tensor is a stack of 2-D planes spanned
+// by the two unit-stride dimensions (innermost in the input and innermost in
+// the output), indexed by all remaining dimensions. Each plane is transposed
+// in tiles that fit in L1 cache, using in-register packet transposes where
+// available, and strips of tiles are distributed across the intra-op threads.
+template <typename T>
+void TransposeTiled(const CPUDevice& device, const Tensor& in,
+                    const absl::Span<const int32_t> perm, Tensor* out) {
+  internal::TransposePermsVec out_positions;
+  internal::TransposeDimsVec new_dims;
+  internal::ReduceTransposeDimensions(in.shape(), perm, &out_positions,
+                                      &new_dims);
+  const int ndims = new_dims.size();
+  // ReduceTransposeDimensions gives the output position of each merged input
+  // dimension; invert it to get the permutation of the merged dimensions.
+  internal::TransposePermsVec new_perm(ndims);
+  for (int i = 0; i < ndims; ++i) {
+    new_perm[out_positions[i]] = i;
+  }
+
+  const T* src = reinterpret_cast<const T*>(in.tensor_data().data());
+  T* dst = reinterpret_cast<T*>(const_cast<char*>(out->tensor_data().data()));
+  const int64_t num_elements = in.NumElements();
+
+  absl::InlinedVector<int64_t, 8UL> in_strides(ndims);
+  absl::InlinedVector<int64_t, 8UL> out_strides(ndims);
+  // Stride in the output of each input dimension.
+  absl::InlinedVector<int64_t, 8UL> in_dim_out_strides(ndims);
+  int64_t in_stride = 1;
+  int64_t out_stride = 1;
+  for (int i = ndims - 1; i >= 0; --i) {
+    in_strides[i] = in_stride;
+    in_stride *= new_dims[i];
+    out_strides[i] = out_stride;
+    in_dim_out_strides[new_perm[i]] = out_stride;
+    out_stride *= new_dims[new_perm[i]];
+  }
+
+  if (new_perm[ndims - 1] == ndims - 1) {
+    // The innermost dimension is unchanged (this includes the identity
+    // permutation, which reduces to a single dimension).
+    const int64_t row_size = new_dims[ndims - 1];
+    auto copy_rows = [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        int64_t src_offset = 0;
+        int64_t t = row * row_size;
+        for (int i = 0; i < ndims - 1; ++i) {
+          const int64_t ratio = t / out_strides[i];
+          t -= ratio * out_strides[i];
+          src_offset += ratio * in_strides[new_perm[i]];
+        }
+        std::copy_n(src + src_offset, row_size, dst + row * row_size);
+      }
+    };
+    const Eigen::TensorOpCost cost(
+        /*bytes_loaded=*/row_size * sizeof(T),
+        /*bytes_stored=*/row_size * sizeof(T),
+        /*compute_cycles=*/(ndims - 1) *
+            Eigen::TensorOpCost::DivCost<int64_t>());
+    device.parallelFor(num_elements / row_size, cost, copy_rows);
+    return;
+  }
+
+  // The plane dimensions: `rows` is contiguous in the output and `cols` is
+  // contiguous in the input.
+  const int row_dim = new_perm[ndims - 1];
+  const int col_dim = ndims - 1;
+  const int64_t num_rows = new_dims[row_dim];
+  const int64_t num_cols = new_dims[col_dim];
+  const int64_t src_row_stride = in_strides[row_dim];
+  const int64_t dst_col_stride = in_dim_out_strides[col_dim];
+
+  // The remaining dimensions index the planes.
+  absl::InlinedVector<int64_t, 8UL> plane_dims;
+  absl::InlinedVector<int64_t, 8UL> plane_in_strides;
+  absl::InlinedVector<int64_t, 8UL> plane_out_strides;
+  for (int i = 0; i < ndims; ++i) {
+    if (i == row_dim || i == col_dim) continue;
+    plane_dims.push_back(new_dims[i]);
+    plane_in_strides.push_back(in_strides[i]);
+    plane_out_strides.push_back(in_dim_out_strides[i]);
+  }
+
+  // A tile is 128 bytes wide, e.g. 32 x 32 floats.
+  constexpr int64_t kTileSize = 128 / sizeof(T);
+  const int64_t num_row_tiles = Eigen::divup(num_rows, kTileSize);
+  auto transpose_strips = [&](int64_t begin, int64_t end) {
+    for (int64_t strip = begin; strip < end; ++strip) {
+      int64_t plane = strip / num_row_tiles;
+      const int64_t row_begin = (strip - plane * num_row_tiles) * kTileSize;
+      const int64_t strip_rows = std::min(kTileSize, num_rows - row_begin);
+      int64_t src_offset = row_begin * src_row_stride;
+      int64_t dst_offset = row_begin;
+      for (int i = plane_dims.size() - 1; i >= 0; --i) {
+        const int64_t index = plane % plane_dims[i];
+        plane /= plane_dims[i];
+        src_offset += index * plane_in_strides[i];
+        dst_offset += index * plane_out_strides[i];
+      }
+      for (int64_t col = 0; col < num_cols; col += kTileSize) {
+        TransposeBlock(src + src_offset + col, src_row_stride,
+                       dst + dst_offset + col * dst_col_stride, dst_col_stride,
+                       strip_rows, std::min(kTileSize, num_cols - col));
+      }
+    }
+  };
+  const Eigen::TensorOpCost cost(
+      /*bytes_loaded=*/kTileSize * num_cols * sizeof(T),
+      /*bytes_stored=*/kTileSize * num_cols * sizeof(T),
+      /*compute_cycles=*/kTileSize * num_cols);
+  device.parallelFor(num_elements / (num_rows * num_cols) * num_row_tiles,
+                     cost, transpose_strips);
+}
+
 }  // namespace
 
 template <typename T, bool conjugate>
 struct Transpose<CPUDevice, T, conjugate> {
   static void run(const CPUDevice& d, const Tensor& in,
                   const absl::Span<const int32_t> perm, Tensor* out) {
+    if constexpr (!conjugate && std::is_trivially_copyable_v<T> &&
+                  (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                   sizeof(T) == 8)) {
+      if (in.dims() >= 2 && in.NumElements() > 0) {
+        TransposeTiled<T>(d, in, perm, out);
+        return;
+      }
+    }
     switch (in.dims()) {
       case 2:
         internal::TransposeUsingEigen<CPUDevice, T, 2>(d, in, perm, conjugate,
@@ -0,0 +1,183 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/transpose_functor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+template <typename T>
+T MakeValue(int64_t i) {
+  return static_cast<T>(i * 7 + 3);
+}
+
+template <>
+tstring MakeValue<tstring>(int64_t i) {
+  return strings::StrCat(i);
+}
+
+// Transposes `in` one element at a time.
+template <typename T>
+Tensor ReferenceTranspose(const Tensor& in, const std::vector<int32_t>& perm) {
+  const int ndims = in.dims();
+  TensorShape out_shape;
+  for (int i = 0; i < ndims; ++i) {
+    out_shape.AddDim(in.dim_size(perm[i]));
+  }
+  Tensor out(in.dtype(), out_shape);
+  std::vector<int64_t> in_strides(ndims, 1);
+  std::vector<int64_t> out_strides(ndims, 1);
+  for (int i = ndims - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * in.dim_size(i + 1);
+    out_strides[i] = out_strides[i + 1] * out_shape.dim_size(i + 1);
+  }
+  auto in_flat = in.flat<T>();
+  auto out_flat = out.flat<T>();
+  for (int64_t o = 0; o < out.NumElements(); ++o) {
+    int64_t t = o;
+    int64_t i_idx = 0;
+    for (int i = 0; i < ndims; ++i) {
+      i_idx += (t / out_strides[i]) * in_strides[perm[i]];
+      t %= out_strides[i];
+    }
+    out_flat(o) = in_flat(i_idx);
+  }
+  return out;
+}
+
+class TransposeFunctorCpuTest : public ::testing::Test {
+ protected:
+  TransposeFunctorCpuTest()
+      : thread_pool_(4), device_(&thread_pool_, thread_pool_.NumThreads()) {}
+
+  template <typename T>
+  void TestTranspose(const TensorShape& shape,
+                     const std::vector<int32_t>& perm) {
+    Tensor in(DataTypeToEnum<T>::value, shape);
+    auto in_flat = in.flat<T>();
+    for (int64_t i = 0; i < in.NumElements(); ++i) {
+      in_flat(i) = MakeValue<T>(i);
+    }
+    const Tensor expected = ReferenceTranspose<T>(in, perm);
+    Tensor out(in.dtype(), expected.shape());
+    TF_ASSERT_OK(DoTranspose(device_, in, perm, &out));
+    test::ExpectTensorEqual<T>(expected, out);
+  }
+
+  template <typename T>
+  void TestAllPermutations(const TensorShape& shape) {
+    std::vector<int32_t> perm(shape.dims());
+    std::iota(perm.begin(), perm.end(), 0);
+    do {
+      TestTranspose<T>(shape, perm);
+    } while (std::next_permutation(perm.begin(), perm.end()));
+  }
+
+  Eigen::ThreadPool thread_pool_;
+  CPUDevice device_;
+};
+
+TEST_F(TransposeFunctorCpuTest, Matrix) {
+  TestTranspose<uint8_t>({131, 257}, {1, 0});
+  TestTranspose<int16_t>({131, 257}, {1, 0});
+  TestTranspose<float>({131, 257}, {1, 0});
+  TestTranspose<double>({131, 257}, {1, 0});
+}
+
+TEST_F(TransposeFunctorCpuTest, NHWCToNCHW) {
+  TestTranspose<uint8_t>({2, 17, 19, 67}, {0, 3, 1, 2});
+  TestTranspose<Eigen::half>({2, 17, 19, 67}, {0, 3, 1, 2});
+  TestTranspose<float>({2, 17, 19, 67}, {0, 3, 1, 2});
+  TestTranspose<int64_t>({2, 17, 19, 67}, {0, 3, 1, 2});
+}
+
+TEST_F(TransposeFunctorCpuTest, NCHWToNHWC) {
+  TestTranspose<uint8_t>({2, 67, 17, 19}, {0, 2, 3, 1});
+  TestTranspose<Eigen::half>({2, 67, 17, 19}, {0, 2, 3, 1});
+  TestTranspose<float>({2, 67, 17, 19}, {0, 2, 3, 1});
+  TestTranspose<int64_t>({2, 67, 17, 19}, {0, 2, 3, 1});
+}
+
+TEST_F(TransposeFunctorCpuTest, AllPermutations) {
+  TestAllPermutations<uint8_t>({3, 1, 35, 4, 33});
+  TestAllPermutations<int16_t>({3, 1, 35, 4, 33});
+  TestAllPermutations<int32_t>({3, 1, 35, 4, 33});
+  TestAllPermutations<double>({3, 1, 35, 4, 33});
+}
+
+TEST_F(TransposeFunctorCpuTest, NonTriviallyCopyable) {
+  TestTranspose<tstring>({5, 7, 3}, {2, 0, 1});
+  TestTranspose<complex64>({5, 7, 3}, {2, 0, 1});
+}
+
+template <typename T>
+void BM_Transpose(::testing::benchmark::State& state,
+                  const TensorShape& shape, const std::vector<int32_t>& perm) {
+  Eigen::ThreadPool thread_pool(port::MaxParallelism());
+  CPUDevice device(&thread_pool, thread_pool.NumThreads());
+  Tensor in(DataTypeToEnum<T>::value, shape);
+  in.flat<T>().setRandom();
+  TensorShape out_shape;
+  for (int i = 0; i < shape.dims(); ++i) {
+    out_shape.AddDim(shape.dim_size(perm[i]));
+  }
+  Tensor out(in.dtype(), out_shape);
+  for (auto s : state) {
+    TF_CHECK_OK(DoTranspose(device, in, perm, &out));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          in.TotalBytes());
+}
+
+#define BM_TRANSPOSE(T, NAME, SHAPE, PERM)                                \
+  static void BM_Transpose_##T##_##NAME(                                  \
+      ::testing::benchmark::State& state) {                               \
+    BM_Transpose<T>(state, TensorShape SHAPE, std::vector<int32_t> PERM); \
+  }                                                                       \
+  BENCHMARK(BM_Transpose_##T##_##NAME)->UseRealTime()
+
+BM_TRANSPOSE(uint8_t, Matrix, ({4096, 4096}), ({1, 0}));
+BM_TRANSPOSE(float, Matrix, ({4096, 4096}), ({1, 0}));
+BM_TRANSPOSE(double, Matrix, ({4096, 4096}), ({1, 0}));
+BM_TRANSPOSE(uint8_t, NHWCToNCHW, ({32, 112, 112, 64}), ({0, 3, 1, 2}));
+BM_TRANSPOSE(int16_t, NHWCToNCHW, ({32, 112, 112, 64}), ({0, 3, 1, 2}));
+BM_TRANSPOSE(float, NHWCToNCHW, ({32, 112, 112, 64}), ({0, 3, 1, 2}));
+BM_TRANSPOSE(float, NCHWToNHWC, ({32, 64, 112, 112}), ({0, 2, 3, 1}));
+BM_TRANSPOSE(float, HWIOToOIHW, ({3, 3, 256, 512}), ({3, 2, 0, 1}));
+BM_TRANSPOSE(float, Reverse5D, ({16, 16, 16, 16, 64}), ({4, 3, 2, 1, 0}));
+BM_TRANSPOSE(float, InnerPreserved, ({64, 256, 32, 64}), ({1, 0, 2, 3}));
+
+#undef BM_TRANSPOSE
+
+}  // namespace
+}  // namespace tensorflow
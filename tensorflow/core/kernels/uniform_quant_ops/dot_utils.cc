@@ -0,0 +1,149 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/uniform_quant_ops/dot_utils.h"
+
+#include <cstdint>
+
+#include "tensorflow/core/platform/cpu_info.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TF_DOT_UTILS_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_FEATURE_DOTPROD)
+#include <arm_neon.h>
+#endif
+
+namespace tensorflow {
+
+namespace internal {
+
+int32_t DotUint8Int8Reference(const uint8_t* lhs, const int8_t* rhs,
+                              int64_t size) {
+  // Unsigned arithmetic wraps around instead of overflowing.
+  uint32_t acc = 0;
+  for (int64_t i = 0; i < size; ++i) {
+    acc += static_cast<uint32_t>(static_cast<int32_t>(lhs[i]) * rhs[i]);
+  }
+  return static_cast<int32_t>(acc);
+}
+
+}  // namespace internal
+
+namespace {
+
+using DotFn = int32_t (*)(const uint8_t*, const int8_t*, int64_t);
+
+#ifdef TF_DOT_UTILS_X86_DISPATCH
+
+// Each VPDPBUSD multiplies 64 pairs of values and adds them up in groups of
+// four into 16 int32 lanes. The remainder is loaded with a mask, which zeroes
+// the values past the end.
+__attribute__((target("avx512f,avx512bw,avx512vnni"))) int32_t
+DotUint8Int8Avx512Vnni(const uint8_t* lhs, const int8_t* rhs, int64_t size) {
+  __m512i acc = _mm512_setzero_si512();
+  int64_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    acc = _mm512_dpbusd_epi32(acc, _mm512_loadu_si512(lhs + i),
+                              _mm512_loadu_si512(rhs + i));
+  }
+  if (i < size) {
+    const __mmask64 mask = (uint64_t{1} << (size - i)) - 1;
+    acc = _mm512_dpbusd_epi32(acc, _mm512_maskz_loadu_epi8(mask, lhs + i),
+                              _mm512_maskz_loadu_epi8(mask, rhs + i));
+  }
+  return _mm512_reduce_add_epi32(acc);
+}
+
+// Without VNNI, the values are widened to int16 and VPMADDWD multiplies them
+// and adds up pairs of products into int32, which cannot overflow.
+__attribute__((target("avx2"))) int32_t DotUint8Int8Avx2(const uint8_t* lhs,
+                                                         const int8_t* rhs,
+                                                         int64_t size) {
+  __m256i acc = _mm256_setzero_si256();
+  int64_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i l = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)));
+    const __m256i r = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(l, r));
+  }
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                              _mm256_extracti128_si256(acc, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<int32_t>(
+      static_cast<uint32_t>(_mm_cvtsi128_si32(sum)) +
+      static_cast<uint32_t>(
+          internal::DotUint8Int8Reference(lhs + i, rhs + i, size - i)));
+}
+
+#endif  // TF_DOT_UTILS_X86_DISPATCH
+
+#if defined(__ARM_FEATURE_DOTPROD)
+
+// SDOT multiplies signed values only, so lhs is shifted to int8 by
+// subtracting 128, and 128 * sum(rhs) is added back. The sum of rhs is
+// computed with another SDOT by a vector of ones.
+int32_t DotUint8Int8Neon(const uint8_t* lhs, const int8_t* rhs, int64_t size) {
+  const uint8x16_t offset = vdupq_n_u8(0x80);
+  const int8x16_t ones = vdupq_n_s8(1);
+  int32x4_t acc = vdupq_n_s32(0);
+  int32x4_t rhs_sum = vdupq_n_s32(0);
+  int64_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const int8x16_t l =
+        vreinterpretq_s8_u8(veorq_u8(vld1q_u8(lhs + i), offset));
+    const int8x16_t r = vld1q_s8(rhs + i);
+    acc = vdotq_s32(acc, l, r);
+    rhs_sum = vdotq_s32(rhs_sum, ones, r);
+  }
+  const uint32_t sum =
+      static_cast<uint32_t>(vaddvq_s32(acc)) +
+      (static_cast<uint32_t>(vaddvq_s32(rhs_sum)) << 7) +
+      static_cast<uint32_t>(
+          internal::DotUint8Int8Reference(lhs + i, rhs + i, size - i));
+  return static_cast<int32_t>(sum);
+}
+
+#endif  // __ARM_FEATURE_DOTPROD
+
+DotFn SelectDotUint8Int8() {
+#ifdef TF_DOT_UTILS_X86_DISPATCH
+  if (port::TestCPUFeature(port::CPUFeature::AVX512_VNNI) &&
+      port::TestCPUFeature(port::CPUFeature::AVX512BW)) {
+    return DotUint8Int8Avx512Vnni;
+  }
+  if (port::TestCPUFeature(port::CPUFeature::AVX2)) {
+    return DotUint8Int8Avx2;
+  }
+#endif  // TF_DOT_UTILS_X86_DISPATCH
+#if defined(__ARM_FEATURE_DOTPROD)
+  return DotUint8Int8Neon;
+#else
+  return internal::DotUint8Int8Reference;
+#endif
+}
+
+}  // namespace
+
+int32_t DotUint8Int8(const uint8_t* lhs, const int8_t* rhs, int64_t size) {
+  static const DotFn dot = SelectDotUint8Int8();
+  return dot(lhs, rhs, size);
+}
+
+}  // namespace tensorflow
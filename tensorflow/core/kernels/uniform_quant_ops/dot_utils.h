@@ -0,0 +1,41 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_UNIFORM_QUANT_OPS_DOT_UTILS_H_
+#define TENSORFLOW_CORE_KERNELS_UNIFORM_QUANT_OPS_DOT_UTILS_H_
+
+#include <cstdint>
+
+namespace tensorflow {
+
+// Returns the sum of lhs[i] * rhs[i] for i in [0, size), accumulated in int32
+// with wraparound on overflow.
+//
+// Uses the dot-product instructions of the CPU when it has them: VPDPBUSD on
+// x86 with AVX512-VNNI, VPMADDWD on x86 with AVX2, and SDOT on Arm when built
+// with the dot-product extension. The instructions are selected at runtime on
+// x86, so that they are used by binaries built for older CPUs.
+int32_t DotUint8Int8(const uint8_t* lhs, const int8_t* rhs, int64_t size);
+
+namespace internal {
+
+// The portable implementation of DotUint8Int8, for tests.
+int32_t DotUint8Int8Reference(const uint8_t* lhs, const int8_t* rhs,
+                              int64_t size);
+
+}  // namespace internal
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_UNIFORM_QUANT_OPS_DOT_UTILS_H_
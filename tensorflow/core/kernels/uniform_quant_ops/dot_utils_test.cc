@@ -0,0 +1,57 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/uniform_quant_ops/dot_utils.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+
+TEST(DotUtilsTest, DotUint8Int8) {
+  const std::vector<uint8_t> lhs = {0, 1, 255, 128};
+  const std::vector<int8_t> rhs = {127, -3, -128, 2};
+  EXPECT_EQ(DotUint8Int8(lhs.data(), rhs.data(), lhs.size()),
+            -3 - 255 * 128 + 256);
+  EXPECT_EQ(DotUint8Int8(lhs.data(), rhs.data(), 0), 0);
+}
+
+TEST(DotUtilsTest, DotUint8Int8MatchesReference) {
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> values(0, 255);
+  // Sizes around the vector widths of the implementations, and extreme values
+  // that reach the largest partial sums.
+  for (int size : {1, 15, 16, 17, 63, 64, 65, 130, 1000}) {
+    std::vector<uint8_t> lhs(size);
+    std::vector<int8_t> rhs(size);
+    for (int trial = 0; trial < 3; ++trial) {
+      for (int i = 0; i < size; ++i) {
+        lhs[i] = trial == 0 ? std::numeric_limits<uint8_t>::max()
+                            : values(random);
+        rhs[i] = trial == 0 ? std::numeric_limits<int8_t>::min()
+                            : static_cast<int8_t>(values(random) - 128);
+      }
+      EXPECT_EQ(DotUint8Int8(lhs.data(), rhs.data(), size),
+                internal::DotUint8Int8Reference(lhs.data(), rhs.data(), size))
+          << "size " << size << ", trial " << trial;
+    }
+  }
+}
+
+}  // namespace tensorflow
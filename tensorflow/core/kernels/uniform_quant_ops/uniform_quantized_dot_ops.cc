@@ -13,9 +13,17 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/kernels/uniform_quant_ops/dot_utils.h"
 #include "tensorflow/core/kernels/uniform_quant_ops/math_utils.h"
 #include "tensorflow/core/kernels/uniform_quant_ops/tensor_utils.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -181,53 +189,6 @@ absl::Status EvalLhsPerTensorAndRhsPerChannelQuantizedDot(
   return absl::OkStatus();
 }
 
-// Performs dot on per-batch (dimension 0) quantized lhs and per-tensor
-// quantized rhs.
-template <typename Tlhs, typename Trhs>
-void EvalLhsPerBatchAndRhsPerTensorQuantizedDot(
-    OpKernelContext* context, const Tensor& lhs, const Tensor& rhs,
-    const Tensor& lhs_scales, const Tensor& lhs_zero_points, float rhs_scale,
-    int32_t rhs_zero_point, Tensor& output) {
-  const float* lhs_scales_data = lhs_scales.flat<float>().data();
-  const int32_t* lhs_zero_points_data = lhs_zero_points.flat<int32_t>().data();
-
-  DotWithAccFunctionAndOutputFunction<Tlhs, Trhs, float>(
-      lhs, rhs, output,
-      [lhs_zero_points_data, rhs_zero_point](Tlhs lhs_val, Trhs rhs_val,
-                                             int64_t b, int64_t out_c) {
-        return (static_cast<int32_t>(lhs_val) - lhs_zero_points_data[b]) *
-               (static_cast<int32_t>(rhs_val) - rhs_zero_point);
-      },
-      [lhs_scales_data, rhs_scale](int32_t acc, int64_t b, int64_t out_c) {
-        return acc * lhs_scales_data[b] * rhs_scale;
-      });
-}
-
-// Performs dot on per-batch (dimension 0) quantized lhs and per-channel
-// (dimension 1) quantized rhs.
-template <typename Tlhs, typename Trhs>
-void EvalLhsPerBatchAndRhsPerChannelQuantizedDot(
-    const Tensor& lhs, const Tensor& rhs, const Tensor& lhs_scales,
-    const Tensor& lhs_zero_points, const Tensor& rhs_scales,
-    const Tensor& rhs_zero_points, Tensor& output) {
-  const float* lhs_scales_data = lhs_scales.flat<float>().data();
-  const int32_t* lhs_zero_points_data = lhs_zero_points.flat<int32_t>().data();
-  const float* rhs_scales_data = rhs_scales.flat<float>().data();
-  const int32_t* rhs_zero_points_data = rhs_zero_points.flat<int32_t>().data();
-
-  DotWithAccFunctionAndOutputFunction<Tlhs, Trhs, float>(
-      lhs, rhs, output,
-      [lhs_zero_points_data, rhs_zero_points_data](Tlhs lhs_val, Trhs rhs_val,
-                                                   int64_t b, int64_t out_c) {
-        return (static_cast<int32_t>(lhs_val) - lhs_zero_points_data[b]) *
-               (static_cast<int32_t>(rhs_val) - rhs_zero_points_data[out_c]);
-      },
-      [lhs_scales_data, rhs_scales_data](int32_t acc, int64_t b,
-                                         int64_t out_c) {
-        return acc * lhs_scales_data[b] * rhs_scales_data[out_c];
-      });
-}
-
 // Given quantized lhs and quantized rhs, performs quantized dot on lhs and rhs,
 // and produce quantized output. Assumes that output is already allocated with
 // correct size.
@@ -260,16 +221,53 @@ absl::Status EvalQuantizedDot(OpKernelContext* context, const Tensor& lhs,
   }
 }
 
+// The rhs of a hybrid dot, transposed to [output_depth, accum_depth] so that
+// the values of each output channel are contiguous, with the sum of the values
+// of each output channel.
+struct TransposedRhs {
+  std::vector<int8_t> values;
+  std::vector<int32_t> sums;
+};
+
+template <typename Trhs>
+TransposedRhs TransposeRhs(const Tensor& rhs) {
+  const int64_t accum_depth = rhs.dim_size(0);
+  const int64_t output_depth = rhs.dim_size(1);
+  const Trhs* rhs_data = rhs.flat<Trhs>().data();
+
+  TransposedRhs transposed;
+  transposed.values.resize(rhs.NumElements());
+  transposed.sums.resize(output_depth);
+  for (int64_t out_c = 0; out_c < output_depth; ++out_c) {
+    int8_t* values = transposed.values.data() + out_c * accum_depth;
+    int32_t sum = 0;
+    for (int64_t d = 0; d < accum_depth; ++d) {
+      values[d] = rhs_data[d * output_depth + out_c].value;
+      sum += values[d];
+    }
+    transposed.sums[out_c] = sum;
+  }
+  return transposed;
+}
+
 // Given float lhs and quantized rhs, performs per-batch dynamic range
 // quantization on lhs, and then performs quantized dot on lhs and rhs. Assumes
 // that output is already allocated with correct size.
 // For more details on lhs quantization policy, refer to the comment of class
 // UniformQuantizedDotHybridOp below.
-template <typename Trhs>
+//
+// The accumulation sum((lhs - lhs_zero_point) * (rhs - rhs_zero_point)) is
+// expanded into sum(lhs * rhs) - rhs_zero_point * sum(lhs)
+// - lhs_zero_point * sum(rhs) + accum_depth * lhs_zero_point * rhs_zero_point,
+// so that the dot products, where all the time goes, are of plain int8 values
+// and use the dot-product instructions of the CPU. The result is the same
+// int32 accumulation as computing each product separately.
 absl::Status EvalHybridDot(OpKernelContext* context, const Tensor& lhs,
-                           const Tensor& rhs, const Tensor& rhs_scales,
+                           const TransposedRhs& rhs, const Tensor& rhs_scales,
                            const Tensor& rhs_zero_points, Tensor& output) {
   const int64_t batches = lhs.dim_size(0);
+  const int64_t accum_depth = lhs.dim_size(1);
+  const int64_t output_depth = output.dim_size(1);
 
   Tensor lhs_quantized;
   TF_RETURN_IF_ERROR(
@@ -291,16 +289,52 @@ absl::Status EvalHybridDot(OpKernelContext* context, const Tensor& lhs,
         /*quantization_max_val=*/127, lhs_scales_data[b],
         lhs_zero_points_data[b], lhs_quantized_tensor.template chip<0>(b)));
   }
-  if (rhs_scales.dims() != 0) {
-    EvalLhsPerBatchAndRhsPerChannelQuantizedDot<qint8, Trhs>(
-        lhs_quantized, rhs, lhs_scales, lhs_zero_points, rhs_scales,
-        rhs_zero_points, output);
-  } else {
-    EvalLhsPerBatchAndRhsPerTensorQuantizedDot<qint8, Trhs>(
-        context, lhs_quantized, rhs, lhs_scales, lhs_zero_points,
-        rhs_scales.scalar<float>()(), rhs_zero_points.scalar<int32_t>()(),
-        output);
+
+  // The dot products take unsigned lhs values, so lhs and its zero points are
+  // shifted by 128, which leaves their differences unchanged.
+  uint8_t* lhs_data =
+      reinterpret_cast<uint8_t*>(lhs_quantized.flat<qint8>().data());
+  std::vector<int64_t> lhs_sums(batches);
+  for (int64_t b = 0; b < batches; ++b) {
+    uint8_t* row = lhs_data + b * accum_depth;
+    int64_t sum = 0;
+    for (int64_t d = 0; d < accum_depth; ++d) {
+      row[d] ^= 0x80;
+      sum += row[d];
+    }
+    lhs_sums[b] = sum;
+    lhs_zero_points_data[b] += 128;
   }
+
+  const bool per_channel = rhs_scales.dims() != 0;
+  const float* rhs_scales_data = rhs_scales.flat<float>().data();
+  const int32_t* rhs_zero_points_data = rhs_zero_points.flat<int32_t>().data();
+  float* output_data = output.flat<float>().data();
+
+  // Each shard computes a range of output channels for all the batches, so
+  // that the rhs values of a channel are read once.
+  auto compute_channels = [&](int64_t start, int64_t limit) {
+    for (int64_t out_c = start; out_c < limit; ++out_c) {
+      const int8_t* rhs_values = rhs.values.data() + out_c * accum_depth;
+      const int64_t rhs_sum = rhs.sums[out_c];
+      const float rhs_scale = rhs_scales_data[per_channel ? out_c : 0];
+      const int64_t rhs_zero_point =
+          rhs_zero_points_data[per_channel ? out_c : 0];
+      for (int64_t b = 0; b < batches; ++b) {
+        const int64_t lhs_zero_point = lhs_zero_points_data[b];
+        const int64_t acc =
+            DotUint8Int8(lhs_data + b * accum_depth, rhs_values, accum_depth) -
+            rhs_zero_point * lhs_sums[b] - lhs_zero_point * rhs_sum +
+            accum_depth * lhs_zero_point * rhs_zero_point;
+        output_data[b * output_depth + out_c] =
+            static_cast<int32_t>(acc) * lhs_scales_data[b] * rhs_scale;
+      }
+    }
+  };
+  const DeviceBase::CpuWorkerThreads& worker_threads =
+      *context->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads.num_threads, worker_threads.workers, output_depth,
+        /*cost_per_unit=*/batches * accum_depth, compute_channels);
   return absl::OkStatus();
 }
 
@@ -475,9 +509,35 @@ class UniformQuantizedDotHybridOp : public OpKernel {
         context,
         context->allocate_output(
             0, TensorShape({lhs.dim_size(0), rhs.dim_size(1)}), &output));
-    OP_REQUIRES_OK(context, EvalHybridDot<Trhs>(context, lhs, rhs, rhs_scales,
-                                                rhs_zero_points, *output));
+    OP_REQUIRES_OK(context,
+                   EvalHybridDot(context, lhs, *GetTransposedRhs(rhs),
+                                 rhs_scales, rhs_zero_points, *output));
   }
+
+ private:
+  // Returns `rhs` transposed, which is cached since rhs usually holds constant
+  // weights. The cache keeps a reference to the last rhs, so that its buffer
+  // cannot be reused for other values, or updated in place by an op that
+  // forwards its input, while it identifies the cached values.
+  std::shared_ptr<const TransposedRhs> GetTransposedRhs(const Tensor& rhs) {
+    {
+      mutex_lock l(mu_);
+      if (transposed_rhs_ != nullptr && rhs_.data() == rhs.data() &&
+          rhs_.shape() == rhs.shape()) {
+        return transposed_rhs_;
+      }
+    }
+    auto transposed_rhs =
+        std::make_shared<const TransposedRhs>(TransposeRhs<Trhs>(rhs));
+    mutex_lock l(mu_);
+    rhs_ = rhs;
+    transposed_rhs_ = transposed_rhs;
+    return transposed_rhs;
+  }
+
+  mutex mu_;
+  Tensor rhs_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<const TransposedRhs> transposed_rhs_ TF_GUARDED_BY(mu_);
 };
 
 REGISTER_KERNEL_BUILDER(Name("UniformQuantizedDot")
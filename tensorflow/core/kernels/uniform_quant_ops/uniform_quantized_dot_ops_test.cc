@@ -269,4 +269,64 @@ TEST_F(UniformQuantizedDotTest, HybridPerChannelQuantized) {
   test::ExpectClose(expected, *GetOutput(0), /*atol=*/0.1, /*rtol=*/0.01);
 }
 
+TEST_F(UniformQuantizedDotTest, HybridPerChannelQuantizedLarge) {
+  TF_ASSERT_OK(NodeDefBuilder("test", "UniformQuantizedDotHybrid")
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_QINT8))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_INT32))
+                   .Attr("Tlhs", DT_FLOAT)
+                   .Attr("Trhs", DT_QINT8)
+                   .Attr("Tout", DT_FLOAT)
+                   .Attr("rhs_quantization_min_val", -128)
+                   .Attr("rhs_quantization_max_val", 127)
+                   .Attr("rhs_quantization_axis", 1)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+
+  // Sizes that are not multiples of the vector widths of the dot products.
+  constexpr int kBatches = 5, kAccumDepth = 100, kOutputDepth = 37;
+  auto run = [&](int rhs_offset) {
+    inputs_.clear();
+    AddInput<float>(TensorShape({kBatches, kAccumDepth}),
+                    [](int i) { return ((i * 7) % 23) / 11.0f - 1.0f; });
+    AddInput<qint8>(TensorShape({kAccumDepth, kOutputDepth}),
+                    [rhs_offset](int i) {
+                      return static_cast<qint8>((i * 13 + rhs_offset) % 255 -
+                                                127);
+                    });
+    AddInput<float>(TensorShape({kOutputDepth}),
+                    [](int i) { return 0.01f * (i % 3 + 1); });
+    AddInput<int32_t>(TensorShape({kOutputDepth}),
+                      [](int i) { return i % 5 - 2; });
+
+    // dot(lhs, [per-channel dequantized rhs]) in float.
+    Tensor expected(allocator(), DT_FLOAT,
+                    TensorShape({kBatches, kOutputDepth}));
+    const auto lhs = inputs_[0]->matrix<float>();
+    const auto rhs = inputs_[1]->matrix<qint8>();
+    const auto scales = inputs_[2]->vec<float>();
+    const auto zero_points = inputs_[3]->vec<int32_t>();
+    for (int b = 0; b < kBatches; ++b) {
+      for (int c = 0; c < kOutputDepth; ++c) {
+        float sum = 0;
+        for (int d = 0; d < kAccumDepth; ++d) {
+          sum += lhs(b, d) * (static_cast<int32_t>(rhs(d, c)) -
+                              zero_points(c)) * scales(c);
+        }
+        expected.matrix<float>()(b, c) = sum;
+      }
+    }
+
+    TF_ASSERT_OK(RunOpKernel());
+    test::ExpectClose(expected, *GetOutput(0), /*atol=*/0.1, /*rtol=*/0.01);
+    // The rhs, now transposed in the kernel, is reused.
+    const Tensor output = *GetOutput(0);
+    TF_ASSERT_OK(RunOpKernel());
+    test::ExpectTensorEqual<float>(output, *GetOutput(0));
+  };
+  run(/*rhs_offset=*/0);
+  run(/*rhs_offset=*/100);
+}
+
 }  // namespace tensorflow
@@ -0,0 +1,31 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
+#define TENSORFLOW_CORE_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
+
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "xla/tsl/lib/random/philox_random_batch.h"
+
+namespace tensorflow {
+namespace random {
+// NOLINTBEGIN(misc-unused-using-decls)
+using tsl::random::PhiloxRandomBatch;
+// NOLINTEND(misc-unused-using-decls)
+
+}  // namespace random
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
@@ -88,11 +88,17 @@ REGISTER_OP("BatchFunction")
     //     to either PAD_UP or BATCH_DOWN so as to minimize the TPU costs per
     //     real request. In this case, it would compare (batch_16_cost / 16) and
     //     (batch_32_cost / 18).
+    //   - MINIMIZE_LATENCY_PER_REQUEST: chooses to either PAD_UP or BATCH_DOWN
+    //     so as to minimize the expected latency per real request, based on
+    //     the batch processing latencies observed for each allowed batch size
+    //     and on the model's latency SLO, if one is set. Large batch
+    //     splitting is not taken into account.
     //
     // WARNING: Not all batch schedulers might support this attribute.
     .Attr(
         "batch_padding_policy: "
-        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST'} = 'PAD_UP'")
+        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST', "
+        "'MINIMIZE_LATENCY_PER_REQUEST'} = 'PAD_UP'")
     .Attr("Tin: list(type)")
     .Attr("Tcaptured: list(type) >= 0")
     .Attr("Tout: list(type)")
@@ -115,6 +121,14 @@ REGISTER_OP("BatchFunction")
     // If greater than zero, a separate thread pool with this number of threads
     // is used for processing warmup requests.
     .Attr("num_warmup_batch_threads: int = 0")
+    // The latency in microseconds that a request should not exceed, or -1 if
+    // there is none. Used by the MINIMIZE_LATENCY_PER_REQUEST batch padding
+    // policy.
+    .Attr("latency_slo_micros: int = -1")
+    // If true, batched inputs are written into recycled buffers, and the
+    // outputs are returned to each request as views into the batched outputs
+    // instead of copies.
+    .Attr("enable_zero_copy_batching: bool = false")
     // TODO(apassos): Fix this shape inference function. It requires shape
     // inference of function calls.
     .SetShapeFn(shape_inference::UnknownShape)
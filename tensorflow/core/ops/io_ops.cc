@@ -63,6 +63,8 @@ REGISTER_OP("SaveV2")
     .Input("shape_and_slices: string")
     .Input("tensors: dtypes")
     .Attr("dtypes: list(type)")
+    .Attr("compression: string = ''")
+    .Attr("background_write: bool = false")
     .SetIsStateful()
     .SetShapeFn([](InferenceContext* c) {
       ShapeHandle unused;
@@ -89,6 +91,7 @@ REGISTER_OP("RestoreV2")
     .Input("shape_and_slices: string")
     .Output("tensors: dtypes")
     .Attr("dtypes: list(type)")
+    .Attr("use_mmap: bool = false")
     .SetIsStateful()
     .SetShapeFn([](InferenceContext* c) {
       ShapeHandle shape0, shape1, shape2;
@@ -147,6 +150,56 @@ REGISTER_OP("MergeV2Checkpoints")
       return absl::OkStatus();
     });
 
+REGISTER_OP("WaitForCheckpointWrites")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
+// --------------------------------------------------------------------------
+
+REGISTER_OP("_PagedBundleGather")
+    .Input("indices: Tindices")
+    .Output("output: dtype")
+    .Attr("dtype: type")
+    .Attr("Tindices: {int32,int64}")
+    .Attr("prefix: string")
+    .Attr("tensor_name: string")
+    .Attr("row_offset: int = 0")
+    .Attr("shape: shape")
+    .Attr("cache_bytes: int = 1073741824")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      PartialTensorShape shape;
+      TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
+      if (!shape.IsFullyDefined() || shape.dims() < 1) {
+        return errors::InvalidArgument(
+            "_PagedBundleGather requires a fully defined shape of rank >= 1, "
+            "got ",
+            shape.DebugString());
+      }
+      ShapeHandle params;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromPartialTensorShape(shape, &params));
+      ShapeHandle row;
+      TF_RETURN_IF_ERROR(c->Subshape(params, 1, &row));
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(c->Concatenate(c->input(0), row, &out));
+      c->set_output(0, out);
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Gathers rows of a variable that is read lazily from a checkpoint.
+
+Equivalent to a ResourceGather of the variable `tensor_name` with shape
+`shape`, after it was restored from the V2 checkpoint `prefix`. Instead of
+restoring the whole variable, the rows are read from the checkpoint when they
+are first looked up, in pages that are cached in a store shared by all the ops
+that read from `prefix`. The store keeps at most `cache_bytes` of pages. The
+variable is stored in rows [row_offset, row_offset + shape[0]) of the
+checkpoint tensor.
+
+*NOTE*: Do not invoke this operator directly in Python. It is created by the
+lazy restore of a SavedModel.
+)doc");
+
 REGISTER_OP("Save")
     .Input("filename: string")
     .Input("tensor_names: string")
@@ -1301,6 +1301,86 @@ REGISTER_OP("LogSoftmax")
 
 // --------------------------------------------------------------------------
 
+REGISTER_OP("_FusedScaledDotProductAttention")
+    .Input("query: T")
+    .Input("key: T")
+    .Input("value: T")
+    .Input("args: num_args * T")
+    .Output("output: T")
+    .Attr("T: {bfloat16, float}")
+    .Attr("num_args: int >= 0 = 0")
+    .Attr("scale: float = 1.0")
+    .Attr("is_causal: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle query;
+      ShapeHandle key;
+      ShapeHandle value;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(0), 2, &query));
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(1), 2, &key));
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(2), 2, &value));
+
+      int num_args;
+      TF_RETURN_IF_ERROR(c->GetAttr("num_args", &num_args));
+      if (num_args > 1) {
+        return errors::InvalidArgument(
+            "_FusedScaledDotProductAttention takes at most one mask, got ",
+            num_args);
+      }
+
+      if (!c->RankKnown(query)) {
+        c->set_output(0, c->UnknownShape());
+        return absl::OkStatus();
+      }
+      const int32_t rank = c->Rank(query);
+      TF_RETURN_IF_ERROR(c->WithRank(key, rank, &key));
+      TF_RETURN_IF_ERROR(c->WithRank(value, rank, &value));
+      if (num_args == 1) {
+        ShapeHandle mask;
+        TF_RETURN_IF_ERROR(c->WithRankAtMost(c->input(3), rank, &mask));
+      }
+
+      // query, key and value have the same batch dimensions. The depth of
+      // query and key, and the length of key and value must match.
+      ShapeHandle batch;
+      ShapeHandle batch_dims;
+      TF_RETURN_IF_ERROR(c->Subshape(query, 0, -2, &batch));
+      TF_RETURN_IF_ERROR(c->Subshape(key, 0, -2, &batch_dims));
+      TF_RETURN_IF_ERROR(c->Merge(batch, batch_dims, &batch));
+      TF_RETURN_IF_ERROR(c->Subshape(value, 0, -2, &batch_dims));
+      TF_RETURN_IF_ERROR(c->Merge(batch, batch_dims, &batch));
+
+      DimensionHandle unused;
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(query, -1), c->Dim(key, -1), &unused));
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(key, -2), c->Dim(value, -2), &unused));
+
+      ShapeHandle output;
+      TF_RETURN_IF_ERROR(c->Concatenate(
+          batch, c->Vector(c->Dim(query, -2)), &output));
+      TF_RETURN_IF_ERROR(
+          c->Concatenate(output, c->Vector(c->Dim(value, -1)), &output));
+      c->set_output(0, output);
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Computes softmax(scale * query * key^T + mask) * value.
+
+The inputs have shapes [..., query_length, depth] for `query`,
+[..., key_length, depth] for `key` and [..., key_length, value_depth] for
+`value`, with the same batch dimensions. The optional mask in `args` is added
+to the scores and must broadcast to [..., query_length, key_length]. If
+`is_causal` is true, query i attends only to the keys j <= i.
+
+The scores are computed in blocks with a running softmax, and are never
+materialized in full. bfloat16 inputs are accumulated in float.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
+// --------------------------------------------------------------------------
+
 REGISTER_OP("SoftmaxCrossEntropyWithLogits")
     .Input("features: T")
     .Input("labels: T")
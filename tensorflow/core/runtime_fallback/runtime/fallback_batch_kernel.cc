@@ -153,6 +153,15 @@ BatchFunctionFallbackKernelBase::BatchFunctionFallbackKernelBase(
         c, c->GetAttr("num_warmup_batch_threads", &num_warmup_batch_threads_));
   }
 
+  if (c->HasAttr("latency_slo_micros")) {
+    OP_REQUIRES_OK(c, c->GetAttr("latency_slo_micros", &latency_slo_micros_));
+  }
+
+  if (c->HasAttr("enable_zero_copy_batching")) {
+    OP_REQUIRES_OK(c, c->GetAttr("enable_zero_copy_batching",
+                                 &enable_zero_copy_batching_));
+  }
+
   // Helper function `SetAdaptiveBatchSchedulerOptions` calls
   // `OP_REQUIRES_OK`, which exits the current function upon error.
   // So validate status of `op-kernel-construction`.
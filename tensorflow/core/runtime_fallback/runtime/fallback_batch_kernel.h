@@ -93,6 +93,8 @@ class BatchFunctionFallbackKernelBase : public AsyncOpKernel {
   bool enable_priority_aware_batch_scheduler_resplit_ = false;
   bool enable_batching_task_lazy_cancellation_ = false;
   int32_t num_warmup_batch_threads_ = 0;
+  int64_t latency_slo_micros_ = serving::kLatencySloMicrosUnknown;
+  bool enable_zero_copy_batching_ = false;
 
   // Parameters for adaptive batch scheduler only.
   // Note 'num_batch_threads_' above is shared by two implementations of batch
@@ -206,6 +208,7 @@ void BatchFunctionFallbackKernel<BatchResourceType>::ComputeAsync(
           batch_timeout_micros_, max_enqueued_batches_, allowed_batch_sizes_,
           batch_function_, disable_padding_, &new_resource);
       if (!status.ok()) return status;
+      new_resource->set_zero_copy_batching(enable_zero_copy_batching_);
       if (c->session_metadata() != nullptr) {
         new_resource->set_session_metadata(*c->session_metadata());
       }
@@ -248,12 +251,14 @@ void BatchFunctionFallbackKernel<BatchResourceType>::ComputeAsync(
               /* op_name= */ c->op_kernel().name());
       model_batch_stats.SetBatchTimeoutMicros(batch_timeout_micros_);
       model_batch_stats.SetNumBatchThreads(num_batch_threads_);
+      model_batch_stats.SetLatencySloMicros(latency_slo_micros_);
 
       std::unique_ptr<BatchResourceType> new_resource;
       auto status = BatchResourceType::Create(
           c, batch_resource_options, batch_function_,
           enable_large_batch_splitting_, disable_padding_, &new_resource);
       if (!status.ok()) return status;
+      new_resource->set_zero_copy_batching(enable_zero_copy_batching_);
       if (c->session_metadata() != nullptr) {
         new_resource->set_session_metadata(*c->session_metadata());
       }
@@ -14,7 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/summary/summary_file_writer.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -32,6 +34,8 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/summary/summary_converter.h"
 #include "tensorflow/core/util/event.pb.h"
 #include "tensorflow/core/util/events_writer.h"
@@ -41,11 +45,12 @@ namespace {
 
 class SummaryFileWriter : public SummaryWriterInterface {
  public:
-  SummaryFileWriter(int max_queue, int flush_millis, Env* env)
+  SummaryFileWriter(int max_queue, int flush_millis, bool async, Env* env)
       : SummaryWriterInterface(),
         is_initialized_(false),
         max_queue_(max_queue),
         flush_millis_(flush_millis),
+        async_(async),
         env_(env) {}
 
   absl::Status Initialize(const std::string& logdir,
@@ -73,20 +78,47 @@ class SummaryFileWriter : public SummaryWriterInterface {
         "Could not initialize events writer.");
     last_flush_ = env_->NowMicros();
     is_initialized_ = true;
+    if (async_) {
+      writer_thread_.reset(env_->StartThread(ThreadOptions(),
+                                             "tf_summary_file_writer",
+                                             [this]() { WriteLoop(); }));
+    }
     return absl::OkStatus();
   }
 
   absl::Status Flush() override {
-    mutex_lock ml(mu_);
-    if (!is_initialized_) {
-      return absl::FailedPreconditionError(
-          "Class was not properly initialized.");
+    {
+      mutex_lock ml(mu_);
+      if (!is_initialized_) {
+        return absl::FailedPreconditionError(
+            "Class was not properly initialized.");
+      }
+      if (!async_) return InternalFlush();
+    }
+    // Waits for the writer thread to write and flush the events enqueued so
+    // far.
+    mutex_lock l(queue_mu_);
+    const int64_t num_events = num_enqueued_;
+    if (num_written_ < num_events) {
+      flush_requested_ = true;
+      queue_cv_.notify_all();
+      while (num_written_ < num_events) queue_cv_.wait(l);
     }
-    return InternalFlush();
+    return TakeWriteStatus();
   }
 
   ~SummaryFileWriter() override {
-    (void)Flush();  // Ignore errors.
+    if (writer_thread_ != nullptr) {
+      {
+        mutex_lock l(queue_mu_);
+        stop_ = true;
+        queue_cv_.notify_all();
+      }
+      // Joins the writer thread, which writes the remaining events first.
+      writer_thread_.reset();
+    } else {
+      (void)Flush();  // Ignore errors.
+    }
   }
 
   absl::Status WriteTensor(int64_t global_step, Tensor t,
@@ -163,6 +195,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
   }
 
   absl::Status WriteEvent(std::unique_ptr<Event> event) override {
+    if (async_) return EnqueueEvent(std::move(event));
     mutex_lock ml(mu_);
     queue_.emplace_back(std::move(event));
     if (queue_.size() > max_queue_ ||
@@ -179,6 +212,69 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
+  // Hands `event` to the writer thread. Blocks while the writer thread is
+  // behind by more than twice the queue size, which bounds the memory held by
+  // events waiting to be written.
+  absl::Status EnqueueEvent(std::unique_ptr<Event> event) {
+    mutex_lock l(queue_mu_);
+    const size_t capacity = 2 * (std::max(max_queue_, 0) + 1);
+    while (pending_.size() >= capacity && !stop_) queue_cv_.wait(l);
+    pending_.emplace_back(std::move(event));
+    ++num_enqueued_;
+    if (pending_.size() > max_queue_) queue_cv_.notify_all();
+    return TakeWriteStatus();
+  }
+
+  // Returns the first error of the writer thread since the last call, if any.
+  absl::Status TakeWriteStatus() TF_EXCLUSIVE_LOCKS_REQUIRED(queue_mu_) {
+    absl::Status status = std::move(write_status_);
+    write_status_ = absl::OkStatus();
+    return status;
+  }
+
+  // Runs on the writer thread of an async writer. Writes the pending events
+  // in batches, once more than max_queue_ events are pending, every
+  // flush_millis_ milliseconds, or when a flush is requested.
+  void WriteLoop() {
+    while (true) {
+      std::vector<std::unique_ptr<Event>> batch;
+      int64_t batch_end;
+      {
+        mutex_lock l(queue_mu_);
+        while (!stop_ && !flush_requested_ && pending_.size() <= max_queue_) {
+          if (pending_.empty()) {
+            queue_cv_.wait(l);
+            continue;
+          }
+          // Only the writer thread updates last_flush_ in async mode.
+          const uint64_t deadline =
+              last_flush_ + 1000 * static_cast<uint64_t>(flush_millis_);
+          const uint64_t now = env_->NowMicros();
+          if (now >= deadline) break;
+          queue_cv_.wait_for(l, std::chrono::microseconds(deadline - now));
+        }
+        if (stop_ && pending_.empty()) return;
+        batch.swap(pending_);
+        batch_end = num_enqueued_;
+        flush_requested_ = false;
+        // Makes room for blocked writers.
+        queue_cv_.notify_all();
+      }
+
+      absl::Status status;
+      {
+        mutex_lock ml(mu_);
+        queue_ = std::move(batch);
+        status = InternalFlush();
+      }
+
+      mutex_lock l(queue_mu_);
+      if (write_status_.ok()) write_status_ = status;
+      num_written_ = batch_end;
+      queue_cv_.notify_all();
+    }
+  }
+
   absl::Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     for (const std::unique_ptr<Event>& e : queue_) {
       events_writer_->WriteEvent(*e);
@@ -193,6 +289,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
   bool is_initialized_;
   const int max_queue_;
   const int flush_millis_;
+  const bool async_;
   uint64_t last_flush_;
   Env* env_;
   mutex mu_;
@@ -201,6 +298,20 @@ class SummaryFileWriter : public SummaryWriterInterface {
   std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(mu_);
   std::vector<std::pair<std::string, SummaryMetadata>> registered_summaries_
       TF_GUARDED_BY(mu_);
+
+  // State shared with the writer thread of an async writer.
+  mutex queue_mu_;
+  condition_variable queue_cv_;
+  // Events waiting for the writer thread.
+  std::vector<std::unique_ptr<Event>> pending_ TF_GUARDED_BY(queue_mu_);
+  // Number of events enqueued, and written and flushed, so far.
+  int64_t num_enqueued_ TF_GUARDED_BY(queue_mu_) = 0;
+  int64_t num_written_ TF_GUARDED_BY(queue_mu_) = 0;
+  bool flush_requested_ TF_GUARDED_BY(queue_mu_) = false;
+  bool stop_ TF_GUARDED_BY(queue_mu_) = false;
+  absl::Status write_status_ TF_GUARDED_BY(queue_mu_);
+  // Declared last so that it is joined before the state above is destroyed.
+  std::unique_ptr<Thread> writer_thread_;
 };
 
 }  // namespace
@@ -210,7 +321,17 @@ absl::Status CreateSummaryFileWriter(int max_queue, int flush_millis,
                                      const std::string& filename_suffix,
                                      Env* env,
                                      SummaryWriterInterface** result) {
-  SummaryFileWriter* w = new SummaryFileWriter(max_queue, flush_millis, env);
+  return CreateSummaryFileWriter(max_queue, flush_millis, /*async=*/false,
+                                 logdir, filename_suffix, env, result);
+}
+
+absl::Status CreateSummaryFileWriter(int max_queue, int flush_millis,
+                                     bool async, const std::string& logdir,
+                                     const std::string& filename_suffix,
+                                     Env* env,
+                                     SummaryWriterInterface** result) {
+  SummaryFileWriter* w =
+      new SummaryFileWriter(max_queue, flush_millis, async, env);
   const absl::Status s = w->Initialize(logdir, filename_suffix);
   if (!s.ok()) {
     w->Unref();
@@ -39,6 +39,21 @@ absl::Status CreateSummaryFileWriter(int max_queue, int flush_millis,
                                      const std::string& filename_suffix,
                                      Env* env, SummaryWriterInterface** result);
 
+/// \brief Creates SummaryWriterInterface which writes to a file, optionally
+/// on a background thread.
+///
+/// If `async` is true, the write calls only enqueue the events, and a writer
+/// thread serializes, writes and flushes them in batches: once more than
+/// max_queue events are pending, at least every flush_millis milliseconds, and
+/// on Flush(), which waits for the events enqueued before it. The write calls
+/// block while the writer thread is behind by about twice max_queue
+/// events. Errors of the writer thread are returned by the next write call or
+/// Flush(). Otherwise, the same as the above.
+absl::Status CreateSummaryFileWriter(int max_queue, int flush_millis,
+                                     bool async, const std::string& logdir,
+                                     const std::string& filename_suffix,
+                                     Env* env, SummaryWriterInterface** result);
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_SUMMARY_SUMMARY_FILE_WRITER_H_
@@ -295,5 +295,85 @@ TEST_F(SummaryFileWriterTest, AvoidFilenameCollision) {
       << "files = [" << absl::StrJoin(files, ", ") << "]";
 }
 
+// Returns the steps of the events in the file of test `test_name`, skipping
+// the leading file version event.
+std::vector<int64_t> ReadSteps(Env* env, const std::string& test_name) {
+  std::vector<std::string> files;
+  TF_CHECK_OK(env->GetChildren(testing::TmpDir(), &files));
+  std::vector<int64_t> steps;
+  for (const std::string& f : files) {
+    if (!absl::StrContains(f, test_name)) continue;
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(io::JoinPath(testing::TmpDir(), f),
+                                         &read_file));
+    io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+    tstring record;
+    uint64_t offset = 0;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    while (reader.ReadRecord(&offset, &record).ok()) {
+      Event e;
+      CHECK(e.ParseFromString(record));
+      steps.push_back(e.step());
+    }
+  }
+  return steps;
+}
+
+TEST_F(SummaryFileWriterTest, AsyncWriter) {
+  const std::string test_name = "async_writer_test";
+  SummaryWriterInterface* writer;
+  TF_CHECK_OK(CreateSummaryFileWriter(5, 100000, /*async=*/true,
+                                      testing::TmpDir(), test_name, &env_,
+                                      &writer));
+  std::vector<int64_t> expected_steps;
+  for (int64_t step = 0; step < 50; ++step) {
+    Tensor one(DT_FLOAT, TensorShape({}));
+    one.scalar<float>()() = 1.0;
+    TF_CHECK_OK(writer->WriteScalar(step, one, "name"));
+    expected_steps.push_back(step);
+  }
+  TF_CHECK_OK(writer->Flush());
+  EXPECT_EQ(ReadSteps(&env_, test_name), expected_steps);
+
+  // Pending events are written when the writer is destroyed.
+  for (int64_t step = 50; step < 53; ++step) {
+    std::unique_ptr<Event> e{new Event};
+    e->set_step(step);
+    TF_CHECK_OK(writer->WriteEvent(std::move(e)));
+    expected_steps.push_back(step);
+  }
+  writer->Unref();
+  EXPECT_EQ(ReadSteps(&env_, test_name), expected_steps);
+}
+
+TEST_F(SummaryFileWriterTest, AsyncWriterConcurrentWrites) {
+  const std::string test_name = "async_writer_concurrent_writes_test";
+  SummaryWriterInterface* writer;
+  TF_CHECK_OK(CreateSummaryFileWriter(1, 100000, /*async=*/true,
+                                      testing::TmpDir(), test_name, &env_,
+                                      &writer));
+  core::ScopedUnref deleter(writer);
+  constexpr int kNumThreads = 4;
+  constexpr int kStepsPerThread = 100;
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+      threads.emplace_back(env_.StartThread(
+          ThreadOptions(), "writer", [writer, i]() {
+            for (int j = 0; j < kStepsPerThread; ++j) {
+              std::unique_ptr<Event> e{new Event};
+              e->set_step(i * kStepsPerThread + j);
+              TF_CHECK_OK(writer->WriteEvent(std::move(e)));
+            }
+          }));
+    }
+  }
+  TF_CHECK_OK(writer->Flush());
+  std::vector<int64_t> steps = ReadSteps(&env_, test_name);
+  std::sort(steps.begin(), steps.end());
+  ASSERT_EQ(steps.size(), kNumThreads * kStepsPerThread);
+  for (int i = 0; i < steps.size(); ++i) EXPECT_EQ(steps[i], i);
+}
+
 }  // namespace
 }  // namespace tensorflow
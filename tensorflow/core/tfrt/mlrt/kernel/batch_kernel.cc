@@ -535,7 +535,8 @@ REGISTER_OP(kMlrtBatchFunctionName)
     // BatchFunction in core/ops/batch_ops.cc.
     .Attr(
         "batch_padding_policy: "
-        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST'} = 'PAD_UP'")
+        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST', "
+        "'MINIMIZE_LATENCY_PER_REQUEST'} = 'PAD_UP'")
     .Attr("Tin: list(type)")
     .Attr("Tcaptured: list(type) >= 0")
     .Attr("Tout: list(type)")
@@ -545,6 +546,8 @@ REGISTER_OP(kMlrtBatchFunctionName)
     .Attr("enable_priority_aware_batch_scheduler_resplit: bool = false")
     .Attr("enable_batching_task_lazy_cancellation: bool = false")
     .Attr("num_warmup_batch_threads: int = 0")
+    .Attr("latency_slo_micros: int = -1")
+    .Attr("enable_zero_copy_batching: bool = false")
     // An opaque function handle, which is an int64_t, for passing the batch
     // function.
     .Attr("opaque_function_handle: int")
@@ -15,8 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <utility>
 
@@ -24,6 +27,7 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "xla/tsl/lib/io/buffered_file.h"
 #include "xla/tsl/util/byte_swap_array.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -42,8 +46,10 @@ limitations under the License.
 #include "tensorflow/core/lib/io/table_builder.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/cord.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/random.h"
@@ -56,6 +62,11 @@ limitations under the License.
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_slice_util.h"
 
+#if !defined(IS_MOBILE_PLATFORM) && !defined(IS_SLIM_BUILD)
+// NOTE: The way zstd is packaged in TF, we cannot include it as <zstd.h>.
+#include "zstd.h"
+#endif  // !IS_MOBILE_PLATFORM && !IS_SLIM_BUILD
+
 #ifdef PLATFORM_WINDOWS
 #undef DeleteFile
 #endif
@@ -65,7 +76,9 @@ namespace tensorflow {
 // Versioning of the tensor bundle format.
 const int kTensorBundleMinProducer = 0;
 const int kTensorBundleMinConsumer = 0;
-const int kTensorBundleVersion = 1;
+const int kTensorBundleVersion = 3;
+const int kTensorBundleChunkedMinConsumer = 2;
+const int kTensorBundleCompressedMinConsumer = 3;
 
 // Size of our input buffer for streaming reads
 static const int kBufferSize = 1024 * 1024;
@@ -82,6 +95,12 @@ const int kMaxFileReadThreads = 8;
 // Minimum size of a file section handled by each thread.
 const int64_t kMinSectionSize = static_cast<int64_t>(1) << 31;
 
+// Uncompressed size of the independently compressed blocks of a tensor.
+const int64_t kCompressionBlockBytes = 4 << 20;
+// Number of threads shared by all bundles to compress or decompress blocks,
+// which is also the number of blocks held in memory at a time per tensor.
+const int kMaxCompressionThreads = 8;
+
 namespace {
 
 // Reads "num_elements" string elements from file[offset, offset+size) into the
@@ -433,11 +452,138 @@ absl::Status PadAlignment(tsl::BufferedWritableFile* out, int alignment,
   return status;
 }
 
+#if !defined(IS_MOBILE_PLATFORM) && !defined(IS_SLIM_BUILD)
+// Whether tensors of "dtype" are byte-shuffled before compression.  Grouping
+// the sign and exponent bytes of floating point values together makes them
+// compress much better.
+bool ShuffleBeforeCompression(DataType dtype) {
+  switch (dtype) {
+    case DT_HALF:
+    case DT_BFLOAT16:
+    case DT_FLOAT:
+    case DT_DOUBLE:
+    case DT_COMPLEX64:
+    case DT_COMPLEX128:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Groups the bytes of the "element_size"-byte elements of "input" by their
+// position within an element.
+void ShuffleBytes(absl::string_view input, int element_size, char* output) {
+  const size_t num_elements = input.size() / element_size;
+  for (size_t i = 0; i < num_elements; ++i) {
+    for (int j = 0; j < element_size; ++j) {
+      output[j * num_elements + i] = input[i * element_size + j];
+    }
+  }
+}
+
+// Inverse of ShuffleBytes().
+void UnshuffleBytes(absl::string_view input, int element_size, char* output) {
+  const size_t num_elements = input.size() / element_size;
+  for (size_t i = 0; i < num_elements; ++i) {
+    for (int j = 0; j < element_size; ++j) {
+      output[i * element_size + j] = input[j * num_elements + i];
+    }
+  }
+}
+
+// Runs "fn(i)" for every i in [0, n) on the threads shared by all bundles,
+// and waits for them to finish.
+void RunBlocks(int64_t n, const std::function<void(int64_t)>& fn) {
+  if (n == 1) {
+    fn(0);
+    return;
+  }
+  static thread::ThreadPool* const pool = new thread::ThreadPool(
+      Env::Default(), "tensor_bundle_compression", kMaxCompressionThreads);
+  BlockingCounter counter(n);
+  for (int64_t i = 0; i < n; ++i) {
+    pool->Schedule([&fn, &counter, i]() {
+      fn(i);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+}
+
+// Compresses the "num_blocks" blocks of "data", the contents of a tensor of
+// "dtype", starting at block "first_block" into "blocks".  Returns false if
+// zstd fails.
+bool CompressBlocks(absl::string_view data, DataType dtype, int level,
+                    int64_t first_block, int64_t num_blocks,
+                    std::vector<std::string>* blocks) {
+  const bool shuffle = ShuffleBeforeCompression(dtype);
+  const int element_size = DataTypeSize(dtype);
+  blocks->resize(num_blocks);
+  std::atomic<bool> failed(false);
+  RunBlocks(num_blocks, [&](int64_t i) {
+    absl::string_view block = data.substr(
+        (first_block + i) * kCompressionBlockBytes, kCompressionBlockBytes);
+    std::string shuffled;
+    if (shuffle) {
+      shuffled.resize(block.size());
+      ShuffleBytes(block, element_size, shuffled.data());
+      block = shuffled;
+    }
+    std::string& compressed = (*blocks)[i];
+    compressed.resize(ZSTD_compressBound(block.size()));
+    const size_t size = ZSTD_compress(compressed.data(), compressed.size(),
+                                      block.data(), block.size(), level);
+    if (ZSTD_isError(size)) {
+      failed = true;
+      return;
+    }
+    compressed.resize(size);
+  });
+  return !failed;
+}
+#endif  // !IS_MOBILE_PLATFORM && !IS_SLIM_BUILD
+
+// Identifies the contents of "chunk".
+std::string ChunkKey(const BundleChunkProto& chunk) {
+  return absl::StrCat(chunk.fingerprint_low(), ":", chunk.fingerprint_high(),
+                      ":", chunk.size(), ":", chunk.crc32c());
+}
+
+// A read-only tensor buffer that points into a memory-mapped data file and
+// keeps the mapping alive.  It never reports owning its memory, so the
+// runtime will not forward it to an op output or update it in place.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                     const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("mmap");
+  }
+  bool GetAllocatedBytes(size_t*) const override { return false; }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
 }  // namespace
 
 BundleWriter::BundleWriter(Env* env, absl::string_view prefix,
                            const Options& options)
-    : env_(env), options_(options), prefix_(prefix), out_(nullptr), size_(0) {
+    : env_(env),
+      options_(options),
+      prefix_(prefix),
+      out_(nullptr),
+      size_(0),
+      wrote_compressed_(false) {
   status_ = env_->HasAtomicMove(prefix_, &use_temp_file_);
   if (!status_.ok()) return;
 
@@ -479,6 +625,25 @@ absl::Status BundleWriter::Add(absl::string_view key, const Tensor& val) {
   entry->set_shard_id(0);
   entry->set_offset(size_);
 
+  if (options_.chunk_bytes > 0 && DataTypeCanUseMemcpy(val.dtype()) &&
+      val.TotalBytes() > 0) {
+    status_ = AddChunks(val.tensor_data(), entry);
+    if (status_.ok()) {
+      status_ = PadAlignment(out_.get(), options_.data_alignment, &size_);
+    }
+    return status_;
+  }
+
+#if !defined(IS_MOBILE_PLATFORM) && !defined(IS_SLIM_BUILD)
+  if (options_.compress && DataTypeCanUseMemcpy(val.dtype()) &&
+      val.TotalBytes() > 0 &&
+      val.TotalBytes() >= options_.min_compression_bytes) {
+    bool compressed = false;
+    status_ = AddCompressed(val.tensor_data(), val.dtype(), entry, &compressed);
+    if (!status_.ok() || compressed) return status_;
+  }
+#endif  // !IS_MOBILE_PLATFORM && !IS_SLIM_BUILD
+
   // Updates the data file.
   size_t data_bytes_written = 0;
   uint32_t crc32c = 0;
@@ -542,6 +707,105 @@ absl::Status BundleWriter::AddSlice(absl::string_view full_tensor_key,
   return status_;
 }
 
+#if !defined(IS_MOBILE_PLATFORM) && !defined(IS_SLIM_BUILD)
+absl::Status BundleWriter::AddCompressed(absl::string_view data,
+                                         DataType dtype,
+                                         BundleEntryProto* entry,
+                                         bool* compressed) {
+  *compressed = false;
+  const int64_t num_blocks =
+      (data.size() + kCompressionBlockBytes - 1) / kCompressionBlockBytes;
+  // Whether the tensor is worth compressing is judged on its first blocks, so
+  // that only a few compressed blocks are held in memory at a time.
+  std::vector<std::string> blocks;
+  int64_t batch_blocks = std::min<int64_t>(num_blocks, kMaxCompressionThreads);
+  if (!CompressBlocks(data, dtype, options_.compression_level, 0,
+                      batch_blocks, &blocks)) {
+    return absl::OkStatus();
+  }
+  const size_t batch_bytes =
+      std::min<size_t>(data.size(), batch_blocks * kCompressionBlockBytes);
+  size_t compressed_bytes = 0;
+  for (const std::string& block : blocks) compressed_bytes += block.size();
+  if (compressed_bytes > batch_bytes - batch_bytes / 8) {
+    return absl::OkStatus();
+  }
+
+  *compressed = true;
+  wrote_compressed_ = true;
+  entry->set_compression(ShuffleBeforeCompression(dtype)
+                             ? BundleEntryProto::ZSTD_BYTE_SHUFFLE
+                             : BundleEntryProto::ZSTD);
+  entry->set_compression_block_bytes(kCompressionBlockBytes);
+  for (int64_t first_block = 0;;) {
+    for (const std::string& block : blocks) {
+      TF_RETURN_IF_ERROR(out_->Append(block));
+      size_ += block.size();
+      entry->add_compressed_block_sizes(block.size());
+    }
+    first_block += batch_blocks;
+    if (first_block == num_blocks) break;
+    batch_blocks =
+        std::min<int64_t>(num_blocks - first_block, kMaxCompressionThreads);
+    if (!CompressBlocks(data, dtype, options_.compression_level, first_block,
+                        batch_blocks, &blocks)) {
+      return absl::InternalError(
+          absl::StrCat("Failed to compress bundle entry at offset ",
+                       entry->offset(), " of ", data_path_));
+    }
+  }
+  entry->set_size(data.size());
+  entry->set_crc32c(crc32c::Mask(crc32c::Value(data.data(), data.size())));
+  return PadAlignment(out_.get(), options_.data_alignment, &size_);
+}
+#endif  // !IS_MOBILE_PLATFORM && !IS_SLIM_BUILD
+
+absl::Status BundleWriter::AddChunks(absl::string_view data,
+                                     BundleEntryProto* entry) {
+  uint32_t crc32c = 0;
+  for (size_t start = 0; start < data.size(); start += options_.chunk_bytes) {
+    const absl::string_view piece = data.substr(start, options_.chunk_bytes);
+    crc32c = crc32c::Extend(crc32c, piece.data(), piece.size());
+    BundleChunkProto* chunk = entry->add_chunks();
+    chunk->set_size(piece.size());
+    chunk->set_crc32c(crc32c::Mask(crc32c::Value(piece.data(), piece.size())));
+    const Fprint128 fingerprint = Fingerprint128(piece);
+    chunk->set_fingerprint_low(fingerprint.low64);
+    chunk->set_fingerprint_high(fingerprint.high64);
+
+    // References identical contents instead of writing them again.
+    const std::string key = ChunkKey(*chunk);
+    const auto written = written_chunks_.find(key);
+    if (written != written_chunks_.end()) {
+      *chunk = written->second;
+      continue;
+    }
+    if (options_.base_chunks != nullptr) {
+      const BundleChunkProto* base_chunk = options_.base_chunks->Find(*chunk);
+      if (base_chunk != nullptr) {
+        const auto source = chunk_source_ids_.try_emplace(
+            base_chunk->source(), chunk_sources_.size() + 1);
+        if (source.second) {
+          chunk_sources_.push_back(
+              options_.base_chunks->sources()[base_chunk->source()]);
+        }
+        *chunk = *base_chunk;
+        chunk->set_source(source.first->second);
+        continue;
+      }
+    }
+
+    chunk->set_shard_id(0);
+    chunk->set_offset(size_);
+    TF_RETURN_IF_ERROR(out_->Append(piece));
+    size_ += piece.size();
+    written_chunks_.emplace(key, *chunk);
+  }
+  entry->set_size(data.size());
+  entry->set_crc32c(crc32c::Mask(crc32c));
+  return absl::OkStatus();
+}
+
 // TODO(zongheng): on metadata write failure or !status_.ok(), consider removing
 // the orphaned data file.
 absl::Status BundleWriter::Finish() {
@@ -575,7 +839,17 @@ absl::Status BundleWriter::Finish() {
     if (!port::kLittleEndian) header.set_endianness(BundleHeaderProto::BIG);
     VersionDef* version = header.mutable_version();
     version->set_producer(kTensorBundleVersion);
-    version->set_min_consumer(kTensorBundleMinConsumer);
+    int min_consumer = kTensorBundleMinConsumer;
+    if (options_.chunk_bytes > 0) {
+      min_consumer = std::max(min_consumer, kTensorBundleChunkedMinConsumer);
+    }
+    if (wrote_compressed_) {
+      min_consumer = std::max(min_consumer, kTensorBundleCompressedMinConsumer);
+    }
+    version->set_min_consumer(min_consumer);
+    for (const BundleChunkSourceProto& source : chunk_sources_) {
+      *header.add_chunk_sources() = source;
+    }
 
     builder.Add(kHeaderEntryKey, header.SerializeAsString());
 
@@ -615,6 +889,10 @@ struct MergeState {
   std::map<std::string, BundleEntryProto> entries;
   // Data file path -> new shard id in the final merged bundle.
   std::unordered_map<std::string, int32_t> shard_ids;
+
+  // Bundles referenced by chunks, and their positions in "chunk_sources".
+  std::vector<BundleChunkSourceProto> chunk_sources;
+  std::unordered_map<std::string, int32_t> chunk_source_ids;
 };
 
 // Merges entries of "prefix" into the accumulator state "merge".
@@ -635,6 +913,8 @@ static absl::Status MergeOneBundle(Env* env, absl::string_view prefix,
   std::unique_ptr<table::Iterator> iter(table->NewIterator());
 
   int num_shards;
+  // Chunk source in this bundle -> chunk source in the merged bundle.
+  std::vector<int32_t> source_ids;
   // Process header.
   {
     iter->Seek(kHeaderEntryKey);
@@ -657,17 +937,39 @@ static absl::Status MergeOneBundle(Env* env, absl::string_view prefix,
         return absl::InvalidArgumentError(
             "Merging bundles with conflicting endianness; inputs corrupted?");
       }
-      // Validates "version".
+      // Validates "version".  Bundles written together may differ only in
+      // "min_consumer", e.g. when only some of them hold compressed entries,
+      // and the merged bundle requires the largest one.
+      VersionDef curr = header.version();
+      curr.set_min_consumer(merge_state->version.min_consumer());
       std::string curr_version, merge_version;
-      header.version().SerializeToString(&curr_version);
+      curr.SerializeToString(&curr_version);
       merge_state->version.SerializeToString(&merge_version);
       if (curr_version != merge_version) {
+        header.version().SerializeToString(&curr_version);
         return absl::InvalidArgumentError(absl::StrCat(
             "Merging bundles with different format versions: merged ",
             merge_version, " vs. curr ", curr_version));
       }
+      merge_state->version.set_min_consumer(
+          std::max(merge_state->version.min_consumer(),
+                   header.version().min_consumer()));
     }
     num_shards = header.num_shards();
+
+    // Every data file is kept, even if only chunks of other bundles refer to
+    // it, so that the merged shard count matches the renamed files.
+    for (int i = 0; i < num_shards; ++i) {
+      merge_state->shard_ids.insert({DataFilename(prefix, i, num_shards),
+                                     merge_state->shard_ids.size()});
+    }
+    source_ids.push_back(0);
+    for (const BundleChunkSourceProto& source : header.chunk_sources()) {
+      const auto result = merge_state->chunk_source_ids.insert(
+          {source.prefix(), merge_state->chunk_sources.size() + 1});
+      if (result.second) merge_state->chunk_sources.push_back(source);
+      source_ids.push_back(result.first->second);
+    }
     iter->Next();
   }
 
@@ -713,6 +1015,21 @@ static absl::Status MergeOneBundle(Env* env, absl::string_view prefix,
         {DataFilename(prefix, to_merge_entry.shard_id(), num_shards),
          merge_state->shard_ids.size()});
     to_merge_entry.set_shard_id(result.first->second);
+    for (BundleChunkProto& chunk : *to_merge_entry.mutable_chunks()) {
+      if (chunk.source() < 0 || chunk.source() >= source_ids.size()) {
+        return absl::DataLossError(absl::StrCat(
+            "Invalid chunk source ", chunk.source(), " for tensor keyed by ",
+            key, " when merging prefix: ", prefix));
+      }
+      if (chunk.source() == 0) {
+        result = merge_state->shard_ids.insert(
+            {DataFilename(prefix, chunk.shard_id(), num_shards),
+             merge_state->shard_ids.size()});
+        chunk.set_shard_id(result.first->second);
+      } else {
+        chunk.set_source(source_ids[chunk.source()]);
+      }
+    }
     merge_state->entries[key] = to_merge_entry;
   }
   return absl::OkStatus();
@@ -761,6 +1078,9 @@ absl::Status MergeBundles(Env* env, absl::Span<const tstring> prefixes,
     header.set_num_shards(merge.num_shards);
     header.set_endianness(merge.endianness);
     *header.mutable_version() = merge.version;
+    for (const BundleChunkSourceProto& source : merge.chunk_sources) {
+      *header.add_chunk_sources() = source;
+    }
     builder.Add(kHeaderEntryKey, header.SerializeAsString());
     // All others.
     for (const auto& p : merge.entries) {
@@ -779,6 +1099,228 @@ absl::Status MergeBundles(Env* env, absl::Span<const tstring> prefixes,
   return status;
 }
 
+// Interface for writing a bundle in parallel.
+
+ShardedBundleWriter::ShardedBundleWriter(Env* env, absl::string_view prefix,
+                                         const Options& options)
+    : env_(env), options_(options), prefix_(prefix) {}
+
+absl::Status ShardedBundleWriter::Add(absl::string_view key,
+                                      const Tensor& val) {
+  if (!status_.ok()) return status_;
+  CHECK_NE(key, kHeaderEntryKey);
+  if (!keys_.insert(std::string(key)).second) {
+    status_ =
+        absl::InvalidArgumentError(absl::StrCat("Adding duplicate key: ", key));
+    return status_;
+  }
+  entries_.push_back({std::string(key), val, std::nullopt, val.shape()});
+  return absl::OkStatus();
+}
+
+absl::Status ShardedBundleWriter::AddSlice(absl::string_view full_tensor_key,
+                                           const TensorShape& full_tensor_shape,
+                                           const TensorSlice& slice_spec,
+                                           const Tensor& slice_tensor) {
+  if (!status_.ok()) return status_;
+  CHECK_NE(full_tensor_key, kHeaderEntryKey);
+  if (IsFullSlice(slice_spec, full_tensor_shape)) {
+    return Add(full_tensor_key, slice_tensor);
+  }
+  const std::string slice_key = checkpoint::EncodeTensorNameSlice(
+      std::string(full_tensor_key), slice_spec);
+  if (!keys_.insert(slice_key).second) {
+    status_ = absl::InvalidArgumentError(
+        absl::StrCat("Adding duplicate slice: ", slice_key));
+    return status_;
+  }
+  entries_.push_back({std::string(full_tensor_key), slice_tensor, slice_spec,
+                      full_tensor_shape});
+  return absl::OkStatus();
+}
+
+absl::Status ShardedBundleWriter::WriteShard(
+    const std::string& prefix, const std::vector<const Entry*>& entries) {
+  BundleWriter writer(env_, prefix, options_.writer_options);
+  for (const Entry* entry : entries) {
+    if (entry->slice_spec.has_value()) {
+      TF_RETURN_IF_ERROR(writer.AddSlice(entry->key, entry->full_shape,
+                                         *entry->slice_spec, entry->tensor));
+    } else {
+      TF_RETURN_IF_ERROR(writer.Add(entry->key, entry->tensor));
+    }
+  }
+  return writer.Finish();
+}
+
+absl::Status ShardedBundleWriter::Finish() {
+  if (!status_.ok()) return status_;
+  status_ = absl::InternalError("ShardedBundleWriter is closed");
+
+  int64_t total_bytes = 0;
+  for (const Entry& entry : entries_) {
+    total_bytes += entry.tensor.TotalBytes();
+  }
+  const int64_t num_shards =
+      std::min<int64_t>(options_.max_num_shards,
+                        total_bytes / std::max<int64_t>(
+                                          options_.min_shard_bytes, 1));
+  if (num_shards < 2) {
+    std::vector<const Entry*> entries;
+    entries.reserve(entries_.size());
+    for (const Entry& entry : entries_) entries.push_back(&entry);
+    return WriteShard(prefix_, entries);
+  }
+
+  // Assigns the largest remaining entry to the least loaded shard.  An entry
+  // larger than a shard's share keeps its shard to itself while other shards
+  // are left.
+  const int64_t shard_bytes = (total_bytes + num_shards - 1) / num_shards;
+  std::vector<const Entry*> sorted_entries;
+  sorted_entries.reserve(entries_.size());
+  for (const Entry& entry : entries_) sorted_entries.push_back(&entry);
+  std::stable_sort(sorted_entries.begin(), sorted_entries.end(),
+                   [](const Entry* a, const Entry* b) {
+                     return a->tensor.TotalBytes() > b->tensor.TotalBytes();
+                   });
+  std::vector<std::vector<const Entry*>> shards(num_shards);
+  std::vector<int64_t> shard_sizes(num_shards, 0);
+  std::vector<bool> shard_is_full(num_shards, false);
+  for (const Entry* entry : sorted_entries) {
+    int64_t shard = -1;
+    for (int64_t i = 0; i < num_shards; ++i) {
+      if (!shard_is_full[i] &&
+          (shard < 0 || shard_sizes[i] < shard_sizes[shard])) {
+        shard = i;
+      }
+    }
+    if (shard < 0) {
+      shard = std::min_element(shard_sizes.begin(), shard_sizes.end()) -
+              shard_sizes.begin();
+    }
+    shards[shard].push_back(entry);
+    shard_sizes[shard] += entry->tensor.TotalBytes();
+    if (entry->tensor.TotalBytes() >= shard_bytes) shard_is_full[shard] = true;
+  }
+  // Drops the shards that received no tensors.
+  shards.erase(std::remove_if(shards.begin(), shards.end(),
+                              [](const std::vector<const Entry*>& shard) {
+                                return shard.empty();
+                              }),
+               shards.end());
+
+  std::vector<tstring> shard_prefixes(shards.size());
+  std::vector<absl::Status> statuses(shards.size());
+  {
+    thread::ThreadPool writer_pool(env_, "save_tensors", shards.size());
+    for (int i = 0; i < shards.size(); ++i) {
+      shard_prefixes[i] = absl::StrCat(prefix_, "_temp_shard_", i);
+      writer_pool.Schedule([this, i, &shards, &shard_prefixes, &statuses]() {
+        statuses[i] = WriteShard(shard_prefixes[i], shards[i]);
+      });
+    }
+  }
+  absl::Status status;
+  for (const absl::Status& shard_status : statuses) {
+    status.Update(shard_status);
+  }
+  if (status.ok()) status = MergeBundles(env_, shard_prefixes, prefix_);
+  if (!status.ok()) {
+    // Cleanup: best effort based and ignores errors.
+    for (const tstring& shard_prefix : shard_prefixes) {
+      env_->DeleteFile(DataFilename(shard_prefix, 0, 1)).IgnoreError();
+      env_->DeleteFile(MetaFilename(shard_prefix)).IgnoreError();
+    }
+  }
+  return status;
+}
+
+// Chunks of earlier bundles.
+
+// Checks that the data files of the bundles referenced by the chunks of the
+// bundle at "prefix" still exist.  They may have been deleted since it was
+// written, e.g. by the retention policy of a checkpoint manager.
+static absl::Status CheckChunkSources(Env* env, absl::string_view prefix,
+                                      const BundleHeaderProto& header) {
+  for (const BundleChunkSourceProto& source : header.chunk_sources()) {
+    for (int i = 0; i < source.num_shards(); ++i) {
+      const std::string data_file =
+          DataFilename(source.prefix(), i, source.num_shards());
+      if (!env->FileExists(data_file).ok()) {
+        return absl::FailedPreconditionError(absl::StrCat(
+            "Checkpoint ", prefix, " references chunks of checkpoint ",
+            source.prefix(), ", whose data file ", data_file,
+            " is missing.  The data files of every checkpoint referenced by "
+            "a chunked checkpoint must be kept for as long as it is used."));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BundleChunkIndex::Load(
+    Env* env, absl::string_view prefix,
+    std::shared_ptr<const BundleChunkIndex>* index) {
+  const std::string filename = MetaFilename(prefix);
+  uint64_t file_size;
+  TF_RETURN_IF_ERROR(env->GetFileSize(filename, &file_size));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+
+  table::Table* table = nullptr;
+  TF_RETURN_IF_ERROR(
+      table::Table::Open(TableBuilderOptions(), file.get(), file_size, &table));
+  std::unique_ptr<table::Table> table_deleter(table);
+  std::unique_ptr<table::Iterator> iter(table->NewIterator());
+
+  iter->Seek(kHeaderEntryKey);
+  if (!iter->Valid()) {
+    return CorruptFileError(iter->status(), filename,
+                            "failed to seek to header entry");
+  }
+  BundleHeaderProto header;
+  absl::Status s = ParseEntryProto(iter->key(), iter->value(), &header);
+  if (!s.ok()) return CorruptFileError(s, filename, "unable to parse header");
+  TF_RETURN_IF_ERROR(CheckVersions(header.version(), kTensorBundleVersion,
+                                   kTensorBundleMinProducer, "Checkpoint",
+                                   "checkpoint"));
+  TF_RETURN_IF_ERROR(CheckChunkSources(env, prefix, header));
+
+  std::shared_ptr<BundleChunkIndex> result(new BundleChunkIndex());
+  BundleChunkSourceProto* self = &result->sources_.emplace_back();
+  self->set_prefix(std::string(prefix));
+  self->set_num_shards(header.num_shards());
+  result->sources_.insert(result->sources_.end(),
+                          header.chunk_sources().begin(),
+                          header.chunk_sources().end());
+
+  // Chunks are only shared between bundles of the same byte order.
+  if ((header.endianness() == BundleHeaderProto::LITTLE) ==
+      port::kLittleEndian) {
+    BundleEntryProto entry;
+    for (iter->Next(); iter->Valid(); iter->Next()) {
+      TF_RETURN_IF_ERROR(ParseEntryProto(iter->key(), iter->value(), &entry));
+      for (const BundleChunkProto& chunk : entry.chunks()) {
+        if (chunk.source() < 0 || chunk.source() >= result->sources_.size()) {
+          return CorruptFileError(
+              absl::OkStatus(), filename,
+              absl::StrCat("invalid chunk source for key ", iter->key()));
+        }
+        result->chunks_.try_emplace(ChunkKey(chunk), chunk);
+      }
+    }
+    TF_RETURN_IF_ERROR(iter->status());
+  }
+  *index = std::move(result);
+  return absl::OkStatus();
+}
+
+const BundleChunkProto* BundleChunkIndex::Find(
+    const BundleChunkProto& chunk) const {
+  const auto it = chunks_.find(ChunkKey(chunk));
+  return it == chunks_.end() ? nullptr : &it->second;
+}
+
 // Interface for reading a tensor bundle.
 
 BundleReader::BundleReader(
@@ -795,6 +1337,7 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
       table_(nullptr),
       index_cache_(nullptr),
       iter_(nullptr),
+      use_mmap_(options.use_mmap),
       need_to_swap_bytes_(false),
       enable_multi_threading_for_testing_(
           options.enable_multi_threading_for_testing) {
@@ -842,6 +1385,8 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
     return;
   }
   num_shards_ = header.num_shards();
+  chunk_sources_.assign(header.chunk_sources().begin(),
+                        header.chunk_sources().end());
   if ((header.endianness() == BundleHeaderProto::BIG && port::kLittleEndian) ||
       (header.endianness() == BundleHeaderProto::LITTLE &&
        !port::kLittleEndian)) {
@@ -849,6 +1394,8 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
   }
   status_ = CheckVersions(header.version(), kTensorBundleVersion,
                           kTensorBundleMinProducer, "Checkpoint", "checkpoint");
+  if (!status_.ok()) return;
+  status_ = CheckChunkSources(env_, prefix_, header);
 }
 
 BundleReader::~BundleReader() {
@@ -893,6 +1440,16 @@ absl::Status BundleReader::GetBundleEntryProto(absl::string_view key,
 
 absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
                                     Tensor* val) {
+  if (!entry.chunks().empty()) return GetChunkedValue(entry, val);
+  if (entry.compression() != BundleEntryProto::NO_COMPRESSION) {
+    return GetCompressedValue(entry, val);
+  }
+  if (use_mmap_) {
+    bool mapped = false;
+    TF_RETURN_IF_ERROR(GetMappedValue(entry, val, &mapped));
+    if (mapped) return absl::OkStatus();
+  }
+
   Tensor* ret = val;
   const TensorShape stored_shape(TensorShape(entry.shape()));
   if (val->NumElements() == 0) {
@@ -1035,6 +1592,245 @@ absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
   return absl::OkStatus();
 }
 
+absl::Status BundleReader::GetChunkedValue(const BundleEntryProto& entry,
+                                           Tensor* val) {
+  if (!DataTypeCanUseMemcpy(entry.dtype())) {
+    return absl::DataLossError(
+        absl::StrCat("Chunked bundle entry of unsupported dtype ",
+                     DataTypeString(entry.dtype()), ": key ", key()));
+  }
+  Tensor ret = *val;
+  if (val->NumElements() == 0) {
+    ret = Tensor(entry.dtype(), TensorShape(entry.shape()));
+  }
+  if (entry.size() != ret.TotalBytes()) {
+    return absl::DataLossError(absl::StrCat(
+        "Invalid size in bundle entry: key ", key(), "; stored size ",
+        entry.size(), "; expected size ", ret.TotalBytes()));
+  }
+
+  char* backing_buffer = GetBackingBuffer(ret);
+  int64_t position = 0;
+  for (const BundleChunkProto& chunk : entry.chunks()) {
+    if (chunk.size() < 0 || chunk.size() > entry.size() - position) {
+      return absl::DataLossError(absl::StrCat(
+          "Chunks of bundle entry exceed its size: key ", key()));
+    }
+    std::string filename;
+    if (chunk.source() == 0) {
+      filename = DataFilename(prefix_, chunk.shard_id(), num_shards_);
+    } else if (chunk.source() > 0 && chunk.source() <= chunk_sources_.size()) {
+      const BundleChunkSourceProto& source = chunk_sources_[chunk.source() - 1];
+      filename =
+          DataFilename(source.prefix(), chunk.shard_id(), source.num_shards());
+    } else {
+      return absl::DataLossError(absl::StrCat(
+          "Invalid chunk source ", chunk.source(), ": key ", key()));
+    }
+    RandomAccessFile* file = nullptr;
+    TF_RETURN_IF_ERROR(cache_->GetFile(filename, &file));
+    char* chunk_buffer = backing_buffer + position;
+    absl::string_view sp;
+    TF_RETURN_IF_ERROR(file->Read(chunk.offset(), sp,
+                                  absl::MakeSpan(chunk_buffer, chunk.size())));
+    if (sp.data() != chunk_buffer) {
+      memmove(chunk_buffer, sp.data(), chunk.size());
+    }
+    position += chunk.size();
+  }
+  if (position != entry.size()) {
+    return absl::DataLossError(absl::StrCat(
+        "Chunks of bundle entry do not cover its size: key ", key()));
+  }
+
+  const uint32_t actual_crc32c = crc32c::Value(backing_buffer, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return absl::DataLossError(absl::StrCat(
+        "TensorBundle at ", prefix_, " (", entry.size(),
+        " bytes in chunks): Checksum does not match: stored ",
+        absl::StrFormat("%08u", crc32c::Unmask(entry.crc32c())),
+        " vs. calculated on the restored bytes ", actual_crc32c));
+  }
+  if (need_to_swap_bytes_) {
+    TF_RETURN_IF_ERROR(ByteSwapTensor(&ret));
+  }
+  *val = ret;
+  return absl::OkStatus();
+}
+
+absl::Status BundleReader::GetCompressedValue(const BundleEntryProto& entry,
+                                              Tensor* val) {
+#if defined(IS_MOBILE_PLATFORM) || defined(IS_SLIM_BUILD)
+  return absl::UnimplementedError(absl::StrCat(
+      "Compressed bundle entries are not supported on this platform: key ",
+      key()));
+#else
+  if (!DataTypeCanUseMemcpy(entry.dtype()) ||
+      (entry.compression() != BundleEntryProto::ZSTD &&
+       entry.compression() != BundleEntryProto::ZSTD_BYTE_SHUFFLE)) {
+    return absl::DataLossError(absl::StrCat(
+        "Unsupported compression ", entry.compression(), " of ",
+        DataTypeString(entry.dtype()), " bundle entry: key ", key()));
+  }
+  Tensor ret = *val;
+  if (val->NumElements() == 0) {
+    ret = Tensor(entry.dtype(), TensorShape(entry.shape()));
+  }
+  if (entry.size() != ret.TotalBytes()) {
+    return absl::DataLossError(absl::StrCat(
+        "Invalid size in bundle entry: key ", key(), "; stored size ",
+        entry.size(), "; expected size ", ret.TotalBytes()));
+  }
+  const int element_size = DataTypeSize(entry.dtype());
+  const int64_t block_bytes = entry.compression_block_bytes();
+  const int64_t num_blocks = entry.compressed_block_sizes_size();
+  if (block_bytes <= 0 || block_bytes % element_size != 0 ||
+      num_blocks != (entry.size() + block_bytes - 1) / block_bytes) {
+    return absl::DataLossError(absl::StrCat(
+        "Invalid compressed blocks in bundle entry: key ", key()));
+  }
+  std::vector<int64_t> block_offsets(num_blocks + 1, 0);
+  for (int64_t i = 0; i < num_blocks; ++i) {
+    if (entry.compressed_block_sizes(i) < 0) {
+      return absl::DataLossError(absl::StrCat(
+          "Invalid compressed blocks in bundle entry: key ", key()));
+    }
+    block_offsets[i + 1] = block_offsets[i] + entry.compressed_block_sizes(i);
+  }
+
+  RandomAccessFile* file = nullptr;
+  TF_RETURN_IF_ERROR(cache_->GetFile(
+      DataFilename(prefix_, entry.shard_id(), num_shards_), &file));
+
+  // Reads and decompresses a few blocks at a time, so that only their
+  // compressed bytes are held in memory besides the restored tensor.
+  char* backing_buffer = GetBackingBuffer(ret);
+  const bool shuffle =
+      entry.compression() == BundleEntryProto::ZSTD_BYTE_SHUFFLE;
+  std::string compressed;
+  for (int64_t first_block = 0; first_block < num_blocks;
+       first_block += kMaxCompressionThreads) {
+    const int64_t batch_blocks =
+        std::min<int64_t>(num_blocks - first_block, kMaxCompressionThreads);
+    const int64_t batch_offset = block_offsets[first_block];
+    compressed.resize(block_offsets[first_block + batch_blocks] -
+                      batch_offset);
+    absl::string_view sp;
+    TF_RETURN_IF_ERROR(
+        file->Read(entry.offset() + batch_offset, sp,
+                   absl::MakeSpan(compressed.data(), compressed.size())));
+    std::vector<absl::Status> statuses(batch_blocks);
+    RunBlocks(batch_blocks, [&](int64_t j) {
+      const int64_t i = first_block + j;
+      const int64_t start = i * block_bytes;
+      const size_t size = std::min<int64_t>(block_bytes, entry.size() - start);
+      std::string shuffled;
+      char* output = backing_buffer + start;
+      if (shuffle) {
+        shuffled.resize(size);
+        output = shuffled.data();
+      }
+      const size_t decompressed = ZSTD_decompress(
+          output, size, sp.data() + block_offsets[i] - batch_offset,
+          entry.compressed_block_sizes(i));
+      if (ZSTD_isError(decompressed) || decompressed != size) {
+        statuses[j] = absl::DataLossError(absl::StrCat(
+            "TensorBundle at ", prefix_, " shard ", entry.shard_id(),
+            ": Failed to decompress block ", i, " of ", num_blocks, ": ",
+            ZSTD_isError(decompressed) ? ZSTD_getErrorName(decompressed)
+                                       : "unexpected size"));
+        return;
+      }
+      if (shuffle) {
+        UnshuffleBytes(shuffled, element_size, backing_buffer + start);
+      }
+    });
+    for (const absl::Status& status : statuses) {
+      TF_RETURN_IF_ERROR(status);
+    }
+  }
+
+  const uint32_t actual_crc32c = crc32c::Value(backing_buffer, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return absl::DataLossError(absl::StrCat(
+        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
+        entry.size(), " bytes compressed to ", block_offsets.back(),
+        "): Checksum does not match: stored ",
+        absl::StrFormat("%08u", crc32c::Unmask(entry.crc32c())),
+        " vs. calculated on the restored bytes ", actual_crc32c));
+  }
+  if (need_to_swap_bytes_) {
+    TF_RETURN_IF_ERROR(ByteSwapTensor(&ret));
+  }
+  *val = ret;
+  return absl::OkStatus();
+#endif  // IS_MOBILE_PLATFORM || IS_SLIM_BUILD
+}
+
+absl::Status BundleReader::GetMappedValue(const BundleEntryProto& entry,
+                                          Tensor* val, bool* mapped) {
+  *mapped = false;
+  const TensorShape stored_shape(entry.shape());
+  if (!DataTypeCanUseMemcpy(entry.dtype()) || need_to_swap_bytes_ ||
+      entry.size() == 0) {
+    return absl::OkStatus();
+  }
+  if (val->NumElements() != 0 &&
+      (val->dtype() != entry.dtype() || val->shape() != stored_shape)) {
+    return absl::OkStatus();
+  }
+  // Leaves reporting malformed entries to the regular read path.
+  if (entry.size() !=
+      stored_shape.num_elements() * DataTypeSize(entry.dtype())) {
+    return absl::OkStatus();
+  }
+
+  // Map the data file if it has not been tried yet.  Filesystems without
+  // mmap support fall back to regular reads for the rest of this reader.
+  auto it = mapped_data_.find(entry.shard_id());
+  if (it == mapped_data_.end()) {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    absl::Status status = env_->NewReadOnlyMemoryRegionFromFile(
+        DataFilename(prefix_, entry.shard_id(), num_shards_), &region);
+    if (!status.ok()) {
+      VLOG(1) << "Not memory-mapping shard " << entry.shard_id() << " of "
+              << prefix_ << ": " << status;
+    }
+    it = mapped_data_.emplace(entry.shard_id(), std::move(region)).first;
+  }
+  const std::shared_ptr<ReadOnlyMemoryRegion>& region = it->second;
+  if (region == nullptr) return absl::OkStatus();
+
+  // Leaves reporting truncated data files to the regular read path too.
+  const uint64_t length = region->length();
+  if (entry.offset() < 0 || entry.offset() > length ||
+      entry.size() > length - entry.offset()) {
+    return absl::OkStatus();
+  }
+  const char* data = static_cast<const char*>(region->data()) + entry.offset();
+#if EIGEN_MAX_ALIGN_BYTES > 0
+  // Tensors assume their buffers are aligned for vectorized access.
+  if (reinterpret_cast<intptr_t>(data) % EIGEN_MAX_ALIGN_BYTES != 0) {
+    return absl::OkStatus();
+  }
+#endif
+
+  const uint32_t actual_crc32c = crc32c::Value(data, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return absl::DataLossError(absl::StrCat(
+        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
+        entry.size(), " bytes): Checksum does not match: stored ",
+        absl::StrFormat("%08u", crc32c::Unmask(entry.crc32c())),
+        " vs. calculated on the restored bytes ", actual_crc32c));
+  }
+
+  auto* buf = new MappedTensorBuffer(region, data, entry.size());
+  *val = Tensor(entry.dtype(), stored_shape, buf);
+  buf->Unref();
+  *mapped = true;
+  return absl::OkStatus();
+}
+
 absl::Status BundleReader::Lookup(absl::string_view key, Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1049,6 +1845,23 @@ absl::Status BundleReader::Lookup(absl::string_view key, Tensor* val) {
   }
 }
 
+absl::Status BundleReader::LookupMapped(absl::string_view key, Tensor* val,
+                                        bool* mapped) {
+  CHECK(val != nullptr);
+  *mapped = false;
+  if (!use_mmap_) return absl::OkStatus();
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  if (!entry.slices().empty() || !entry.chunks().empty() ||
+      entry.compression() != BundleEntryProto::NO_COMPRESSION) {
+    return absl::OkStatus();
+  }
+  Tensor mapped_val;
+  TF_RETURN_IF_ERROR(GetMappedValue(entry, &mapped_val, mapped));
+  if (*mapped) *val = std::move(mapped_val);
+  return absl::OkStatus();
+}
+
 absl::Status BundleReader::ReadCurrent(Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1089,6 +1902,106 @@ absl::Status BundleReader::LookupSlice(absl::string_view full_tensor_key,
   return GetSliceValue(full_tensor_key, entry, slice_spec, val);
 }
 
+absl::Status BundleReader::LookupRows(absl::string_view key, int64_t start_row,
+                                      int64_t num_rows, Tensor* val) {
+  CHECK(val != nullptr);
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  const TensorShape full_shape(entry.shape());
+  if (full_shape.dims() == 0 || start_row < 0 || num_rows < 0 ||
+      start_row > full_shape.dim_size(0) - num_rows) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Rows [", start_row, ", ", start_row + num_rows, ") are out of range ",
+        "for tensor ", key, " of shape ", full_shape.DebugString()));
+  }
+  TensorShape rows_shape = full_shape;
+  rows_shape.set_dim(0, num_rows);
+  *val = Tensor(entry.dtype(), rows_shape);
+  if (entry.slices().empty()) {
+    return GetRowsValue(entry, start_row, num_rows, val);
+  }
+
+  // Reads the requested rows of every stored slice that holds some of them
+  // straight into their place in "val", so that rows spanning several slices
+  // do not read those slices in full.  Stored slices do not overlap.
+  const int64_t end_row = start_row + num_rows;
+  int64_t rows_read = 0;
+  for (const TensorSliceProto& slice_proto : entry.slices()) {
+    const TensorSlice stored_slice(slice_proto);
+    const int64_t slice_start = stored_slice.start(0);
+    const int64_t slice_end = stored_slice.IsFullAt(0)
+                                  ? full_shape.dim_size(0)
+                                  : stored_slice.end(0);
+    const int64_t begin = std::max(start_row, slice_start);
+    const int64_t end = std::min(end_row, slice_end);
+    if (begin >= end) continue;
+    for (int d = 1; d < full_shape.dims(); ++d) {
+      if (!stored_slice.IsFullAt(d)) {
+        return absl::UnimplementedError(absl::StrCat(
+            "Can not read rows of tensor ", key, " from stored slice ",
+            stored_slice.DebugString(), ", which does not hold whole rows"));
+      }
+    }
+    BundleEntryProto stored_slice_entry;
+    TF_RETURN_IF_ERROR(GetBundleEntryProto(
+        checkpoint::EncodeTensorNameSlice(std::string(key), stored_slice),
+        &stored_slice_entry));
+    Tensor rows = val->Slice(begin - start_row, end - start_row);
+    TF_RETURN_IF_ERROR(GetRowsValue(stored_slice_entry, begin - slice_start,
+                                    end - begin, &rows));
+    rows_read += end - begin;
+  }
+  if (rows_read != num_rows) {
+    return absl::NotFoundError(absl::StrCat(
+        "Rows [", start_row, ", ", end_row, ") of tensor ", key,
+        " are not all stored in the checkpoint"));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BundleReader::GetRowsValue(const BundleEntryProto& entry,
+                                        int64_t start_row, int64_t num_rows,
+                                        Tensor* val) {
+  if (!DataTypeCanUseMemcpy(entry.dtype()) || !entry.chunks().empty() ||
+      entry.compression() != BundleEntryProto::NO_COMPRESSION) {
+    return absl::UnimplementedError(absl::StrCat(
+        "Can not read rows of ", DataTypeString(entry.dtype()),
+        " bundle entry ", key(),
+        "; only unchunked, uncompressed entries of fixed-size dtypes"));
+  }
+  const TensorShape stored_shape(entry.shape());
+  if (entry.size() !=
+      stored_shape.num_elements() * DataTypeSize(entry.dtype())) {
+    return absl::DataLossError(absl::StrCat(
+        "Invalid size in bundle entry: key ", key(), "; stored size ",
+        entry.size(), "; expected size ",
+        stored_shape.num_elements() * DataTypeSize(entry.dtype())));
+  }
+  if (num_rows == 0 || val->TotalBytes() == 0) return absl::OkStatus();
+  const int64_t row_bytes = entry.size() / stored_shape.dim_size(0);
+
+  RandomAccessFile* file = nullptr;
+  TF_RETURN_IF_ERROR(cache_->GetFile(
+      DataFilename(prefix_, entry.shard_id(), num_shards_), &file));
+  char* backing_buffer = const_cast<char*>(val->tensor_data().data());
+  absl::string_view sp;
+  TF_RETURN_IF_ERROR(
+      file->Read(entry.offset() + start_row * row_bytes, sp,
+                 absl::MakeSpan(backing_buffer, num_rows * row_bytes)));
+  if (sp.size() != num_rows * row_bytes) {
+    return absl::DataLossError(absl::StrCat(
+        "TensorBundle at ", prefix_, " shard ", entry.shard_id(),
+        ": truncated data for key ", key()));
+  }
+  if (sp.data() != backing_buffer) {
+    memmove(backing_buffer, sp.data(), sp.size());
+  }
+  if (need_to_swap_bytes_) {
+    TF_RETURN_IF_ERROR(ByteSwapTensor(val));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status BundleReader::GetSliceValue(
     absl::string_view full_tensor_key,
     const BundleEntryProto& full_tensor_entry, const TensorSlice& slice_spec,
@@ -64,6 +64,7 @@ limitations under the License.
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -71,6 +72,7 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/base/call_once.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
@@ -102,14 +104,22 @@ namespace tensorflow {
 // History:
 // 0. Any tensor bundles produced before this field was added.
 // 1. Added this field (2016-09-14).
+// 2. Added chunked tensor contents (2026-10-19).
+// 3. Added compressed tensor contents (2026-10-19).
 extern const int kTensorBundleMinProducer;
 extern const int kTensorBundleMinConsumer;
 extern const int kTensorBundleVersion;
+// Minimum consumer version of bundles that store chunked tensor contents.
+extern const int kTensorBundleChunkedMinConsumer;
+// Minimum consumer version of bundles that store compressed tensor contents.
+extern const int kTensorBundleCompressedMinConsumer;
 
 // The empty string, hence always the first key in the metadata table.  Its
 // corresponding value is a BundleHeaderProto.
 extern const char* const kHeaderEntryKey;
 
+class BundleChunkIndex;
+
 // Builds a string-string table of tensor names to BundleEntryProto (metadata).
 //
 // On construction, attempts to create a directory given by the dirname of
@@ -123,6 +133,33 @@ class BundleWriter {
     // Alignment, in bytes, for tensor data.
     // Must be >= 1. The default size of 1 densely packs tensors.
     int data_alignment{1};
+
+    // If positive, the contents of memcpy-able tensors are stored as chunks
+    // of at most this many bytes, identified by their fingerprints.  A chunk
+    // whose contents were already written to this bundle, or are found in
+    // "base_chunks", is referenced instead of being written again.
+    //
+    // Such bundles can only be read by readers of format version
+    // kTensorBundleChunkedMinConsumer or above.
+    int64_t chunk_bytes{0};
+
+    // Chunks of earlier bundles that may be referenced.  The data files of
+    // those bundles must be kept for as long as this bundle is read.
+    std::shared_ptr<const BundleChunkIndex> base_chunks;
+
+    // If true, the contents of memcpy-able tensors of at least
+    // "min_compression_bytes" are compressed with zstd at
+    // "compression_level", in blocks that are compressed and decompressed in
+    // parallel.  Floating point tensors are byte-shuffled first.  Tensors
+    // whose first blocks compress by less than an eighth, and chunked
+    // tensors, are stored as is.  Compression is not available on mobile
+    // platforms, where tensors are always stored as is.
+    //
+    // Bundles that hold compressed tensors can only be read by readers of
+    // format version kTensorBundleCompressedMinConsumer or above.
+    bool compress{false};
+    int64_t min_compression_bytes{64 << 10};
+    int compression_level{1};
   };
   BundleWriter(Env* env, absl::string_view prefix,
                const Options& options = Options());
@@ -158,6 +195,14 @@ class BundleWriter {
   absl::Status status() const { return status_; }
 
  private:
+  // Stores "data" as the chunks of "entry", writing only new chunks.
+  absl::Status AddChunks(absl::string_view data, BundleEntryProto* entry);
+  // Stores "data", the contents of a tensor of "dtype", as the compressed
+  // blocks of "entry" and sets "*compressed", unless it does not compress
+  // well enough, in which case nothing is written.
+  absl::Status AddCompressed(absl::string_view data, DataType dtype,
+                             BundleEntryProto* entry, bool* compressed);
+
   Env* const env_;  // Not owned.
   const Options options_;
   const std::string prefix_;
@@ -168,6 +213,15 @@ class BundleWriter {
   int64_t size_;  // Number of bytes written into out_.
   std::map<std::string, BundleEntryProto> entries_;
   absl::Status status_;
+  // Whether any entry was stored compressed.
+  bool wrote_compressed_;
+
+  // Chunks written to this bundle, keyed by their contents.
+  absl::flat_hash_map<std::string, BundleChunkProto> written_chunks_;
+  // Bundles referenced by chunks, in the order of the header's
+  // "chunk_sources", and the position of each source of "base_chunks" there.
+  std::vector<BundleChunkSourceProto> chunk_sources_;
+  absl::flat_hash_map<int, int> chunk_source_ids_;
 
   BundleWriter(const BundleWriter&) = delete;
   void operator=(const BundleWriter&) = delete;
@@ -199,6 +253,116 @@ absl::Status MergeBundles(Env* env, absl::Span<const tstring> prefixes,
                           absl::string_view merged_prefix,
                           bool allow_missing_files = false);
 
+// Writes a bundle whose data is spread over several data files that are
+// written concurrently, then merged into a single bundle under "prefix".
+// The result is an ordinary multi-shard bundle that BundleReader can read.
+//
+// Add() and AddSlice() only record the tensors, which must stay unmodified
+// until Finish() writes them.  Small bundles are written to one data file,
+// exactly as BundleWriter would.  Otherwise whole tensors are balanced across
+// up to "max_num_shards" files, and each tensor larger than a shard's share
+// gets a file of its own.  Tensors are never split, so that they can still be
+// memory-mapped and read by rows.  As a consequence, writing a bundle takes at
+// least as long as writing its largest tensor to a single file: bundles
+// dominated by one tensor (e.g. an embedding table) gain little from sharding,
+// as BM_ShardedBundleWriterSkewed shows.
+//
+// If a data file fails to be written, the files already written for the other
+// data files are deleted.
+//
+// All threads accessing the same ShardedBundleWriter must synchronize.
+class ShardedBundleWriter {
+ public:
+  struct Options {
+    Options() {}
+    // Options for the writer of each data file.
+    BundleWriter::Options writer_options;
+    // Upper bound on the number of data files written in parallel.
+    int max_num_shards = 16;
+    // Minimum number of tensor bytes per data file.  Bundles smaller than
+    // twice this size are written to a single data file.
+    int64_t min_shard_bytes = 64 << 20;
+  };
+  ShardedBundleWriter(Env* env, absl::string_view prefix,
+                      const Options& options = Options());
+
+  // Same contracts as BundleWriter::Add() and BundleWriter::AddSlice().
+  absl::Status Add(absl::string_view key, const Tensor& val);
+  absl::Status AddSlice(absl::string_view full_tensor_key,
+                        const TensorShape& full_tensor_shape,
+                        const TensorSlice& slice_spec,
+                        const Tensor& slice_tensor);
+
+  // Writes all recorded tensors and the merged metadata.
+  absl::Status Finish();
+
+  absl::Status status() const { return status_; }
+
+ private:
+  // A recorded Add() or, if "slice_spec" is set, AddSlice() call.
+  struct Entry {
+    std::string key;
+    Tensor tensor;
+    std::optional<TensorSlice> slice_spec;
+    TensorShape full_shape;
+  };
+
+  // Writes "entries" as a single-shard bundle under "prefix".
+  absl::Status WriteShard(const std::string& prefix,
+                          const std::vector<const Entry*>& entries);
+
+  Env* const env_;  // Not owned.
+  const Options options_;
+  const std::string prefix_;
+  std::vector<Entry> entries_;
+  // Keys and encoded slice keys added so far, to reject duplicates early.
+  absl::flat_hash_set<std::string> keys_;
+  absl::Status status_;
+
+  ShardedBundleWriter(const ShardedBundleWriter&) = delete;
+  void operator=(const ShardedBundleWriter&) = delete;
+};
+
+// The chunks stored by a bundle written with BundleWriter::Options::chunk_bytes
+// set, including those it references in earlier bundles.  Passed as the
+// "base_chunks" of a BundleWriter, it lets the new bundle reference every
+// chunk whose contents did not change, so that a chain of checkpoints each
+// based on the previous one only writes what changed in between.
+//
+// References are not chained: a chunk is always referenced in the bundle that
+// first wrote it, which for a chunk that never changes is the oldest bundle of
+// the chain.  Every later bundle thus depends on the data files of all the
+// bundles listed in its sources(), not only on those of its base, and deleting
+// an old bundle (e.g. once it falls out of a checkpoint manager's
+// "max_to_keep") breaks them all.  BundleReader and Load() fail on a bundle
+// whose sources are missing data files.
+//
+// Thread-safe once loaded.
+class BundleChunkIndex {
+ public:
+  // Reads the chunk index of the bundle at "prefix".  Bundles without chunks,
+  // or of the other endianness, have an empty index.
+  static absl::Status Load(Env* env, absl::string_view prefix,
+                           std::shared_ptr<const BundleChunkIndex>* index);
+
+  // Returns a chunk with the same size, checksum and fingerprint as "chunk",
+  // or nullptr.  The "source" of the returned chunk indexes sources().
+  const BundleChunkProto* Find(const BundleChunkProto& chunk) const;
+
+  // The bundles holding the indexed chunks; the first is the loaded bundle.
+  const std::vector<BundleChunkSourceProto>& sources() const {
+    return sources_;
+  }
+
+  size_t size() const { return chunks_.size(); }
+
+ private:
+  BundleChunkIndex() = default;
+
+  std::vector<BundleChunkSourceProto> sources_;
+  absl::flat_hash_map<std::string, BundleChunkProto> chunks_;
+};
+
 class BundleCache;
 
 // On construction, silently attempts to read the metadata associated with
@@ -217,6 +381,17 @@ class BundleReader {
 
     // For tests only.
     bool enable_multi_threading_for_testing = false;
+
+    // If true, data files are memory-mapped where the filesystem supports it,
+    // and Lookup() returns tensors that share the mapped bytes instead of
+    // copying them.  This applies to memcpy-able dtypes whose stored data is
+    // suitably aligned and needs no byte swapping; other tensors are read as
+    // usual.  A caller-allocated "val" is replaced rather than filled in.
+    //
+    // The returned buffers are read-only and never forwarded, so ops that
+    // want to modify them (e.g. variable updates) copy first.  The data files
+    // must not be modified or truncated while such tensors are alive.
+    bool use_mmap = false;
   };
   BundleReader(Env* env, absl::string_view prefix, Options options);
 
@@ -268,6 +443,17 @@ class BundleReader {
   // REQUIRES: status().ok()
   absl::Status Lookup(absl::string_view key, Tensor* val);
 
+  // Looks up the tensor keyed by "key" as a tensor backed by the
+  // memory-mapped data file, so that callers need not allocate a buffer for
+  // it.  Sets "*mapped" to whether it could; otherwise "val" is left as is and
+  // the tensor must be read with Lookup().  Tensors are only mapped if
+  // Options::use_mmap is set and they are stored whole, uncompressed and not
+  // chunked.
+  //
+  // Validates the stored crc32c checksum against the mapped bytes.
+  // REQUIRES: status().ok()
+  absl::Status LookupMapped(absl::string_view key, Tensor* val, bool* mapped);
+
   // Looks up the tensor pointed to by the internal iterator.
   //
   // On error, "val" may contain nonsense data.
@@ -293,6 +479,20 @@ class BundleReader {
   absl::Status LookupSlice(absl::string_view full_tensor_key,
                            const TensorSlice& slice_spec, Tensor* val);
 
+  // Looks up rows [start_row, start_row + num_rows) of the tensor keyed by
+  // "key", i.e. a slice along its first dimension, and replaces "val" with
+  // them.  Only the bytes of those rows are read, so the stored checksum,
+  // which covers the whole tensor, is not verified.
+  //
+  // Tensors partitioned along their first dimension are supported; rows that
+  // span several stored slices are assembled from the rows read from each of
+  // them.  Returns an Unimplemented error for entries whose rows can not be
+  // read on their own: strings, variants, chunked or compressed contents, and
+  // stored slices that do not hold whole rows.
+  // REQUIRES: status().ok()
+  absl::Status LookupRows(absl::string_view key, int64_t start_row,
+                          int64_t num_rows, Tensor* val);
+
   // Seeks to the first position in the bundle whose key is no less than "key".
   // REQUIRES: status().ok()
   void Seek(absl::string_view key) { return iter_->Seek(key); }
@@ -323,6 +523,24 @@ class BundleReader {
   // Usage for "val" follows the comment of "Lookup()".
   absl::Status GetValue(const BundleEntryProto& entry, Tensor* val);
 
+  // Reads the value of "entry" from the chunks that make up its contents.
+  // REQUIRES: entry.chunks_size() > 0
+  absl::Status GetChunkedValue(const BundleEntryProto& entry, Tensor* val);
+
+  // Reads and decompresses the value of "entry".
+  // REQUIRES: entry.compression() != BundleEntryProto::NO_COMPRESSION
+  absl::Status GetCompressedValue(const BundleEntryProto& entry, Tensor* val);
+
+  // Points "val" at the mapped bytes of "entry" if possible.  Sets "*mapped"
+  // to false, leaving "val" untouched, if the entry must be read instead.
+  absl::Status GetMappedValue(const BundleEntryProto& entry, Tensor* val,
+                              bool* mapped);
+
+  // Reads rows [start_row, start_row + num_rows) of the tensor stored in
+  // "entry" into "val", which has the shape of those rows.
+  absl::Status GetRowsValue(const BundleEntryProto& entry, int64_t start_row,
+                            int64_t num_rows, Tensor* val);
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -344,6 +562,12 @@ class BundleReader {
   // Owned InputBuffer objects. cache_ owns the underlying RandomAccessFiles.
   std::unordered_map<int32_t, io::InputBuffer*> data_;
 
+  // Memory-mapped data files, shared with the tensors that point into them.
+  // Holds nullptr for shards that could not be mapped.
+  bool use_mmap_ = false;
+  std::unordered_map<int32_t, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
+
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
   std::unordered_map<std::string, checkpoint::TensorSliceSet*> tensor_slices_;
@@ -352,6 +576,9 @@ class BundleReader {
   // the header entry in the metadata table.
   int num_shards_;
 
+  // Other bundles holding chunks of this bundle's tensors, from the header.
+  std::vector<BundleChunkSourceProto> chunk_sources_;
+
   // Flag that this class sets to true when the endianness of the target bundle
   // differs from that of the current system's processor architecture.
   bool need_to_swap_bytes_;
@@ -1153,6 +1153,516 @@ TEST(TensorBundleTest, LargeVariableLoadingTest) {
   }
 }
 
+TEST(TensorBundleTest, MemoryMappedLookup) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = 64;
+    BundleWriter writer(Env::Default(), Prefix("mmap"), opts);
+    TF_EXPECT_OK(writer.Add("float", Constant_100x100<float>(1.5)));
+    TF_EXPECT_OK(writer.Add("int64", Constant_2x3<int64_t>(7)));
+    TF_EXPECT_OK(writer.Add("string", test::AsTensor<tstring>({"a", "b"})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader::Options options;
+  options.use_mmap = true;
+  Tensor outlives_reader;
+  {
+    BundleReader reader(Env::Default(), Prefix("mmap"), options);
+    TF_ASSERT_OK(reader.status());
+    // Caller-allocated tensors are replaced by mapped ones, which are never
+    // forwarded and so never written to.
+    Tensor val(DT_FLOAT, TensorShape({100, 100}));
+    TF_ASSERT_OK(reader.Lookup("float", &val));
+    test::ExpectTensorEqual<float>(val, Constant_100x100<float>(1.5));
+    EXPECT_FALSE(val.RefCountIsOne());
+
+    TF_ASSERT_OK(reader.Lookup("int64", &outlives_reader));
+    EXPECT_FALSE(outlives_reader.RefCountIsOne());
+
+    // Strings are read as usual.
+    Tensor strings;
+    TF_ASSERT_OK(reader.Lookup("string", &strings));
+    test::ExpectTensorEqual<tstring>(strings,
+                                     test::AsTensor<tstring>({"a", "b"}));
+
+    // LookupMapped only returns mapped tensors.
+    Tensor mapped_val;
+    bool mapped = false;
+    TF_ASSERT_OK(reader.LookupMapped("float", &mapped_val, &mapped));
+    EXPECT_TRUE(mapped);
+    test::ExpectTensorEqual<float>(mapped_val, Constant_100x100<float>(1.5));
+    EXPECT_FALSE(mapped_val.RefCountIsOne());
+    Tensor not_mapped;
+    TF_ASSERT_OK(reader.LookupMapped("string", &not_mapped, &mapped));
+    EXPECT_FALSE(mapped);
+    EXPECT_EQ(not_mapped.NumElements(), 0);
+  }
+  test::ExpectTensorEqual<int64_t>(outlives_reader, Constant_2x3<int64_t>(7));
+}
+
+TEST(TensorBundleTest, MemoryMappedLookupFallsBackWhenUnaligned) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("mmap_unaligned"));
+    TF_EXPECT_OK(writer.Add("aligned", Constant_2x3<float>(1)));
+    TF_EXPECT_OK(writer.Add("unaligned", Constant_2x3<float>(2)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader::Options options;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mmap_unaligned"), options);
+  TF_ASSERT_OK(reader.status());
+  Tensor aligned;
+  TF_ASSERT_OK(reader.Lookup("aligned", &aligned));
+  test::ExpectTensorEqual<float>(aligned, Constant_2x3<float>(1));
+  EXPECT_FALSE(aligned.RefCountIsOne());
+  Tensor unaligned;
+  TF_ASSERT_OK(reader.Lookup("unaligned", &unaligned));
+  test::ExpectTensorEqual<float>(unaligned, Constant_2x3<float>(2));
+  EXPECT_TRUE(unaligned.RefCountIsOne());
+}
+
+TEST(TensorBundleTest, MemoryMappedLookupChecksum) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("mmap_checksum"));
+    TF_EXPECT_OK(writer.Add("foo", Constant_2x3<float>(1)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  const std::string datafile = DataFilename(Prefix("mmap_checksum"), 0, 1);
+  std::string data;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), datafile, &data));
+  data[0] = ~data[0];
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), datafile, data));
+
+  BundleReader::Options options;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mmap_checksum"), options);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  absl::Status status = reader.Lookup("foo", &val);
+  EXPECT_TRUE(absl::IsDataLoss(status));
+  EXPECT_TRUE(absl::StrContains(status.ToString(), "Checksum does not match"));
+}
+
+TEST(TensorBundleTest, LookupRows) {
+  const TensorShape kFullShape({6, 2});
+  Tensor full(DT_FLOAT, kFullShape);
+  test::FillIota<float>(&full, 0);
+  {
+    BundleWriter writer(Env::Default(), Prefix("rows"));
+    TF_EXPECT_OK(writer.Add("full", full));
+    // Rows 0-3 and 4-5 stored as separate slices.
+    TF_EXPECT_OK(writer.AddSlice("sliced", kFullShape,
+                                 TensorSlice::ParseOrDie("0,4:-"),
+                                 full.Slice(0, 4)));
+    TF_EXPECT_OK(writer.AddSlice("sliced", kFullShape,
+                                 TensorSlice::ParseOrDie("4,2:-"),
+                                 full.Slice(4, 6)));
+    // Columns 0 and 1 stored as separate slices.
+    TF_EXPECT_OK(writer.AddSlice("columns", kFullShape,
+                                 TensorSlice::ParseOrDie("-:0,1"),
+                                 Constant<float>(0, TensorShape({6, 1}))));
+    TF_EXPECT_OK(writer.AddSlice("columns", kFullShape,
+                                 TensorSlice::ParseOrDie("-:1,1"),
+                                 Constant<float>(1, TensorShape({6, 1}))));
+    TF_EXPECT_OK(writer.Add("string", test::AsTensor<tstring>({"a", "b"})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader reader(Env::Default(), Prefix("rows"));
+  TF_ASSERT_OK(reader.status());
+  for (const char* key : {"full", "sliced"}) {
+    for (int64_t start = 0; start < 6; ++start) {
+      for (int64_t num_rows = 0; start + num_rows <= 6; ++num_rows) {
+        Tensor val;
+        TF_ASSERT_OK(reader.LookupRows(key, start, num_rows, &val))
+            << key << " " << start << " " << num_rows;
+        test::ExpectTensorEqual<float>(val,
+                                       full.Slice(start, start + num_rows));
+      }
+    }
+  }
+  Tensor val;
+  EXPECT_TRUE(absl::IsInvalidArgument(reader.LookupRows("full", 5, 2, &val)));
+  EXPECT_TRUE(absl::IsUnimplemented(reader.LookupRows("string", 0, 1, &val)));
+  EXPECT_TRUE(absl::IsUnimplemented(reader.LookupRows("columns", 0, 1, &val)));
+  EXPECT_TRUE(absl::IsNotFound(reader.LookupRows("missing", 0, 1, &val)));
+}
+
+TEST(ShardedBundleWriterTest, SmallBundleIsSingleShard) {
+  {
+    ShardedBundleWriter writer(Env::Default(), Prefix("sharded_small"));
+    TF_EXPECT_OK(writer.Add("foo", Constant_2x3<float>(1)));
+    TF_EXPECT_OK(writer.Add("bar", test::AsTensor<tstring>({"a", "b"})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  TF_EXPECT_OK(Env::Default()->FileExists(
+      DataFilename(Prefix("sharded_small"), 0, 1)));
+  BundleReader reader(Env::Default(), Prefix("sharded_small"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "foo", Constant_2x3<float>(1));
+  Expect<tstring>(&reader, "bar", test::AsTensor<tstring>({"a", "b"}));
+}
+
+TEST(ShardedBundleWriterTest, DuplicateKeys) {
+  ShardedBundleWriter writer(Env::Default(), Prefix("sharded_duplicate"));
+  TF_EXPECT_OK(writer.Add("foo", Constant_2x3<float>(1)));
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      writer.Add("foo", Constant_2x3<float>(2))));
+  EXPECT_TRUE(absl::IsInvalidArgument(writer.Finish()));
+}
+
+BundleEntryProto GetEntry(BundleReader* reader, const std::string& key) {
+  BundleEntryProto entry;
+  reader->Seek(key);
+  CHECK(reader->Valid() && reader->key() == key);
+  CHECK(entry.ParseFromString(reader->value()));
+  return entry;
+}
+
+TEST(ShardedBundleWriterTest, WritesShardsInParallel) {
+  ShardedBundleWriter::Options options;
+  options.max_num_shards = 4;
+  options.min_shard_bytes = 1 << 10;
+  const Tensor big = test::AsTensor<float>(
+      std::vector<float>(1 << 12, 0), TensorShape({1 << 8, 1 << 4}));
+  {
+    ShardedBundleWriter writer(Env::Default(), Prefix("sharded"), options);
+    for (int i = 0; i < 10; ++i) {
+      TF_EXPECT_OK(writer.Add(absl::StrCat("small_", i),
+                              Constant(static_cast<float>(i),
+                                       TensorShape({16, 16}))));
+    }
+    TF_EXPECT_OK(writer.Add("big", big));
+    TF_EXPECT_OK(writer.Add("strings", test::AsTensor<tstring>({"a", "b"})));
+    // A partitioned variable, as in PartitionedVariables.
+    TF_EXPECT_OK(writer.AddSlice("partitioned", TensorShape({2, 3}),
+                                 TensorSlice::ParseOrDie("0,1:-"),
+                                 Constant(1.f, TensorShape({1, 3}))));
+    TF_EXPECT_OK(writer.AddSlice("partitioned", TensorShape({2, 3}),
+                                 TensorSlice::ParseOrDie("1,1:-"),
+                                 Constant(2.f, TensorShape({1, 3}))));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  for (int i = 0; i < 4; ++i) {
+    TF_EXPECT_OK(
+        Env::Default()->FileExists(DataFilename(Prefix("sharded"), i, 4)));
+    EXPECT_FALSE(Env::Default()
+                     ->FileExists(MetaFilename(
+                         absl::StrCat(Prefix("sharded"), "_temp_shard_", i)))
+                     .ok());
+  }
+
+  BundleReader reader(Env::Default(), Prefix("sharded"));
+  TF_ASSERT_OK(reader.status());
+  for (int i = 0; i < 10; ++i) {
+    Expect<float>(&reader, absl::StrCat("small_", i),
+                  Constant(static_cast<float>(i), TensorShape({16, 16})));
+  }
+  Expect<tstring>(&reader, "strings", test::AsTensor<tstring>({"a", "b"}));
+  Expect<float>(&reader, "partitioned",
+                test::AsTensor<float>({1, 1, 1, 2, 2, 2}, TensorShape({2, 3})));
+  // The big tensor exceeds a shard's share, so it is stored whole in a data
+  // file of its own.
+  Expect<float>(&reader, "big", big);
+  std::vector<TensorSlice> slices;
+  TF_ASSERT_OK(reader.LookupTensorSlices("big", &slices));
+  EXPECT_TRUE(slices.empty());
+  const int big_shard = GetEntry(&reader, "big").shard_id();
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_NE(GetEntry(&reader, absl::StrCat("small_", i)).shard_id(),
+              big_shard);
+  }
+}
+
+TEST(ShardedBundleWriterTest, DeletesShardsOnFailure) {
+  ShardedBundleWriter::Options options;
+  options.max_num_shards = 4;
+  options.min_shard_bytes = 1 << 10;
+  const std::string prefix = Prefix("sharded_failure");
+  auto shard_prefix = [&prefix](int i) {
+    return absl::StrCat(prefix, "_temp_shard_", i);
+  };
+  // The metadata of the last shard can not be written over a directory.
+  TF_ASSERT_OK(
+      Env::Default()->RecursivelyCreateDir(MetaFilename(shard_prefix(3))));
+  ShardedBundleWriter writer(Env::Default(), prefix, options);
+  for (int i = 0; i < 4; ++i) {
+    TF_EXPECT_OK(writer.Add(absl::StrCat("tensor_", i),
+                            Constant(static_cast<float>(i),
+                                     TensorShape({16, 16}))));
+  }
+  EXPECT_FALSE(writer.Finish().ok());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_FALSE(
+        Env::Default()->FileExists(DataFilename(shard_prefix(i), 0, 1)).ok());
+    if (i < 3) {
+      EXPECT_FALSE(
+          Env::Default()->FileExists(MetaFilename(shard_prefix(i))).ok());
+    }
+  }
+  EXPECT_FALSE(Env::Default()->FileExists(MetaFilename(prefix)).ok());
+}
+
+uint64_t DataFileSize(const std::string& prefix) {
+  uint64_t size = 0;
+  TF_CHECK_OK(Env::Default()->GetFileSize(DataFilename(prefix, 0, 1), &size));
+  return size;
+}
+
+TEST(ChunkedBundleTest, IdenticalChunksAreWrittenOnce) {
+  BundleWriter::Options options;
+  options.chunk_bytes = 64;
+  {
+    BundleWriter writer(Env::Default(), Prefix("chunked_zeros"), options);
+    TF_EXPECT_OK(writer.Add("a", Constant(0.f, TensorShape({64}))));
+    TF_EXPECT_OK(writer.Add("b", Constant(0.f, TensorShape({16}))));
+    TF_EXPECT_OK(writer.Add("c", test::AsTensor<tstring>({"x"})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader reader(Env::Default(), Prefix("chunked_zeros"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "a", Constant(0.f, TensorShape({64})));
+  Expect<float>(&reader, "b", Constant(0.f, TensorShape({16})));
+  Expect<tstring>(&reader, "c", test::AsTensor<tstring>({"x"}));
+
+  BundleHeaderProto header;
+  reader.Seek(kHeaderEntryKey);
+  ASSERT_TRUE(header.ParseFromString(reader.value()));
+  EXPECT_EQ(kTensorBundleChunkedMinConsumer, header.version().min_consumer());
+  // One 64-byte chunk of zeros and the string tensor.
+  EXPECT_LT(DataFileSize(Prefix("chunked_zeros")), 2 * 64);
+}
+
+TEST(ChunkedBundleTest, IncrementalCheckpoints) {
+  std::vector<float> values(64);
+  for (int i = 0; i < values.size(); ++i) values[i] = i;
+  const Tensor frozen = test::AsTensor<float>(values);
+  for (int i = 0; i < values.size(); ++i) values[i] = -i - 1;
+  Tensor changing = test::AsTensor<float>(values);
+
+  BundleWriter::Options options;
+  options.chunk_bytes = 64;
+  const std::vector<std::string> prefixes = {
+      Prefix("incremental-0"), Prefix("incremental-1"),
+      Prefix("incremental-2")};
+  std::vector<Tensor> changing_values;
+  for (int step = 0; step < prefixes.size(); ++step) {
+    if (step > 0) {
+      TF_ASSERT_OK(BundleChunkIndex::Load(Env::Default(), prefixes[step - 1],
+                                          &options.base_chunks));
+      EXPECT_EQ(options.base_chunks->size(), 8);
+      // Changes one of the four 64-byte chunks of "changing".
+      changing.flat<float>()((step - 1) * 16) = step;
+    }
+    changing_values.push_back(tensor::DeepCopy(changing));
+    BundleWriter writer(Env::Default(), prefixes[step], options);
+    TF_EXPECT_OK(writer.Add("frozen", frozen));
+    TF_EXPECT_OK(writer.Add("changing", changing));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  EXPECT_EQ(DataFileSize(prefixes[0]), 2 * values.size() * sizeof(float));
+  EXPECT_EQ(DataFileSize(prefixes[1]), 64);
+  EXPECT_EQ(DataFileSize(prefixes[2]), 64);
+
+  // The last checkpoint also reads chunks from both earlier bundles.
+  for (int step = 0; step < prefixes.size(); ++step) {
+    BundleReader reader(Env::Default(), prefixes[step]);
+    TF_ASSERT_OK(reader.status());
+    Expect<float>(&reader, "frozen", frozen);
+    Expect<float>(&reader, "changing", changing_values[step]);
+  }
+  BundleReader reader(Env::Default(), prefixes[2]);
+  TF_ASSERT_OK(reader.status());
+  BundleHeaderProto header;
+  reader.Seek(kHeaderEntryKey);
+  ASSERT_TRUE(header.ParseFromString(reader.value()));
+  ASSERT_EQ(header.chunk_sources_size(), 2);
+  EXPECT_EQ(header.chunk_sources(0).prefix(), prefixes[0]);
+  EXPECT_EQ(header.chunk_sources(1).prefix(), prefixes[1]);
+}
+
+TEST(ChunkedBundleTest, MissingSourceIsReportedOnOpen) {
+  const Tensor frozen = Constant(1.f, TensorShape({64}));
+  BundleWriter::Options options;
+  options.chunk_bytes = 64;
+  const std::vector<std::string> prefixes = {
+      Prefix("missing_source-0"), Prefix("missing_source-1"),
+      Prefix("missing_source-2")};
+  for (int step = 0; step < prefixes.size(); ++step) {
+    if (step > 0) {
+      TF_ASSERT_OK(BundleChunkIndex::Load(Env::Default(), prefixes[step - 1],
+                                          &options.base_chunks));
+    }
+    BundleWriter writer(Env::Default(), prefixes[step], options);
+    TF_EXPECT_OK(writer.Add("frozen", frozen));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  // The last bundle references the chunks of the first one, not of its base.
+  TF_ASSERT_OK(Env::Default()->DeleteFile(DataFilename(prefixes[0], 0, 1)));
+  BundleReader reader(Env::Default(), prefixes[2]);
+  EXPECT_TRUE(absl::IsFailedPrecondition(reader.status()));
+  EXPECT_TRUE(absl::StrContains(reader.status().message(), prefixes[0]));
+  std::shared_ptr<const BundleChunkIndex> index;
+  EXPECT_TRUE(absl::IsFailedPrecondition(
+      BundleChunkIndex::Load(Env::Default(), prefixes[2], &index)));
+}
+
+TEST(ChunkedBundleTest, ShardedWriterWithBase) {
+  BundleWriter::Options base_options;
+  base_options.chunk_bytes = 256;
+  const Tensor frozen = Constant(1.f, TensorShape({1 << 8, 1 << 4}));
+  {
+    BundleWriter writer(Env::Default(), Prefix("sharded_base"), base_options);
+    TF_EXPECT_OK(writer.Add("frozen", frozen));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  ShardedBundleWriter::Options options;
+  options.max_num_shards = 4;
+  options.min_shard_bytes = 1 << 10;
+  options.writer_options.chunk_bytes = 256;
+  TF_ASSERT_OK(BundleChunkIndex::Load(Env::Default(), Prefix("sharded_base"),
+                                      &options.writer_options.base_chunks));
+  const Tensor changed = Constant(2.f, TensorShape({1 << 8, 1 << 4}));
+  {
+    ShardedBundleWriter writer(Env::Default(), Prefix("sharded_chunked"),
+                               options);
+    TF_EXPECT_OK(writer.Add("frozen", frozen));
+    TF_EXPECT_OK(writer.Add("changed", changed));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader reader(Env::Default(), Prefix("sharded_chunked"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "frozen", frozen);
+  Expect<float>(&reader, "changed", changed);
+}
+
+TEST(CompressedBundleTest, RoundTrip) {
+  // Spans several compression blocks.
+  std::vector<float> floats(3 << 20);
+  for (int i = 0; i < floats.size(); ++i) floats[i] = (i % 1000) * 0.5f;
+  const Tensor large = test::AsTensor<float>(floats);
+  const Tensor ints = Constant(int64_t{7}, TensorShape({64, 1024}));
+  const Tensor small = Constant_2x3<float>(1);
+  std::vector<uint8_t> noise(1 << 17);
+  std::mt19937 random(0);
+  for (uint8_t& byte : noise) byte = random();
+  const Tensor incompressible = test::AsTensor<uint8_t>(noise);
+
+  BundleWriter::Options options;
+  options.compress = true;
+  {
+    BundleWriter writer(Env::Default(), Prefix("compressed"), options);
+    TF_EXPECT_OK(writer.Add("large", large));
+    TF_EXPECT_OK(writer.Add("ints", ints));
+    TF_EXPECT_OK(writer.Add("small", small));
+    TF_EXPECT_OK(writer.Add("incompressible", incompressible));
+    TF_EXPECT_OK(writer.Add("strings", test::AsTensor<tstring>({"a", "b"})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  EXPECT_LT(DataFileSize(Prefix("compressed")),
+            large.TotalBytes() / 2 + incompressible.TotalBytes());
+
+  BundleReader reader(Env::Default(), Prefix("compressed"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "large", large);
+  Expect<int64_t>(&reader, "ints", ints);
+  Expect<float>(&reader, "small", small);
+  Expect<uint8_t>(&reader, "incompressible", incompressible);
+  Expect<tstring>(&reader, "strings", test::AsTensor<tstring>({"a", "b"}));
+
+  const BundleEntryProto large_entry = GetEntry(&reader, "large");
+  EXPECT_EQ(large_entry.compression(), BundleEntryProto::ZSTD_BYTE_SHUFFLE);
+  EXPECT_EQ(large_entry.compressed_block_sizes_size(), 3);
+  EXPECT_EQ(GetEntry(&reader, "ints").compression(), BundleEntryProto::ZSTD);
+  EXPECT_EQ(GetEntry(&reader, "small").compression(),
+            BundleEntryProto::NO_COMPRESSION);
+  EXPECT_EQ(GetEntry(&reader, "incompressible").compression(),
+            BundleEntryProto::NO_COMPRESSION);
+  const BundleHeaderProto header = [&reader]() {
+    BundleHeaderProto header;
+    reader.Seek(kHeaderEntryKey);
+    CHECK(header.ParseFromString(reader.value()));
+    return header;
+  }();
+  EXPECT_EQ(kTensorBundleCompressedMinConsumer,
+            header.version().min_consumer());
+
+  // Compressed slices are read through the same path.
+  Tensor row(DT_FLOAT, TensorShape({1024}));
+  BundleReader slice_reader(Env::Default(), Prefix("compressed"));
+  TF_ASSERT_OK(slice_reader.status());
+  TF_ASSERT_OK(slice_reader.LookupSlice(
+      "large", TensorSlice::ParseOrDie("1024,1024"), &row));
+  test::ExpectTensorEqual<float>(row, large.Slice(1024, 2048));
+}
+
+TEST(CompressedBundleTest, MergesWithUncompressedBundles) {
+  const Tensor ints = Constant(int64_t{7}, TensorShape({1 << 14}));
+  std::vector<uint8_t> noise(1 << 17);
+  std::mt19937 random(0);
+  for (uint8_t& byte : noise) byte = random();
+  const Tensor incompressible = test::AsTensor<uint8_t>(noise);
+
+  BundleWriter::Options options;
+  options.compress = true;
+  {
+    BundleWriter writer(Env::Default(), Prefix("compressed_part"), options);
+    TF_EXPECT_OK(writer.Add("ints", ints));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleWriter writer(Env::Default(), Prefix("uncompressed_part"), options);
+    TF_EXPECT_OK(writer.Add("incompressible", incompressible));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  auto min_consumer = [](const std::string& prefix) {
+    BundleReader reader(Env::Default(), prefix);
+    TF_CHECK_OK(reader.status());
+    reader.Seek(kHeaderEntryKey);
+    BundleHeaderProto header;
+    CHECK(header.ParseFromString(reader.value()));
+    return header.version().min_consumer();
+  };
+  // Only bundles that hold compressed entries require newer readers.
+  EXPECT_EQ(kTensorBundleCompressedMinConsumer,
+            min_consumer(Prefix("compressed_part")));
+  EXPECT_EQ(kTensorBundleMinConsumer,
+            min_consumer(Prefix("uncompressed_part")));
+
+  TF_ASSERT_OK(MergeBundles(
+      Env::Default(), {Prefix("uncompressed_part"), Prefix("compressed_part")},
+      Prefix("compressed_merged")));
+  EXPECT_EQ(kTensorBundleCompressedMinConsumer,
+            min_consumer(Prefix("compressed_merged")));
+  BundleReader reader(Env::Default(), Prefix("compressed_merged"));
+  TF_ASSERT_OK(reader.status());
+  Expect<int64_t>(&reader, "ints", ints);
+  Expect<uint8_t>(&reader, "incompressible", incompressible);
+}
+
+TEST(CompressedBundleTest, CorruptedBlock) {
+  BundleWriter::Options options;
+  options.compress = true;
+  {
+    BundleWriter writer(Env::Default(), Prefix("compressed_corrupt"), options);
+    TF_EXPECT_OK(
+        writer.Add("ints", Constant(int64_t{7}, TensorShape({1 << 14}))));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  // Overwrites the data file with garbage of the same size.
+  const std::string data_path =
+      DataFilename(Prefix("compressed_corrupt"), 0, 1);
+  TF_ASSERT_OK(WriteStringToFile(
+      Env::Default(), data_path,
+      std::string(DataFileSize(Prefix("compressed_corrupt")), 'x')));
+
+  BundleReader reader(Env::Default(), Prefix("compressed_corrupt"));
+  TF_ASSERT_OK(reader.status());
+  Tensor val(DT_INT64, TensorShape({1 << 14}));
+  EXPECT_TRUE(absl::IsDataLoss(reader.Lookup("ints", &val)));
+}
+
 absl::Status CreateFile(Env* env, const std::string& fname) {
   std::unique_ptr<WritableFile> file;
   TF_RETURN_IF_ERROR(env->NewWritableFile(fname, &file));
@@ -1324,4 +1834,58 @@ static void BM_BundleWriterLargeTensor(::testing::benchmark::State& state) {
 BENCHMARK(BM_BundleWriterLargeTensor)->Arg(1 << 10);
 BENCHMARK(BM_BundleWriterLargeTensor)->Arg(4 << 10);
 
+static void BM_ShardedBundleWriter(::testing::benchmark::State& state) {
+  const int num_tensors = state.range(0);
+  const int64_t bytes = state.range(1);
+  ShardedBundleWriter::Options options;
+  options.max_num_shards = state.range(2);
+  options.min_shard_bytes = 1 << 20;
+  Tensor t = Constant(static_cast<int8_t>('a'), TensorShape{bytes});
+  for (auto s : state) {
+    ShardedBundleWriter writer(Env::Default(), Prefix("sharded"), options);
+    for (int i = 0; i < num_tensors; ++i) {
+      TF_CHECK_OK(writer.Add(absl::StrCat("tensor", i), t));
+    }
+    TF_CHECK_OK(writer.Finish());
+  }
+  state.SetBytesProcessed(state.iterations() * num_tensors * bytes);
+}
+
+// Args: number of tensors, bytes per tensor, maximum number of data files.
+BENCHMARK(BM_ShardedBundleWriter)
+    ->Args({1000, 16 << 10, 1})
+    ->Args({1000, 16 << 10, 16})
+    ->Args({64, 4 << 20, 1})
+    ->Args({64, 4 << 20, 16})
+    ->Args({4, 256 << 20, 1})
+    ->Args({4, 256 << 20, 16});
+
+// A bundle dominated by one tensor, as with a large embedding table.  Tensors
+// are not split, so the write time is bounded by that tensor's data file.
+static void BM_ShardedBundleWriterSkewed(::testing::benchmark::State& state) {
+  const int64_t large_bytes = state.range(0);
+  ShardedBundleWriter::Options options;
+  options.max_num_shards = state.range(1);
+  options.min_shard_bytes = 1 << 20;
+  Tensor large = Constant(static_cast<int8_t>('a'), TensorShape{large_bytes});
+  Tensor small = Constant(static_cast<int8_t>('b'), TensorShape{1 << 20});
+  for (auto s : state) {
+    ShardedBundleWriter writer(Env::Default(), Prefix("sharded_skewed"),
+                               options);
+    TF_CHECK_OK(writer.Add("large", large));
+    for (int i = 0; i < 64; ++i) {
+      TF_CHECK_OK(writer.Add(absl::StrCat("small", i), small));
+    }
+    TF_CHECK_OK(writer.Finish());
+  }
+  state.SetBytesProcessed(state.iterations() * (large_bytes + (64 << 20)));
+}
+
+// Args: bytes of the large tensor, maximum number of data files.
+BENCHMARK(BM_ShardedBundleWriterSkewed)
+    ->Args({64 << 20, 1})
+    ->Args({64 << 20, 16})
+    ->Args({1 << 30, 1})
+    ->Args({1 << 30, 16});
+
 }  // namespace tensorflow
@@ -21,6 +21,7 @@ import functools
 import glob
 import inspect
 import os
+import queue
 import threading
 import time
 import weakref
@@ -139,6 +140,47 @@ def _execute_callbacks(callbacks, save_path):
       )
 
 
+class _BackgroundWriteCallbacks:
+  """Finishes the checkpoints written in the background, in order.
+
+  Once the files of a checkpoint have been written, runs its write callbacks
+  and records its size on a daemon thread.
+  """
+
+  def __init__(self):
+    self._queue = queue.Queue()
+    self._error = None
+    self._thread = threading.Thread(target=self._run, daemon=True)
+    self._thread.start()
+
+  def put(self, save_path, callbacks):
+    self._queue.put((save_path, callbacks))
+
+  def _run(self):
+    while True:
+      save_path, callbacks = self._queue.get()
+      try:
+        functional_saver.wait_for_background_writes()
+        if callbacks:
+          _execute_callbacks(callbacks, save_path)
+        metrics.RecordCheckpointSize(
+            api_label=_CHECKPOINT_V2, filesize=_get_checkpoint_size(save_path)
+        )
+      except Exception as e:  # pylint: disable=broad-except
+        logging.error("Writing checkpoint %s failed: %s", save_path, e)
+        if self._error is None:
+          self._error = e
+      finally:
+        self._queue.task_done()
+
+  def sync(self):
+    """Waits for the pending checkpoints, and raises the first error."""
+    self._queue.join()
+    error, self._error = self._error, None
+    if error is not None:
+      raise error
+
+
 class ObjectGraphProtoPrettyPrinter:
   """Lazily traverses an object graph proto to pretty print names.
 
@@ -2191,6 +2233,8 @@ class Checkpoint(autotrackable.AutoTrackable):
 
     # Don't instantiate the AsyncCheckpointer unless required.
     self._async_checkpointer_impl = None
+    # Created by the first checkpoint written in the background.
+    self._background_write_callbacks = None
 
     # Store checkpoint options during the save/write calls so that subsequent
     # read/restore calls are done properly. This is only populated when
@@ -2366,12 +2410,26 @@ class Checkpoint(autotrackable.AutoTrackable):
 
     start_time = time.time()
     options = options or checkpoint_options.CheckpointOptions()
+    background_write = options.experimental_background_write
+    if background_write and not context.executing_eagerly():
+      logging.warning(
+          "Writing checkpoints in the background in graph mode is not "
+          "supported; switching to regular sync checkpoint instead.")
+      options = copy.copy(options)
+      options.experimental_background_write = background_write = False
     output = self._saver.save(file_prefix=file_prefix, options=options)
     output = _convert_file_name_tensor_to_string(output)
 
     # Execute callbacks (the only place they are executed; i.e. all entry points
-    # for callbacks will ultimately be directed to here for execution)
-    if options.experimental_write_callbacks:
+    # for callbacks will ultimately be directed to here for execution). The
+    # callbacks of checkpoints written in the background run once the files
+    # have been written.
+    if background_write:
+      if self._background_write_callbacks is None:
+        self._background_write_callbacks = _BackgroundWriteCallbacks()
+      self._background_write_callbacks.put(
+          output, options.experimental_write_callbacks)
+    elif options.experimental_write_callbacks:
       _execute_callbacks(options.experimental_write_callbacks, output)
 
     # Ensure save operations have completed when running in eager runtime.
@@ -2401,9 +2459,10 @@ class Checkpoint(autotrackable.AutoTrackable):
         )
       _END_TIME_OF_LAST_WRITE = end_time
 
-    metrics.RecordCheckpointSize(
-        api_label=_CHECKPOINT_V2, filesize=_get_checkpoint_size(output)
-    )
+    if not background_write:
+      metrics.RecordCheckpointSize(
+          api_label=_CHECKPOINT_V2, filesize=_get_checkpoint_size(output)
+      )
     return output
 
   @property
@@ -2424,6 +2483,8 @@ class Checkpoint(autotrackable.AutoTrackable):
     # `getattr` for safer check.
     if getattr(self, "_async_checkpointer_impl", None) is not None:
       self._async_checkpointer_impl.sync()
+    if getattr(self, "_background_write_callbacks", None) is not None:
+      self._background_write_callbacks.sync()
 
   def save(self, file_prefix, options=None):
     # pylint:disable=line-too-long
@@ -48,6 +48,8 @@ class CheckpointOptions(object):
       "enable_async",
       "experimental_sharding_callback",
       "experimental_skip_slot_variables",
+      "experimental_compression",
+      "experimental_background_write",
   )
 
   @deprecated_args(
@@ -60,7 +62,9 @@ class CheckpointOptions(object):
       experimental_write_callbacks=None,
       enable_async=False,
       experimental_skip_slot_variables=False,
-      experimental_sharding_callback=None
+      experimental_sharding_callback=None,
+      experimental_compression=None,
+      experimental_background_write=False,
   ):
     """Creates an object that stores options for a Checkpoint.
 
@@ -100,6 +104,19 @@ class CheckpointOptions(object):
         `tf.train.experimental.ShardByDevicePolicy` and
         `tf.train.experimental.MaxShardSizePolicy`. You may also write a custom
         callback, see `tf.train.experimental.ShardingCallback`.
+      experimental_compression: string. The compression of the tensors written
+        to the checkpoint. If `None` (default), tensors are not compressed. If
+        "zstd", large tensors are compressed with Zstandard, which makes
+        checkpoints of compressible values smaller and faster to write to and
+        read from network storage. Checkpoints with compressed tensors cannot be
+        read by older TensorFlow releases.
+      experimental_background_write: bool Type. If true, `save()` and `write()`
+        return once the values have been captured, and the checkpoint files are
+        written on a background thread of the host, without copying the values
+        first. Write callbacks, and the bookkeeping of
+        `tf.train.CheckpointManager`, run once the files have been written;
+        call `sync()` to wait for them. Only supported in eager mode, for
+        resource variables. Cannot be combined with `enable_async`.
     """
     self.experimental_io_device = experimental_io_device
     self.enable_async = experimental_enable_async_checkpoint or enable_async
@@ -117,6 +134,15 @@ class CheckpointOptions(object):
                          f"was of type {type(experimental_sharding_callback)}.")
     self.experimental_sharding_callback = experimental_sharding_callback
     self.experimental_skip_slot_variables = experimental_skip_slot_variables
+    if experimental_compression not in (None, "zstd"):
+      raise ValueError("The experimental_compression checkpoint option must be "
+                       f"None or \"zstd\". The option provided was "
+                       f"{experimental_compression!r}.")
+    self.experimental_compression = experimental_compression
+    if experimental_background_write and self.enable_async:
+      raise ValueError("The experimental_background_write checkpoint option "
+                       "cannot be combined with enable_async.")
+    self.experimental_background_write = experimental_background_write
 
   def __copy__(self):
     # Only `experimental_write_callbacks` needs special treatment to Ensure that
@@ -14,8 +14,10 @@
 # ==============================================================================
 """Saves and restore variables inside traced @tf.functions."""
 
+import copy
 import dataclasses
 import math
+import threading
 import time
 from typing import Callable, Mapping, MutableMapping, MutableSequence, Sequence
 
@@ -54,6 +56,22 @@ RegisteredSaversDict = Mapping[
 MappedCapturesCallable = Callable[
     [core.ConcreteFunction, Sequence[tensor_lib.Tensor]], tensor_lib.Tensor]
 
+# The devices that have merged checkpoints written in the background.
+_background_write_devices = set()
+_background_write_devices_lock = threading.Lock()
+
+
+def wait_for_background_writes() -> None:
+  """Waits for the checkpoints written in the background by this process.
+
+  Raises the first error of the writes, if any.
+  """
+  with _background_write_devices_lock:
+    devices = list(_background_write_devices)
+  for device in devices:
+    with ops.device(device):
+      gen_io_ops.wait_for_checkpoint_writes()
+
 
 def _single_shard_save(
     file_prefix: tensor_lib.Tensor,
@@ -99,7 +117,10 @@ def _single_shard_save(
 
   save_device = options.experimental_io_device or (tensors and task)
   with ops.device(save_device or "CPU:0"):
-    return io_ops.save_v2(file_prefix, tensor_names, slice_specs, tensors)
+    return io_ops.save_v2(
+        file_prefix, tensor_names, slice_specs, tensors,
+        compression=options.experimental_compression or "",
+        background_write=options.experimental_background_write)
 
 
 def _single_shard_restore(
@@ -457,6 +478,17 @@ class MultiDeviceSaver:
       An `Operation`, or None when executing eagerly.
     """
     options = options or checkpoint_options.CheckpointOptions()
+    if options.experimental_background_write and not (
+        context.executing_eagerly() and
+        (options.experimental_io_device or self._num_unique_tasks <= 1)):
+      # The merge waits for the shards written in the background on its own
+      # host only.
+      logging.warning(
+          "experimental_background_write requires eager execution, and "
+          "either experimental_io_device or a single task. Writing the "
+          "checkpoint synchronously.")
+      options = copy.copy(options)
+      options.experimental_background_write = False
 
     # IMPLEMENTATION DETAILS: most clients should skip.
     #
@@ -539,6 +571,9 @@ class MultiDeviceSaver:
         merge_device_spec = (
             options.experimental_io_device or
             saveable_object_util.set_cpu0(tensor_device_spec.to_string()))
+        if options.experimental_background_write:
+          with _background_write_devices_lock:
+            _background_write_devices.add(merge_device_spec)
         with ops.device(merge_device_spec):
           # V2 format write path consists of a metadata merge step.  Once
           # merged, attempts to delete the temporary directory,
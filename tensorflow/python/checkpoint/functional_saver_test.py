@@ -18,6 +18,7 @@ import os
 import time
 
 from tensorflow.python.checkpoint import checkpoint
+from tensorflow.python.checkpoint import checkpoint_management
 from tensorflow.python.checkpoint import checkpoint_options
 from tensorflow.python.checkpoint import functional_saver
 from tensorflow.python.checkpoint import graph_view
@@ -90,6 +91,54 @@ class SaverTest(test.TestCase):
     self.evaluate(second_saver.restore(prefix))
     self.assertEqual(2., self.evaluate(v2))
 
+  @test_util.run_in_graph_and_eager_modes
+  def test_compression(self):
+    v = resource_variable_ops.ResourceVariable(
+        constant_op.constant(1., shape=[64, 1024]))
+    self.evaluate(v.initializer)
+    saver = functional_saver.MultiDeviceSaver.from_saveables(
+        saveable_object_util.saveable_objects_for_op(v, "x"))
+    sizes = {}
+    for compression in (None, "zstd"):
+      prefix = os.path.join(self.get_temp_dir(), f"ckpt_{compression}")
+      options = checkpoint_options.CheckpointOptions(
+          experimental_compression=compression)
+      self.evaluate(saver.save(constant_op.constant(prefix), options))
+      sizes[compression] = sum(
+          gfile.Stat(path).length for path in gfile.Glob(prefix + ".data-*"))
+      self.evaluate(v.assign(constant_op.constant(0., shape=[64, 1024])))
+      self.evaluate(saver.restore(prefix))
+      self.assertAllEqual(1., self.evaluate(v))
+      self.evaluate(v.assign(constant_op.constant(1., shape=[64, 1024])))
+    self.assertLess(sizes["zstd"], sizes[None] // 4)
+
+    with self.assertRaisesRegex(ValueError, "experimental_compression"):
+      checkpoint_options.CheckpointOptions(experimental_compression="gzip")
+
+  def test_background_write(self):
+    with context.eager_mode():
+      v = resource_variable_ops.ResourceVariable(1.)
+      ckpt = checkpoint.Checkpoint(v=v)
+      manager = checkpoint_management.CheckpointManager(
+          ckpt, self.get_temp_dir(), max_to_keep=2)
+      options = checkpoint_options.CheckpointOptions(
+          experimental_background_write=True)
+      first_path = manager.save(options=options)
+      # Copies the buffer that the pending write still holds.
+      v.assign(2.)
+      second_path = manager.save(options=options)
+      manager.sync()
+      self.assertEqual(second_path, manager.latest_checkpoint)
+      self.assertEqual([first_path, second_path], manager.checkpoints)
+      ckpt.restore(first_path)
+      self.assertEqual(1., self.evaluate(v))
+      ckpt.restore(second_path)
+      self.assertEqual(2., self.evaluate(v))
+
+    with self.assertRaisesRegex(ValueError, "experimental_background_write"):
+      checkpoint_options.CheckpointOptions(
+          experimental_background_write=True, enable_async=True)
+
   @test_util.run_in_graph_and_eager_modes
   def test_resource_variable_use_localhost(self):
     v1 = resource_variable_ops.ResourceVariable(2.)
@@ -252,9 +252,9 @@ def snapshot(path, compression="AUTO", reader_func=None, shard_func=None):
     path: Required. A directory to use for storing / loading the snapshot to /
       from.
     compression: Optional. The type of compression to apply to the snapshot
-      written to disk. Supported options are `GZIP`, `SNAPPY`, `AUTO` or None.
-      Defaults to AUTO, which attempts to pick an appropriate compression
-      algorithm for the dataset.
+      written to disk. Supported options are `GZIP`, `SNAPPY`, `ZSTD`, `AUTO`
+      or None. Defaults to AUTO, which attempts to pick an appropriate
+      compression algorithm for the dataset.
     reader_func: Optional. A function to control how to read data from snapshot
       shards.
     shard_func: Optional. A function to control how to shard data when writing a
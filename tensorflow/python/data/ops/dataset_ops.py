@@ -1695,7 +1695,8 @@ class DatasetV2(
            path,
            compression=None,
            shard_func=None,
-           checkpoint_args=None):
+           checkpoint_args=None,
+           compression_threads=1):
     """Saves the content of the given dataset.
 
       Example usage:
@@ -1760,6 +1761,9 @@ class DatasetV2(
           specified, then checkpointing will not be performed. The `save()`
           implementation creates a `tf.train.Checkpoint` object internally, so
           users should not set the `checkpoint` argument in `checkpoint_args`.
+     compression_threads: Optional. The number of threads, shared by all
+          shards, that compress the saved data in blocks when `compression` is
+          set. Defaults to 1, which compresses each shard on its writer thread.
 
     Returns:
       An operation which when executed performs the save. When writing
@@ -1772,7 +1776,8 @@ class DatasetV2(
     # dataset_ops).
     # pylint: disable=g-import-not-at-top,protected-access
     from tensorflow.python.data.ops import save_op
-    return save_op._save(self, path, compression, shard_func, checkpoint_args)
+    return save_op._save(self, path, compression, shard_func, checkpoint_args,
+                         compression_threads)
     # pylint: enable=g-import-not-at-top,protected-access
 
   @staticmethod  # pylint: disable=staticmethod-use
@@ -3376,9 +3381,9 @@ name=None))
       path: Required. A directory to use for storing / loading the snapshot to /
         from.
       compression: Optional. The type of compression to apply to the snapshot
-        written to disk. Supported options are `GZIP`, `SNAPPY`, `AUTO` or None.
-        Defaults to `AUTO`, which attempts to pick an appropriate compression
-        algorithm for the dataset.
+        written to disk. Supported options are `GZIP`, `SNAPPY`, `ZSTD`, `AUTO`
+        or None. Defaults to `AUTO`, which attempts to pick an appropriate
+        compression algorithm for the dataset.
       reader_func: Optional. A function to control how to read data from
         snapshot shards.
       shard_func: Optional. A function to control how to shard data when writing
@@ -33,10 +33,12 @@ def _save(input_dataset,
           path,
           compression=None,
           shard_func=None,
-          checkpoint_args=None):
+          checkpoint_args=None,
+          compression_threads=1):
   """Implements the save function and checkpoint functionality."""
   if context.executing_eagerly() and checkpoint_args:
-    save_dataset = _SaveDataset(input_dataset, path, shard_func, compression)
+    save_dataset = _SaveDataset(input_dataset, path, shard_func, compression,
+                                compression_threads)
     save_iterator = iter(save_dataset)
 
     if "checkpoint" in checkpoint_args:
@@ -62,13 +64,15 @@ def _save(input_dataset,
         shard_func_other_args=shard_func.captured_inputs,
         compression=compression,
         shard_func=shard_func,
-        use_shard_func=use_shard_func)
+        use_shard_func=use_shard_func,
+        compression_threads=compression_threads)
 
 
 class _SaveDataset(dataset_ops.UnaryDataset):
   """"A dataset that loads previously saved dataset."""
 
-  def __init__(self, dataset, path, shard_func, compression):
+  def __init__(self, dataset, path, shard_func, compression,
+               compression_threads=1):
     self._element_spec = dataset.element_spec
     self._shard_func = shard_func
     dataset, shard_func, use_shard_func, path = set_save_dataset_attributes(
@@ -80,6 +84,7 @@ class _SaveDataset(dataset_ops.UnaryDataset):
         shard_func=shard_func,
         use_shard_func=use_shard_func,
         compression=compression,
+        compression_threads=compression_threads,
         output_types=structure.get_flat_tensor_types(dataset.element_spec),
         output_shapes=structure.get_flat_tensor_shapes(dataset.element_spec),
     )
@@ -1366,6 +1366,7 @@ class Context:
     rewriter_bool("disable_meta_optimizer")
     rewriter_toggle("auto_mixed_precision_onednn_bfloat16")
     rewriter_toggle("auto_mixed_precision_mkl")
+    rewriter_toggle("experimental_quantize_matmul_weights")
     nodes = self._optimizer_experimental_options.get("min_graph_nodes", None)
     if nodes is not None:
       config.graph_options.rewrite_options.min_graph_nodes = nodes
@@ -2204,6 +2205,7 @@ class Context:
     rewriter_bool("disable_meta_optimizer")
     rewriter_toggle("auto_mixed_precision_onednn_bfloat16")
     rewriter_toggle("auto_mixed_precision_mkl")
+    rewriter_toggle("experimental_quantize_matmul_weights")
 
     if rewrite_options.min_graph_nodes != 0:
       options["min_graph_nodes"] = rewrite_options.min_graph_nodes
@@ -250,6 +250,9 @@ def set_optimizer_experimental_options(options):
         loss scaling, this can cause numerical underflow (see
         `keras.mixed_precision.experimental.LossScaleOptimizer`).
       - disable_meta_optimizer: Disable the entire meta optimizer.
+      - experimental_quantize_matmul_weights: Replace float MatMuls on CPU
+        whose right-hand side is a constant by int8 weight-quantized products.
+        This changes the results of the graph.
       - min_graph_nodes: The minimum number of nodes in a graph to optimizer.
         For smaller graphs, optimization is skipped.
       - auto_parallel: Automatically parallelizes graphs by splitting along
@@ -195,6 +195,24 @@ class TopKTest(test.TestCase):
       values = -np.sort(-inputs, axis=1)[:, :k]
       self._validateTopK(inputs, k, values, indices)
 
+  def testFewLongRows(self):
+    # Rows this long are split across threads when there are fewer rows than
+    # threads.
+    b = 2
+    n = 300000
+    for dtype in [np.float32, np.float64, np.int32]:
+      for k in [2, 100, 1000]:
+        # Repeated values check that equal values keep the lowest indices.
+        inputs = np.random.randint(0, 1000, size=(b, n)).astype(dtype)
+        indices = np.argsort(-inputs, axis=1, kind="mergesort")[:, :k]
+        values = -np.sort(-inputs, axis=1)[:, :k]
+        self._validateTopK(inputs, k, values, indices)
+
+        inputs = np.random.permutation(b * n).reshape(b, n).astype(dtype)
+        indices = np.argsort(-inputs, axis=1)[:, :k]
+        values = -np.sort(-inputs, axis=1)[:, :k]
+        self._validateTopK(inputs, k, values, indices, sorted=False)
+
   def testTopAll(self):
     inputs = [[0.1, 0.3, 0.2, 0.4], [0.1, 0.3, 0.3, 0.2]]
     self._validateTopK(inputs, 4, [[0.4, 0.3, 0.2, 0.1], [0.3, 0.3, 0.2, 0.1]],
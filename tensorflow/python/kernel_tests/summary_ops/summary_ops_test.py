@@ -773,6 +773,20 @@ class SummaryWriterTest(test_util.TensorFlowTestCase):
         writer.close()
         self.assertEqual(2, get_total())
 
+  def testCreate_asyncWrite(self):
+    logdir = self.get_temp_dir()
+    with context.eager_mode():
+      writer = summary_ops.create_file_writer_v2(
+          logdir, max_queue=2, experimental_async_write=True)
+      with writer.as_default():
+        for step in range(10):
+          summary_ops.write('tag', step, step=step)
+      writer.flush()
+      events = events_from_logdir(logdir)
+      self.assertEqual(11, len(events))
+      self.assertEqual(list(range(10)), [e.step for e in events[1:]])
+      writer.close()
+
   def testCreate_fromFunction(self):
     logdir = self.get_temp_dir()
     @def_function.function
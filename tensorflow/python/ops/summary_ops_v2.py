@@ -526,6 +526,7 @@ def create_file_writer_v2(
     name=None,
     experimental_trackable=False,
     experimental_mesh=None,
+    experimental_async_write=False,
 ):
   """Creates a summary file writer for the given log directory.
 
@@ -542,6 +543,10 @@ def create_file_writer_v2(
     experimental_mesh: a `tf.experimental.dtensor.Mesh` instance. When running
       with DTensor, the mesh (experimental_mesh.host_mesh()) will be used for
       bringing all the DTensor logging from accelerator to CPU mesh.
+    experimental_async_write: a boolean that controls whether the events are
+      written on a background thread of the writer, so that writing summaries
+      does not wait on file I/O. Events are still written in full by `flush()`
+      and `close()`.
 
   Returns:
     A SummaryWriter object.
@@ -583,7 +588,8 @@ def create_file_writer_v2(
           logdir=logdir,
           max_queue=max_queue,
           flush_millis=flush_millis,
-          filename_suffix=filename_suffix)
+          filename_suffix=filename_suffix,
+          async_write=experimental_async_write)
       if experimental_trackable:
         return _TrackableResourceSummaryWriter(
             create_fn=create_fn, init_op_fn=init_op_fn, mesh=experimental_mesh
@@ -0,0 +1,380 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/parallel_compression_outputbuffer.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/status_macros.h"
+#include "zstd.h"
+
+namespace tsl {
+namespace io {
+
+struct ParallelCompressionOutputBuffer::Block {
+  std::string input;
+  // Input preceding this block that back-references may point into (zlib).
+  std::string dictionary;
+  // Whether this block ends the stream.
+  bool last = false;
+
+  // Set by the pool thread before `done` is notified.
+  std::string output;
+  uint32_t check = 0;
+  absl::Status status;
+  absl::Notification done;
+};
+
+ParallelCompressionOutputBuffer::ParallelCompressionOutputBuffer(
+    WritableFile* file, int num_threads, int64_t block_bytes,
+    const ZlibCompressionOptions& zlib_options, thread::ThreadPool* pool)
+    : file_(file),
+      num_threads_(num_threads),
+      block_bytes_(block_bytes),
+      is_zstd_(false),
+      zlib_options_(zlib_options),
+      pool_(pool) {}
+
+ParallelCompressionOutputBuffer::ParallelCompressionOutputBuffer(
+    WritableFile* file, int num_threads, int64_t block_bytes,
+    const ZstdCompressionOptions& zstd_options, thread::ThreadPool* pool)
+    : file_(file),
+      num_threads_(num_threads),
+      block_bytes_(block_bytes),
+      is_zstd_(true),
+      zstd_options_(zstd_options),
+      pool_(pool) {}
+
+ParallelCompressionOutputBuffer::~ParallelCompressionOutputBuffer() {
+  if (initialized_ && !closed_) {
+    LOG(WARNING) << "ParallelCompressionOutputBuffer::Close() not called. "
+                 << "Possible data loss";
+  }
+  // The blocks in flight refer to this buffer, and a shared pool outlives it.
+  for (const std::shared_ptr<Block>& block : pending_) {
+    block->done.WaitForNotification();
+  }
+  owned_pool_.reset();
+  ZSTD_freeCDict(cdict_);
+}
+
+absl::Status ParallelCompressionOutputBuffer::Init() {
+  if (num_threads_ < 1 || block_bytes_ == 0 ||
+      block_bytes_ > std::numeric_limits<uInt>::max()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid parallel compression settings: ", num_threads_,
+                     " threads, blocks of ", block_bytes_, " bytes"));
+  }
+  if (IsZlib()) {
+    // Raw deflate has negative window bits, gzip adds 16.
+    window_bits_ = zlib_options_.window_bits;
+    if (window_bits_ < 0) {
+      window_bits_ = -window_bits_;
+    } else if (window_bits_ > MAX_WBITS) {
+      window_bits_ -= 16;
+    }
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    int status = deflateInit2(&stream, zlib_options_.compression_level,
+                              zlib_options_.compression_method, -window_bits_,
+                              zlib_options_.mem_level,
+                              zlib_options_.compression_strategy);
+    if (status != Z_OK) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("deflateInit failed with status ", status));
+    }
+    deflateEnd(&stream);
+    check_ = zlib_options_.window_bits > MAX_WBITS ? crc32(0L, Z_NULL, 0)
+                                                   : adler32(0L, Z_NULL, 0);
+    RETURN_IF_ERROR(file_->Append(ZlibHeader()));
+  } else if (!zstd_options_.dictionary.empty()) {
+    cdict_ = ZSTD_createCDict(zstd_options_.dictionary.data(),
+                              zstd_options_.dictionary.size(),
+                              zstd_options_.compression_level);
+    if (cdict_ == nullptr) {
+      return absl::InvalidArgumentError("Unable to load zstd dictionary.");
+    }
+  }
+  if (pool_ == nullptr) {
+    owned_pool_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "parallel_compression", num_threads_);
+    pool_ = owned_pool_.get();
+  }
+  input_.reserve(block_bytes_);
+  initialized_ = true;
+  return absl::OkStatus();
+}
+
+std::string ParallelCompressionOutputBuffer::ZlibHeader() const {
+  if (zlib_options_.window_bits < 0) {
+    return "";
+  }
+  const int level = zlib_options_.compression_level == Z_DEFAULT_COMPRESSION
+                        ? 6
+                        : zlib_options_.compression_level;
+  if (zlib_options_.window_bits > MAX_WBITS) {
+    // RFC 1952: no file name, no modification time, unknown OS.
+    const char extra_flags = level == 9 ? 2 : level == 1 ? 4 : 0;
+    return std::string({'\x1f', '\x8b', Z_DEFLATED, 0, 0, 0, 0, 0, extra_flags,
+                        '\xff'});
+  }
+  // RFC 1950: method and window size, then the level hint padded so that the
+  // header is a multiple of 31.
+  const int level_hint = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+  uint32_t header =
+      ((((window_bits_ - 8) << 4) | Z_DEFLATED) << 8) | (level_hint << 6);
+  header += 31 - header % 31;
+  return std::string({static_cast<char>(header >> 8),
+                      static_cast<char>(header & 0xff)});
+}
+
+std::string ParallelCompressionOutputBuffer::ZlibTrailer() const {
+  std::string trailer;
+  if (zlib_options_.window_bits > MAX_WBITS) {
+    // crc32 and input size, little endian.
+    for (uint32_t value : {check_, static_cast<uint32_t>(total_in_)}) {
+      for (int i = 0; i < 4; ++i) {
+        trailer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+      }
+    }
+  } else if (zlib_options_.window_bits > 0) {
+    // adler32, big endian.
+    for (int i = 3; i >= 0; --i) {
+      trailer.push_back(static_cast<char>((check_ >> (8 * i)) & 0xff));
+    }
+  }
+  return trailer;
+}
+
+void ParallelCompressionOutputBuffer::DeflateBlock(Block* block) const {
+  z_stream stream;
+  memset(&stream, 0, sizeof(z_stream));
+  int error = deflateInit2(&stream, zlib_options_.compression_level,
+                           zlib_options_.compression_method, -window_bits_,
+                           zlib_options_.mem_level,
+                           zlib_options_.compression_strategy);
+  if (error != Z_OK) {
+    block->status = absl::InternalError(
+        absl::StrCat("deflateInit failed with status ", error));
+    return;
+  }
+  if (!block->dictionary.empty()) {
+    deflateSetDictionary(
+        &stream, reinterpret_cast<const Bytef*>(block->dictionary.data()),
+        block->dictionary.size());
+  }
+  // A sync flush ends the block on a byte boundary without ending the stream,
+  // so the next block's deflate output can follow it directly.
+  const int flush = block->last ? Z_FINISH : Z_SYNC_FLUSH;
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(block->input.data()));
+  stream.avail_in = block->input.size();
+  // deflateBound() does not account for the sync flush marker.
+  block->output.resize(deflateBound(&stream, block->input.size()) + 16);
+  size_t produced = 0;
+  while (true) {
+    stream.next_out = reinterpret_cast<Bytef*>(&block->output[produced]);
+    stream.avail_out = block->output.size() - produced;
+    error = deflate(&stream, flush);
+    produced = block->output.size() - stream.avail_out;
+    if (error != Z_OK && error != Z_BUF_ERROR && error != Z_STREAM_END) {
+      block->status = absl::DataLossError(
+          absl::StrCat("deflate() failed with error ", error));
+      break;
+    }
+    if (flush == Z_FINISH ? error == Z_STREAM_END : stream.avail_out > 0) {
+      break;
+    }
+    block->output.resize(2 * block->output.size());
+  }
+  deflateEnd(&stream);
+  block->output.resize(produced);
+
+  const auto* input = reinterpret_cast<const Bytef*>(block->input.data());
+  if (zlib_options_.window_bits > MAX_WBITS) {
+    block->check = crc32(crc32(0L, Z_NULL, 0), input, block->input.size());
+  } else if (zlib_options_.window_bits > 0) {
+    block->check =
+        adler32(adler32(0L, Z_NULL, 0), input, block->input.size());
+  }
+}
+
+void ParallelCompressionOutputBuffer::ZstdCompressBlock(Block* block) const {
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  if (cctx == nullptr) {
+    block->status = absl::InternalError("ZSTD_createCCtx() failed.");
+    return;
+  }
+  size_t result =
+      cdict_ != nullptr
+          ? ZSTD_CCtx_refCDict(cctx, cdict_)
+          : ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+                                   zstd_options_.compression_level);
+  if (!ZSTD_isError(result)) {
+    block->output.resize(ZSTD_compressBound(block->input.size()));
+    result = ZSTD_compress2(cctx, &block->output[0], block->output.size(),
+                            block->input.data(), block->input.size());
+  }
+  ZSTD_freeCCtx(cctx);
+  if (ZSTD_isError(result)) {
+    block->status = absl::DataLossError(
+        absl::StrCat("ZSTD_compress2() failed: ", ZSTD_getErrorName(result)));
+    return;
+  }
+  block->output.resize(result);
+}
+
+absl::Status ParallelCompressionOutputBuffer::ScheduleBlock(bool last) {
+  // Bounds the memory held by blocks in flight.
+  while (pending_.size() >= 2 * static_cast<size_t>(num_threads_)) {
+    pending_.front()->done.WaitForNotification();
+    RETURN_IF_ERROR(WriteFinishedBlocks(/*wait=*/false));
+  }
+  auto block = std::make_shared<Block>();
+  block->last = last;
+  if (IsZlib()) {
+    const size_t window = size_t{1} << window_bits_;
+    block->dictionary = history_;
+    if (input_.size() >= window) {
+      history_.assign(input_, input_.size() - window, window);
+    } else {
+      history_.append(input_);
+      if (history_.size() > window) {
+        history_.erase(0, history_.size() - window);
+      }
+    }
+  }
+  block->input.swap(input_);
+  input_.clear();
+  input_.reserve(block_bytes_);
+  pending_.push_back(block);
+  pool_->Schedule([this, block]() {
+    if (IsZlib()) {
+      DeflateBlock(block.get());
+    } else {
+      ZstdCompressBlock(block.get());
+    }
+    block->done.Notify();
+  });
+  return absl::OkStatus();
+}
+
+absl::Status ParallelCompressionOutputBuffer::WriteFinishedBlocks(bool wait) {
+  while (!pending_.empty()) {
+    Block* block = pending_.front().get();
+    if (!block->done.HasBeenNotified()) {
+      if (!wait) break;
+      block->done.WaitForNotification();
+    }
+    RETURN_IF_ERROR(block->status);
+    RETURN_IF_ERROR(file_->Append(block->output));
+    if (zlib_options_.window_bits > MAX_WBITS && IsZlib()) {
+      check_ = crc32_combine(check_, block->check, block->input.size());
+    } else if (zlib_options_.window_bits > 0 && IsZlib()) {
+      check_ = adler32_combine(check_, block->check, block->input.size());
+    }
+    total_in_ += block->input.size();
+    pending_.pop_front();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ParallelCompressionOutputBuffer::Append(absl::string_view data) {
+  if (!initialized_ || closed_) {
+    return absl::FailedPreconditionError(
+        "ParallelCompressionOutputBuffer is not initialized or already "
+        "closed.");
+  }
+  while (!data.empty()) {
+    const size_t bytes = std::min(data.size(), block_bytes_ - input_.size());
+    input_.append(data.data(), bytes);
+    data.remove_prefix(bytes);
+    if (input_.size() == block_bytes_) {
+      RETURN_IF_ERROR(ScheduleBlock(/*last=*/false));
+    }
+  }
+  return WriteFinishedBlocks(/*wait=*/false);
+}
+
+#if defined(TF_CORD_SUPPORT)
+absl::Status ParallelCompressionOutputBuffer::Append(const absl::Cord& cord) {
+  for (absl::string_view fragment : cord.Chunks()) {
+    RETURN_IF_ERROR(Append(fragment));
+  }
+  return absl::OkStatus();
+}
+#endif
+
+absl::Status ParallelCompressionOutputBuffer::Flush() {
+  if (!initialized_ || closed_) {
+    return absl::FailedPreconditionError(
+        "ParallelCompressionOutputBuffer is not initialized or already "
+        "closed.");
+  }
+  if (!input_.empty()) {
+    RETURN_IF_ERROR(ScheduleBlock(/*last=*/false));
+  }
+  RETURN_IF_ERROR(WriteFinishedBlocks(/*wait=*/true));
+  return file_->Flush();
+}
+
+absl::Status ParallelCompressionOutputBuffer::Name(
+    absl::string_view* result) const {
+  return file_->Name(result);
+}
+
+absl::Status ParallelCompressionOutputBuffer::Sync() {
+  RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
+absl::Status ParallelCompressionOutputBuffer::Close() {
+  if (!initialized_ || closed_) {
+    return absl::OkStatus();
+  }
+  closed_ = true;
+  // A deflate stream always needs a final block, even an empty one; zstd
+  // frames need no terminator.
+  if (IsZlib() || !input_.empty()) {
+    RETURN_IF_ERROR(ScheduleBlock(/*last=*/true));
+  }
+  RETURN_IF_ERROR(WriteFinishedBlocks(/*wait=*/true));
+  if (IsZlib()) {
+    RETURN_IF_ERROR(file_->Append(ZlibTrailer()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ParallelCompressionOutputBuffer::Tell(int64_t* position) {
+  return file_->Tell(position);
+}
+
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,170 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_PARALLEL_COMPRESSION_OUTPUTBUFFER_H_
+#define XLA_TSL_LIB_IO_PARALLEL_COMPRESSION_OUTPUTBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/io/zlib_compression_options.h"
+#include "xla/tsl/lib/io/zstd_compression_options.h"
+#include "xla/tsl/platform/file_system.h"
+#include "xla/tsl/platform/threadpool.h"
+#include "tsl/platform/cord.h"
+
+// Forward declare the dictionary type of zstd.h, which is only included in the
+// .cc file.
+typedef struct ZSTD_CDict_s ZSTD_CDict;
+
+namespace tsl {
+namespace io {
+
+// Compresses its input in independent blocks on a thread pool and writes the
+// compressed blocks to file in order, in the manner of pigz.
+//
+// The output is an ordinary stream for the configured compressor and is read
+// back with `ZlibInputStream` or `ZstdInputStream`:
+//  - zlib (including raw deflate and gzip): every block is deflated on its own,
+//    primed with the preceding 32KB of input as a dictionary, and ends with a
+//    sync flush so the blocks concatenate into a single deflate stream. The
+//    header and trailer are written here, with the check values of the blocks
+//    combined in order.
+//  - zstd: every block is written as its own zstd frame.
+//
+// A given instance of an ParallelCompressionOutputBuffer is NOT safe for
+// concurrent use by multiple threads
+class ParallelCompressionOutputBuffer : public WritableFile {
+ public:
+  // Create a ParallelCompressionOutputBuffer for `file` that compresses blocks
+  // of `block_bytes` uncompressed bytes on `num_threads` threads. At most two
+  // blocks per thread are in flight at any time.
+  //
+  // If `pool` is set, the blocks are compressed on it instead of on a pool
+  // owned by this buffer, so that several buffers can share the same threads.
+  // `pool` must outlive the buffer.
+  // Does not take ownership of `file` or `pool`.
+  ParallelCompressionOutputBuffer(WritableFile* file, int num_threads,
+                                  int64_t block_bytes,
+                                  const ZlibCompressionOptions& zlib_options,
+                                  thread::ThreadPool* pool = nullptr);
+  ParallelCompressionOutputBuffer(WritableFile* file, int num_threads,
+                                  int64_t block_bytes,
+                                  const ZstdCompressionOptions& zstd_options,
+                                  thread::ThreadPool* pool = nullptr);
+
+  // Waits for the blocks in flight, but does not write them out.
+  ~ParallelCompressionOutputBuffer() override;
+
+  // Validates the options and starts the thread pool, unless one was given.
+  // This call is required before any other operation on the buffer.
+  absl::Status Init();
+
+  // Adds `data` to the current block, handing the block to the thread pool
+  // once it is full.
+  absl::Status Append(absl::string_view data) override;
+
+#if defined(TF_CORD_SUPPORT)
+  absl::Status Append(const absl::Cord& cord) override;
+#endif
+
+  // Compresses the current (partial) block and writes all blocks in flight to
+  // file. Everything appended so far can be read back afterwards.
+  absl::Status Flush() override;
+
+  // Compresses the last block and writes all blocks and the stream trailer to
+  // file. This must be called before the destructor to avoid any data loss.
+  //
+  // After calling this, any further calls to `Append()` or `Flush()` will
+  // fail.
+  absl::Status Close() override;
+
+  // Returns the name of the underlying file.
+  absl::Status Name(absl::string_view* result) const override;
+
+  // Flushes all blocks to file and syncs it.
+  absl::Status Sync() override;
+
+  // Returns the write position in the underlying file. The position does not
+  // reflect blocks that are still being compressed.
+  absl::Status Tell(int64_t* position) override;
+
+ private:
+  struct Block;
+
+  bool IsZlib() const { return !is_zstd_; }
+
+  // Hands `input_` to the thread pool as the next block, after writing out
+  // finished blocks to stay within the in-flight limit.
+  absl::Status ScheduleBlock(bool last);
+
+  // Writes the finished blocks at the head of the queue to file, in order. If
+  // `wait` is set, waits for and writes all blocks in flight.
+  absl::Status WriteFinishedBlocks(bool wait);
+
+  // Compress `block` on a pool thread.
+  void DeflateBlock(Block* block) const;
+  void ZstdCompressBlock(Block* block) const;
+
+  // The zlib or gzip header and trailer around the deflate stream; empty for
+  // raw deflate.
+  std::string ZlibHeader() const;
+  std::string ZlibTrailer() const;
+
+  WritableFile* file_;  // Not owned
+  const int num_threads_;
+  const size_t block_bytes_;
+  const bool is_zstd_;
+  const ZlibCompressionOptions zlib_options_;
+  const ZstdCompressionOptions zstd_options_;
+  bool initialized_ = false;
+  bool closed_ = false;
+
+  // Base two logarithm of the deflate window.
+  int window_bits_ = 15;
+  // The last up to 2^window_bits_ bytes of input, used as the dictionary of
+  // the next zlib block.
+  std::string history_;
+  // Running check value (adler32 for zlib, crc32 for gzip) and length of the
+  // blocks written so far.
+  uint32_t check_ = 0;
+  uint64_t total_in_ = 0;
+
+  ZSTD_CDict* cdict_ = nullptr;
+
+  // Uncompressed bytes of the block that is being filled.
+  std::string input_;
+
+  // Blocks handed to the pool, oldest first.
+  std::deque<std::shared_ptr<Block>> pending_;
+
+  thread::ThreadPool* pool_;  // Not owned
+  // The pool started by Init() if none was given.
+  std::unique_ptr<thread::ThreadPool> owned_pool_;
+
+  ParallelCompressionOutputBuffer(const ParallelCompressionOutputBuffer&) =
+      delete;
+  void operator=(const ParallelCompressionOutputBuffer&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_PARALLEL_COMPRESSION_OUTPUTBUFFER_H_
@@ -0,0 +1,226 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/parallel_compression_outputbuffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/lib/io/random_inputstream.h"
+#include "xla/tsl/lib/io/zlib_compression_options.h"
+#include "xla/tsl/lib/io/zlib_inputstream.h"
+#include "xla/tsl/lib/io/zstd_compression_options.h"
+#include "xla/tsl/lib/io/zstd_inputstream.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/errors.h"
+#include "xla/tsl/platform/test.h"
+#include "xla/tsl/platform/threadpool.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+std::string GenTestString(int copies = 1) {
+  static const char kRecord[] =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Fusce "
+      "vehicula tincidunt libero sit amet ultrices. Vestibulum non felis "
+      "augue. Duis vitae augue id lectus lacinia congue et ut purus. ";
+  std::string result;
+  for (int i = 0; i < copies; i++) {
+    result += kRecord;
+    result += std::to_string(i);
+  }
+  return result;
+}
+
+// Writes `data` to `fname` in `num_writes` pieces through a
+// ParallelCompressionOutputBuffer with the given options.
+template <typename Options>
+void WriteCompressed(const std::string& fname, const std::string& data,
+                     int num_threads, int64_t block_bytes,
+                     const Options& options, int num_writes = 1) {
+  Env* env = Env::Default();
+  std::unique_ptr<WritableFile> file_writer;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+  ParallelCompressionOutputBuffer out(file_writer.get(), num_threads,
+                                      block_bytes, options);
+  TF_ASSERT_OK(out.Init());
+  const size_t piece_size = data.size() / num_writes + 1;
+  for (size_t i = 0; i < data.size(); i += piece_size) {
+    TF_ASSERT_OK(out.Append(absl::string_view(data).substr(i, piece_size)));
+  }
+  TF_ASSERT_OK(out.Close());
+  TF_ASSERT_OK(file_writer->Close());
+}
+
+absl::Status ReadZlib(const std::string& fname, int64_t bytes_to_read,
+                      const ZlibCompressionOptions& options, tstring* result) {
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  RandomAccessInputStream input_stream(file_reader.get());
+  ZlibInputStream in(&input_stream, 1000, 1000, options);
+  TF_RETURN_IF_ERROR(in.ReadNBytes(bytes_to_read, result));
+  // The stream must end right after the data, trailer included.
+  tstring rest;
+  absl::Status s = in.ReadNBytes(1, &rest);
+  return absl::IsOutOfRange(s) ? absl::OkStatus()
+                               : absl::DataLossError("Data after the stream");
+}
+
+absl::Status ReadZstd(const std::string& fname, int64_t bytes_to_read,
+                      tstring* result) {
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  RandomAccessInputStream input_stream(file_reader.get());
+  ZstdInputStream in(&input_stream, 1000, 1000,
+                     ZstdCompressionOptions::DEFAULT());
+  return in.ReadNBytes(bytes_to_read, result);
+}
+
+TEST(ParallelCompressionOutputBuffer, Zlib) {
+  std::string fname;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&fname));
+  ZlibCompressionOptions raw = ZlibCompressionOptions::DEFAULT();
+  raw.window_bits = -raw.window_bits;
+  for (const ZlibCompressionOptions& options :
+       {ZlibCompressionOptions::DEFAULT(), ZlibCompressionOptions::GZIP(),
+        raw}) {
+    for (int copies : {0, 1, 500}) {
+      std::string data = GenTestString(copies);
+      for (int64_t block_bytes : {1, 100, 4096, 1 << 20}) {
+        // Single byte blocks are slow for large inputs.
+        if (block_bytes == 1 && copies > 1) continue;
+        WriteCompressed(fname, data, /*num_threads=*/4, block_bytes, options,
+                        /*num_writes=*/7);
+        tstring result;
+        TF_ASSERT_OK(ReadZlib(fname, data.size(), options, &result))
+            << options.window_bits << " " << block_bytes;
+        EXPECT_EQ(result, data);
+      }
+    }
+  }
+}
+
+TEST(ParallelCompressionOutputBuffer, Zstd) {
+  std::string fname;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&fname));
+  for (int copies : {0, 1, 500}) {
+    std::string data = GenTestString(copies);
+    for (int64_t block_bytes : {1, 100, 4096, 1 << 20}) {
+      if (block_bytes == 1 && copies > 1) continue;
+      WriteCompressed(fname, data, /*num_threads=*/4, block_bytes,
+                      ZstdCompressionOptions::DEFAULT(), /*num_writes=*/7);
+      tstring result;
+      TF_ASSERT_OK(ReadZstd(fname, data.size(), &result)) << block_bytes;
+      EXPECT_EQ(result, data);
+    }
+  }
+}
+
+TEST(ParallelCompressionOutputBuffer, MatchesSerialCompressionRatio) {
+  // Priming every block with the input that precedes it keeps the zlib
+  // output close to what a single deflate stream produces.
+  std::string fname;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&fname));
+  std::string data = GenTestString(2000);
+  WriteCompressed(fname, data, /*num_threads=*/4, /*block_bytes=*/1 << 16,
+                  ZlibCompressionOptions::DEFAULT());
+  uint64_t parallel_size;
+  TF_ASSERT_OK(Env::Default()->GetFileSize(fname, &parallel_size));
+  WriteCompressed(fname, data, /*num_threads=*/1, /*block_bytes=*/data.size(),
+                  ZlibCompressionOptions::DEFAULT());
+  uint64_t single_block_size;
+  TF_ASSERT_OK(Env::Default()->GetFileSize(fname, &single_block_size));
+  EXPECT_LT(parallel_size, single_block_size * 11 / 10);
+}
+
+TEST(ParallelCompressionOutputBuffer, FlushMakesDataReadable) {
+  Env* env = Env::Default();
+  std::string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  std::string data = GenTestString(20);
+
+  std::unique_ptr<WritableFile> file_writer;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+  ParallelCompressionOutputBuffer out(file_writer.get(), /*num_threads=*/2,
+                                      /*block_bytes=*/1 << 20,
+                                      ZstdCompressionOptions::DEFAULT());
+  TF_ASSERT_OK(out.Init());
+  TF_ASSERT_OK(out.Append(data));
+  TF_ASSERT_OK(out.Flush());
+
+  tstring result;
+  TF_ASSERT_OK(ReadZstd(fname, data.size(), &result));
+  EXPECT_EQ(result, data);
+  TF_ASSERT_OK(out.Close());
+  EXPECT_FALSE(out.Append("more").ok());
+}
+
+TEST(ParallelCompressionOutputBuffer, SharesThreadPool) {
+  Env* env = Env::Default();
+  thread::ThreadPool pool(env, "shared_compression", /*num_threads=*/2);
+  std::string fnames[2];
+  std::unique_ptr<WritableFile> file_writers[2];
+  std::unique_ptr<ParallelCompressionOutputBuffer> outs[2];
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(env->LocalTempFilename(&fnames[i]));
+    TF_ASSERT_OK(env->NewWritableFile(fnames[i], &file_writers[i]));
+    outs[i] = std::make_unique<ParallelCompressionOutputBuffer>(
+        file_writers[i].get(), /*num_threads=*/2, /*block_bytes=*/100,
+        ZstdCompressionOptions::DEFAULT(), &pool);
+    TF_ASSERT_OK(outs[i]->Init());
+  }
+  const std::string data = GenTestString(50);
+  for (size_t i = 0; i < data.size(); i += 70) {
+    for (auto& out : outs) {
+      TF_ASSERT_OK(out->Append(absl::string_view(data).substr(i, 70)));
+    }
+  }
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK(outs[i]->Close());
+    TF_ASSERT_OK(file_writers[i]->Close());
+    tstring result;
+    TF_ASSERT_OK(ReadZstd(fnames[i], data.size(), &result));
+    EXPECT_EQ(result, data);
+  }
+}
+
+TEST(ParallelCompressionOutputBuffer, InvalidOptions) {
+  Env* env = Env::Default();
+  std::string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  std::unique_ptr<WritableFile> file_writer;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+
+  ParallelCompressionOutputBuffer no_threads(
+      file_writer.get(), /*num_threads=*/0, /*block_bytes=*/100,
+      ZstdCompressionOptions::DEFAULT());
+  EXPECT_TRUE(absl::IsInvalidArgument(no_threads.Init()));
+  EXPECT_TRUE(absl::IsFailedPrecondition(no_threads.Append("data")));
+
+  ZlibCompressionOptions options = ZlibCompressionOptions::DEFAULT();
+  options.mem_level = 100;
+  ParallelCompressionOutputBuffer bad_zlib(file_writer.get(), /*num_threads=*/2,
+                                           /*block_bytes=*/100, options);
+  EXPECT_TRUE(absl::IsInvalidArgument(bad_zlib.Init()));
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tsl
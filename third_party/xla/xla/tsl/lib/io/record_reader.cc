@@ -37,6 +37,9 @@ limitations under the License.
 #include "xla/tsl/platform/errors.h"
 #include "tsl/platform/raw_coding.h"
 #include "tsl/platform/tstring.h"
+#if !defined(IS_MOBILE_PLATFORM)
+#include "xla/tsl/lib/io/zstd_inputstream.h"
+#endif  // IS_MOBILE_PLATFORM
 
 namespace tsl {
 namespace io {
@@ -59,6 +62,11 @@ RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
   } else if (compression_type == compression::kSnappy) {
     options.compression_type = io::RecordReaderOptions::SNAPPY_COMPRESSION;
+#if !defined(IS_MOBILE_PLATFORM)
+  } else if (compression_type == compression::kZstd) {
+    options.compression_type = io::RecordReaderOptions::ZSTD_COMPRESSION;
+    options.zstd_options = io::ZstdCompressionOptions::DEFAULT();
+#endif  // IS_MOBILE_PLATFORM
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
                << ". No compression will be used.";
@@ -90,6 +98,15 @@ RecordReader::RecordReader(RandomAccessFile* file,
     input_stream_.reset(
         new SnappyInputStream(input_stream_.release(),
                               options.snappy_options.output_buffer_size, true));
+  } else if (options.compression_type ==
+             RecordReaderOptions::ZSTD_COMPRESSION) {
+#if defined(IS_MOBILE_PLATFORM)
+    LOG(FATAL) << "ZSTD compression is unsupported on mobile platforms.";
+#else
+    input_stream_.reset(new ZstdInputStream(
+        input_stream_.release(), options.zstd_options.input_buffer_size,
+        options.zstd_options.output_buffer_size, options.zstd_options, true));
+#endif  // IS_MOBILE_PLATFORM
   } else if (options.compression_type == RecordReaderOptions::NONE) {
     // Nothing to do.
   } else {
@@ -19,11 +19,19 @@ limitations under the License.
 #include "xla/tsl/lib/io/inputstream_interface.h"
 #include "xla/tsl/platform/errors.h"
 #include "tsl/platform/stringpiece.h"
+// clang-format off
+// Required for IS_MOBILE_PLATFORM
+#include "tsl/platform/platform.h"  // IWYU pragma: keep
+// clang-format on
 #if !defined(IS_SLIM_BUILD)
 #include "xla/tsl/lib/io/snappy/snappy_compression_options.h"
 #include "xla/tsl/lib/io/snappy/snappy_inputstream.h"
 #include "xla/tsl/lib/io/zlib_compression_options.h"
 #include "xla/tsl/lib/io/zlib_inputstream.h"
+#if !defined(IS_MOBILE_PLATFORM)
+#include "xla/tsl/lib/io/zstd_compression_options.h"
+#include "xla/tsl/lib/io/zstd_inputstream.h"
+#endif  // IS_MOBILE_PLATFORM
 #endif  // IS_SLIM_BUILD
 #include "xla/tsl/platform/macros.h"
 #include "xla/tsl/platform/types.h"
@@ -37,7 +45,8 @@ struct RecordReaderOptions {
   enum CompressionType {
     NONE = 0,
     ZLIB_COMPRESSION = 1,
-    SNAPPY_COMPRESSION = 2
+    SNAPPY_COMPRESSION = 2,
+    ZSTD_COMPRESSION = 3
   };
   CompressionType compression_type = NONE;
 
@@ -53,6 +62,10 @@ struct RecordReaderOptions {
   // Options specific to compression.
   ZlibCompressionOptions zlib_options;
   SnappyCompressionOptions snappy_options;
+#if !defined(IS_MOBILE_PLATFORM)
+  // zstd is not part of mobile builds.
+  ZstdCompressionOptions zstd_options;
+#endif  // IS_MOBILE_PLATFORM
 #endif  // IS_SLIM_BUILD
 };
 
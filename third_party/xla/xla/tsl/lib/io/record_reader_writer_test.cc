@@ -21,6 +21,7 @@ limitations under the License.
 #include <zlib.h>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/log/check.h"
@@ -45,6 +46,9 @@ io::RecordReaderOptions GetMatchingReaderOptions(
   if (options.compression_type == io::RecordWriterOptions::ZLIB_COMPRESSION) {
     return io::RecordReaderOptions::CreateRecordReaderOptions("ZLIB");
   }
+  if (options.compression_type == io::RecordWriterOptions::ZSTD_COMPRESSION) {
+    return io::RecordReaderOptions::CreateRecordReaderOptions("ZSTD");
+  }
   return io::RecordReaderOptions::CreateRecordReaderOptions("");
 }
 
@@ -121,6 +125,16 @@ TEST(RecordReaderWriterTest, TestZlibSyncFlush) {
   VerifyFlush(options);
 }
 
+TEST(RecordReaderWriterTest, TestZstdFlush) {
+  // Unlike zlib's default flush mode, flushing a zstd stream always ends the
+  // current block, so every flushed record can be read back right away.
+  io::RecordWriterOptions options =
+      io::RecordWriterOptions::CreateRecordWriterOptions("ZSTD");
+  EXPECT_EQ(options.compression_type,
+            io::RecordWriterOptions::ZSTD_COMPRESSION);
+  VerifyFlush(options);
+}
+
 TEST(RecordReaderWriterTest, TestBasics) {
   Env* env = Env::Default();
   std::string fname = testing::TmpDir() + "/record_reader_writer_test";
@@ -344,6 +358,94 @@ TEST(RecordReaderWriterTest, TestZlib) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestZstd) {
+  Env* env = Env::Default();
+  std::string fname = testing::TmpDir() + "/record_reader_writer_zstd_test";
+
+  for (auto buf_size : BufferSizes()) {
+    {
+      std::unique_ptr<WritableFile> file;
+      CHECK_OK(env->NewWritableFile(fname, &file));
+
+      io::RecordWriterOptions options;
+      options.compression_type = io::RecordWriterOptions::ZSTD_COMPRESSION;
+      options.zstd_options.output_buffer_size = buf_size;
+      io::RecordWriter writer(file.get(), options);
+      TF_EXPECT_OK(writer.WriteRecord("abc"));
+      TF_EXPECT_OK(writer.WriteRecord("defg"));
+      CHECK_OK(writer.Flush());
+    }
+
+    {
+      std::unique_ptr<RandomAccessFile> read_file;
+      // Read it back with the RecordReader.
+      CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+      io::RecordReaderOptions options;
+      options.compression_type = io::RecordReaderOptions::ZSTD_COMPRESSION;
+      options.zstd_options.input_buffer_size = buf_size;
+      io::RecordReader reader(read_file.get(), options);
+      uint64_t offset = 0;
+      tstring record;
+      CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ("abc", record);
+      CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ("defg", record);
+    }
+  }
+}
+
+TEST(RecordReaderWriterTest, TestParallelCompressionFlush) {
+  io::RecordWriterOptions options =
+      io::RecordWriterOptions::CreateRecordWriterOptions("ZLIB");
+  options.compression_threads = 4;
+  options.compression_block_size = 16;
+  VerifyFlush(options);
+}
+
+TEST(RecordReaderWriterTest, TestParallelCompression) {
+  Env* env = Env::Default();
+  std::string fname =
+      testing::TmpDir() + "/record_reader_writer_parallel_compression_test";
+  std::vector<std::string> records;
+  for (int i = 0; i < 1000; ++i) {
+    records.push_back(strings::StrCat("record ", i, std::string(i % 37, 'x')));
+  }
+
+  for (const char* compression_type : {"ZLIB", "GZIP", "ZSTD"}) {
+    {
+      std::unique_ptr<WritableFile> file;
+      CHECK_OK(env->NewWritableFile(fname, &file));
+
+      io::RecordWriterOptions options =
+          io::RecordWriterOptions::CreateRecordWriterOptions(compression_type);
+      options.compression_threads = 4;
+      options.compression_block_size = 1000;
+      io::RecordWriter writer(file.get(), options);
+      for (const std::string& record : records) {
+        TF_EXPECT_OK(writer.WriteRecord(record));
+      }
+      TF_EXPECT_OK(writer.Close());
+      TF_EXPECT_OK(file->Close());
+    }
+
+    {
+      std::unique_ptr<RandomAccessFile> read_file;
+      // Read it back with the RecordReader.
+      CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+      io::RecordReader reader(
+          read_file.get(),
+          io::RecordReaderOptions::CreateRecordReaderOptions(compression_type));
+      uint64_t offset = 0;
+      tstring record;
+      for (const std::string& expected : records) {
+        TF_ASSERT_OK(reader.ReadRecord(&offset, &record)) << compression_type;
+        EXPECT_EQ(expected, record);
+      }
+      EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+    }
+  }
+}
+
 TEST(RecordReaderWriterTest, TestUseAfterClose) {
   Env* env = Env::Default();
   std::string fname =
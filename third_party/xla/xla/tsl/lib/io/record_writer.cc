@@ -31,6 +31,10 @@ bool IsZlibCompressed(const RecordWriterOptions& options) {
 bool IsSnappyCompressed(const RecordWriterOptions& options) {
   return options.compression_type == RecordWriterOptions::SNAPPY_COMPRESSION;
 }
+
+bool IsZstdCompressed(const RecordWriterOptions& options) {
+  return options.compression_type == RecordWriterOptions::ZSTD_COMPRESSION;
+}
 }  // namespace
 
 RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
@@ -50,6 +54,9 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
   } else if (compression_type == compression::kSnappy) {
     options.compression_type = io::RecordWriterOptions::SNAPPY_COMPRESSION;
+  } else if (compression_type == compression::kZstd) {
+    options.compression_type = io::RecordWriterOptions::ZSTD_COMPRESSION;
+    options.zstd_options = io::ZstdCompressionOptions::DEFAULT();
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
                << ". No compression will be used.";
@@ -66,7 +73,25 @@ RecordWriter::RecordWriter(WritableFile* dest,
     LOG(FATAL) << "Compression is unsupported on mobile platforms.";
   }
 #else
-  if (IsZlibCompressed(options)) {
+  if (options.compression_threads > 1 &&
+      (IsZlibCompressed(options) || IsZstdCompressed(options))) {
+    ParallelCompressionOutputBuffer* parallel_output_buffer =
+        IsZlibCompressed(options)
+            ? new ParallelCompressionOutputBuffer(
+                  dest, options.compression_threads,
+                  options.compression_block_size, options.zlib_options,
+                  options.compression_thread_pool)
+            : new ParallelCompressionOutputBuffer(
+                  dest, options.compression_threads,
+                  options.compression_block_size, options.zstd_options,
+                  options.compression_thread_pool);
+    absl::Status s = parallel_output_buffer->Init();
+    if (!s.ok()) {
+      LOG(FATAL) << "Failed to initialize parallel compression outputbuffer. "
+                 << "Error: " << s;
+    }
+    dest_ = parallel_output_buffer;
+  } else if (IsZlibCompressed(options)) {
     ZlibOutputBuffer* zlib_output_buffer = new ZlibOutputBuffer(
         dest, options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options);
@@ -79,6 +104,15 @@ RecordWriter::RecordWriter(WritableFile* dest,
     dest_ =
         new SnappyOutputBuffer(dest, options.snappy_options.input_buffer_size,
                                options.snappy_options.output_buffer_size);
+  } else if (IsZstdCompressed(options)) {
+    ZstdOutputBuffer* zstd_output_buffer = new ZstdOutputBuffer(
+        dest, options.zstd_options.input_buffer_size,
+        options.zstd_options.output_buffer_size, options.zstd_options);
+    absl::Status s = zstd_output_buffer->Init();
+    if (!s.ok()) {
+      LOG(FATAL) << "Failed to initialize Zstd outputbuffer. Error: " << s;
+    }
+    dest_ = zstd_output_buffer;
   } else if (options.compression_type == RecordWriterOptions::NONE) {
     // Nothing to do
   } else {
@@ -138,7 +172,8 @@ absl::Status RecordWriter::WriteRecord(const absl::Cord& data) {
 
 absl::Status RecordWriter::Close() {
   if (dest_ == nullptr) return absl::OkStatus();
-  if (IsZlibCompressed(options_) || IsSnappyCompressed(options_)) {
+  if (IsZlibCompressed(options_) || IsSnappyCompressed(options_) ||
+      IsZstdCompressed(options_)) {
     absl::Status s = dest_->Close();
     delete dest_;
     dest_ = nullptr;
@@ -21,10 +21,13 @@ limitations under the License.
 #include "tsl/platform/coding.h"
 #include "tsl/platform/stringpiece.h"
 #if !defined(IS_SLIM_BUILD)
+#include "xla/tsl/lib/io/parallel_compression_outputbuffer.h"
 #include "xla/tsl/lib/io/snappy/snappy_compression_options.h"
 #include "xla/tsl/lib/io/snappy/snappy_outputbuffer.h"
 #include "xla/tsl/lib/io/zlib_compression_options.h"
 #include "xla/tsl/lib/io/zlib_outputbuffer.h"
+#include "xla/tsl/lib/io/zstd_compression_options.h"
+#include "xla/tsl/lib/io/zstd_outputbuffer.h"
 #endif  // IS_SLIM_BUILD
 #include "xla/tsl/platform/macros.h"
 #include "xla/tsl/platform/types.h"
@@ -34,6 +37,10 @@ namespace tsl {
 
 class WritableFile;
 
+namespace thread {
+class ThreadPool;
+}  // namespace thread
+
 namespace io {
 
 struct RecordWriterOptions {
@@ -41,17 +48,32 @@ struct RecordWriterOptions {
   enum CompressionType {
     NONE = 0,
     ZLIB_COMPRESSION = 1,
-    SNAPPY_COMPRESSION = 2
+    SNAPPY_COMPRESSION = 2,
+    ZSTD_COMPRESSION = 3
   };
   CompressionType compression_type = NONE;
 
   static RecordWriterOptions CreateRecordWriterOptions(
       const std::string& compression_type);
 
+  // Number of threads compressing the output. With more than one thread, ZLIB
+  // and ZSTD output is compressed in independent blocks of
+  // `compression_block_size` uncompressed bytes on a thread pool (see
+  // ParallelCompressionOutputBuffer). The result is read back by RecordReader
+  // as usual. Ignored for SNAPPY.
+  int compression_threads = 1;
+  int64_t compression_block_size = 1 << 20;
+  // If set, the blocks are compressed on this pool, which may be shared by
+  // several writers and must outlive the RecordWriter, instead of on a pool
+  // of `compression_threads` threads owned by the writer. At most two blocks
+  // per `compression_threads` are then in flight. Not owned.
+  thread::ThreadPool* compression_thread_pool = nullptr;
+
 #if !defined(IS_SLIM_BUILD)
   // Options specific to compression.
   io::ZlibCompressionOptions zlib_options;
   io::SnappyCompressionOptions snappy_options;
+  io::ZstdCompressionOptions zstd_options;
 #endif  // IS_SLIM_BUILD
 };
 
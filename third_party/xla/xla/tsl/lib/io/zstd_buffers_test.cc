@@ -0,0 +1,201 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/lib/io/random_inputstream.h"
+#include "xla/tsl/lib/io/zstd_compression_options.h"
+#include "xla/tsl/lib/io/zstd_inputstream.h"
+#include "xla/tsl/lib/io/zstd_outputbuffer.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/errors.h"
+#include "xla/tsl/platform/test.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+std::vector<int> BufferSizes() { return {1, 10, 100, 1000, 256 << 10}; }
+
+std::string GenTestString(int copies = 1) {
+  static const char kRecord[] =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Fusce "
+      "vehicula tincidunt libero sit amet ultrices. Vestibulum non felis "
+      "augue. Duis vitae augue id lectus lacinia congue et ut purus. ";
+  std::string result;
+  for (int i = 0; i < copies; i++) {
+    result += kRecord;
+    result += std::to_string(i);
+  }
+  return result;
+}
+
+// Writes `data` to `fname` in `num_writes` pieces, flushing after each piece
+// if `with_flush` is set.
+void WriteCompressed(const std::string& fname, const std::string& data,
+                     int input_buf_size, int output_buf_size,
+                     const ZstdCompressionOptions& options, int num_writes = 1,
+                     bool with_flush = false) {
+  Env* env = Env::Default();
+  std::unique_ptr<WritableFile> file_writer;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+  ZstdOutputBuffer out(file_writer.get(), input_buf_size, output_buf_size,
+                       options);
+  TF_ASSERT_OK(out.Init());
+  const size_t piece_size = data.size() / num_writes + 1;
+  for (size_t i = 0; i < data.size(); i += piece_size) {
+    TF_ASSERT_OK(out.Append(absl::string_view(data).substr(i, piece_size)));
+    if (with_flush) {
+      TF_ASSERT_OK(out.Flush());
+    }
+  }
+  TF_ASSERT_OK(out.Close());
+  TF_ASSERT_OK(file_writer->Close());
+}
+
+absl::Status ReadCompressed(const std::string& fname, int64_t bytes_to_read,
+                            int input_buf_size, int output_buf_size,
+                            const ZstdCompressionOptions& options,
+                            tstring* result) {
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  RandomAccessInputStream input_stream(file_reader.get());
+  ZstdInputStream in(&input_stream, input_buf_size, output_buf_size, options);
+  return in.ReadNBytes(bytes_to_read, result);
+}
+
+TEST(ZstdBuffers, AllBufferSizes) {
+  std::string fname;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&fname));
+  const ZstdCompressionOptions options = ZstdCompressionOptions::DEFAULT();
+  for (int copies : {1, 50, 500}) {
+    std::string data = GenTestString(copies);
+    for (int input_buf_size : BufferSizes()) {
+      for (int output_buf_size : BufferSizes()) {
+        WriteCompressed(fname, data, input_buf_size, output_buf_size, options,
+                        /*num_writes=*/7);
+        tstring result;
+        TF_ASSERT_OK(ReadCompressed(fname, data.size(), input_buf_size,
+                                    output_buf_size, options, &result));
+        EXPECT_EQ(result, data) << input_buf_size << " " << output_buf_size;
+      }
+    }
+  }
+}
+
+TEST(ZstdBuffers, MultipleWriteCallsWithFlush) {
+  std::string fname;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&fname));
+  const ZstdCompressionOptions options = ZstdCompressionOptions::DEFAULT();
+  std::string data = GenTestString(10);
+  WriteCompressed(fname, data, 200, 200, options, /*num_writes=*/10,
+                  /*with_flush=*/true);
+  tstring result;
+  TF_ASSERT_OK(ReadCompressed(fname, data.size(), 200, 200, options, &result));
+  EXPECT_EQ(result, data);
+}
+
+TEST(ZstdBuffers, FlushMakesDataReadable) {
+  Env* env = Env::Default();
+  std::string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  const ZstdCompressionOptions options = ZstdCompressionOptions::DEFAULT();
+  std::string data = GenTestString(20);
+
+  std::unique_ptr<WritableFile> file_writer;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+  ZstdOutputBuffer out(file_writer.get(), 1 << 20, 1 << 20, options);
+  TF_ASSERT_OK(out.Init());
+  TF_ASSERT_OK(out.Append(data));
+  TF_ASSERT_OK(out.Flush());
+
+  // The frame is not finished yet, but everything appended so far is.
+  tstring result;
+  TF_ASSERT_OK(ReadCompressed(fname, data.size(), 100, 100, options, &result));
+  EXPECT_EQ(result, data);
+  TF_ASSERT_OK(out.Close());
+  EXPECT_FALSE(out.Append("more").ok());
+}
+
+TEST(ZstdBuffers, Dictionary) {
+  std::string fname;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&fname));
+  ZstdCompressionOptions options = ZstdCompressionOptions::DEFAULT();
+  options.dictionary = GenTestString(4);
+  std::string data = GenTestString(1);
+
+  WriteCompressed(fname, data, 100, 100, options);
+  uint64_t dictionary_size;
+  TF_ASSERT_OK(Env::Default()->GetFileSize(fname, &dictionary_size));
+  tstring result;
+  TF_ASSERT_OK(ReadCompressed(fname, data.size(), 100, 100, options, &result));
+  EXPECT_EQ(result, data);
+
+  // Without the dictionary the stream can not be decoded.
+  EXPECT_TRUE(absl::IsDataLoss(
+      ReadCompressed(fname, data.size(), 100, 100,
+                     ZstdCompressionOptions::DEFAULT(), &result)));
+
+  WriteCompressed(fname, data, 100, 100, ZstdCompressionOptions::DEFAULT());
+  uint64_t plain_size;
+  TF_ASSERT_OK(Env::Default()->GetFileSize(fname, &plain_size));
+  EXPECT_LT(dictionary_size, plain_size);
+}
+
+TEST(ZstdInputStream, TellAndReset) {
+  std::string fname;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&fname));
+  const ZstdCompressionOptions options = ZstdCompressionOptions::DEFAULT();
+  std::string data = GenTestString(50);
+  WriteCompressed(fname, data, 100, 100, options);
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  RandomAccessInputStream input_stream(file_reader.get());
+  ZstdInputStream in(&input_stream, 100, 100, options);
+
+  const size_t half = data.size() / 2;
+  TF_ASSERT_OK(in.SkipNBytes(half));
+  EXPECT_EQ(in.Tell(), half);
+  tstring result;
+  TF_ASSERT_OK(in.ReadNBytes(data.size() - half, &result));
+  EXPECT_EQ(result, data.substr(half));
+  EXPECT_EQ(in.Tell(), data.size());
+  EXPECT_TRUE(absl::IsOutOfRange(in.ReadNBytes(1, &result)));
+
+  TF_ASSERT_OK(in.Reset());
+  EXPECT_EQ(in.Tell(), 0);
+  TF_ASSERT_OK(in.ReadNBytes(data.size(), &result));
+  EXPECT_EQ(result, data);
+}
+
+TEST(ZstdInputStream, FailsOnCorruptedInput) {
+  Env* env = Env::Default();
+  std::string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  TF_ASSERT_OK(WriteStringToFile(env, fname, "nonsense non-zstd data"));
+
+  tstring result;
+  EXPECT_TRUE(absl::IsDataLoss(ReadCompressed(
+      fname, 5, 100, 100, ZstdCompressionOptions::DEFAULT(), &result)));
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,54 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_ZSTD_COMPRESSION_OPTIONS_H_
+#define XLA_TSL_LIB_IO_ZSTD_COMPRESSION_OPTIONS_H_
+
+#include <string>
+
+#include "xla/tsl/platform/types.h"
+
+namespace tsl {
+namespace io {
+
+struct ZstdCompressionOptions {
+  static ZstdCompressionOptions DEFAULT() { return ZstdCompressionOptions(); }
+
+  // Size of the buffer used for caching the data read from source file.
+  int64_t input_buffer_size = 256 << 10;
+
+  // Size of the sink buffer where the compressed/decompressed data produced by
+  // zstd is cached.
+  int64_t output_buffer_size = 256 << 10;
+
+  // From the zstd manual (http://facebook.github.io/zstd/zstd_manual.html):
+  // levels range from negative values (fastest, least compression) up to 22;
+  // 0 selects the library default (currently 3). Levels above 19 use a lot
+  // more memory on both ends.
+  //
+  // This option is ignored for `ZstdInputStream`.
+  int compression_level = 3;
+
+  // Raw content dictionary (or one produced by `zstd --train`). Streams
+  // written with a dictionary can only be read back with the same dictionary,
+  // which makes this mostly useful for files of many small, similar records.
+  // Empty means no dictionary.
+  std::string dictionary;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_ZSTD_COMPRESSION_OPTIONS_H_
@@ -0,0 +1,161 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/zstd_inputstream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/platform/status_macros.h"
+#include "zstd.h"
+
+namespace tsl {
+namespace io {
+
+ZstdInputStream::ZstdInputStream(InputStreamInterface* input_stream,
+                                 size_t input_buffer_bytes,
+                                 size_t output_buffer_bytes,
+                                 const ZstdCompressionOptions& zstd_options,
+                                 bool owns_input_stream)
+    : owns_input_stream_(owns_input_stream),
+      input_stream_(input_stream),
+      input_buffer_capacity_(input_buffer_bytes),
+      output_buffer_capacity_(output_buffer_bytes),
+      zstd_options_(zstd_options),
+      output_(new char[output_buffer_bytes]),
+      next_unread_byte_(output_.get()),
+      output_end_(output_.get()) {
+  dctx_ = ZSTD_createDCtx();
+  if (dctx_ == nullptr) {
+    init_status_ = absl::InternalError("ZSTD_createDCtx() failed.");
+    return;
+  }
+  if (!zstd_options_.dictionary.empty()) {
+    size_t error =
+        ZSTD_DCtx_loadDictionary(dctx_, zstd_options_.dictionary.data(),
+                                 zstd_options_.dictionary.size());
+    if (ZSTD_isError(error)) {
+      init_status_ = absl::InvalidArgumentError(
+          absl::StrCat("Unable to load zstd dictionary: ",
+                       ZSTD_getErrorName(error)));
+    }
+  }
+}
+
+ZstdInputStream::ZstdInputStream(InputStreamInterface* input_stream,
+                                 size_t input_buffer_bytes,
+                                 size_t output_buffer_bytes,
+                                 const ZstdCompressionOptions& zstd_options)
+    : ZstdInputStream(input_stream, input_buffer_bytes, output_buffer_bytes,
+                      zstd_options, false) {}
+
+ZstdInputStream::~ZstdInputStream() {
+  ZSTD_freeDCtx(dctx_);
+  if (owns_input_stream_) {
+    delete input_stream_;
+  }
+}
+
+absl::Status ZstdInputStream::Reset() {
+  RETURN_IF_ERROR(init_status_);
+  RETURN_IF_ERROR(input_stream_->Reset());
+  // Keeps the loaded dictionary.
+  ZSTD_DCtx_reset(dctx_, ZSTD_reset_session_only);
+  input_.clear();
+  input_pos_ = 0;
+  next_unread_byte_ = output_.get();
+  output_end_ = output_.get();
+  output_pending_ = false;
+  bytes_read_ = 0;
+  return absl::OkStatus();
+}
+
+absl::Status ZstdInputStream::ReadFromStream() {
+  absl::Status s = input_stream_->ReadNBytes(input_buffer_capacity_, &input_);
+  input_pos_ = 0;
+  if (!s.ok() && !absl::IsOutOfRange(s)) {
+    return s;
+  }
+  // As in ZlibInputStream, the last read may come back short with an
+  // OutOfRange status; only report the end of the stream once nothing at all
+  // could be read.
+  if (input_.empty()) {
+    return absl::OutOfRangeError("EOF reached");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ZstdInputStream::Decompress() {
+  ZSTD_inBuffer in = {input_.data(), input_.size(), input_pos_};
+  ZSTD_outBuffer out = {output_.get(), output_buffer_capacity_, 0};
+  size_t error = ZSTD_decompressStream(dctx_, &out, &in);
+  if (ZSTD_isError(error)) {
+    return absl::DataLossError(absl::StrCat(
+        "ZSTD_decompressStream() failed: ", ZSTD_getErrorName(error)));
+  }
+  input_pos_ = in.pos;
+  next_unread_byte_ = output_.get();
+  output_end_ = output_.get() + out.pos;
+  output_pending_ = out.pos == out.size;
+  return absl::OkStatus();
+}
+
+size_t ZstdInputStream::ReadBytesFromCache(size_t bytes_to_read,
+                                           tstring* result) {
+  size_t can_read_bytes =
+      std::min<size_t>(bytes_to_read, output_end_ - next_unread_byte_);
+  if (can_read_bytes > 0) {
+    result->append(next_unread_byte_, can_read_bytes);
+    next_unread_byte_ += can_read_bytes;
+  }
+  bytes_read_ += can_read_bytes;
+  return can_read_bytes;
+}
+
+absl::Status ZstdInputStream::ReadNBytes(int64_t bytes_to_read,
+                                         tstring* result) {
+  RETURN_IF_ERROR(init_status_);
+  result->clear();
+  // Read as many bytes as possible from cache.
+  bytes_to_read -= ReadBytesFromCache(bytes_to_read, result);
+
+  while (bytes_to_read > 0) {
+    if (input_pos_ == input_.size() && !output_pending_) {
+      RETURN_IF_ERROR(ReadFromStream());
+    }
+    RETURN_IF_ERROR(Decompress());
+    bytes_to_read -= ReadBytesFromCache(bytes_to_read, result);
+  }
+  return absl::OkStatus();
+}
+
+#if defined(TF_CORD_SUPPORT)
+absl::Status ZstdInputStream::ReadNBytes(int64_t bytes_to_read,
+                                         absl::Cord* result) {
+  tstring buf;
+  RETURN_IF_ERROR(ReadNBytes(bytes_to_read, &buf));
+  result->Clear();
+  result->Append(absl::string_view(buf));
+  return absl::OkStatus();
+}
+#endif
+
+int64_t ZstdInputStream::Tell() const { return bytes_read_; }
+
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,128 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_ZSTD_INPUTSTREAM_H_
+#define XLA_TSL_LIB_IO_ZSTD_INPUTSTREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "xla/tsl/lib/io/inputstream_interface.h"
+#include "xla/tsl/lib/io/zstd_compression_options.h"
+#include "xla/tsl/platform/types.h"
+
+// Forward declare the decompression context of zstd.h, which is only included
+// in the .cc file.
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+namespace tsl {
+namespace io {
+
+// An ZstdInputStream provides support for reading from a stream compressed
+// using zstd (https://facebook.github.io/zstd/). Buffers the contents of the
+// file. Concatenated zstd frames are read back as a single stream.
+//
+// A given instance of an ZstdInputStream is NOT safe for concurrent use
+// by multiple threads
+class ZstdInputStream : public InputStreamInterface {
+ public:
+  // Create a ZstdInputStream for `input_stream` with a buffer of size
+  // `input_buffer_bytes` bytes for reading contents from `input_stream` and
+  // another buffer with size `output_buffer_bytes` for caching decompressed
+  // contents.
+  //
+  // Takes ownership of `input_stream` iff `owns_input_stream` is true.
+  ZstdInputStream(InputStreamInterface* input_stream, size_t input_buffer_bytes,
+                  size_t output_buffer_bytes,
+                  const ZstdCompressionOptions& zstd_options,
+                  bool owns_input_stream);
+
+  // Equivalent to the previous constructor with owns_input_stream=false.
+  ZstdInputStream(InputStreamInterface* input_stream, size_t input_buffer_bytes,
+                  size_t output_buffer_bytes,
+                  const ZstdCompressionOptions& zstd_options);
+
+  ~ZstdInputStream() override;
+
+  // Reads bytes_to_read bytes into *result, overwriting *result.
+  //
+  // Return Status codes:
+  // OK:           If successful.
+  // OUT_OF_RANGE: If there are not enough bytes to read before
+  //               the end of the stream.
+  // DATA_LOSS:    If the stream is not valid zstd data, or was written with a
+  //               different dictionary.
+  // others:       If reading from stream failed.
+  absl::Status ReadNBytes(int64_t bytes_to_read, tstring* result) override;
+
+#if defined(TF_CORD_SUPPORT)
+  absl::Status ReadNBytes(int64_t bytes_to_read, absl::Cord* result) override;
+#endif
+
+  int64_t Tell() const override;
+
+  absl::Status Reset() override;
+
+ private:
+  // Reads up to `input_buffer_capacity_` compressed bytes from
+  // `input_stream_`, replacing the (fully consumed) contents of `input_`.
+  //
+  // Returns OutOfRange error iff no data could be read from the stream.
+  absl::Status ReadFromStream();
+
+  // Decompresses as much of `input_` as fits in the output buffer and resets
+  // the cache to the produced bytes.
+  absl::Status Decompress();
+
+  // Appends up to `bytes_to_read` cached bytes to `result` and returns how
+  // many were appended.
+  size_t ReadBytesFromCache(size_t bytes_to_read, tstring* result);
+
+  const bool owns_input_stream_;
+  InputStreamInterface* input_stream_;
+  const size_t input_buffer_capacity_;
+  const size_t output_buffer_capacity_;
+  const ZstdCompressionOptions zstd_options_;
+
+  ZSTD_DCtx* dctx_ = nullptr;
+  absl::Status init_status_;
+
+  // Compressed bytes read from `input_stream_`; the first `input_pos_` of
+  // them have been handed to zstd already.
+  tstring input_;
+  size_t input_pos_ = 0;
+
+  // Decompressed bytes. [next_unread_byte_, output_end_) has not been
+  // returned to the caller yet.
+  std::unique_ptr<char[]> output_;
+  char* next_unread_byte_;
+  char* output_end_;
+  // Whether the last decompression filled the output buffer, in which case
+  // zstd may hold more output without needing further input.
+  bool output_pending_ = false;
+
+  // Number of *uncompressed* bytes that have been read from this stream.
+  int64_t bytes_read_ = 0;
+
+  ZstdInputStream(const ZstdInputStream&) = delete;
+  void operator=(const ZstdInputStream&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_ZSTD_INPUTSTREAM_H_
@@ -0,0 +1,163 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/zstd_outputbuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/platform/status_macros.h"
+#include "zstd.h"
+
+namespace tsl {
+namespace io {
+
+ZstdOutputBuffer::ZstdOutputBuffer(WritableFile* file,
+                                   int64_t input_buffer_bytes,
+                                   int64_t output_buffer_bytes,
+                                   const ZstdCompressionOptions& zstd_options)
+    : file_(file),
+      input_buffer_capacity_(input_buffer_bytes),
+      output_buffer_capacity_(output_buffer_bytes),
+      zstd_options_(zstd_options),
+      output_(new char[output_buffer_bytes]) {}
+
+ZstdOutputBuffer::~ZstdOutputBuffer() {
+  if (cctx_ != nullptr) {
+    LOG(WARNING) << "ZstdOutputBuffer::Close() not called. Possible data loss";
+    ZSTD_freeCCtx(cctx_);
+  }
+}
+
+absl::Status ZstdOutputBuffer::Init() {
+  if (output_buffer_capacity_ == 0) {
+    return absl::InvalidArgumentError(
+        "output_buffer_bytes should be greater than 0");
+  }
+  cctx_ = ZSTD_createCCtx();
+  if (cctx_ == nullptr) {
+    return absl::InternalError("ZSTD_createCCtx() failed.");
+  }
+  size_t error = ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel,
+                                        zstd_options_.compression_level);
+  if (!ZSTD_isError(error) && !zstd_options_.dictionary.empty()) {
+    error = ZSTD_CCtx_loadDictionary(cctx_, zstd_options_.dictionary.data(),
+                                     zstd_options_.dictionary.size());
+  }
+  if (ZSTD_isError(error)) {
+    ZSTD_freeCCtx(cctx_);
+    cctx_ = nullptr;
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unable to configure zstd compression: ", ZSTD_getErrorName(error)));
+  }
+  input_.reserve(input_buffer_capacity_);
+  return absl::OkStatus();
+}
+
+absl::Status ZstdOutputBuffer::Compress(absl::string_view data,
+                                        int end_directive) {
+  const auto mode = static_cast<ZSTD_EndDirective>(end_directive);
+  ZSTD_inBuffer in = {data.data(), data.size(), 0};
+  bool done = false;
+  while (!done) {
+    ZSTD_outBuffer out = {output_.get(), output_buffer_capacity_, 0};
+    size_t remaining = ZSTD_compressStream2(cctx_, &out, &in, mode);
+    if (ZSTD_isError(remaining)) {
+      return absl::DataLossError(absl::StrCat(
+          "ZSTD_compressStream2() failed: ", ZSTD_getErrorName(remaining)));
+    }
+    if (out.pos > 0) {
+      RETURN_IF_ERROR(
+          file_->Append(absl::string_view(output_.get(), out.pos)));
+    }
+    // ZSTD_e_continue only has to consume the input; flushing and ending also
+    // have to drain everything zstd buffered internally.
+    done = mode == ZSTD_e_continue ? in.pos == in.size : remaining == 0;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ZstdOutputBuffer::CompressBuffered(int end_directive) {
+  absl::Status s = Compress(input_, end_directive);
+  input_.clear();
+  return s;
+}
+
+absl::Status ZstdOutputBuffer::Append(absl::string_view data) {
+  if (cctx_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "ZstdOutputBuffer is not initialized or already closed.");
+  }
+  if (input_.size() + data.size() <= input_buffer_capacity_) {
+    input_.append(data.data(), data.size());
+    return absl::OkStatus();
+  }
+  RETURN_IF_ERROR(CompressBuffered(ZSTD_e_continue));
+  if (data.size() <= input_buffer_capacity_) {
+    input_.append(data.data(), data.size());
+    return absl::OkStatus();
+  }
+  // `data` is too large to fit in the input buffer so we compress it directly.
+  return Compress(data, ZSTD_e_continue);
+}
+
+#if defined(TF_CORD_SUPPORT)
+absl::Status ZstdOutputBuffer::Append(const absl::Cord& cord) {
+  for (absl::string_view fragment : cord.Chunks()) {
+    RETURN_IF_ERROR(Append(fragment));
+  }
+  return absl::OkStatus();
+}
+#endif
+
+absl::Status ZstdOutputBuffer::Flush() {
+  if (cctx_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "ZstdOutputBuffer is not initialized or already closed.");
+  }
+  RETURN_IF_ERROR(CompressBuffered(ZSTD_e_flush));
+  return file_->Flush();
+}
+
+absl::Status ZstdOutputBuffer::Name(absl::string_view* result) const {
+  return file_->Name(result);
+}
+
+absl::Status ZstdOutputBuffer::Sync() {
+  RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
+absl::Status ZstdOutputBuffer::Close() {
+  if (cctx_ != nullptr) {
+    absl::Status s = CompressBuffered(ZSTD_e_end);
+    ZSTD_freeCCtx(cctx_);
+    cctx_ = nullptr;
+    return s;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ZstdOutputBuffer::Tell(int64_t* position) {
+  return file_->Tell(position);
+}
+
+}  // namespace io
+}  // namespace tsl
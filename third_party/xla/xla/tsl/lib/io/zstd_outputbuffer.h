@@ -0,0 +1,120 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_ZSTD_OUTPUTBUFFER_H_
+#define XLA_TSL_LIB_IO_ZSTD_OUTPUTBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/io/zstd_compression_options.h"
+#include "xla/tsl/platform/file_system.h"
+#include "tsl/platform/cord.h"
+
+// Forward declare the compression context of zstd.h, which is only included in
+// the .cc file.
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+
+namespace tsl {
+namespace io {
+
+// Provides support for writing compressed output to file using zstd
+// (https://facebook.github.io/zstd/).
+// A given instance of an ZstdOutputBuffer is NOT safe for concurrent use
+// by multiple threads
+class ZstdOutputBuffer : public WritableFile {
+ public:
+  // Create an ZstdOutputBuffer for `file` with two buffers that cache the
+  // 1. input data to be compressed
+  // 2. the compressed output
+  // with sizes `input_buffer_bytes` and `output_buffer_bytes` respectively.
+  // Does not take ownership of `file`.
+  ZstdOutputBuffer(WritableFile* file, int64_t input_buffer_bytes,
+                   int64_t output_buffer_bytes,
+                   const ZstdCompressionOptions& zstd_options);
+
+  ~ZstdOutputBuffer() override;
+
+  // Sets up the compression context with the level and dictionary of the
+  // options. This call is required before any other operation on the buffer.
+  absl::Status Init();
+
+  // Adds `data` to the compression pipeline.
+  //
+  // Small writes are collected in the input buffer and handed to zstd in bulk.
+  // The compressed output is written to file whenever the output buffer is
+  // full.
+  //
+  // To immediately write contents to file call `Flush()`.
+  absl::Status Append(absl::string_view data) override;
+
+#if defined(TF_CORD_SUPPORT)
+  absl::Status Append(const absl::Cord& cord) override;
+#endif
+
+  // Compresses any cached input, ends the current zstd block and writes all
+  // output to file. Everything appended so far can be read back afterwards.
+  absl::Status Flush() override;
+
+  // Compresses any cached input, ends the zstd frame and writes all output to
+  // file. This must be called before the destructor to avoid any data loss.
+  //
+  // After calling this, any further calls to `Append()` or `Flush()` will
+  // fail.
+  absl::Status Close() override;
+
+  // Returns the name of the underlying file.
+  absl::Status Name(absl::string_view* result) const override;
+
+  // Compresses any cached input, writes all output to file and syncs it.
+  absl::Status Sync() override;
+
+  // Returns the write position in the underlying file. The position does not
+  // reflect buffered, un-flushed data.
+  absl::Status Tell(int64_t* position) override;
+
+ private:
+  // Hands `data` to zstd with the given ZSTD_EndDirective and appends all
+  // output it produces to `file_`.
+  absl::Status Compress(absl::string_view data, int end_directive);
+
+  // Compresses the contents of `input_` and clears it.
+  absl::Status CompressBuffered(int end_directive);
+
+  WritableFile* file_;  // Not owned
+  const size_t input_buffer_capacity_;
+  const size_t output_buffer_capacity_;
+  const ZstdCompressionOptions zstd_options_;
+
+  ZSTD_CCtx* cctx_ = nullptr;
+
+  // Uncompressed bytes not yet handed to zstd.
+  std::string input_;
+
+  // Buffer for compressed bytes on their way to `file_`.
+  std::unique_ptr<char[]> output_;
+
+  ZstdOutputBuffer(const ZstdOutputBuffer&) = delete;
+  void operator=(const ZstdOutputBuffer&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_ZSTD_OUTPUTBUFFER_H_
@@ -0,0 +1,165 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// A CPU-only variant of PhiloxRandom that computes several consecutive
+// 128-bit blocks of the Philox stream at a time.
+
+#ifndef XLA_TSL_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
+#define XLA_TSL_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
+
+#include <cstdint>
+
+#include "xla/tsl/lib/random/philox_random.h"
+
+namespace tsl {
+namespace random {
+
+// A generator that returns exactly the same sequence of samples as the
+// PhiloxRandom it is constructed from, but computes them `kBatchSize` blocks
+// at a time.
+//
+// The state of all blocks in a batch is kept in structure-of-arrays form, so
+// that every step of a Philox round is a loop over independent lanes. The
+// compiler turns these loops into SIMD code (e.g. VPMULUDQ on AVX2/AVX-512,
+// UMULL on NEON) instead of producing one block per call.
+//
+// PhiloxRandomBatch can be used wherever a distribution expects a
+// PhiloxRandom-like generator, e.g. UniformDistribution<PhiloxRandomBatch,
+// float>. The underlying PhiloxRandom is advanced by whole batches, so the
+// generator should not be mixed with direct uses of the PhiloxRandom it was
+// constructed from.
+class PhiloxRandomBatch {
+ public:
+  using ResultType = PhiloxRandom::ResultType;
+  using ResultElementType = PhiloxRandom::ResultElementType;
+  // The number of elements that will be returned.
+  static constexpr int kResultElementCount = PhiloxRandom::kResultElementCount;
+  // Cost of generation of a single element (in cycles).
+  static constexpr int kElementCost = PhiloxRandom::kElementCost;
+  // The number of 128-bit blocks computed together.
+  static constexpr int kBatchSize = 16;
+
+  explicit PhiloxRandomBatch(const PhiloxRandom& gen)
+      : gen_(gen), next_(kBatchSize) {}
+
+  // Returns the next group of four random numbers in the stream of the
+  // PhiloxRandom this generator was constructed from.
+  ResultType operator()() {
+    if (next_ == kBatchSize) {
+      Refill();
+    }
+    ResultType result;
+    result[0] = c0_[next_];
+    result[1] = c1_[next_];
+    result[2] = c2_[next_];
+    result[3] = c3_[next_];
+    ++next_;
+    return result;
+  }
+
+  // Writes the next kBatchSize groups of the stream to `out`, which must hold
+  // kBatchSize * kResultElementCount values, in the order kBatchSize calls of
+  // operator() would return them. Lets callers transform a whole batch of
+  // samples in one loop, which vectorizes like the Philox rounds do.
+  void NextBatch(uint32_t* out) {
+    if (next_ != kBatchSize) {
+      // Not at a batch boundary: returns the remaining groups of this batch
+      // and the first ones of the next.
+      for (int i = 0; i < kBatchSize; ++i) {
+        const ResultType result = (*this)();
+        for (int j = 0; j < kResultElementCount; ++j) {
+          out[i * kResultElementCount + j] = result[j];
+        }
+      }
+      return;
+    }
+    Refill();
+    for (int i = 0; i < kBatchSize; ++i) {
+      out[4 * i] = c0_[i];
+      out[4 * i + 1] = c1_[i];
+      out[4 * i + 2] = c2_[i];
+      out[4 * i + 3] = c3_[i];
+    }
+    next_ = kBatchSize;
+  }
+
+ private:
+  // Must match the constants used by PhiloxRandom.
+  static constexpr uint32_t kPhiloxW32A = 0x9E3779B9;
+  static constexpr uint32_t kPhiloxW32B = 0xBB67AE85;
+  static constexpr uint32_t kPhiloxM4x32A = 0xD2511F53;
+  static constexpr uint32_t kPhiloxM4x32B = 0xCD9E8D57;
+
+  // Computes the next kBatchSize blocks of the stream into c0_ ... c3_.
+  void Refill() {
+    // Lay out the counters of consecutive blocks. Carries out of the lowest
+    // word are rare, so they are handled by PhiloxRandom::Skip().
+    const ResultType& counter = gen_.counter();
+    if (counter[0] <= UINT32_MAX - kBatchSize) {
+      for (int i = 0; i < kBatchSize; ++i) {
+        c0_[i] = counter[0] + i;
+        c1_[i] = counter[1];
+        c2_[i] = counter[2];
+        c3_[i] = counter[3];
+      }
+    } else {
+      PhiloxRandom counter_gen = gen_;
+      for (int i = 0; i < kBatchSize; ++i) {
+        const ResultType& block_counter = counter_gen.counter();
+        c0_[i] = block_counter[0];
+        c1_[i] = block_counter[1];
+        c2_[i] = block_counter[2];
+        c3_[i] = block_counter[3];
+        counter_gen.Skip(1);
+      }
+    }
+
+    uint32_t key0 = gen_.key()[0];
+    uint32_t key1 = gen_.key()[1];
+    for (int round = 0; round < 10; ++round) {
+      for (int i = 0; i < kBatchSize; ++i) {
+        const uint64_t product0 = static_cast<uint64_t>(kPhiloxM4x32A) * c0_[i];
+        const uint64_t product1 = static_cast<uint64_t>(kPhiloxM4x32B) * c2_[i];
+        const uint32_t lo0 = static_cast<uint32_t>(product0);
+        const uint32_t hi0 = static_cast<uint32_t>(product0 >> 32);
+        const uint32_t lo1 = static_cast<uint32_t>(product1);
+        const uint32_t hi1 = static_cast<uint32_t>(product1 >> 32);
+        c0_[i] = hi1 ^ c1_[i] ^ key0;
+        c1_[i] = lo1;
+        c2_[i] = hi0 ^ c3_[i] ^ key1;
+        c3_[i] = lo0;
+      }
+      key0 += kPhiloxW32A;
+      key1 += kPhiloxW32B;
+    }
+
+    gen_.Skip(kBatchSize);
+    next_ = 0;
+  }
+
+  PhiloxRandom gen_;
+  int next_;
+  // The computed blocks in structure-of-arrays form: block `i` of the batch
+  // is {c0_[i], c1_[i], c2_[i], c3_[i]}.
+  alignas(64) uint32_t c0_[kBatchSize];
+  alignas(64) uint32_t c1_[kBatchSize];
+  alignas(64) uint32_t c2_[kBatchSize];
+  alignas(64) uint32_t c3_[kBatchSize];
+};
+
+}  // namespace random
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
@@ -22,6 +22,7 @@ limitations under the License.
 #include <unordered_map>
 #include <vector>
 
+#include "xla/tsl/lib/random/philox_random_batch.h"
 #include "xla/tsl/lib/random/philox_random_test_utils.h"
 #include "xla/tsl/lib/random/random_distributions.h"
 #include "xla/tsl/platform/logging.h"
@@ -69,6 +70,69 @@ TEST(PhiloxRandomTest, SkipMatchTest) {
   }
 }
 
+// This test checks that PhiloxRandomBatch produces exactly the same stream as
+// PhiloxRandom, including when the counter carries into its higher words.
+TEST(PhiloxRandomTest, BatchMatchTest) {
+  constexpr int count = 1024;
+
+  for (uint64_t skip : {uint64_t{0}, uint64_t{0xfffffff9},
+                        uint64_t{0xfffffffffffffff3}}) {
+    PhiloxRandom gen(GetTestSeed(), GetTestSeed());
+    gen.Skip(skip);
+    PhiloxRandomBatch batch_gen(gen);
+    for (int i = 0; i < count; ++i) {
+      const PhiloxRandom::ResultType expected = gen();
+      const PhiloxRandom::ResultType actual = batch_gen();
+      for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+        ASSERT_EQ(expected[j], actual[j]) << "skip " << skip << " sample " << i;
+      }
+    }
+  }
+}
+
+// NextBatch() returns the same stream as PhiloxRandom, whether or not it is
+// called at a batch boundary.
+TEST(PhiloxRandomTest, NextBatchMatchTest) {
+  constexpr int kBatchValues =
+      PhiloxRandomBatch::kBatchSize * PhiloxRandom::kResultElementCount;
+
+  PhiloxRandom gen(GetTestSeed(), GetTestSeed());
+  PhiloxRandomBatch batch_gen(gen);
+  uint32_t batch[kBatchValues];
+  for (int i = 0; i < 8; ++i) {
+    if (i == 4) {
+      // Moves off the batch boundary.
+      const PhiloxRandom::ResultType expected = gen();
+      const PhiloxRandom::ResultType actual = batch_gen();
+      ASSERT_EQ(expected[0], actual[0]);
+    }
+    batch_gen.NextBatch(batch);
+    for (int j = 0; j < kBatchValues; j += PhiloxRandom::kResultElementCount) {
+      const PhiloxRandom::ResultType expected = gen();
+      for (int k = 0; k < PhiloxRandom::kResultElementCount; ++k) {
+        ASSERT_EQ(expected[k], batch[j + k]) << "batch " << i << " value " << j;
+      }
+    }
+  }
+}
+
+// Distributions over PhiloxRandomBatch match those over PhiloxRandom.
+TEST(PhiloxRandomTest, BatchDistributionMatchTest) {
+  constexpr int count = 1000;
+
+  PhiloxRandom gen(GetTestSeed());
+  PhiloxRandomBatch batch_gen(gen);
+  NormalDistribution<PhiloxRandom, float> normal;
+  NormalDistribution<PhiloxRandomBatch, float> batch_normal;
+  for (int i = 0; i < count; ++i) {
+    const auto expected = normal(&gen);
+    const auto actual = batch_normal(&batch_gen);
+    for (int j = 0; j < expected.kElementCount; ++j) {
+      ASSERT_EQ(expected[j], actual[j]);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace random
 }  // namespace tsl
@@ -0,0 +1,416 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/platform/cloud/caching_file_system.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/call_once.h"
+#include "absl/hash/hash.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xla/tsl/platform/cloud/tiered_file_block_cache.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/file_statistics.h"
+#include "xla/tsl/platform/file_system.h"
+#include "xla/tsl/platform/status_macros.h"
+#include "xla/tsl/util/env_var.h"
+
+namespace tsl {
+
+namespace {
+
+constexpr char kBlockSizeMb[] = "TF_FILE_CACHE_BLOCK_SIZE_MB";
+constexpr char kRamMb[] = "TF_FILE_CACHE_RAM_MB";
+constexpr char kDiskDir[] = "TF_FILE_CACHE_DISK_DIR";
+constexpr char kDiskMb[] = "TF_FILE_CACHE_DISK_MB";
+constexpr char kShards[] = "TF_FILE_CACHE_SHARDS";
+constexpr char kReadaheadBlocks[] = "TF_FILE_CACHE_READAHEAD_BLOCKS";
+constexpr char kEvictionPolicy[] = "TF_FILE_CACHE_EVICTION_POLICY";
+constexpr char kMaxStaleness[] = "TF_FILE_CACHE_MAX_STALENESS";
+
+// Returns the non-negative integer in the environment variable `name`, or
+// `default_value` if it is unset or invalid.
+int64_t ReadNonNegativeEnvVar(const char* name, int64_t default_value) {
+  int64_t value;
+  absl::Status status = ReadInt64FromEnvVar(name, default_value, &value);
+  if (!status.ok() || value < 0) {
+    LOG(WARNING) << "Ignoring " << name << ", which is not a non-negative "
+                 << "integer: " << status;
+    return default_value;
+  }
+  return value;
+}
+
+TieredFileBlockCacheOptions GetCacheOptionsFromEnv() {
+  TieredFileBlockCacheOptions options;
+  options.block_size =
+      ReadNonNegativeEnvVar(kBlockSizeMb, options.block_size >> 20) << 20;
+  options.max_ram_bytes =
+      ReadNonNegativeEnvVar(kRamMb, options.max_ram_bytes >> 20) << 20;
+  absl::Status status = ReadStringFromEnvVar(kDiskDir, "", &options.disk_dir);
+  if (!status.ok()) LOG(WARNING) << "Ignoring " << kDiskDir << ": " << status;
+  options.max_disk_bytes =
+      ReadNonNegativeEnvVar(kDiskMb, options.max_disk_bytes >> 20) << 20;
+  options.num_shards = ReadNonNegativeEnvVar(kShards, options.num_shards);
+  options.readahead_blocks =
+      ReadNonNegativeEnvVar(kReadaheadBlocks, options.readahead_blocks);
+  options.max_staleness =
+      ReadNonNegativeEnvVar(kMaxStaleness, options.max_staleness);
+  std::string policy;
+  status = ReadStringFromEnvVar(kEvictionPolicy, "lru", &policy);
+  policy = absl::AsciiStrToLower(policy);
+  if (policy == "fifo") {
+    options.eviction_policy = BlockEvictionPolicy::kFifo;
+  } else if (!status.ok() || policy != "lru") {
+    LOG(WARNING) << "Ignoring " << kEvictionPolicy << "=" << policy
+                 << ", which is neither \"lru\" nor \"fifo\"";
+  }
+  return options;
+}
+
+// A random access file whose reads go through the cache of a
+// CachingFileSystem.
+class CachingRandomAccessFile : public RandomAccessFile {
+ public:
+  CachingRandomAccessFile(std::string name, std::string inner_name,
+                          TieredFileBlockCache* cache,
+                          std::function<void()> on_close)
+      : name_(std::move(name)),
+        inner_name_(std::move(inner_name)),
+        cache_(cache),
+        on_close_(std::move(on_close)) {}
+
+  ~CachingRandomAccessFile() override { on_close_(); }
+
+  absl::Status Name(absl::string_view* result) const override {
+    *result = name_;
+    return absl::OkStatus();
+  }
+
+  absl::Status Read(uint64_t offset, absl::string_view& result,
+                    absl::Span<char> scratch) const override {
+    size_t bytes_transferred = 0;
+    absl::Status status = cache_->Read(inner_name_, offset, scratch.size(),
+                                       scratch.data(), &bytes_transferred);
+    result = absl::string_view(scratch.data(), bytes_transferred);
+    RETURN_IF_ERROR(status);
+    if (bytes_transferred < scratch.size()) {
+      return absl::OutOfRangeError(absl::StrCat(
+          "EOF reached, ", result.size(), " bytes were read out of ",
+          scratch.size(), " bytes requested."));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  const std::string name_;
+  const std::string inner_name_;
+  TieredFileBlockCache* const cache_;  // Not owned.
+  const std::function<void()> on_close_;
+};
+
+}  // namespace
+
+CachingFileSystem::CachingFileSystem()
+    : CachingFileSystem(GetCacheOptionsFromEnv(), Env::Default()) {}
+
+CachingFileSystem::CachingFileSystem(const TieredFileBlockCacheOptions& options,
+                                     Env* env)
+    : options_(options), env_(env) {}
+
+TieredFileBlockCache* CachingFileSystem::cache() {
+  absl::call_once(cache_once_, [this] {
+    cache_ = std::make_unique<TieredFileBlockCache>(
+        options_,
+        [this](const std::string& inner_name, size_t offset, size_t n,
+               char* buffer, size_t* bytes_transferred) {
+          return FetchBlock(inner_name, offset, n, buffer, bytes_transferred);
+        },
+        env_);
+    cache_created_ = true;
+  });
+  return cache_.get();
+}
+
+TieredFileBlockCache::Stats CachingFileSystem::GetCacheStats() {
+  if (!cache_created_) return {};
+  return cache()->GetStats();
+}
+
+absl::Status CachingFileSystem::Resolve(absl::string_view fname,
+                                        std::string* inner_name,
+                                        FileSystem** file_system) const {
+  absl::string_view path = fname;
+  if (!absl::ConsumePrefix(&path, absl::StrCat(kScheme, "://")) ||
+      path.empty()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected a path of the form ", kScheme, "://<path>, got ", fname));
+  }
+  if (absl::StartsWith(path, absl::StrCat(kScheme, "://"))) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot cache the cached path ", fname));
+  }
+  *inner_name = std::string(path);
+  return env_->GetFileSystemForFile(*inner_name, file_system);
+}
+
+absl::Status CachingFileSystem::FetchBlock(const std::string& inner_name,
+                                           size_t offset, size_t n,
+                                           char* buffer,
+                                           size_t* bytes_transferred) {
+  *bytes_transferred = 0;
+  std::shared_ptr<RandomAccessFile> file;
+  {
+    absl::MutexLock lock(open_files_mu_);
+    auto it = open_files_.find(inner_name);
+    if (it != open_files_.end()) file = it->second.first;
+  }
+  if (file == nullptr) {
+    // The file was closed, e.g. before its readahead.
+    std::unique_ptr<RandomAccessFile> reopened;
+    RETURN_IF_ERROR(env_->NewRandomAccessFile(inner_name, &reopened));
+    file = std::move(reopened);
+  }
+  absl::string_view result;
+  absl::Status status = file->Read(offset, result, absl::MakeSpan(buffer, n));
+  if (!status.ok() && !absl::IsOutOfRange(status)) {
+    return status;
+  }
+  if (result.data() != buffer) {
+    std::memmove(buffer, result.data(), result.size());
+  }
+  *bytes_transferred = result.size();
+  return absl::OkStatus();
+}
+
+void CachingFileSystem::AddOpenFile(const std::string& inner_name,
+                                    std::shared_ptr<RandomAccessFile> file) {
+  absl::MutexLock lock(open_files_mu_);
+  // Reads go to the most recently opened file.
+  auto& [open_file, count] = open_files_[inner_name];
+  open_file = std::move(file);
+  ++count;
+}
+
+void CachingFileSystem::RemoveOpenFile(const std::string& inner_name) {
+  absl::MutexLock lock(open_files_mu_);
+  auto it = open_files_.find(inner_name);
+  if (--it->second.second == 0) open_files_.erase(it);
+}
+
+absl::Status CachingFileSystem::NewRandomAccessFile(
+    const std::string& fname, std::unique_ptr<RandomAccessFile>* result) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  std::unique_ptr<RandomAccessFile> inner_file;
+  RETURN_IF_ERROR(file_system->NewRandomAccessFile(inner_name, &inner_file));
+  FileStatistics stat;
+  RETURN_IF_ERROR(file_system->Stat(inner_name, &stat));
+  if (!cache()->ValidateAndUpdateFileSignature(
+          inner_name,
+          static_cast<int64_t>(absl::HashOf(stat.length, stat.mtime_nsec)))) {
+    VLOG(1) << "File signature has been changed. Refreshing the cache. Path: "
+            << fname;
+  }
+  AddOpenFile(inner_name, std::move(inner_file));
+  *result = std::make_unique<CachingRandomAccessFile>(
+      fname, inner_name, cache(),
+      [this, inner_name] { RemoveOpenFile(inner_name); });
+  return absl::OkStatus();
+}
+
+absl::Status CachingFileSystem::NewWritableFile(
+    const std::string& fname, std::unique_ptr<WritableFile>* result) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  cache()->RemoveFile(inner_name);
+  return file_system->NewWritableFile(inner_name, result);
+}
+
+absl::Status CachingFileSystem::NewAppendableFile(
+    const std::string& fname, std::unique_ptr<WritableFile>* result) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  cache()->RemoveFile(inner_name);
+  return file_system->NewAppendableFile(inner_name, result);
+}
+
+absl::Status CachingFileSystem::NewReadOnlyMemoryRegionFromFile(
+    const std::string& fname, std::unique_ptr<ReadOnlyMemoryRegion>* result) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  return file_system->NewReadOnlyMemoryRegionFromFile(inner_name, result);
+}
+
+absl::Status CachingFileSystem::FileExists(absl::string_view fname) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  return file_system->FileExists(inner_name);
+}
+
+absl::Status CachingFileSystem::GetChildren(const std::string& dir,
+                                            std::vector<std::string>* result) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(dir, &inner_name, &file_system));
+  return file_system->GetChildren(inner_name, result);
+}
+
+absl::Status CachingFileSystem::GetMatchingPaths(
+    const std::string& pattern, std::vector<std::string>* results) {
+  std::string inner_pattern;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(pattern, &inner_pattern, &file_system));
+  RETURN_IF_ERROR(file_system->GetMatchingPaths(inner_pattern, results));
+  for (std::string& path : *results) {
+    path = absl::StrCat(kScheme, "://", path);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status CachingFileSystem::Stat(const std::string& fname,
+                                     FileStatistics* stat) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  return file_system->Stat(inner_name, stat);
+}
+
+absl::Status CachingFileSystem::DeleteFile(const std::string& fname) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  cache()->RemoveFile(inner_name);
+  return file_system->DeleteFile(inner_name);
+}
+
+absl::Status CachingFileSystem::CreateDir(const std::string& dirname) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(dirname, &inner_name, &file_system));
+  return file_system->CreateDir(inner_name);
+}
+
+absl::Status CachingFileSystem::CreateDir(const std::string& dirname,
+                                          uint32_t mode) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(dirname, &inner_name, &file_system));
+  return file_system->CreateDir(inner_name, mode);
+}
+
+absl::Status CachingFileSystem::RecursivelyCreateDir(
+    const std::string& dirname) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(dirname, &inner_name, &file_system));
+  return file_system->RecursivelyCreateDir(inner_name);
+}
+
+absl::Status CachingFileSystem::RecursivelyCreateDir(absl::string_view dirname,
+                                                     uint32_t mode) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(dirname, &inner_name, &file_system));
+  return file_system->RecursivelyCreateDir(inner_name, mode);
+}
+
+absl::Status CachingFileSystem::DeleteDir(const std::string& dirname) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(dirname, &inner_name, &file_system));
+  return file_system->DeleteDir(inner_name);
+}
+
+absl::Status CachingFileSystem::DeleteRecursively(const std::string& dirname,
+                                                  int64_t* undeleted_files,
+                                                  int64_t* undeleted_dirs) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(dirname, &inner_name, &file_system));
+  // The cached blocks of the deleted files are left to be evicted.
+  return file_system->DeleteRecursively(inner_name, undeleted_files,
+                                        undeleted_dirs);
+}
+
+absl::Status CachingFileSystem::GetFileSize(const std::string& fname,
+                                            uint64_t* file_size) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  return file_system->GetFileSize(inner_name, file_size);
+}
+
+absl::Status CachingFileSystem::RenameFile(const std::string& src,
+                                           const std::string& target) {
+  std::string inner_src, inner_target;
+  FileSystem* src_file_system;
+  FileSystem* target_file_system;
+  RETURN_IF_ERROR(Resolve(src, &inner_src, &src_file_system));
+  RETURN_IF_ERROR(Resolve(target, &inner_target, &target_file_system));
+  if (src_file_system != target_file_system) {
+    return absl::UnimplementedError(
+        absl::StrCat("Renaming ", src, " to ", target, " not implemented"));
+  }
+  cache()->RemoveFile(inner_src);
+  cache()->RemoveFile(inner_target);
+  return src_file_system->RenameFile(inner_src, inner_target);
+}
+
+absl::Status CachingFileSystem::IsDirectory(const std::string& fname) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(fname, &inner_name, &file_system));
+  return file_system->IsDirectory(inner_name);
+}
+
+absl::Status CachingFileSystem::HasAtomicMove(const std::string& path,
+                                              bool* has_atomic_move) {
+  std::string inner_name;
+  FileSystem* file_system;
+  RETURN_IF_ERROR(Resolve(path, &inner_name, &file_system));
+  return file_system->HasAtomicMove(inner_name, has_atomic_move);
+}
+
+void CachingFileSystem::FlushCaches() {
+  // Flushing must not create the cache, which Env::FlushFileSystemCaches does
+  // for every registered file system.
+  if (!cache_created_) return;
+  cache()->Flush();
+}
+
+}  // namespace tsl
+
+REGISTER_FILE_SYSTEM(::tsl::CachingFileSystem::kScheme,
+                     ::tsl::CachingFileSystem);
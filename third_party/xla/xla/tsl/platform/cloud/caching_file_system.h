@@ -0,0 +1,168 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_PLATFORM_CLOUD_CACHING_FILE_SYSTEM_H_
+#define XLA_TSL_PLATFORM_CLOUD_CACHING_FILE_SYSTEM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/call_once.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/tsl/platform/cloud/tiered_file_block_cache.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/file_statistics.h"
+#include "xla/tsl/platform/file_system.h"
+#include "tsl/platform/thread_annotations.h"
+
+namespace tsl {
+
+/// \brief A file system that caches the reads of any other file system.
+///
+/// Paths of the form "cache://<path>" refer to `<path>` on the file system
+/// registered for it, e.g. "cache://gs://bucket/data" or "cache:///mnt/nfs".
+/// Reads of random access files go through a TieredFileBlockCache, which
+/// keeps blocks in RAM and on local disk, and reads ahead of sequential reads.
+/// Every other operation is forwarded.
+///
+/// A file is fetched again when its length or modification time changes, or
+/// when it is written, deleted or renamed through this file system.
+class CachingFileSystem : public FileSystem {
+ public:
+  /// The scheme of the paths served by the file system.
+  static constexpr char kScheme[] = "cache";
+
+  /// Reads the options of the cache from the environment:
+  ///  - TF_FILE_CACHE_BLOCK_SIZE_MB: the size of the cached blocks.
+  ///  - TF_FILE_CACHE_RAM_MB: the size of the RAM tier, 0 to disable caching.
+  ///  - TF_FILE_CACHE_DISK_DIR: the local directory of the disk tier, which is
+  ///    disabled if unset.
+  ///  - TF_FILE_CACHE_DISK_MB: the size of the disk tier.
+  ///  - TF_FILE_CACHE_SHARDS: the number of shards of the cache.
+  ///  - TF_FILE_CACHE_READAHEAD_BLOCKS: the number of blocks read ahead.
+  ///  - TF_FILE_CACHE_EVICTION_POLICY: "lru" or "fifo".
+  ///  - TF_FILE_CACHE_MAX_STALENESS: the lifetime of blocks in seconds, 0 for
+  ///    unlimited.
+  CachingFileSystem();
+  CachingFileSystem(const TieredFileBlockCacheOptions& options, Env* env);
+
+  absl::Status NewRandomAccessFile(
+      const std::string& fname,
+      std::unique_ptr<RandomAccessFile>* result) override;
+
+  absl::Status NewWritableFile(const std::string& fname,
+                               std::unique_ptr<WritableFile>* result) override;
+
+  absl::Status NewAppendableFile(
+      const std::string& fname,
+      std::unique_ptr<WritableFile>* result) override;
+
+  absl::Status NewReadOnlyMemoryRegionFromFile(
+      const std::string& fname,
+      std::unique_ptr<ReadOnlyMemoryRegion>* result) override;
+
+  absl::Status FileExists(absl::string_view fname) override;
+
+  absl::Status GetChildren(const std::string& dir,
+                           std::vector<std::string>* result) override;
+
+  absl::Status GetMatchingPaths(const std::string& pattern,
+                                std::vector<std::string>* results) override;
+
+  absl::Status Stat(const std::string& fname, FileStatistics* stat) override;
+
+  absl::Status DeleteFile(const std::string& fname) override;
+
+  absl::Status CreateDir(const std::string& dirname) override;
+
+  absl::Status CreateDir(const std::string& dirname, uint32_t mode) override;
+
+  absl::Status RecursivelyCreateDir(const std::string& dirname) override;
+
+  absl::Status RecursivelyCreateDir(absl::string_view dirname,
+                                    uint32_t mode) override;
+
+  absl::Status DeleteDir(const std::string& dirname) override;
+
+  absl::Status DeleteRecursively(const std::string& dirname,
+                                 int64_t* undeleted_files,
+                                 int64_t* undeleted_dirs) override;
+
+  absl::Status GetFileSize(const std::string& fname,
+                           uint64_t* file_size) override;
+
+  absl::Status RenameFile(const std::string& src,
+                          const std::string& target) override;
+
+  absl::Status IsDirectory(const std::string& fname) override;
+
+  absl::Status HasAtomicMove(const std::string& path,
+                             bool* has_atomic_move) override;
+
+  void FlushCaches() override;
+
+  /// The hit and miss counters of the cache, which are all zero until the
+  /// cache is used.
+  TieredFileBlockCache::Stats GetCacheStats();
+
+ private:
+  /// Returns the cache, which is created on first use, so that registering the
+  /// file system does not start threads or create directories.
+  TieredFileBlockCache* cache();
+
+  /// Returns the path wrapped by `fname` and the file system serving it.
+  absl::Status Resolve(absl::string_view fname, std::string* inner_name,
+                       FileSystem** file_system) const;
+
+  /// Reads a block of `inner_name` for the cache.
+  absl::Status FetchBlock(const std::string& inner_name, size_t offset,
+                          size_t n, char* buffer, size_t* bytes_transferred);
+
+  /// Registers `file` as an open file of `inner_name`, which FetchBlock reads
+  /// rather than opening the file again, until RemoveOpenFile has been called
+  /// for every AddOpenFile.
+  void AddOpenFile(const std::string& inner_name,
+                   std::shared_ptr<RandomAccessFile> file)
+      TF_LOCKS_EXCLUDED(open_files_mu_);
+  void RemoveOpenFile(const std::string& inner_name)
+      TF_LOCKS_EXCLUDED(open_files_mu_);
+
+  const TieredFileBlockCacheOptions options_;
+  Env* const env_;
+
+  absl::Mutex open_files_mu_;
+  /// The open files of each path, and the number of times they are open.
+  absl::flat_hash_map<std::string,
+                      std::pair<std::shared_ptr<RandomAccessFile>, int>>
+      open_files_ TF_GUARDED_BY(open_files_mu_);
+
+  absl::once_flag cache_once_;
+  /// Whether `cache_` has been created by cache().
+  std::atomic<bool> cache_created_{false};
+  /// Declared last, so that the readahead in flight finishes before the rest
+  /// is destroyed.
+  std::unique_ptr<TieredFileBlockCache> cache_;
+};
+
+}  // namespace tsl
+
+#endif  // XLA_TSL_PLATFORM_CLOUD_CACHING_FILE_SYSTEM_H_
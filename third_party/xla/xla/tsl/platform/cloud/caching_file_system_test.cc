@@ -0,0 +1,195 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/platform/cloud/caching_file_system.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/file_statistics.h"
+#include "xla/tsl/platform/test.h"
+#include "tsl/platform/path.h"
+
+namespace tsl {
+namespace {
+
+using ::testing::ElementsAre;
+
+class CachingFileSystemTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = io::JoinPath(testing::TmpDir(), "caching_file_system",
+                        ::testing::UnitTest::GetInstance()
+                            ->current_test_info()
+                            ->name());
+    TF_ASSERT_OK(Env::Default()->RecursivelyCreateDir(dir_));
+  }
+
+  TieredFileBlockCacheOptions Options() {
+    TieredFileBlockCacheOptions options;
+    options.block_size = 16;
+    options.max_ram_bytes = 1024;
+    options.readahead_blocks = 0;
+    return options;
+  }
+
+  // Returns the path of `name` in the test directory, through the cache.
+  std::string CachedPath(absl::string_view name) {
+    return absl::StrCat("cache://", io::JoinPath(dir_, name));
+  }
+
+  // Reads `n` bytes of `file` at `offset`.
+  std::string ReadFile(const RandomAccessFile& file, uint64_t offset,
+                       size_t n, absl::Status* status) {
+    std::string scratch(n, '\0');
+    absl::string_view result;
+    *status = file.Read(offset, result, absl::MakeSpan(scratch));
+    return std::string(result);
+  }
+
+  std::string dir_;
+};
+
+TEST_F(CachingFileSystemTest, ReadsThroughCache) {
+  const std::string contents = "0123456789abcdefghijklmnopqrstuvwxyz";
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), io::JoinPath(dir_, "file"),
+                                 contents));
+  CachingFileSystem fs(Options(), Env::Default());
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(fs.NewRandomAccessFile(CachedPath("file"), &file));
+  absl::string_view name;
+  TF_ASSERT_OK(file->Name(&name));
+  EXPECT_EQ(name, CachedPath("file"));
+
+  absl::Status status;
+  EXPECT_EQ(ReadFile(*file, 5, 20, &status), contents.substr(5, 20));
+  TF_EXPECT_OK(status);
+  EXPECT_EQ(ReadFile(*file, 10, 5, &status), contents.substr(10, 5));
+  TF_EXPECT_OK(status);
+  EXPECT_EQ(ReadFile(*file, 30, 10, &status), contents.substr(30));
+  EXPECT_TRUE(absl::IsOutOfRange(status));
+
+  TieredFileBlockCache::Stats stats = fs.GetCacheStats();
+  EXPECT_EQ(stats.misses, 3);
+  EXPECT_EQ(stats.ram_hits, 2);
+}
+
+TEST_F(CachingFileSystemTest, RefetchesChangedFiles) {
+  const std::string path = io::JoinPath(dir_, "file");
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path, "old contents"));
+  CachingFileSystem fs(Options(), Env::Default());
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(fs.NewRandomAccessFile(CachedPath("file"), &file));
+  absl::Status status;
+  EXPECT_EQ(ReadFile(*file, 0, 12, &status), "old contents");
+
+  // Written behind the back of the cache, with a different length.
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path, "new contents!"));
+  TF_ASSERT_OK(fs.NewRandomAccessFile(CachedPath("file"), &file));
+  EXPECT_EQ(ReadFile(*file, 0, 13, &status), "new contents!");
+
+  // Written through the cache.
+  std::unique_ptr<WritableFile> writable;
+  TF_ASSERT_OK(fs.NewWritableFile(CachedPath("file"), &writable));
+  TF_ASSERT_OK(writable->Append("NEW CONTENTS!"));
+  TF_ASSERT_OK(writable->Close());
+  EXPECT_EQ(ReadFile(*file, 0, 13, &status), "NEW CONTENTS!");
+}
+
+TEST_F(CachingFileSystemTest, ForwardsFileSystemOperations) {
+  CachingFileSystem fs(Options(), Env::Default());
+  TF_ASSERT_OK(fs.RecursivelyCreateDir(CachedPath("a/b")));
+  TF_EXPECT_OK(fs.IsDirectory(CachedPath("a/b")));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), io::JoinPath(dir_, "a/f1"),
+                                 "contents"));
+  TF_EXPECT_OK(fs.FileExists(CachedPath("a/f1")));
+  EXPECT_TRUE(absl::IsNotFound(fs.FileExists(CachedPath("a/f2"))));
+
+  FileStatistics stat;
+  TF_ASSERT_OK(fs.Stat(CachedPath("a/f1"), &stat));
+  EXPECT_EQ(stat.length, 8);
+  EXPECT_FALSE(stat.is_directory);
+
+  std::vector<std::string> children;
+  TF_ASSERT_OK(fs.GetChildren(CachedPath("a"), &children));
+  std::sort(children.begin(), children.end());
+  EXPECT_THAT(children, ElementsAre("b", "f1"));
+
+  std::vector<std::string> matches;
+  TF_ASSERT_OK(fs.GetMatchingPaths(CachedPath("a/f*"), &matches));
+  EXPECT_THAT(matches, ElementsAre(CachedPath("a/f1")));
+
+  TF_ASSERT_OK(fs.RenameFile(CachedPath("a/f1"), CachedPath("a/f2")));
+  TF_EXPECT_OK(fs.FileExists(CachedPath("a/f2")));
+  TF_ASSERT_OK(fs.DeleteFile(CachedPath("a/f2")));
+  EXPECT_TRUE(absl::IsNotFound(fs.FileExists(CachedPath("a/f2"))));
+  TF_EXPECT_OK(fs.DeleteDir(CachedPath("a/b")));
+}
+
+TEST_F(CachingFileSystemTest, CreatesCacheOnFirstUse) {
+  TieredFileBlockCacheOptions options = Options();
+  options.disk_dir = io::JoinPath(dir_, "disk");
+  CachingFileSystem fs(options, Env::Default());
+  fs.FlushCaches();
+  EXPECT_EQ(fs.GetCacheStats().misses, 0);
+  EXPECT_TRUE(absl::IsNotFound(Env::Default()->FileExists(options.disk_dir)));
+
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), io::JoinPath(dir_, "file"),
+                                 "contents"));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(fs.NewRandomAccessFile(CachedPath("file"), &file));
+  TF_EXPECT_OK(Env::Default()->FileExists(options.disk_dir));
+  absl::Status status;
+  EXPECT_EQ(ReadFile(*file, 0, 8, &status), "contents");
+  EXPECT_EQ(fs.GetCacheStats().misses, 1);
+  fs.FlushCaches();
+  EXPECT_EQ(ReadFile(*file, 0, 8, &status), "contents");
+  EXPECT_EQ(fs.GetCacheStats().misses, 2);
+}
+
+TEST_F(CachingFileSystemTest, RejectsInvalidPaths) {
+  CachingFileSystem fs(Options(), Env::Default());
+  std::unique_ptr<RandomAccessFile> file;
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      fs.NewRandomAccessFile(io::JoinPath(dir_, "file"), &file)));
+  EXPECT_TRUE(
+      absl::IsInvalidArgument(fs.NewRandomAccessFile("cache://", &file)));
+  EXPECT_TRUE(absl::IsInvalidArgument(fs.NewRandomAccessFile(
+      absl::StrCat("cache://", CachedPath("file")), &file)));
+}
+
+TEST_F(CachingFileSystemTest, IsRegistered) {
+  const std::string contents(100, 'x');
+  TF_ASSERT_OK(
+      WriteStringToFile(Env::Default(), CachedPath("registered"), contents));
+  std::string read;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), CachedPath("registered"),
+                                &read));
+  EXPECT_EQ(read, contents);
+  const std::string uncached_path = io::JoinPath(dir_, "registered");
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), uncached_path, &read));
+  EXPECT_EQ(read, contents);
+}
+
+}  // namespace
+}  // namespace tsl
@@ -0,0 +1,675 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/platform/cloud/tiered_file_block_cache.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // !_WIN32
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xla/tsl/lib/hash/crc32c.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/file_system.h"
+#include "xla/tsl/platform/status_macros.h"
+#include "xla/tsl/platform/threadpool.h"
+#include "tsl/platform/path.h"
+
+namespace tsl {
+
+namespace {
+
+// Upper bound on the number of threads fetching blocks ahead of reads.
+constexpr int kMaxReadaheadThreads = 8;
+
+// Upper bound on the number of files whose access pattern is tracked for
+// readahead. The patterns are forgotten when it is reached.
+constexpr size_t kMaxTrackedFiles = 4096;
+
+// The directory holding the disk tiers of the caches in a disk directory.
+constexpr char kDiskTiersDir[] = "tf_file_block_cache";
+
+// The suffix of the file next to the directory of a disk tier, which the cache
+// owning the disk tier keeps locked.
+constexpr char kLockSuffix[] = ".lock";
+
+// Opens `path` and takes an exclusive lock on it, without waiting. Returns the
+// file descriptor holding the lock, or -1 if the file is locked by another
+// descriptor, was deleted, or the platform has no file locks.
+int OpenAndLock(const std::string& path, bool create) {
+#ifndef _WIN32
+  // O_CLOEXEC keeps the lock from being inherited by subprocesses.
+  const int fd =
+      open(path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0600);
+  if (fd < 0) return -1;
+  struct stat locked, current;
+  if (flock(fd, LOCK_EX | LOCK_NB) != 0 || fstat(fd, &locked) != 0 ||
+      stat(path.c_str(), &current) != 0 || locked.st_dev != current.st_dev ||
+      locked.st_ino != current.st_ino) {
+    // Locked elsewhere, or deleted by another process between open and flock.
+    close(fd);
+    return -1;
+  }
+  return fd;
+#else
+  return -1;
+#endif  // !_WIN32
+}
+
+void Unlock(int fd) {
+#ifndef _WIN32
+  if (fd >= 0) close(fd);
+#endif  // !_WIN32
+}
+
+// Deletes the disk tiers in `root` whose lock files are not locked, which were
+// left by processes that exited without destroying their cache, e.g. that of a
+// registered file system. Disk tiers are never deleted on Windows.
+void DeleteStaleDiskTiers(Env* env, const std::string& root) {
+  std::vector<std::string> children;
+  if (!env->GetChildren(root, &children).ok()) return;
+  for (const std::string& child : children) {
+    if (!absl::EndsWith(child, kLockSuffix)) continue;
+    const std::string lock = io::JoinPath(root, child);
+    const int fd = OpenAndLock(lock, /*create=*/false);
+    if (fd < 0) continue;
+    const std::string dir(absl::StripSuffix(lock, kLockSuffix));
+    int64_t undeleted_files, undeleted_dirs;
+    absl::Status status =
+        env->DeleteRecursively(dir, &undeleted_files, &undeleted_dirs);
+    // The lock file is kept until the directory is deleted.
+    if (status.ok() || absl::IsNotFound(status)) {
+      status = env->DeleteFile(lock);
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to delete the stale disk tier " << dir
+                   << " of the file block cache: " << status;
+    }
+    Unlock(fd);
+  }
+}
+
+absl::Status ReadDiskBlock(Env* env, const std::string& path, size_t size,
+                           uint32_t crc, std::vector<char>* data) {
+  std::unique_ptr<RandomAccessFile> file;
+  RETURN_IF_ERROR(env->NewRandomAccessFile(path, &file));
+  data->resize(size);
+  absl::string_view result;
+  RETURN_IF_ERROR(file->Read(0, result, absl::MakeSpan(*data)));
+  if (result.size() != size) {
+    return absl::DataLossError(absl::StrCat("Expected ", size,
+                                            " bytes in cached block ", path,
+                                            ", got ", result.size()));
+  }
+  if (result.data() != data->data()) {
+    std::memmove(data->data(), result.data(), size);
+  }
+  if (crc32c::Value(data->data(), size) != crc) {
+    return absl::DataLossError(
+        absl::StrCat("Checksum mismatch in cached block ", path));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status WriteDiskBlock(Env* env, const std::string& path,
+                            const std::vector<char>& data) {
+  std::unique_ptr<WritableFile> file;
+  RETURN_IF_ERROR(env->NewWritableFile(path, &file));
+  RETURN_IF_ERROR(file->Append(absl::string_view(data.data(), data.size())));
+  return file->Close();
+}
+
+}  // namespace
+
+TieredFileBlockCache::TieredFileBlockCache(
+    const TieredFileBlockCacheOptions& options, BlockFetcher block_fetcher,
+    Env* env)
+    : options_(options),
+      max_disk_bytes_(options.disk_dir.empty() ? 0 : options.max_disk_bytes),
+      block_fetcher_(std::move(block_fetcher)),
+      env_(env) {
+  if (!IsCacheEnabled()) {
+    VLOG(1) << "Tiered file block cache is disabled";
+    return;
+  }
+  const size_t num_shards = std::clamp<size_t>(
+      options_.num_shards, 1,
+      std::max<size_t>(1, options_.max_ram_bytes / options_.block_size));
+  max_ram_bytes_per_shard_ = options_.max_ram_bytes / num_shards;
+  max_disk_bytes_per_shard_ = max_disk_bytes_ / num_shards;
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+  if (max_disk_bytes_per_shard_ > 0) {
+    const std::string root = io::JoinPath(options_.disk_dir, kDiskTiersDir);
+    DeleteStaleDiskTiers(env_, root);
+    // Named after the host, process, thread and time, so that processes
+    // sharing the directory, e.g. in containers, do not collide.
+    std::string dir = io::JoinPath(root, "cache-");
+    absl::Status status = env_->RecursivelyCreateDir(root);
+    if (status.ok() && !env_->CreateUniqueFileName(&dir, "")) {
+      status = absl::AlreadyExistsError("No unique directory name");
+    }
+    if (status.ok()) {
+      // The lock is taken before the directory is created, so that other
+      // processes never take the directory for a stale one.
+      disk_lock_fd_ = OpenAndLock(absl::StrCat(dir, kLockSuffix),
+                                  /*create=*/true);
+#ifndef _WIN32
+      if (disk_lock_fd_ < 0) {
+        status = absl::UnavailableError(
+            absl::StrCat("Failed to lock ", dir, kLockSuffix));
+      }
+#endif  // !_WIN32
+    }
+    if (status.ok()) status = env_->RecursivelyCreateDir(dir);
+    if (status.ok()) {
+      disk_dir_ = std::move(dir);
+    } else {
+      if (disk_lock_fd_ >= 0) {
+        env_->DeleteFile(absl::StrCat(dir, kLockSuffix)).IgnoreError();
+        Unlock(disk_lock_fd_);
+        disk_lock_fd_ = -1;
+      }
+      LOG(WARNING) << "Disabling the disk tier of the file block cache, which "
+                      "failed to create a directory in "
+                   << options_.disk_dir << ": " << status;
+    }
+  }
+  if (options_.readahead_blocks > 0) {
+    readahead_pool_ = std::make_unique<thread::ThreadPool>(
+        env_, "tf_file_block_cache_readahead",
+        std::min<int>(options_.readahead_blocks, kMaxReadaheadThreads));
+  }
+  VLOG(1) << "Tiered file block cache is enabled with " << num_shards
+          << " shards, " << options_.max_ram_bytes << " bytes of RAM and "
+          << (disk_dir_.empty() ? 0 : max_disk_bytes_) << " bytes of disk";
+}
+
+TieredFileBlockCache::~TieredFileBlockCache() {
+  // Waits for the readahead in flight, which uses the shards and the disk tier.
+  readahead_pool_.reset();
+  if (!disk_dir_.empty()) {
+    int64_t undeleted_files, undeleted_dirs;
+    absl::Status status =
+        env_->DeleteRecursively(disk_dir_, &undeleted_files, &undeleted_dirs);
+    if (status.ok() && disk_lock_fd_ >= 0) {
+      status = env_->DeleteFile(absl::StrCat(disk_dir_, kLockSuffix));
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to delete the disk tier of the file block cache "
+                   << disk_dir_ << ": " << status;
+    }
+  }
+  Unlock(disk_lock_fd_);
+}
+
+TieredFileBlockCache::Shard& TieredFileBlockCache::ShardFor(const Key& key) {
+  return *shards_[absl::HashOf(key.first, key.second) % shards_.size()];
+}
+
+absl::Status TieredFileBlockCache::GetBlock(const Key& key, bool readahead,
+                                            BlockData* data) {
+  Shard& shard = ShardFor(key);
+  std::shared_ptr<Fetch> fetch;
+  std::string disk_path;
+  size_t disk_size = 0;
+  uint32_t disk_crc = 0;
+  uint64_t timestamp = env_->NowSeconds();
+  uint64_t generation = 0;
+  bool owner = false;
+  std::vector<std::string> deletions;
+  {
+    absl::MutexLock lock(shard.mu);
+    auto it = shard.blocks.find(key);
+    if (it != shard.blocks.end() && options_.max_staleness > 0 &&
+        timestamp - it->second.timestamp > options_.max_staleness) {
+      RemoveBlock_Locked(shard, it, &deletions);
+      it = shard.blocks.end();
+    }
+    if (it != shard.blocks.end()) {
+      if (readahead) return absl::OkStatus();
+      Touch_Locked(shard, it);
+      if (it->second.data != nullptr) {
+        ++ram_hits_;
+        if (cache_stats_ != nullptr) {
+          cache_stats_->RecordCacheHitBlockSize(it->second.size);
+        }
+        *data = it->second.data;
+        return absl::OkStatus();
+      }
+      disk_path = it->second.disk_path;
+      disk_size = it->second.size;
+      disk_crc = it->second.crc;
+      timestamp = it->second.timestamp;
+    }
+    auto [fetch_it, inserted] = shard.fetches.try_emplace(key);
+    if (inserted) {
+      fetch_it->second = std::make_shared<Fetch>();
+    }
+    // Readahead does not wait for blocks that are already being fetched.
+    if (inserted || !readahead) fetch = fetch_it->second;
+    owner = inserted;
+    generation = shard.generation;
+  }
+  DeleteFiles(deletions);
+  if (fetch == nullptr) return absl::OkStatus();
+  if (!owner) {
+    // Another read is fetching the block.
+    fetch->done.WaitForNotification();
+    ++fetch_waits_;
+    if (fetch->status.ok()) *data = fetch->data;
+    return fetch->status;
+  }
+
+  auto block = std::make_shared<std::vector<char>>();
+  absl::Status status;
+  bool from_disk = false;
+  if (!disk_path.empty()) {
+    status = ReadDiskBlock(env_, disk_path, disk_size, disk_crc, block.get());
+    if (status.ok()) {
+      from_disk = true;
+      ++disk_hits_;
+      if (cache_stats_ != nullptr) {
+        cache_stats_->RecordCacheHitBlockSize(disk_size);
+      }
+    } else {
+      // The block may have been evicted from disk since the lookup, or its
+      // file may have been damaged.
+      VLOG(1) << "Fetching block " << key.first << "@" << key.second
+              << " again after failing to read it from disk: " << status;
+      timestamp = env_->NowSeconds();
+    }
+  }
+  if (!from_disk) {
+    block->resize(options_.block_size);
+    size_t bytes_transferred = 0;
+    status = block_fetcher_(key.first, key.second, options_.block_size,
+                            block->data(), &bytes_transferred);
+    if (readahead) {
+      ++readahead_fetches_;
+    } else {
+      ++misses_;
+    }
+    if (cache_stats_ != nullptr) {
+      cache_stats_->RecordCacheMissBlockSize(bytes_transferred);
+    }
+    if (status.ok()) {
+      block->resize(bytes_transferred);
+      // Shrink the data capacity to the actual size used.
+      // NOLINTNEXTLINE: shrink_to_fit() may not shrink the capacity.
+      std::vector<char>(*block).swap(*block);
+    }
+  }
+
+  std::vector<Spill> spills;
+  {
+    absl::MutexLock lock(shard.mu);
+    auto it = shard.fetches.find(key);
+    if (it != shard.fetches.end() && it->second == fetch) {
+      shard.fetches.erase(it);
+    }
+    if (status.ok() && shard.generation == generation) {
+      Insert_Locked(shard, key, block, timestamp, &spills);
+    }
+  }
+  fetch->status = status;
+  if (status.ok()) fetch->data = block;
+  fetch->done.Notify();
+  SpillToDisk(shard, std::move(spills));
+  if (status.ok()) *data = std::move(block);
+  return status;
+}
+
+void TieredFileBlockCache::Insert_Locked(Shard& shard, const Key& key,
+                                         BlockData data, uint64_t timestamp,
+                                         std::vector<Spill>* spills) {
+  Block& block = shard.blocks[key];
+  if (block.data != nullptr) return;
+  block.size = data->size();
+  block.data = std::move(data);
+  block.timestamp = timestamp;
+  shard.ram_list.push_front(key);
+  block.ram_position = shard.ram_list.begin();
+  shard.ram_bytes += block.size;
+
+  while (shard.ram_bytes > max_ram_bytes_per_shard_ &&
+         !shard.ram_list.empty()) {
+    auto it = shard.blocks.find(shard.ram_list.back());
+    Block& evicted = it->second;
+    shard.ram_list.pop_back();
+    shard.ram_bytes -= evicted.size;
+    ++ram_evictions_;
+    if (!evicted.disk_path.empty()) {
+      // Already in the disk tier.
+      evicted.data.reset();
+      continue;
+    }
+    if (!disk_dir_.empty() && evicted.size > 0) {
+      spills->push_back({it->first, std::move(evicted.data)});
+    }
+    shard.blocks.erase(it);
+  }
+}
+
+void TieredFileBlockCache::Touch_Locked(Shard& shard,
+                                        std::map<Key, Block>::iterator it) {
+  if (options_.eviction_policy != BlockEvictionPolicy::kLru) return;
+  Block& block = it->second;
+  if (block.data != nullptr) {
+    shard.ram_list.splice(shard.ram_list.begin(), shard.ram_list,
+                          block.ram_position);
+  }
+  if (!block.disk_path.empty()) {
+    shard.disk_list.splice(shard.disk_list.begin(), shard.disk_list,
+                           block.disk_position);
+  }
+}
+
+void TieredFileBlockCache::TrimDisk_Locked(
+    Shard& shard, std::vector<std::string>* deletions) {
+  while (shard.disk_bytes > max_disk_bytes_per_shard_ &&
+         !shard.disk_list.empty()) {
+    auto it = shard.blocks.find(shard.disk_list.back());
+    Block& evicted = it->second;
+    shard.disk_list.pop_back();
+    shard.disk_bytes -= evicted.size;
+    ++disk_evictions_;
+    deletions->push_back(std::move(evicted.disk_path));
+    evicted.disk_path.clear();
+    if (evicted.data == nullptr) shard.blocks.erase(it);
+  }
+}
+
+void TieredFileBlockCache::RemoveBlock_Locked(
+    Shard& shard, std::map<Key, Block>::iterator it,
+    std::vector<std::string>* deletions) {
+  Block& block = it->second;
+  if (block.data != nullptr) {
+    shard.ram_list.erase(block.ram_position);
+    shard.ram_bytes -= block.size;
+  }
+  if (!block.disk_path.empty()) {
+    shard.disk_list.erase(block.disk_position);
+    shard.disk_bytes -= block.size;
+    deletions->push_back(std::move(block.disk_path));
+  }
+  shard.blocks.erase(it);
+  ++shard.generation;
+}
+
+void TieredFileBlockCache::SpillToDisk(Shard& shard,
+                                       std::vector<Spill> spills) {
+  if (spills.empty()) return;
+  uint64_t generation;
+  {
+    absl::MutexLock lock(shard.mu);
+    generation = shard.generation;
+  }
+  std::vector<std::pair<Spill, std::string>> written;
+  for (Spill& spill : spills) {
+    std::string path =
+        io::JoinPath(disk_dir_, absl::StrCat(next_disk_file_++));
+    spill.crc = crc32c::Value(spill.data->data(), spill.data->size());
+    absl::Status status = WriteDiskBlock(env_, path, *spill.data);
+    if (!status.ok()) {
+      LOG_EVERY_N_SEC(WARNING, 60)
+          << "Failed to write block " << spill.key.first << "@"
+          << spill.key.second << " of the file block cache to " << path
+          << ": " << status;
+      DeleteFiles({path});
+      continue;
+    }
+    written.emplace_back(std::move(spill), std::move(path));
+  }
+
+  std::vector<std::string> deletions;
+  {
+    absl::MutexLock lock(shard.mu);
+    for (auto& [spill, path] : written) {
+      if (shard.generation != generation) {
+        // Blocks were removed while writing, possibly these.
+        deletions.push_back(std::move(path));
+        continue;
+      }
+      auto [it, inserted] = shard.blocks.try_emplace(spill.key);
+      Block& block = it->second;
+      if (!block.disk_path.empty()) {
+        deletions.push_back(std::move(path));
+        continue;
+      }
+      if (inserted) block.timestamp = env_->NowSeconds();
+      block.size = spill.data->size();
+      block.crc = spill.crc;
+      block.disk_path = std::move(path);
+      shard.disk_list.push_front(spill.key);
+      block.disk_position = shard.disk_list.begin();
+      shard.disk_bytes += block.size;
+    }
+    TrimDisk_Locked(shard, &deletions);
+  }
+  DeleteFiles(deletions);
+}
+
+void TieredFileBlockCache::DeleteFiles(const std::vector<std::string>& paths) {
+  for (const std::string& path : paths) {
+    absl::Status status = env_->DeleteFile(path);
+    if (!status.ok() && !absl::IsNotFound(status)) {
+      LOG_EVERY_N_SEC(WARNING, 60)
+          << "Failed to delete " << path << " from the file block cache: "
+          << status;
+    }
+  }
+}
+
+absl::Status TieredFileBlockCache::Read(const std::string& filename,
+                                        size_t offset, size_t n, char* buffer,
+                                        size_t* bytes_transferred) {
+  *bytes_transferred = 0;
+  if (n == 0) {
+    return absl::OkStatus();
+  }
+  if (!IsCacheEnabled() || (n > options_.max_ram_bytes)) {
+    // The cache is effectively disabled, so we pass the read through to the
+    // fetcher without breaking it up into blocks.
+    return block_fetcher_(filename, offset, n, buffer, bytes_transferred);
+  }
+  const size_t block_size = options_.block_size;
+  // Calculate the block-aligned start and end of the read.
+  size_t start = block_size * (offset / block_size);
+  size_t finish = block_size * ((offset + n) / block_size);
+  if (finish < offset + n) {
+    finish += block_size;
+  }
+  size_t total_bytes_transferred = 0;
+  bool eof = false;
+  // Now iterate through the blocks, reading them one at a time.
+  for (size_t pos = start; pos < finish; pos += block_size) {
+    BlockData block;
+    RETURN_IF_ERROR(GetBlock(std::make_pair(filename, pos),
+                             /*readahead=*/false, &block));
+    const std::vector<char>& data = *block;
+    if (offset >= pos + data.size()) {
+      // The requested offset is at or beyond the end of the file. This can
+      // happen if `offset` is not block-aligned, and the read returns the last
+      // block in the file, which does not extend all the way out to `offset`.
+      *bytes_transferred = total_bytes_transferred;
+      return absl::OutOfRangeError(
+          absl::StrCat("EOF at offset ", offset, " in file ", filename,
+                       " at position ", pos, " with data size ", data.size()));
+    }
+    size_t begin = offset > pos ? offset - pos : 0;
+    size_t end = std::min(data.size(), offset + n - pos);
+    if (begin < end) {
+      std::memcpy(&buffer[total_bytes_transferred], data.data() + begin,
+                  end - begin);
+      total_bytes_transferred += end - begin;
+    }
+    if (data.size() < block_size) {
+      // The block was a partial block and thus signals EOF at its upper bound.
+      eof = true;
+      break;
+    }
+  }
+  *bytes_transferred = total_bytes_transferred;
+  if (!eof) {
+    MaybeReadahead(filename, start / block_size, finish / block_size - 1);
+  }
+  return absl::OkStatus();
+}
+
+void TieredFileBlockCache::MaybeReadahead(const std::string& filename,
+                                          size_t first_block,
+                                          size_t last_block) {
+  if (readahead_pool_ == nullptr) return;
+  size_t begin, end;
+  {
+    absl::MutexLock lock(readahead_mu_);
+    if (read_states_.size() >= kMaxTrackedFiles &&
+        !read_states_.contains(filename)) {
+      read_states_.clear();
+    }
+    ReadState& state = read_states_[filename];
+    // A read continues a sequential pattern if it starts in the last block of
+    // the previous read or right after it. The first read of a file counts if
+    // it starts at the beginning.
+    if (first_block == state.next_block ||
+        first_block + 1 == state.next_block) {
+      ++state.sequential_reads;
+    } else {
+      state.sequential_reads = 0;
+      state.readahead_end = 0;
+    }
+    state.next_block = last_block + 1;
+    if (state.sequential_reads == 0) return;
+    begin = std::max(state.next_block, state.readahead_end);
+    end = state.next_block + options_.readahead_blocks;
+    if (begin >= end) return;
+    state.readahead_end = end;
+  }
+  for (size_t block = begin; block < end; ++block) {
+    readahead_pool_->Schedule(
+        [this, key = std::make_pair(filename, block * options_.block_size)] {
+          BlockData data;
+          absl::Status status = GetBlock(key, /*readahead=*/true, &data);
+          if (!status.ok()) {
+            VLOG(1) << "Failed to read ahead block " << key.first << "@"
+                    << key.second << ": " << status;
+          }
+        });
+  }
+}
+
+bool TieredFileBlockCache::ValidateAndUpdateFileSignature(
+    const std::string& filename, int64_t file_signature) {
+  {
+    absl::MutexLock lock(signature_mu_);
+    auto [it, inserted] =
+        file_signatures_.try_emplace(filename, file_signature);
+    if (inserted || it->second == file_signature) {
+      return true;
+    }
+    it->second = file_signature;
+  }
+  // Remove the file from cache if the signatures don't match.
+  RemoveFile(filename);
+  return false;
+}
+
+void TieredFileBlockCache::RemoveFile(const std::string& filename) {
+  std::vector<std::string> deletions;
+  for (const auto& shard : shards_) {
+    absl::MutexLock lock(shard->mu);
+    auto it = shard->blocks.lower_bound(std::make_pair(filename, size_t{0}));
+    while (it != shard->blocks.end() && it->first.first == filename) {
+      RemoveBlock_Locked(*shard, it++, &deletions);
+    }
+    // Later reads must not wait for the fetches that started before.
+    auto fetch =
+        shard->fetches.lower_bound(std::make_pair(filename, size_t{0}));
+    while (fetch != shard->fetches.end() && fetch->first.first == filename) {
+      fetch = shard->fetches.erase(fetch);
+    }
+    ++shard->generation;
+  }
+  DeleteFiles(deletions);
+  absl::MutexLock lock(readahead_mu_);
+  read_states_.erase(filename);
+}
+
+void TieredFileBlockCache::Flush() {
+  std::vector<std::string> deletions;
+  for (const auto& shard : shards_) {
+    absl::MutexLock lock(shard->mu);
+    for (auto& [key, block] : shard->blocks) {
+      if (!block.disk_path.empty()) {
+        deletions.push_back(std::move(block.disk_path));
+      }
+    }
+    shard->blocks.clear();
+    shard->fetches.clear();
+    shard->ram_list.clear();
+    shard->disk_list.clear();
+    shard->ram_bytes = 0;
+    shard->disk_bytes = 0;
+    ++shard->generation;
+  }
+  DeleteFiles(deletions);
+  absl::MutexLock lock(readahead_mu_);
+  read_states_.clear();
+}
+
+size_t TieredFileBlockCache::CacheSize() const {
+  Stats stats = GetStats();
+  return stats.ram_bytes + stats.disk_bytes;
+}
+
+TieredFileBlockCache::Stats TieredFileBlockCache::GetStats() const {
+  Stats stats;
+  stats.ram_hits = ram_hits_;
+  stats.disk_hits = disk_hits_;
+  stats.misses = misses_;
+  stats.fetch_waits = fetch_waits_;
+  stats.readahead_fetches = readahead_fetches_;
+  stats.ram_evictions = ram_evictions_;
+  stats.disk_evictions = disk_evictions_;
+  for (const auto& shard : shards_) {
+    absl::MutexLock lock(shard->mu);
+    stats.ram_bytes += shard->ram_bytes;
+    stats.disk_bytes += shard->disk_bytes;
+  }
+  return stats;
+}
+
+}  // namespace tsl
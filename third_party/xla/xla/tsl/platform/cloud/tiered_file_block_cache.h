@@ -0,0 +1,299 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_PLATFORM_CLOUD_TIERED_FILE_BLOCK_CACHE_H_
+#define XLA_TSL_PLATFORM_CLOUD_TIERED_FILE_BLOCK_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xla/tsl/platform/cloud/file_block_cache.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/threadpool.h"
+#include "tsl/platform/thread_annotations.h"
+
+namespace tsl {
+
+/// The order in which the blocks of a TieredFileBlockCache are evicted.
+enum class BlockEvictionPolicy {
+  /// Evict the least recently read block first.
+  kLru,
+  /// Evict the block that was cached first, regardless of reads. Suits
+  /// datasets that are read in full every epoch, which defeat LRU once they
+  /// are larger than the cache.
+  kFifo,
+};
+
+struct TieredFileBlockCacheOptions {
+  /// The size of the cached blocks.
+  size_t block_size = 16 << 20;
+  /// Upper bound on the memory used by the RAM tier. The cache is disabled if
+  /// this is 0.
+  size_t max_ram_bytes = size_t{1} << 30;
+  /// The local directory holding the disk tier, which keeps the blocks evicted
+  /// from RAM. The disk tier is disabled if this is empty. The directory may be
+  /// shared by several processes: each cache locks its own disk tier, and
+  /// deletes the unlocked ones left by processes that have exited when it is
+  /// created.
+  std::string disk_dir;
+  /// Upper bound on the disk space used by the disk tier.
+  size_t max_disk_bytes = size_t{10} << 30;
+  /// The number of independently locked shards of the cache. Capped so that
+  /// each shard holds at least one block in RAM.
+  int num_shards = 16;
+  /// The number of blocks read ahead of sequential reads of a file.
+  size_t readahead_blocks = 2;
+  BlockEvictionPolicy eviction_policy = BlockEvictionPolicy::kLru;
+  /// Blocks cached for longer than this many seconds are fetched again. Blocks
+  /// never go stale if this is 0.
+  uint64_t max_staleness = 0;
+};
+
+/// \brief A two-tier block cache of file contents, keyed by {filename, offset}.
+///
+/// Blocks are cached in RAM, and spilled to files in a local directory when
+/// they are evicted from RAM, so that a working set larger than the memory
+/// budget is still read from local disk rather than from the backing
+/// filesystem. The cache is split into shards with their own locks. Concurrent
+/// reads of a block that is not cached share a single fetch.
+///
+/// Once a file has been read sequentially, the blocks following each read are
+/// fetched ahead of time on a background thread pool.
+///
+/// This class should be shared by read-only random access files on a slow
+/// filesystem (e.g. a network mount or an object store).
+class TieredFileBlockCache : public FileBlockCache {
+ public:
+  /// Counters of the cache since its creation.
+  struct Stats {
+    /// Blocks read from the RAM tier.
+    uint64_t ram_hits = 0;
+    /// Blocks read from the disk tier.
+    uint64_t disk_hits = 0;
+    /// Blocks fetched from the backing filesystem for a read.
+    uint64_t misses = 0;
+    /// Blocks read by waiting for the fetch of another read (e.g. a readahead
+    /// that had not finished), from the backing filesystem or from disk.
+    uint64_t fetch_waits = 0;
+    /// Blocks fetched from the backing filesystem ahead of reads.
+    uint64_t readahead_fetches = 0;
+    /// Blocks dropped from the RAM tier, and from the disk tier.
+    uint64_t ram_evictions = 0;
+    uint64_t disk_evictions = 0;
+    /// The current size of the RAM tier and of the disk tier, in bytes.
+    uint64_t ram_bytes = 0;
+    uint64_t disk_bytes = 0;
+  };
+
+  TieredFileBlockCache(const TieredFileBlockCacheOptions& options,
+                       BlockFetcher block_fetcher, Env* env = Env::Default());
+
+  /// Waits for the readahead in flight, and deletes the disk tier.
+  ~TieredFileBlockCache() override;
+
+  /// Read `n` bytes from `filename` starting at `offset` into `out`. This
+  /// method will return:
+  ///
+  /// 1) The error from the backing filesystem, if the read from the backing
+  ///    filesystem failed.
+  /// 2) OUT_OF_RANGE if the read from the backing filesystem succeeded, but
+  ///    the file contents do not extend past `offset` and thus nothing was
+  ///    placed in `out`.
+  /// 3) OK otherwise (i.e. the read succeeded, and at least one byte was placed
+  ///    in `out`).
+  absl::Status Read(const std::string& filename, size_t offset, size_t n,
+                    char* buffer, size_t* bytes_transferred) override;
+
+  // Validate the given file signature with the existing file signature in the
+  // cache. Returns true if the signature doesn't change or the file doesn't
+  // exist before. If the signature changes, update the existing signature with
+  // the new one and remove the file from cache.
+  bool ValidateAndUpdateFileSignature(const std::string& filename,
+                                      int64_t file_signature) override
+      TF_LOCKS_EXCLUDED(signature_mu_);
+
+  /// Remove all cached blocks for `filename`.
+  void RemoveFile(const std::string& filename) override;
+
+  /// Remove all cached data.
+  void Flush() override;
+
+  /// Accessors for cache parameters.
+  size_t block_size() const override { return options_.block_size; }
+  size_t max_bytes() const override {
+    return options_.max_ram_bytes + max_disk_bytes_;
+  }
+  uint64_t max_staleness() const override { return options_.max_staleness; }
+
+  /// The current size (in bytes) of the cache, over both tiers.
+  size_t CacheSize() const override;
+
+  // Returns true if the cache is enabled. If false, the BlockFetcher callback
+  // is always executed during Read.
+  bool IsCacheEnabled() const override {
+    return options_.block_size > 0 && options_.max_ram_bytes > 0;
+  }
+
+  Stats GetStats() const;
+
+ private:
+  /// The key of a block: {filename, offset}.
+  typedef std::pair<std::string, size_t> Key;
+  typedef std::shared_ptr<const std::vector<char>> BlockData;
+
+  struct Block {
+    /// The contents of the block if it is in the RAM tier, null otherwise.
+    BlockData data;
+    /// The size of the block.
+    size_t size = 0;
+    /// The file holding the block if it is in the disk tier, empty otherwise.
+    std::string disk_path;
+    /// The crc32c of the block in the disk tier, checked when it is read.
+    uint32_t crc = 0;
+    /// The positions of the block in the eviction lists of the tiers it is in.
+    std::list<Key>::iterator ram_position;
+    std::list<Key>::iterator disk_position;
+    /// The time at which the block was fetched, in seconds.
+    uint64_t timestamp = 0;
+  };
+
+  /// A fetch of a block from the backing filesystem or from disk, which other
+  /// reads of the block wait for.
+  struct Fetch {
+    absl::Notification done;
+    absl::Status status;
+    BlockData data;
+  };
+
+  /// A block evicted from RAM that is still to be written to disk.
+  struct Spill {
+    Key key;
+    BlockData data;
+    uint32_t crc = 0;
+  };
+
+  struct Shard {
+    absl::Mutex mu;
+    std::map<Key, Block> blocks TF_GUARDED_BY(mu);
+    std::map<Key, std::shared_ptr<Fetch>> fetches TF_GUARDED_BY(mu);
+    /// The eviction order of each tier: blocks at the back go first.
+    std::list<Key> ram_list TF_GUARDED_BY(mu);
+    std::list<Key> disk_list TF_GUARDED_BY(mu);
+    size_t ram_bytes TF_GUARDED_BY(mu) = 0;
+    size_t disk_bytes TF_GUARDED_BY(mu) = 0;
+    /// Incremented whenever blocks are removed, so that fetches and spills
+    /// that started before do not insert stale data.
+    uint64_t generation TF_GUARDED_BY(mu) = 0;
+  };
+
+  /// The sequential access pattern of a file.
+  struct ReadState {
+    /// The block following the last read.
+    size_t next_block = 0;
+    /// The number of reads in a row that started where the previous one
+    /// ended.
+    int sequential_reads = 0;
+    /// Blocks before this one have already been read ahead.
+    size_t readahead_end = 0;
+  };
+
+  Shard& ShardFor(const Key& key);
+
+  /// Returns the block at `key`, from the cache or fetched.
+  absl::Status GetBlock(const Key& key, bool readahead, BlockData* data);
+
+  /// Inserts a fetched block in the RAM tier of `shard`, and evicts blocks
+  /// from RAM, appending those to be written to disk to `spills`.
+  void Insert_Locked(Shard& shard, const Key& key, BlockData data,
+                     uint64_t timestamp, std::vector<Spill>* spills)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Moves the block at `it` to the front of the eviction lists, for LRU.
+  void Touch_Locked(Shard& shard, std::map<Key, Block>::iterator it)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Evicts blocks from the disk tier of `shard` until it is within its limit,
+  /// appending the files to delete to `deletions`.
+  void TrimDisk_Locked(Shard& shard, std::vector<std::string>* deletions)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Removes the block at `it` from both tiers, appending its file to
+  /// `deletions`.
+  void RemoveBlock_Locked(Shard& shard, std::map<Key, Block>::iterator it,
+                          std::vector<std::string>* deletions)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Writes `spills` to the disk tier of `shard`.
+  void SpillToDisk(Shard& shard, std::vector<Spill> spills);
+  void DeleteFiles(const std::vector<std::string>& paths);
+
+  /// Records a read of blocks [first_block, last_block] of `filename`, and
+  /// schedules the readahead of the blocks following it if the file is being
+  /// read sequentially.
+  void MaybeReadahead(const std::string& filename, size_t first_block,
+                      size_t last_block) TF_LOCKS_EXCLUDED(readahead_mu_);
+
+  const TieredFileBlockCacheOptions options_;
+  const size_t max_disk_bytes_;
+  const BlockFetcher block_fetcher_;
+  Env* const env_;
+
+  /// The limits of each shard.
+  size_t max_ram_bytes_per_shard_ = 0;
+  size_t max_disk_bytes_per_shard_ = 0;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  /// The directory of the disk tier of this cache, inside
+  /// `options_.disk_dir`. Empty if the disk tier is disabled.
+  std::string disk_dir_;
+  /// The file descriptor holding the lock on the lock file next to
+  /// `disk_dir_`, or -1.
+  int disk_lock_fd_ = -1;
+  std::atomic<uint64_t> next_disk_file_{0};
+
+  absl::Mutex signature_mu_;
+  absl::flat_hash_map<std::string, int64_t> file_signatures_
+      TF_GUARDED_BY(signature_mu_);
+
+  absl::Mutex readahead_mu_;
+  absl::flat_hash_map<std::string, ReadState> read_states_
+      TF_GUARDED_BY(readahead_mu_);
+
+  std::atomic<uint64_t> ram_hits_{0};
+  std::atomic<uint64_t> disk_hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> fetch_waits_{0};
+  std::atomic<uint64_t> readahead_fetches_{0};
+  std::atomic<uint64_t> ram_evictions_{0};
+  std::atomic<uint64_t> disk_evictions_{0};
+
+  /// Runs the readahead. Destroyed first, so that the readahead in flight
+  /// finishes while the cache is still alive.
+  std::unique_ptr<thread::ThreadPool> readahead_pool_;
+};
+
+}  // namespace tsl
+
+#endif  // XLA_TSL_PLATFORM_CLOUD_TIERED_FILE_BLOCK_CACHE_H_
@@ -0,0 +1,439 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/platform/cloud/tiered_file_block_cache.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/cloud/now_seconds_env.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/test.h"
+#include "tsl/platform/path.h"
+
+namespace tsl {
+namespace {
+
+absl::Status ReadCache(TieredFileBlockCache* cache,
+                       const std::string& filename, size_t offset, size_t n,
+                       std::vector<char>* out) {
+  out->clear();
+  out->resize(n, 0);
+  size_t bytes_transferred = 0;
+  absl::Status status =
+      cache->Read(filename, offset, n, out->data(), &bytes_transferred);
+  EXPECT_LE(bytes_transferred, n);
+  out->resize(bytes_transferred, n);
+  return status;
+}
+
+// A backing file system of files of `file_size` bytes, where the byte at
+// offset `i` is `i % 256`. Counts the fetches of each block.
+class FakeFetcher {
+ public:
+  explicit FakeFetcher(size_t file_size) : file_size_(file_size) {}
+
+  TieredFileBlockCache::BlockFetcher fetcher() {
+    return [this](const std::string& filename, size_t offset, size_t n,
+                  char* buffer, size_t* bytes_transferred) {
+      {
+        absl::MutexLock lock(mu_);
+        ++fetches_[offset];
+      }
+      *bytes_transferred = 0;
+      for (size_t i = offset; i < offset + n && i < file_size_; ++i) {
+        buffer[(*bytes_transferred)++] = static_cast<char>(i % 256);
+      }
+      return absl::OkStatus();
+    };
+  }
+
+  int fetches(size_t offset) {
+    absl::MutexLock lock(mu_);
+    return fetches_[offset];
+  }
+
+  int total_fetches() {
+    absl::MutexLock lock(mu_);
+    return TotalFetches();
+  }
+
+  // Waits until `n` blocks have been fetched in total.
+  void WaitForFetches(int n) {
+    struct Arg {
+      FakeFetcher* fetcher;
+      int n;
+    } arg = {this, n};
+    absl::MutexLock lock(mu_);
+    mu_.Await(absl::Condition(
+        +[](Arg* arg) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+          return arg->fetcher->TotalFetches() >= arg->n;
+        },
+        &arg));
+  }
+
+ private:
+  int TotalFetches() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    int total = 0;
+    for (const auto& [offset, count] : fetches_) total += count;
+    return total;
+  }
+
+  const size_t file_size_;
+  absl::Mutex mu_;
+  std::map<size_t, int> fetches_;
+};
+
+void ExpectContents(const std::vector<char>& out, size_t offset) {
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_EQ(out[i], static_cast<char>((offset + i) % 256)) << i;
+  }
+}
+
+TieredFileBlockCacheOptions Options(size_t block_size, size_t max_ram_bytes) {
+  TieredFileBlockCacheOptions options;
+  options.block_size = block_size;
+  options.max_ram_bytes = max_ram_bytes;
+  options.num_shards = 1;
+  options.readahead_blocks = 0;
+  return options;
+}
+
+TEST(TieredFileBlockCacheTest, IsCacheEnabled) {
+  FakeFetcher fetcher(0);
+  EXPECT_FALSE(
+      TieredFileBlockCache(Options(0, 32), fetcher.fetcher()).IsCacheEnabled());
+  EXPECT_FALSE(
+      TieredFileBlockCache(Options(16, 0), fetcher.fetcher()).IsCacheEnabled());
+  EXPECT_TRUE(TieredFileBlockCache(Options(16, 32), fetcher.fetcher())
+                  .IsCacheEnabled());
+}
+
+TEST(TieredFileBlockCacheTest, PassThroughWhenDisabled) {
+  FakeFetcher fetcher(100);
+  TieredFileBlockCache cache(Options(16, 0), fetcher.fetcher());
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "a", 3, 10, &out));
+  ExpectContents(out, 3);
+  TF_EXPECT_OK(ReadCache(&cache, "a", 3, 10, &out));
+  EXPECT_EQ(fetcher.fetches(3), 2);
+  EXPECT_EQ(cache.CacheSize(), 0);
+}
+
+TEST(TieredFileBlockCacheTest, ReadsAcrossBlocks) {
+  FakeFetcher fetcher(100);
+  TieredFileBlockCache cache(Options(16, 1024), fetcher.fetcher());
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "a", 10, 30, &out));
+  EXPECT_EQ(out.size(), 30);
+  ExpectContents(out, 10);
+  TF_EXPECT_OK(ReadCache(&cache, "a", 20, 5, &out));
+  ExpectContents(out, 20);
+  EXPECT_EQ(fetcher.total_fetches(), 3);
+
+  // A read past the end of the file returns what is left.
+  TF_EXPECT_OK(ReadCache(&cache, "a", 90, 20, &out));
+  EXPECT_EQ(out.size(), 10);
+  ExpectContents(out, 90);
+  EXPECT_TRUE(absl::IsOutOfRange(ReadCache(&cache, "a", 100, 4, &out)));
+
+  TieredFileBlockCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 5);
+  EXPECT_EQ(stats.ram_hits, 2);
+  EXPECT_EQ(stats.ram_bytes, 16 * 4 + 4);
+  EXPECT_EQ(cache.CacheSize(), 16 * 4 + 4);
+}
+
+TEST(TieredFileBlockCacheTest, LruEviction) {
+  FakeFetcher fetcher(1000);
+  // Room for two blocks.
+  TieredFileBlockCache cache(Options(16, 32), fetcher.fetcher());
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 16, 1, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+  // Evicts the block at 16, which was read last.
+  TF_EXPECT_OK(ReadCache(&cache, "a", 32, 1, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+  EXPECT_EQ(fetcher.fetches(0), 1);
+  TF_EXPECT_OK(ReadCache(&cache, "a", 16, 1, &out));
+  EXPECT_EQ(fetcher.fetches(16), 2);
+  EXPECT_EQ(cache.GetStats().ram_evictions, 2);
+}
+
+TEST(TieredFileBlockCacheTest, FifoEviction) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCacheOptions options = Options(16, 32);
+  options.eviction_policy = BlockEvictionPolicy::kFifo;
+  TieredFileBlockCache cache(options, fetcher.fetcher());
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 16, 1, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+  // Evicts the block at 0, which was cached first.
+  TF_EXPECT_OK(ReadCache(&cache, "a", 32, 1, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 16, 1, &out));
+  EXPECT_EQ(fetcher.fetches(16), 1);
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+  EXPECT_EQ(fetcher.fetches(0), 2);
+}
+
+TEST(TieredFileBlockCacheTest, SpillsToDisk) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCacheOptions options = Options(16, 32);
+  options.disk_dir = io::JoinPath(testing::TmpDir(), "spills_to_disk");
+  // Room for six more blocks.
+  options.max_disk_bytes = 96;
+  std::vector<char> out;
+  {
+    TieredFileBlockCache cache(options, fetcher.fetcher());
+    for (size_t offset = 0; offset < 16 * 8; offset += 16) {
+      TF_EXPECT_OK(ReadCache(&cache, "a", offset, 16, &out));
+    }
+    EXPECT_EQ(fetcher.total_fetches(), 8);
+    TieredFileBlockCache::Stats stats = cache.GetStats();
+    EXPECT_EQ(stats.ram_evictions, 6);
+    EXPECT_EQ(stats.disk_evictions, 0);
+    EXPECT_EQ(stats.ram_bytes, 32);
+    EXPECT_EQ(stats.disk_bytes, 96);
+
+    // Blocks 5 to 2 are read from disk. Blocks 6 and 7 are spilled in turn,
+    // which evicts blocks 0 and 1 from disk.
+    for (int block = 5; block >= 2; --block) {
+      TF_EXPECT_OK(ReadCache(&cache, "a", 16 * block, 16, &out));
+      ExpectContents(out, 16 * block);
+    }
+    EXPECT_EQ(fetcher.total_fetches(), 8);
+    stats = cache.GetStats();
+    EXPECT_EQ(stats.disk_hits, 4);
+    EXPECT_EQ(stats.disk_evictions, 2);
+    TF_EXPECT_OK(ReadCache(&cache, "a", 0, 16, &out));
+    ExpectContents(out, 0);
+    EXPECT_EQ(fetcher.fetches(0), 2);
+
+    cache.RemoveFile("a");
+    EXPECT_EQ(cache.CacheSize(), 0);
+    TF_EXPECT_OK(ReadCache(&cache, "a", 16 * 2, 16, &out));
+    EXPECT_EQ(fetcher.fetches(16 * 2), 2);
+  }
+  // The disk tier is deleted with the cache.
+  std::vector<std::string> children;
+  TF_EXPECT_OK(Env::Default()->GetChildren(
+      io::JoinPath(options.disk_dir, "tf_file_block_cache"), &children));
+  EXPECT_TRUE(children.empty());
+}
+
+TEST(TieredFileBlockCacheTest, DeletesStaleDiskTiers) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCacheOptions options = Options(16, 32);
+  options.disk_dir = io::JoinPath(testing::TmpDir(), "stale_disk_tiers");
+  const std::string root =
+      io::JoinPath(options.disk_dir, "tf_file_block_cache");
+  // Left by a process that exited without destroying its cache, so that its
+  // lock file is not locked.
+  const std::string stale = io::JoinPath(root, "stale");
+  TF_ASSERT_OK(Env::Default()->RecursivelyCreateDir(stale));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), io::JoinPath(stale, "0"),
+                                 "stale block"));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), stale + ".lock", ""));
+
+  TieredFileBlockCache cache(options, fetcher.fetcher());
+  EXPECT_TRUE(absl::IsNotFound(Env::Default()->FileExists(stale)));
+  EXPECT_TRUE(absl::IsNotFound(Env::Default()->FileExists(stale + ".lock")));
+  std::vector<std::string> children;
+  TF_EXPECT_OK(Env::Default()->GetChildren(root, &children));
+  EXPECT_EQ(children.size(), 2);
+  {
+    // The locked disk tiers of live caches are kept.
+    TieredFileBlockCache other(options, fetcher.fetcher());
+    TF_EXPECT_OK(Env::Default()->GetChildren(root, &children));
+    EXPECT_EQ(children.size(), 4);
+  }
+  std::vector<char> out;
+  for (size_t offset = 0; offset < 16 * 4; offset += 16) {
+    TF_EXPECT_OK(ReadCache(&cache, "a", offset, 16, &out));
+  }
+  EXPECT_EQ(cache.GetStats().disk_bytes, 32);
+}
+
+TEST(TieredFileBlockCacheTest, RefetchesDamagedDiskBlocks) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCacheOptions options = Options(16, 16);
+  options.disk_dir = io::JoinPath(testing::TmpDir(), "damaged_disk_blocks");
+  TieredFileBlockCache cache(options, fetcher.fetcher());
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 16, &out));
+  // Spills block 0 to disk.
+  TF_EXPECT_OK(ReadCache(&cache, "a", 16, 16, &out));
+  EXPECT_EQ(cache.GetStats().disk_bytes, 16);
+
+  // Overwrites the spilled block with other data of the same size.
+  const std::string root =
+      io::JoinPath(options.disk_dir, "tf_file_block_cache");
+  std::vector<std::string> matches;
+  TF_ASSERT_OK(Env::Default()->GetMatchingPaths(
+      io::JoinPath(root, "cache-*", "*"), &matches));
+  ASSERT_EQ(matches.size(), 1);
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), matches[0],
+                                 std::string(16, 'x')));
+
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 16, &out));
+  ExpectContents(out, 0);
+  EXPECT_EQ(fetcher.fetches(0), 2);
+  EXPECT_EQ(cache.GetStats().disk_hits, 0);
+}
+
+TEST(TieredFileBlockCacheTest, Readahead) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCacheOptions options = Options(16, 1024);
+  options.readahead_blocks = 2;
+  TieredFileBlockCache cache(options, fetcher.fetcher());
+  std::vector<char> out;
+  // The first read of a file reads blocks 1 and 2 ahead, the second one block
+  // 3, the third one block 4.
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 10, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 10, 10, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 20, 20, &out));
+  fetcher.WaitForFetches(5);
+  // Reads in reverse order are not sequential, and read nothing ahead.
+  for (int block = 4; block >= 0; --block) {
+    TF_EXPECT_OK(ReadCache(&cache, "a", 16 * block, 16, &out));
+    ExpectContents(out, 16 * block);
+    EXPECT_EQ(fetcher.fetches(16 * block), 1);
+  }
+  EXPECT_EQ(fetcher.total_fetches(), 5);
+  // Blocks 1 and 2 may have been read before they were read ahead.
+  TieredFileBlockCache::Stats stats = cache.GetStats();
+  EXPECT_GE(stats.readahead_fetches, 2);
+  EXPECT_EQ(stats.readahead_fetches + stats.misses, 5);
+}
+
+TEST(TieredFileBlockCacheTest, NoReadaheadOfRandomReads) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCacheOptions options = Options(16, 1024);
+  options.readahead_blocks = 2;
+  std::vector<char> out;
+  {
+    TieredFileBlockCache cache(options, fetcher.fetcher());
+    TF_EXPECT_OK(ReadCache(&cache, "a", 160, 1, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "a", 48, 1, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "a", 320, 1, &out));
+  }
+  EXPECT_EQ(fetcher.total_fetches(), 3);
+}
+
+TEST(TieredFileBlockCacheTest, ConcurrentReadsShareFetch) {
+  FakeFetcher fetcher(1000);
+  auto fetch = fetcher.fetcher();
+  absl::Notification fetching, release;
+  TieredFileBlockCache cache(
+      Options(16, 1024), [&](const std::string& filename, size_t offset,
+                             size_t n, char* buffer,
+                             size_t* bytes_transferred) {
+        fetching.Notify();
+        release.WaitForNotification();
+        return fetch(filename, offset, n, buffer, bytes_transferred);
+      });
+  std::vector<char> out1, out2;
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      ThreadOptions(), "reader",
+      [&] { TF_EXPECT_OK(ReadCache(&cache, "a", 0, 16, &out1)); }));
+  fetching.WaitForNotification();
+  std::unique_ptr<Thread> waiter(Env::Default()->StartThread(
+      ThreadOptions(), "waiter",
+      [&] { TF_EXPECT_OK(ReadCache(&cache, "a", 4, 8, &out2)); }));
+  Env::Default()->SleepForMicroseconds(100 * 1000);
+  release.Notify();
+  thread.reset();
+  waiter.reset();
+  ExpectContents(out1, 0);
+  ExpectContents(out2, 4);
+  EXPECT_EQ(fetcher.total_fetches(), 1);
+  // The waiter is not counted as a miss, nor as a hit if it waited for the
+  // fetch.
+  TieredFileBlockCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.fetch_waits + stats.ram_hits, 1);
+}
+
+TEST(TieredFileBlockCacheTest, FetchError) {
+  int calls = 0;
+  TieredFileBlockCache cache(
+      Options(16, 1024), [&calls](const std::string& filename, size_t offset,
+                                  size_t n, char* buffer,
+                                  size_t* bytes_transferred) {
+        ++calls;
+        return absl::UnavailableError("Unavailable");
+      });
+  std::vector<char> out;
+  EXPECT_TRUE(absl::IsUnavailable(ReadCache(&cache, "a", 0, 4, &out)));
+  // Errors are not cached.
+  EXPECT_TRUE(absl::IsUnavailable(ReadCache(&cache, "a", 0, 4, &out)));
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(cache.CacheSize(), 0);
+}
+
+TEST(TieredFileBlockCacheTest, ValidateAndUpdateFileSignature) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCache cache(Options(16, 1024), fetcher.fetcher());
+  std::vector<char> out;
+  EXPECT_TRUE(cache.ValidateAndUpdateFileSignature("a", 123));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 16, &out));
+  EXPECT_TRUE(cache.ValidateAndUpdateFileSignature("a", 123));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 16, &out));
+  EXPECT_EQ(fetcher.fetches(0), 1);
+  EXPECT_FALSE(cache.ValidateAndUpdateFileSignature("a", 321));
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 16, &out));
+  EXPECT_EQ(fetcher.fetches(0), 2);
+}
+
+TEST(TieredFileBlockCacheTest, MaxStaleness) {
+  FakeFetcher fetcher(1000);
+  std::unique_ptr<NowSecondsEnv> env(new NowSecondsEnv);
+  TieredFileBlockCacheOptions options = Options(16, 1024);
+  options.max_staleness = 2;
+  TieredFileBlockCache cache(options, fetcher.fetcher(), env.get());
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+  for (int i = 1; i <= 10; i++) {
+    env->SetNowSeconds(i + 1);
+    TF_EXPECT_OK(ReadCache(&cache, "a", 0, 1, &out));
+    EXPECT_EQ(fetcher.fetches(0), 1 + i / 3);
+  }
+}
+
+TEST(TieredFileBlockCacheTest, Flush) {
+  FakeFetcher fetcher(1000);
+  TieredFileBlockCacheOptions options = Options(16, 64);
+  options.num_shards = 4;
+  TieredFileBlockCache cache(options, fetcher.fetcher());
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "a", 0, 64, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "b", 0, 16, &out));
+  EXPECT_GT(cache.CacheSize(), 0);
+  cache.Flush();
+  EXPECT_EQ(cache.CacheSize(), 0);
+  TF_EXPECT_OK(ReadCache(&cache, "b", 0, 16, &out));
+  EXPECT_EQ(fetcher.fetches(0), 3);
+}
+
+}  // namespace
+}  // namespace tsl
@@ -387,6 +387,7 @@ def tf_additional_core_deps():
         clean_dep("//xla/tsl:ios"): [],
         clean_dep("//xla/tsl:linux_s390x"): [],
         "//conditions:default": [
+            clean_dep("//xla/tsl/platform/cloud:caching_file_system"),
             clean_dep("//xla/tsl/platform/cloud:gcs_file_system"),
         ],
     })